@@ -0,0 +1,69 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Example consumer of the shared memory snapshot published by nvtop --shm: prints the devices and their processes
+// every second. Build against include/nvtop/shm_snapshot.h only, nothing else from nvtop is needed.
+
+#include "nvtop/shm_snapshot.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+int main(int argc, char **argv) {
+  const char *name = argc > 1 ? argv[1] : NVTOP_SHM_DEFAULT_NAME;
+  const struct nvtop_shm_segment *segment = nvtop_shm_open(name);
+  if (!segment) {
+    fprintf(stderr, "No nvtop snapshot published under %s\n", name);
+    return EXIT_FAILURE;
+  }
+
+  // The snapshot is large, keep it off the stack
+  struct nvtop_shm_segment *snapshot = malloc(sizeof(*snapshot));
+  if (!snapshot) {
+    perror("Cannot allocate memory: ");
+    return EXIT_FAILURE;
+  }
+  for (;;) {
+    nvtop_shm_read(segment, snapshot);
+    printf("Update %" PRIu64 " from pid %" PRId32 "\n", snapshot->sequence / 2, snapshot->publisher_pid);
+    for (uint32_t i = 0; i < snapshot->devices_count; ++i) {
+      const struct nvtop_shm_device *device = &snapshot->devices[i];
+      printf("  [%" PRIu32 "] %s %s", i, device->pdev, device->valid & nvtop_shm_device_name ? device->name : "");
+      if (device->valid & nvtop_shm_device_gpu_util)
+        printf(" GPU %" PRIu32 "%%", device->gpu_util);
+      if (device->valid & nvtop_shm_device_used_memory && device->valid & nvtop_shm_device_total_memory)
+        printf(" MEM %" PRIu64 "/%" PRIu64 " MiB", device->used_memory >> 20, device->total_memory >> 20);
+      printf("\n");
+      for (uint32_t j = 0; j < device->processes_count; ++j) {
+        const struct nvtop_shm_process *process = &snapshot->processes[device->processes_offset + j];
+        printf("    pid %" PRId32, process->pid);
+        if (process->valid & nvtop_shm_process_gpu_util)
+          printf(" GPU %" PRIu32 "%%", process->gpu_util);
+        if (process->valid & nvtop_shm_process_gpu_memory)
+          printf(" MEM %" PRIu64 " MiB", process->gpu_memory >> 20);
+        printf("\n");
+      }
+    }
+    fflush(stdout);
+    sleep(1);
+  }
+}
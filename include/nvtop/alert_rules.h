@@ -0,0 +1,105 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef NVTOP_ALERT_RULES_H__
+#define NVTOP_ALERT_RULES_H__
+
+#include "list.h"
+
+#include <stdbool.h>
+
+/*
+ * Alert rules come from the [Alert] sections of the configuration file. A rule fires on a device once its condition
+ * held on every refresh for `duration` seconds, then stays quiet until the condition clears: a new firing needs a new
+ * episode and at least `cooldown` seconds since the last one. On top of that, the firings of all the rules share a
+ * budget of ALERT_MAX_FIRINGS_PER_MINUTE and at most ALERT_MAX_RUNNING_COMMANDS hook commands run at once; the firings
+ * over budget are dropped and counted in the next delivered one.
+ *
+ * A condition is a conjunction of clauses separated by "&&", each of the form "metric < threshold" or
+ * "metric > threshold" with the metrics:
+ *   gpu      GPU utilization in percent
+ *   mem      Memory used in percent of the device memory
+ *   memused  Memory used in bytes
+ *   temp     Temperature in Celsius
+ *   power    Power draw in watts
+ *   fan      Fan speed in percent
+ *   procmem  Memory used by the largest process of the device in bytes
+ * Byte thresholds take the K, M, G and T binary suffixes. Temperature thresholds can be relative to the device
+ * limits: "temp > slowdown - 5" or "temp > shutdown - 10".
+ */
+
+#define ALERT_MAX_CLAUSES 8
+#define ALERT_DEFAULT_COOLDOWN 300.
+#define ALERT_MAX_FIRINGS_PER_MINUTE 12
+#define ALERT_MAX_RUNNING_COMMANDS 4
+
+struct alert_rule {
+  char *name;
+  char *condition;
+  double duration; // Seconds the condition must hold before firing
+  double cooldown; // Minimum seconds between two firings of the rule on a device
+  char *command;   // Run by /bin/sh with the NVTOP_ALERT_* environment variables, NULL if none
+  char *fifo;      // FIFO or file receiving a JSON line per firing, NULL if none
+};
+
+enum alert_metric {
+  alert_metric_gpu_util,
+  alert_metric_memory,
+  alert_metric_memory_used,
+  alert_metric_temperature,
+  alert_metric_power,
+  alert_metric_fan,
+  alert_metric_process_memory,
+  alert_metric_count,
+};
+
+enum alert_reference {
+  alert_reference_none,
+  alert_reference_slowdown,
+  alert_reference_shutdown,
+};
+
+struct alert_clause {
+  enum alert_metric metric;
+  bool below;
+  enum alert_reference reference; // The threshold is an offset to this device limit
+  double threshold;
+};
+
+// Parses a condition, returns false if malformed
+bool alert_condition_parse(const char *condition, unsigned *count, struct alert_clause clauses[ALERT_MAX_CLAUSES]);
+
+// Appends a rule with the default settings to the array
+struct alert_rule *alert_rules_append(unsigned *count, struct alert_rule **rules, const char *name);
+
+void alert_rules_free(unsigned count, struct alert_rule *rules);
+
+struct alert_engine;
+
+// Copies the rules, returns NULL after reporting the first malformed rule
+struct alert_engine *alert_engine_create(unsigned count, const struct alert_rule *rules);
+
+// Evaluates the rules on the current data of the devices, now in seconds on a monotonic clock
+void alert_engine_evaluate(struct alert_engine *engine, struct list_head *devices, double now);
+
+void alert_engine_destroy(struct alert_engine *engine);
+
+#endif // NVTOP_ALERT_RULES_H__
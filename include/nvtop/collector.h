@@ -0,0 +1,179 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef NVTOP_COLLECTOR_H__
+#define NVTOP_COLLECTOR_H__
+
+#include "nvtop/extract_gpuinfo_common.h"
+
+#include <signal.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * The collector daemon (nvtop --daemon) polls the devices once and serves the gathered data to any number of clients
+ * over a Unix domain socket or TCP.
+ *
+ * Everything on the wire is encoded explicitly in little endian, independently of the struct layouts of both ends.
+ * Every message starts with a header: uint32_t magic, uint16_t version, uint16_t type, uint32_t payload length.
+ *
+ * A client sends either a query or a subscription whose payload is the uint64_t sequence number of the last snapshot
+ * it received, 0 at first. The daemon replies to a query with one snapshot; a subscribed client gets one snapshot
+ * after every refresh. A snapshot is:
+ *   uint64_t sequence number of this snapshot
+ *   uint32_t number of devices, number of devices included in this message
+ *   For each included device (only the devices that changed since the client sequence number):
+ *     uint32_t device index, uint8_t flags (COLLECTOR_DEVICE_HAS_*), text PCI address
+ *     The static info fields, only for the first snapshot
+ *     The dynamic info fields that changed, if any
+ *     If the processes changed: uint32_t number of processes, followed for each process by its int32_t pid and the
+ *     fields that changed, all of them for a process the client does not know yet
+ *
+ * A list of fields is a uint8_t count followed for each field by its uint8_t number in the field table of the
+ * structure, a uint8_t valid flag and, when valid, its value: uint32_t, uint64_t, int32_t, uint8_t booleans, doubles
+ * as their IEEE 754 bits in a uint64_t, enums as a uint32_t below the number of values, texts as a uint16_t length
+ * followed by the characters. The decoder rejects any value out of range.
+ */
+
+// The socket of the system daemon lives in a directory only it can write to, a daemon of another user serves in
+// $XDG_RUNTIME_DIR
+#define COLLECTOR_DEFAULT_SOCKET_DIR "/run/nvtop"
+#define COLLECTOR_DEFAULT_SOCKET COLLECTOR_DEFAULT_SOCKET_DIR "/collector.sock"
+#define COLLECTOR_USER_SOCKET_NAME "nvtop-collector.sock"
+#define COLLECTOR_DEFAULT_PORT "9394"
+#define COLLECTOR_PROTOCOL_MAGIC UINT32_C(0x4e56544f)
+#define COLLECTOR_PROTOCOL_VERSION 3
+#define COLLECTOR_HEADER_SIZE 12
+#define COLLECTOR_REQUEST_SIZE (COLLECTOR_HEADER_SIZE + 8)
+// The decoder rejects the snapshots of a peer claiming more devices
+#define COLLECTOR_MAX_DEVICES 4096
+
+enum collector_message_type {
+  collector_message_query = 1,
+  collector_message_snapshot,
+  collector_message_subscribe,
+};
+
+struct collector_message_header {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t type;
+  uint32_t length; // Payload size following this header
+};
+
+#define COLLECTOR_DEVICE_HAS_STATIC_INFO 0x1
+#define COLLECTOR_DEVICE_HAS_DYNAMIC_INFO 0x2
+#define COLLECTOR_DEVICE_HAS_PROCESSES 0x4
+
+// The process fields on the wire: the ones with a valid bit, and the process type
+#define COLLECTOR_PROCESS_FIELDS (gpuinfo_process_info_count + 1)
+
+// Daemon side copy of a process, with the sequence numbers at which each of its fields last changed
+struct collector_process_history {
+  struct gpu_process process; // Owns its strings
+  uint64_t added;
+  uint64_t changes[COLLECTOR_PROCESS_FIELDS];
+};
+
+// Daemon side copy of the data of a device, compared field by field at every refresh to know what changed
+struct collector_device_history {
+  struct gpuinfo_dynamic_info dynamic_info;
+  uint64_t dynamic_changes[gpuinfo_dynamic_info_count];
+  uint64_t dynamic_changed;   // Latest of dynamic_changes
+  uint64_t processes_changed; // Last change of the process list or of any of their fields
+  unsigned processes_count;
+  struct collector_process_history *processes;
+};
+
+// Client side copy of the data of a device
+struct collector_device {
+  char pdev[PDEV_LEN];
+  bool has_static_info;
+  struct gpuinfo_static_info static_info;
+  struct gpuinfo_dynamic_info dynamic_info;
+  unsigned processes_count;
+  struct gpu_process *processes; // The command lines and user names are owned by the device
+};
+
+struct collector_snapshot {
+  uint64_t sequence;
+  unsigned devices_count;
+  struct collector_device *devices;
+};
+
+struct collector_buffer {
+  size_t size;
+  size_t capacity;
+  char *data;
+};
+
+void collector_encode_header(enum collector_message_type type, uint32_t length, char header[COLLECTOR_HEADER_SIZE]);
+
+void collector_decode_header(const char data[COLLECTOR_HEADER_SIZE], struct collector_message_header *header);
+
+void collector_encode_request(enum collector_message_type type, uint64_t sequence, char request[COLLECTOR_REQUEST_SIZE]);
+
+// The sequence number of a request whose header has been checked
+uint64_t collector_request_sequence(const char request[COLLECTOR_REQUEST_SIZE]);
+
+// Records the sequence number of the fields of the device that differ from the history, then updates the history
+void collector_device_history_update(struct collector_device_history *history, const struct gpu_info *device,
+                                     uint64_t sequence);
+
+void collector_device_history_free(struct collector_device_history *history);
+
+/**
+ * @brief Serializes a snapshot payload for a client
+ *
+ * @param devices_count The number of devices
+ * @param devices The devices, for their PCI address and static info
+ * @param histories The history of each device, up to date with sequence
+ * @param sequence The sequence number of the current data
+ * @param client_sequence The last sequence number the client received, 0 to include everything
+ * @param buffer The payload is written to this buffer, grown as needed
+ */
+void collector_encode_snapshot(unsigned devices_count, struct gpu_info *const *devices,
+                               const struct collector_device_history *histories, uint64_t sequence,
+                               uint64_t client_sequence, struct collector_buffer *buffer);
+
+// Applies a snapshot payload on top of the previously received data. Returns false if the payload is malformed.
+bool collector_decode_snapshot(const char *payload, size_t length, struct collector_snapshot *snapshot);
+
+void collector_snapshot_free(struct collector_snapshot *snapshot);
+
+void collector_buffer_append(struct collector_buffer *buffer, const void *data, size_t size);
+
+void collector_buffer_free(struct collector_buffer *buffer);
+
+// The system socket for root, and for a client when a system daemon runs. Otherwise the socket of the user in
+// $XDG_RUNTIME_DIR when it is set.
+const char *collector_default_endpoint(bool daemon);
+
+// Runs the collector daemon until stop becomes non zero, also publishing into the shared memory segment shm_name if
+// not NULL. The endpoint is either a Unix socket path or [host]:port to listen on TCP.
+int collector_daemon_run(const char *endpoint, const char *shm_name, int update_interval,
+                         volatile sig_atomic_t *stop);
+
+// Makes the device extraction go through the daemons listening on the comma separated endpoints (Unix socket paths or
+// host[:port]) instead of the local vendors
+void collector_client_enable(const char *endpoints);
+
+#endif // NVTOP_COLLECTOR_H__
@@ -0,0 +1,76 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef NVTOP_DEVICE_TOPOLOGY_H__
+#define NVTOP_DEVICE_TOPOLOGY_H__
+
+#include "nvtop/extract_gpuinfo_common.h"
+
+// How two devices reach each other, from the closest to the farthest
+enum topology_link {
+  topology_link_self = 0,
+  topology_link_nvlink,       // Direct NVLink connection
+  topology_link_xgmi,         // Same AMD xGMI hive
+  topology_link_pcie_switch,  // Through at most one PCIe bridge on each side
+  topology_link_pcie_bridges, // Through multiple PCIe bridges without crossing the host bridge
+  topology_link_host_bridge,  // Through the PCIe host bridge
+  topology_link_numa_node,    // Through the interconnect between host bridges of the same NUMA node
+  topology_link_system,       // Through the interconnect between NUMA nodes
+  topology_link_unknown,
+  topology_link_count,
+};
+
+struct topology_pair {
+  enum topology_link link;
+  unsigned links_count; // Number of direct links for NVLink
+  double bandwidth;     // GB/s per direction, 0 when unknown
+};
+
+// Computed once on demand since the topology does not change while running
+struct device_topology {
+  unsigned devices_count;
+  struct topology_pair *pairs; // devices_count * devices_count
+  double *pcie_bandwidth;      // Current bandwidth of the PCIe path between each device and its root port
+};
+
+void device_topology_compute(struct list_head *devices, struct device_topology *topology);
+
+void device_topology_free(struct device_topology *topology);
+
+inline const struct topology_pair *device_topology_pair(const struct device_topology *topology, unsigned dev1,
+                                                        unsigned dev2) {
+  return &topology->pairs[dev1 * topology->devices_count + dev2];
+}
+
+/**
+ * @brief Classifies the PCIe path between two devices
+ *
+ * @param path1 The sysfs path of the first device, e.g. /sys/devices/pci0000:00/0000:00:01.0/0000:01:00.0
+ * @param node1 The NUMA node of the first device, -1 if unknown
+ * @param path2 The sysfs path of the second device
+ * @param node2 The NUMA node of the second device, -1 if unknown
+ */
+enum topology_link topology_pcie_link_between(const char *path1, int node1, const char *path2, int node2);
+
+// Usable bandwidth in GB/s of a PCIe link running at speed GT/s per lane
+double topology_pcie_bandwidth(double speed, unsigned width);
+
+#endif // NVTOP_DEVICE_TOPOLOGY_H__
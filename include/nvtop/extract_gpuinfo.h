@@ -30,6 +30,10 @@ bool gpuinfo_init_info_extraction(unsigned *total_dev_count, struct list_head *d
 
 bool gpuinfo_shutdown_info_extraction(struct list_head *devices);
 
+// Appends the devices that appeared since the initialization, such as the ones of a collector daemon that was not
+// reachable at startup, with their static info populated. Returns their number.
+unsigned gpuinfo_add_new_devices(struct list_head *devices);
+
 bool gpuinfo_populate_static_infos(struct list_head *devices);
 
 bool gpuinfo_refresh_dynamic_info(struct list_head *devices);
@@ -40,6 +44,33 @@ bool gpuinfo_refresh_processes(struct list_head *devices);
 
 bool gpuinfo_utilisation_rate(struct list_head *devices);
 
+// Accumulates the GPU time, peak memory, average usage, idle-held memory and energy of the processes over their
+// observed lifetime and follows the growth of their memory. The energy used by a device since the last call goes to
+// its processes by their share of engine usage.
+bool gpuinfo_account_processes(struct list_head *devices);
+
+// A process using no engine while holding more memory than this threshold accumulates idle time and idle-held
+// memory·time
+#define GPUINFO_DEFAULT_IDLE_MEMORY_THRESHOLD (1024ull * 1048576ull)
+
+// Tells whether the host holds the process back while it leaves its GPU mostly idle
+void gpuinfo_classify_process_starvation(const struct gpu_info *device, struct gpu_process *process);
+
+void gpuinfo_set_idle_memory_threshold(unsigned long long bytes);
+
+// Called with the last accumulated values of a process that stopped using a device, or that was still using it when
+// the cache is cleared
+typedef void (*gpuinfo_process_exit_callback)(const struct gpu_info *device, const struct gpu_process *process,
+                                              double observed_seconds, void *data);
+
+void gpuinfo_set_process_exit_callback(gpuinfo_process_exit_callback callback, void *data);
+
+// Comma separated environment variables holding the batch scheduler job id of a process, in order of preference.
+// The job id is otherwise taken from the Slurm or PBS cgroup of the process.
+#define GPUINFO_DEFAULT_JOB_ID_VARIABLES "SLURM_JOB_ID,PBS_JOBID"
+
+void gpuinfo_set_job_id_variables(const char *variables);
+
 void gpuinfo_clean(struct list_head *devices);
 
 void gpuinfo_clear_cache(void);
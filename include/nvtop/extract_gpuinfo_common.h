@@ -28,6 +28,8 @@
 #include <sys/types.h>
 
 #include "list.h"
+#include "nvtop/host_locality.h"
+#include "nvtop/process_cgroup.h"
 
 #define STRINGIFY(x) STRINGIFY_HELPER_(x)
 #define STRINGIFY_HELPER_(x) #x
@@ -60,6 +62,7 @@ enum gpuinfo_static_info_valid {
   gpuinfo_n_shared_cores_valid,
   gpuinfo_l2cache_size_valid,
   gpuinfo_n_exec_engines_valid,
+  gpuinfo_numa_node_valid,
   gpuinfo_static_info_count,
 };
 
@@ -76,6 +79,8 @@ struct gpuinfo_static_info {
   unsigned n_exec_engines;
   bool integrated_graphics;
   bool encode_decode_shared;
+  int numa_node;
+  struct host_mask local_cpus; // CPUs of the NUMA node of the device, valid along with numa_node
   unsigned char valid[(gpuinfo_static_info_count + CHAR_BIT - 1) / CHAR_BIT];
 };
 
@@ -104,9 +109,19 @@ enum gpuinfo_dynamic_info_valid {
   gpuinfo_power_draw_valid,
   gpuinfo_power_draw_max_valid,
   gpuinfo_multi_instance_mode_valid,
+  gpuinfo_energy_counter_valid,
+  gpuinfo_energy_consumed_valid,
+  gpuinfo_throttle_reasons_valid,
   gpuinfo_dynamic_info_count,
 };
 
+// Reasons for the device to run below its maximum clock, combined in gpuinfo_dynamic_info.throttle_reasons
+enum gpu_throttle_reason {
+  gpu_throttle_power = 1u << 0,    // Software power cap or power brake
+  gpu_throttle_thermal = 1u << 1,  // Software or hardware thermal slowdown
+  gpu_throttle_hardware = 1u << 2, // Other hardware slowdown
+};
+
 struct gpuinfo_dynamic_info {
   unsigned int gpu_clock_speed;     // Device clock speed in MHz
   unsigned int gpu_clock_speed_max; // Maximum clock speed in MHz
@@ -129,6 +144,9 @@ struct gpuinfo_dynamic_info {
   unsigned int power_draw;          // Power usage in milliwatts
   unsigned int power_draw_max;      // Max power usage in milliwatts
   bool multi_instance_mode;          // True if the GPU is in multi-instance mode
+  unsigned long long energy_counter;  // Cumulative energy counter in millijoules, its origin is driver defined
+  unsigned long long energy_consumed; // Energy used since nvtop started monitoring the device in millijoules
+  unsigned throttle_reasons;          // The gpu_throttle_reason currently slowing the device down
   unsigned char valid[(gpuinfo_dynamic_info_count + CHAR_BIT - 1) / CHAR_BIT];
 };
 
@@ -140,6 +158,15 @@ enum gpu_process_type {
   gpu_process_type_count,
 };
 
+// Host-side reason for a process to leave its GPU mostly idle
+enum gpu_process_starvation {
+  gpu_process_not_starved = 0,
+  gpu_process_starved_cpu,       // The process saturates its CPU time
+  gpu_process_starved_io,        // The process waits on block I/O
+  gpu_process_starved_preempted, // The process gets preempted by other tasks competing for the CPU
+  gpu_process_starvation_count,
+};
+
 #define SET_GPUINFO_PROCESS(structPtr, field, value) SET_VALUE(structPtr, field, value, gpuinfo_process_)
 #define RESET_GPUINFO_PROCESS(structPtr, field) INVALIDATE_VALUE(structPtr, field, gpuinfo_process_)
 #define GPUINFO_PROCESS_FIELD_VALID(structPtr, field) VALUE_IS_VALID(structPtr, field, gpuinfo_process_)
@@ -160,12 +187,31 @@ enum gpuinfo_process_info_valid {
   gpuinfo_process_cpu_memory_res_valid,
   gpuinfo_process_gpu_cycles_valid,
   gpuinfo_process_sample_delta_valid,
+  gpuinfo_process_parent_pid_valid,
+  gpuinfo_process_cpu_io_wait_valid,
+  gpuinfo_process_voluntary_ctx_switches_valid,
+  gpuinfo_process_involuntary_ctx_switches_valid,
+  gpuinfo_process_io_read_rate_valid,
+  gpuinfo_process_starvation_valid,
+  gpuinfo_process_locality_valid,
+  gpuinfo_process_energy_valid,
+  gpuinfo_process_gpu_time_valid,
+  gpuinfo_process_gpu_memory_peak_valid,
+  gpuinfo_process_gpu_usage_average_valid,
+  gpuinfo_process_idle_time_valid,
+  gpuinfo_process_idle_memory_time_valid,
+  gpuinfo_process_gpu_memory_growth_valid,
+  gpuinfo_process_time_to_oom_valid,
+  gpuinfo_process_namespace_pid_valid,
+  gpuinfo_process_cgroup_valid,
+  gpuinfo_process_job_id_valid,
   gpuinfo_process_info_count
 };
 
 struct gpu_process {
   enum gpu_process_type type;
   pid_t pid;                           // Process ID
+  pid_t parent_pid;                    // Parent process ID
   char *cmdline;                       // Process User Name
   char *user_name;                     // Process User Name
   uint64_t sample_delta;               // Time spent between two successive samples
@@ -183,11 +229,36 @@ struct gpu_process {
   unsigned cpu_usage;
   unsigned long cpu_memory_virt;
   unsigned long cpu_memory_res;
+  unsigned cpu_io_wait;                     // Percentage of time spent waiting for block I/O
+  unsigned long voluntary_ctx_switches;     // Per second
+  unsigned long involuntary_ctx_switches;   // Per second
+  unsigned long long io_read_rate;          // Bytes read per second
+  enum gpu_process_starvation starvation;
+  enum host_locality locality; // CPUs and memory the process is allowed to use with regards to the device NUMA node
+  unsigned long long energy;   // Estimated energy used on the device since the process was first seen, in millijoules
+  uint64_t gpu_time;           // Engine time in nanoseconds used since the process was first seen
+  unsigned long long gpu_memory_peak; // Highest memory usage seen
+  unsigned gpu_usage_average;         // Average GPU usage since the process was first seen
+  uint64_t idle_time;                 // Nanoseconds spent using no engine while holding more than the idle threshold
+  double idle_memory_time;            // Memory held during idle_time, in byte-seconds
+  double gpu_memory_growth;           // Trend of the memory usage in bytes per second, see memory_trend.h
+  double time_to_oom;                 // Seconds until the device memory runs out at this growth
+  pid_t namespace_pid;                // Pid seen from inside the container of the process
+  char cgroup[PROCESS_CGROUP_LABEL_LEN]; // Pod, container or systemd unit of the process, see process_cgroup_label
+  char job_id[PROCESS_JOB_ID_LEN];       // Batch scheduler (Slurm, PBS) job of the process
   unsigned char valid[(gpuinfo_process_info_count + CHAR_BIT - 1) / CHAR_BIT];
 };
 
 struct gpu_info;
 
+#define PDEV_LEN 16
+
+// A direct device-to-device link such as NVLink
+struct gpu_peer_link {
+  char peer_pdev[PDEV_LEN];
+  double bandwidth; // GB/s per direction
+};
+
 struct gpu_vendor {
   struct list_head list;
 
@@ -203,10 +274,24 @@ struct gpu_vendor {
   void (*refresh_utilisation_rate)(struct gpu_info *gpu_info);
 
   void (*refresh_running_processes)(struct gpu_info *gpu_info);
+
+  // Optional: fills up to max_links active device-to-device links and returns their number
+  unsigned (*get_peer_links)(struct gpu_info *gpu_info, unsigned max_links, struct gpu_peer_link *links);
+  // Optional: appends the devices that appeared since the initialization or the previous call, returns their number
+  unsigned (*get_new_device_handles)(struct list_head *devices);
   char *name;
 };
 
-#define PDEV_LEN 16
+// Integration of the device energy across the refreshes
+struct gpuinfo_energy_accounting {
+  uint64_t last_refresh_ns;        // Time of the previous refresh, 0 before the first one
+  unsigned long long last_counter; // Previous energy counter reading, when last_counter_valid
+  bool last_counter_valid;
+  bool measured;       // Either the energy counter or the power draw has been available
+  double consumed;     // Energy used since the first refresh in millijoules
+  double unattributed; // Energy of the refreshes not yet apportioned to the processes
+};
+
 struct gpu_info {
   struct list_head list;
   struct gpu_vendor *vendor;
@@ -216,9 +301,13 @@ struct gpu_info {
   struct gpu_process *processes;
   unsigned processes_array_size;
   char pdev[PDEV_LEN];
+  unsigned host_id; // Non zero for the devices of a remote host, whose processes are not on this machine
+  struct gpuinfo_energy_accounting energy_accounting;
 };
 
 void register_gpu_vendor(struct gpu_vendor *vendor);
+// Replaces all the registered vendors by this one
+void register_exclusive_gpu_vendor(struct gpu_vendor *vendor);
 
 bool extract_drm_fdinfo_key_value(char *buf, char **key, char **val);
 
@@ -0,0 +1,90 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef NVTOP_FLIGHT_RECORDER_H__
+#define NVTOP_FLIGHT_RECORDER_H__
+
+#include "list.h"
+
+#include <stdbool.h>
+
+/*
+ * The flight recorder keeps the device and process samples of the last seconds in memory. When a trigger fires, the
+ * samples from `before` seconds ahead of it to `after` seconds past it are written as JSON lines to a timestamped file
+ * of the recording directory: a header line describing the trigger followed by one line per sample.
+ *
+ * The triggers are a comma separated list of:
+ *   gpu<N, gpu>N     GPU utilization in percent
+ *   mem<N, mem>N     Memory used in percent of the device memory
+ *   temp<N, temp>N   Temperature in Celsius
+ *   power<N, power>N Power draw in watts
+ *   throttle         The device clocks get throttled for a new reason
+ *   exit             A process stops using a device
+ * A threshold fires when a device crosses it, not while it stays beyond.
+ */
+
+#define FLIGHT_RECORDER_DEFAULT_TRIGGERS "mem>95,throttle"
+#define FLIGHT_RECORDER_DEFAULT_BEFORE 30.
+#define FLIGHT_RECORDER_DEFAULT_AFTER 10.
+#define FLIGHT_RECORDER_MAX_TRIGGERS 16
+
+enum flight_trigger_kind {
+  flight_trigger_gpu_util,
+  flight_trigger_memory,
+  flight_trigger_temperature,
+  flight_trigger_power,
+  flight_trigger_throttle,
+  flight_trigger_process_exit,
+  flight_trigger_kind_count,
+};
+
+struct flight_trigger {
+  enum flight_trigger_kind kind;
+  bool below; // Fires when the metric falls under the threshold, otherwise when it rises over it
+  double threshold;
+};
+
+// Parses a trigger list, returns false if malformed
+bool flight_triggers_parse(const char *spec, unsigned *count,
+                           struct flight_trigger triggers[FLIGHT_RECORDER_MAX_TRIGGERS]);
+
+struct flight_recorder;
+
+/**
+ * @brief Starts recording the samples in memory, along with the background thread writing the snapshots
+ *
+ * @param directory Where the snapshots are written
+ * @param triggers The trigger list
+ * @param before Seconds of samples written ahead of a trigger
+ * @param after Seconds of samples written past a trigger
+ * @return The recorder, or NULL if the directory is not writable or the triggers are malformed
+ */
+struct flight_recorder *flight_recorder_open(const char *directory, const char *triggers, double before, double after);
+
+// Records the current data of the devices and checks the triggers. The windows follow time, in seconds of a monotonic
+// clock, wall_time in seconds since the epoch only names the snapshots and dates their samples.
+void flight_recorder_sample(struct flight_recorder *recorder, struct list_head *devices, double time,
+                            double wall_time);
+
+// Writes the snapshot still being recorded, waits for the pending writes and releases the recorder
+void flight_recorder_close(struct flight_recorder *recorder);
+
+#endif // NVTOP_FLIGHT_RECORDER_H__
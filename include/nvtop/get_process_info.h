@@ -26,13 +26,29 @@
 #include <stdlib.h>
 #include <sys/types.h>
 
+#include "nvtop/host_locality.h"
 #include "nvtop/time.h"
 
 struct process_cpu_usage {
-  double total_user_time;   // Seconds
-  double total_kernel_time; // Seconds
-  size_t virtual_memory;    // Bytes
-  size_t resident_memory;   // Bytes
+  pid_t parent_pid;
+  pid_t namespace_pid;            // Pid in the innermost pid namespace, e.g. inside a container
+  unsigned long long start_time;  // Since boot, in clock ticks. Tells a process from a later one reusing its pid.
+  double total_user_time;         // Seconds
+  double total_kernel_time;       // Seconds
+  double total_io_wait_time;      // Seconds spent waiting for block I/O
+  size_t virtual_memory;          // Bytes
+  size_t resident_memory;         // Bytes
+  unsigned long voluntary_ctx_switches;
+  unsigned long involuntary_ctx_switches;
+  unsigned long long read_bytes;  // Bytes fetched from the storage, page cache hits excluded
+  struct host_mask cpus_allowed;  // CPUs the process may run on
+  struct host_mask mems_allowed;  // NUMA nodes the process may allocate memory on
+  bool io_wait_valid;
+  bool ctx_switches_valid;
+  bool read_bytes_valid;
+  bool affinity_valid;
+  bool namespace_pid_valid;       // Only set for the processes of a nested pid namespace
+  bool start_time_valid;
   nvtop_time timestamp;
 };
 
@@ -40,6 +56,12 @@ void get_username_from_pid(pid_t pid, char **buffer);
 
 void get_command_from_pid(pid_t pid, char **buffer);
 
+// Copies the cgroup v2 path of the process (the systemd hierarchy on cgroup v1) into buffer, empty if not available
+void get_cgroup_from_pid(pid_t pid, char *buffer, size_t size);
+
+// Copies the value of the first of the environment variables names set for the process into buffer, empty otherwise
+void get_environ_value_from_pid(pid_t pid, const char *const *names, unsigned names_count, char *buffer, size_t size);
+
 bool get_process_info(pid_t pid, struct process_cpu_usage *usage);
 
 #endif // GET_PROCESS_INFO_H_
@@ -0,0 +1,66 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef NVTOP_HOST_LOCALITY_H__
+#define NVTOP_HOST_LOCALITY_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Matches the glibc CPU_SETSIZE
+#define HOST_MASK_MAX_IDS 1024
+
+// A set of CPU or NUMA node ids
+struct host_mask {
+  uint64_t bits[HOST_MASK_MAX_IDS / 64];
+};
+
+// Where the CPUs and memory a process may use sit relative to its device
+enum host_locality {
+  host_locality_local = 0, // Restricted to the NUMA node of the device
+  host_locality_any,       // Allowed on both the device node and other nodes
+  host_locality_remote,    // Cannot run or allocate memory on the device node
+  host_locality_count,
+};
+
+// Parse a kernel list format string such as "0-7,16-23" (see cpuset(7))
+bool host_mask_from_list(const char *list, struct host_mask *mask);
+
+bool host_mask_is_set(const struct host_mask *mask, unsigned id);
+
+bool host_mask_intersects(const struct host_mask *mask1, const struct host_mask *mask2);
+
+bool host_mask_is_subset(const struct host_mask *subset, const struct host_mask *mask);
+
+/**
+ * @brief Reads the NUMA node and the CPUs local to a PCI device from sysfs
+ *
+ * @param pdev The PCI address of the device (domain:bus:device.function)
+ * @param numa_node Set to the NUMA node of the device
+ * @param local_cpus Set to the CPUs of the NUMA node of the device
+ * @return True if the device is attached to a NUMA node, false otherwise
+ */
+bool host_locality_of_pci_device(const char *pdev, int *numa_node, struct host_mask *local_cpus);
+
+enum host_locality host_locality_classify(int device_node, const struct host_mask *device_cpus,
+                                          const struct host_mask *cpus_allowed, const struct host_mask *mems_allowed);
+
+#endif // NVTOP_HOST_LOCALITY_H__
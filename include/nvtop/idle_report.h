@@ -0,0 +1,49 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef NVTOP_IDLE_REPORT_H__
+#define NVTOP_IDLE_REPORT_H__
+
+#include "nvtop/extract_gpuinfo_common.h"
+
+#include <stdio.h>
+
+#define IDLE_REPORT_DEFAULT_COUNT 10
+
+struct idle_report;
+
+/**
+ * @brief Opens a ranking of the processes that held the most GPU memory while idle, measured in memory·time
+ *
+ * @param count How many processes are kept and printed
+ * @param threshold The idle memory threshold of the accounting, printed in the title
+ * @return The report
+ */
+struct idle_report *idle_report_open(unsigned count, unsigned long long threshold);
+
+// Ranks a process, matches gpuinfo_process_exit_callback with the report as data
+void idle_report_record(const struct gpu_info *device, const struct gpu_process *process, double observed_seconds,
+                        void *report);
+
+// Prints the ranking to the file and releases the report
+void idle_report_close(struct idle_report *report, FILE *file);
+
+#endif // NVTOP_IDLE_REPORT_H__
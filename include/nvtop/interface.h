@@ -37,14 +37,24 @@ void interface_check_monitored_gpu_change(struct nvtop_interface **interface, un
                                           unsigned *num_monitored_gpus, struct list_head *monitoredGpus,
                                           struct list_head *nonMonitoredGpus);
 
+// Makes room for the devices appended to newGpus, which are monitored and join the device lists
+void interface_add_devices(struct nvtop_interface **interface, unsigned *allDevCount, struct list_head *newGpus,
+                           unsigned *num_monitored_gpus, struct list_head *monitoredGpus,
+                           struct list_head *nonMonitoredGpus);
+
 unsigned interface_largest_gpu_name(struct list_head *devices);
 
 void draw_gpu_info_ncurses(unsigned monitored_dev_count, struct list_head *devices, struct nvtop_interface *interface);
 
 void save_current_data_to_ring(struct list_head *devices, struct nvtop_interface *interface);
 
+void interface_track_imbalance(struct list_head *devices, struct nvtop_interface *interface);
+
 void update_window_size_to_terminal_size(struct nvtop_interface *inter);
 
+// Resize and move the existing windows after a terminal size change, recreating them only if the layout changed
+void interface_resize_to_terminal_size(struct nvtop_interface *inter);
+
 void interface_key(int keyId, struct nvtop_interface *inter);
 
 bool is_escape_for_quit(struct nvtop_interface *inter);
@@ -32,6 +32,13 @@ enum plot_information {
   plot_fan_speed,
   plot_gpu_clock_rate,
   plot_gpu_mem_clock_rate,
+  // Absolute units, the plots holding them are scaled to their largest value
+  plot_pcie_rx,
+  plot_pcie_tx,
+  plot_gpu_power_draw,
+  plot_gpu_clock,
+  plot_gpu_mem_clock,
+  plot_gpu_mem_used,
   plot_information_count
 };
 
@@ -48,10 +55,31 @@ enum process_field {
   process_memory,
   process_cpu_usage,
   process_cpu_mem_usage,
+  process_io_read,
+  process_starvation,
+  process_numa,
+  process_energy,
+  process_gpu_time,
+  process_memory_peak,
+  process_gpu_average,
+  process_idle_held,
+  process_memory_growth,
+  process_time_to_oom,
+  process_namespace_pid,
+  process_job_id,
   process_command,
   process_field_count,
 };
 
 typedef int process_field_displayed;
 
+// Aggregation of the process list into one row per owner
+enum process_rollup {
+  process_rollup_none = 0,
+  process_rollup_user,
+  process_rollup_cgroup,
+  process_rollup_job,
+  process_rollup_count,
+};
+
 #endif // INTERFACE_COMMON_H__
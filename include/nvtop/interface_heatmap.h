@@ -0,0 +1,56 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef INTERFACE_HEATMAP_H__
+#define INTERFACE_HEATMAP_H__
+
+#include <limits.h>
+#include <stdbool.h>
+
+// Value of a cell for which no sample was recorded yet
+#define HEATMAP_NO_DATA UCHAR_MAX
+
+// One row per device and one column per sample. The cells of the previous draw are kept so that a new sample only
+// shifts the rows by one column and fills the newest one from the history.
+struct heatmap {
+  unsigned rows;
+  unsigned cols;
+  bool newest_first;           // The newest sample is in the first column, otherwise in the last one
+  bool filled;                 // False until every cell has been filled once
+  unsigned long samples_drawn; // Value of the sample counter when the cells were last updated
+  unsigned char *cells;        // Values between 0 and 100, or HEATMAP_NO_DATA
+};
+
+void heatmap_alloc(unsigned rows, unsigned cols, bool newest_first, struct heatmap *heatmap);
+
+void heatmap_free(struct heatmap *heatmap);
+
+// Slide the rows by the number of samples recorded since the last update. Return how many of the newest columns
+// must be filled again, all of them on the first update or when the shift spans the whole heatmap.
+unsigned heatmap_advance(struct heatmap *heatmap, unsigned long samples_recorded);
+
+// Cell of the sample recorded age updates ago on a row
+inline unsigned char *heatmap_cell(const struct heatmap *heatmap, unsigned row, unsigned age) {
+  unsigned col = heatmap->newest_first ? age : heatmap->cols - 1 - age;
+  return &heatmap->cells[row * heatmap->cols + col];
+}
+
+#endif // INTERFACE_HEATMAP_H__
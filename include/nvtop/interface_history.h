@@ -0,0 +1,64 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef INTERFACE_HISTORY_H__
+#define INTERFACE_HISTORY_H__
+
+// Time of every sample pushed to the chart history, in seconds of the monotonic clock. The series of the ring buffer
+// are pushed along with it, their newest value is the one of the newest time.
+struct sample_clock {
+  unsigned capacity;
+  unsigned start;
+  unsigned count;
+  double *times;
+};
+
+void sample_clock_alloc(unsigned capacity, struct sample_clock *clock);
+
+void sample_clock_free(struct sample_clock *clock);
+
+void sample_clock_push(struct sample_clock *clock, double time);
+
+// Copy the times from the oldest to the newest, times holds clock->count values
+void sample_clock_copy(const struct sample_clock *clock, double *times);
+
+// Index of the first of the sorted times that is not before time, count if there is none
+unsigned history_lower_bound(unsigned count, const double times[], double time);
+
+// A frozen series of samples, oldest first, with the maxima of its ranges answered in logarithmic time
+struct history_series {
+  unsigned size;
+  unsigned *tree; // Segment tree, the samples are its leaves from tree[size]
+};
+
+void history_series_alloc(unsigned size, struct history_series *series);
+
+void history_series_free(struct history_series *series);
+
+// The samples to fill in before history_series_build
+inline unsigned *history_series_samples(struct history_series *series) { return series->tree + series->size; }
+
+void history_series_build(struct history_series *series);
+
+// Maximum of the samples in [begin, end), which must not be empty
+unsigned history_series_max(const struct history_series *series, unsigned begin, unsigned end);
+
+#endif // INTERFACE_HISTORY_H__
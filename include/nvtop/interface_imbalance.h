@@ -0,0 +1,74 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef INTERFACE_IMBALANCE_H__
+#define INTERFACE_IMBALANCE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Number of refreshes considered when deciding if a device lags behind
+#define IMBALANCE_WINDOW_SIZE 16
+// A device lags when its usage is this many percentage points below the mean usage of its job
+#define IMBALANCE_LAG_THRESHOLD 10
+
+// One process running on one device. The processes sharing the same job_id across multiple devices are compared
+// against each other.
+struct imbalance_sample {
+  int64_t job_id;
+  unsigned device;
+  bool gpu_usage_valid;
+  unsigned gpu_usage;
+  unsigned long long gpu_memory;
+};
+
+struct device_imbalance_window {
+  uint32_t sampled; // Bit i is set if the device ran a multi-device job i refreshes ago
+  uint32_t lagging; // Bit i is set if the device lagged behind its job i refreshes ago
+  unsigned char usage_gap[IMBALANCE_WINDOW_SIZE];        // Percentage points behind the job mean usage
+  unsigned char memory_imbalance[IMBALANCE_WINDOW_SIZE]; // Job memory spread (max - min) / max in percent
+};
+
+struct imbalance_tracker {
+  unsigned devices_count;
+  unsigned next_slot;
+  struct device_imbalance_window *devices;
+};
+
+void imbalance_tracker_alloc(unsigned devices_count, struct imbalance_tracker *tracker);
+
+void imbalance_tracker_free(struct imbalance_tracker *tracker);
+
+// Record one refresh worth of samples and slide the window by one
+void imbalance_tracker_push(struct imbalance_tracker *tracker, unsigned samples_count,
+                            const struct imbalance_sample *samples);
+
+// True if the device took part in a multi-device job for at least half the window and lagged behind its job for at
+// least three quarters of these refreshes
+bool imbalance_device_is_straggler(const struct imbalance_tracker *tracker, unsigned device);
+
+// Mean number of percentage points the device is behind its job over the window
+unsigned imbalance_device_usage_gap(const struct imbalance_tracker *tracker, unsigned device);
+
+// Mean memory spread of the job running on the device over the window
+unsigned imbalance_device_memory_imbalance(const struct imbalance_tracker *tracker, unsigned device);
+
+#endif // INTERFACE_IMBALANCE_H__
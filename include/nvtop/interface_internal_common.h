@@ -23,7 +23,13 @@
 #define INTERFACE_INTERNAL_COMMON_H__
 
 #include "nvtop/common.h"
+#include "nvtop/device_topology.h"
+#include "nvtop/interface_heatmap.h"
+#include "nvtop/interface_history.h"
+#include "nvtop/interface_imbalance.h"
+#include "nvtop/interface_layout_selection.h"
 #include "nvtop/interface_options.h"
+#include "nvtop/interface_process_groups.h"
 #include "nvtop/interface_ring_buffer.h"
 #include "nvtop/time.h"
 
@@ -73,6 +79,7 @@ struct device_window {
   bool dec_was_visible;
   nvtop_time last_decode_seen;
   nvtop_time last_encode_seen;
+  unsigned grid_posX, grid_posY; // Cell of the device when the devices are drawn as a grid
 };
 
 static const unsigned int option_window_size = 13;
@@ -91,6 +98,15 @@ struct process_window {
   WINDOW *process_with_option_win;
   unsigned selected_row;
   pid_t selected_pid;
+  unsigned selected_host_id; // Non zero when the selected process runs on a remote host
+  bool selected_is_group; // The selected row belongs to a process running on multiple devices or to a rollup
+  int64_t selected_group_key; // Key of the group of the selected row, toggled by Enter
+  int64_t *expanded_groups; // Host and pid of the processes whose per-device rows are shown below the merged row
+  unsigned expanded_groups_count;
+  unsigned expanded_groups_size;
+  struct process_groups groups; // Updated once per refresh
+  unsigned long groups_refresh; // saved_data_count at the last update of the groups
+  bool groups_filter_nvtop_pid; // The nvtop process was left out of the rows at the last update
   struct option_window option_window;
 };
 
@@ -101,6 +117,16 @@ struct plot_window {
   WINDOW *plot_window;
   unsigned num_devices_to_plot;
   unsigned devices_ids[MAX_LINES_PER_PLOT];
+  struct history_series history[MAX_LINES_PER_PLOT]; // Frozen lines while navigating the history
+};
+
+// Replaces the line charts when plot_heatmap is set
+struct heatmap_window {
+  WINDOW *win;
+  WINDOW *plot_window;
+  unsigned num_devices_to_plot;
+  unsigned *devices_ids;
+  struct heatmap cells;
 };
 
 enum setup_window_section {
@@ -123,18 +149,46 @@ struct setup_window {
   unsigned options_selected[2];
 };
 
+struct topology_window {
+  bool visible;
+  bool computed;
+  WINDOW *win;
+  struct device_topology topology;
+};
+
 // Keep gpu information every 1 second for 10 minutes
+// Browsing the chart history: the plots are frozen on the samples recorded when it started while the collection
+// goes on. The plot columns span a fixed time, the samples of a column are found by a binary search on their times.
+struct history_navigation {
+  bool active;
+  unsigned samples;         // Number of times
+  double *times;            // Time of each sample, oldest first
+  double wall_clock_offset; // From the monotonic clock to the epoch
+  double newest_edge;       // Time at the newest edge of the plots
+  double column_seconds;    // Time spanned by a plot column
+  unsigned cursor;          // Columns between the cursor and the newest edge
+};
+
 struct nvtop_interface {
   nvtop_interface_option options;
   unsigned total_dev_count;
   unsigned monitored_dev_count;
+  enum device_header_layout header_layout;
   struct device_window *devices_win;
+  WINDOW *device_grid;        // Every cell of the grid layouts, devices_win is then unused
+  WINDOW *device_grid_legend;
   struct process_window process;
   WINDOW *shortcut_window;
   unsigned num_plots;
   struct plot_window *plots;
+  struct heatmap_window heatmap;
   interface_ring_buffer saved_data_ring;
+  unsigned long saved_data_count; // Number of samples pushed to the ring buffer
+  struct sample_clock saved_data_times;
+  struct history_navigation navigation;
+  struct imbalance_tracker imbalance;
   struct setup_window setup_win;
+  struct topology_window topology;
 };
 
 enum device_field {
@@ -13,12 +13,32 @@ struct window_position {
 // Should be fine
 #define MAX_CHARTS 64
 
+// From this many devices, the headers are replaced by a grid of one line cells
+#define DEVICE_GRID_MIN_DEVICES 16
+
+enum device_header_layout {
+  device_header_full,        // One header of device_header_rows x device_header_cols per device
+  device_header_grid_wide,   // One cell per device with its GPU usage, memory usage and temperature
+  device_header_grid_narrow, // One cell per device with the tens digit of these values
+};
+
+// Columns of a grid cell, without the space separating it from the next one
+unsigned device_grid_cell_cols(unsigned monitored_dev_count, enum device_header_layout layout);
+
+// The layouts of the last LAYOUT_CACHE_SIZE distinct inputs are kept, the least recently used one is dropped first
+#define LAYOUT_CACHE_SIZE 64
+
+// The grid layouts also set grid_legend_position to the line explaining the cells, below the grid
 void compute_sizes_from_layout(unsigned monitored_dev_count, unsigned device_header_rows, unsigned device_header_cols,
                                unsigned rows, unsigned cols, const nvtop_interface_gpu_opts *gpu_opts,
                                process_field_displayed process_field_displayed,
-                               struct window_position *device_positions, unsigned *num_plots,
+                               enum device_header_layout *header_layout, struct window_position *device_positions,
+                               struct window_position *grid_legend_position, unsigned *num_plots,
                                struct window_position plot_positions[MAX_CHARTS], unsigned *map_device_to_plot,
                                struct window_position *process_position, struct window_position *setup_position,
                                bool process_win_hide);
 
+// Drop every cached layout
+void layout_cache_clear(void);
+
 #endif // INTERFACE_LAYOUT_SELECTION_H__
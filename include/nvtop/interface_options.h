@@ -22,6 +22,7 @@
 #ifndef INTERFACE_OPTIONS_H__
 #define INTERFACE_OPTIONS_H__
 
+#include "nvtop/alert_rules.h"
 #include "nvtop/common.h"
 #include "nvtop/extract_gpuinfo_common.h"
 #include "nvtop/interface_common.h"
@@ -32,11 +33,13 @@ typedef struct {
   plot_info_to_draw to_draw;  // The set of metrics to draw for this gpu
   bool doNotMonitor;          // True if this GPU should not be monitored
   struct gpu_info *linkedGpu; // The gpu to which this option apply
+  unsigned history_slot;      // Row of the chart history of this gpu, moves along when the monitored set changes
 } nvtop_interface_gpu_opts;
 
 typedef struct nvtop_interface_option_struct {
   bool
       plot_left_to_right; // true to reverse the plot refresh direction defines inactivity (0 use rate) before hiding it
+  bool plot_heatmap;                                // Draw one heatmap row per device instead of the line charts
   bool temperature_in_fahrenheit;                   // Switch from celsius to fahrenheit temperature scale
   bool use_color;                                   // Name self explanatory
   double encode_decode_hiding_timer;                // Negative to always display, positive
@@ -52,6 +55,10 @@ typedef struct nvtop_interface_option_struct {
   bool has_monitored_set_changed;                   // True if the set of monitored gpu was modified through the interface
   bool has_gpu_info_bar;                            // Show info bar with additional GPU parametres
   bool hide_processes_list;                         // Hide processes list
+  bool group_multi_device_processes;                // Merge the rows of a process running on multiple devices
+  enum process_rollup process_rollup;               // Aggregate the process list per user, cgroup or job
+  unsigned alert_rules_count;                       // Alert rules of the config file
+  struct alert_rule *alert_rules;
 } nvtop_interface_option;
 
 inline bool plot_isset_draw_info(enum plot_information check_info, plot_info_to_draw to_draw) {
@@ -110,6 +117,18 @@ inline process_field_displayed process_default_displayed_field(void) {
   }
   to_display = process_remove_field_to_display(process_enc_rate, to_display);
   to_display = process_remove_field_to_display(process_dec_rate, to_display);
+  to_display = process_remove_field_to_display(process_io_read, to_display);
+  to_display = process_remove_field_to_display(process_starvation, to_display);
+  to_display = process_remove_field_to_display(process_numa, to_display);
+  to_display = process_remove_field_to_display(process_energy, to_display);
+  to_display = process_remove_field_to_display(process_gpu_time, to_display);
+  to_display = process_remove_field_to_display(process_memory_peak, to_display);
+  to_display = process_remove_field_to_display(process_gpu_average, to_display);
+  to_display = process_remove_field_to_display(process_idle_held, to_display);
+  to_display = process_remove_field_to_display(process_memory_growth, to_display);
+  to_display = process_remove_field_to_display(process_time_to_oom, to_display);
+  to_display = process_remove_field_to_display(process_namespace_pid, to_display);
+  to_display = process_remove_field_to_display(process_job_id, to_display);
   return to_display;
 }
 
@@ -0,0 +1,109 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef INTERFACE_PROCESS_GROUPS_H__
+#define INTERFACE_PROCESS_GROUPS_H__
+
+#include "nvtop/extract_gpuinfo_common.h"
+#include "nvtop/interface_common.h"
+#include "nvtop/process_cgroup.h"
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <uthash.h>
+
+// Rows of a process using several devices can be merged into a single row.
+// The groups are built with a single hash pass over the all_processes_array output, which is ordered by device.
+// The same pass rolls the process list up per user, cgroup or batch job, every process of a user, a cgroup (pod,
+// container, systemd unit) or a job being merged into a single row.
+// The groups are updated once per refresh and kept in their hash tables from one refresh to the next.
+
+#define PROCESS_GROUP_DEVICES_LEN 24
+#define PROCESS_GROUP_SUMMARY_LEN (PROCESS_CGROUP_LABEL_LEN + 32) // Also fits "Job " and a PROCESS_JOB_ID_LEN id
+#define PROCESS_GROUP_NO_MEMBER UINT_MAX
+
+struct process_group;
+
+struct gpuid_and_process {
+  unsigned gpu_id;
+  unsigned host_id;
+  struct gpu_process *process;
+  const struct process_group *group; // Set when the row merges the same process running on multiple devices
+  bool group_member;                 // The row is displayed below its expanded group
+};
+
+typedef struct {
+  unsigned processes_count;
+  struct gpuid_and_process *processes;
+} all_processes;
+
+struct process_group {
+  int64_t key; // Identical pids of different hosts are different processes
+  struct gpu_process merged; // Aggregated values shown on the group row
+  enum process_rollup rollup; // Every process of a user, cgroup or job instead of the devices of one process
+  bool mixed_users;           // The processes of a rollup belong to different users
+  unsigned members_count;
+  unsigned processes_count; // Distinct processes of a rollup
+  unsigned first_member, last_member; // Indexes of the member rows, chained through next_member
+  bool straggler_member;              // One of the devices lags behind the others
+  unsigned gpu_usage_count, gpu_usage_sum, gpu_usage_min, gpu_usage_max;
+  unsigned encode_usage_count, encode_usage_sum;
+  unsigned decode_usage_count, decode_usage_sum;
+  unsigned gpu_usage_average_count, gpu_usage_average_sum;
+  char devices[PROCESS_GROUP_DEVICES_LEN]; // Device indexes, e.g. "0-3,6"
+  char summary[PROCESS_GROUP_SUMMARY_LEN]; // Shown in place of the command of a rollup
+  unsigned generation;                     // Update in which the group last had members
+  UT_hash_handle hh;                       // Last, the fields before it are reset at every update
+};
+
+// A process of a rollup, whose host values are summed once whatever the number of its devices
+struct process_rollup_member {
+  int64_t key;
+  unsigned generation;
+  bool cpu_usage_counted, cpu_memory_res_counted, cpu_memory_virt_counted;
+  UT_hash_handle hh;
+};
+
+struct process_groups {
+  unsigned groups_count;
+  struct process_group **groups; // The groups having members, in the order of their first member
+  struct process_group *groups_by_pid;
+  struct process_rollup_member *rollup_members;
+  unsigned *next_member;
+  unsigned capacity; // Size of groups and next_member
+  enum process_rollup rollup;
+  unsigned generation; // Number of updates, 0 before the first one
+};
+
+int64_t process_group_key(unsigned host_id, pid_t pid);
+
+int64_t process_group_name_key(unsigned host_id, const char *name);
+
+// Key of the group of a row for the given rollup, the host and pid of the process without rollup
+int64_t process_group_key_of(const struct gpuid_and_process *row, enum process_rollup rollup);
+
+// Regroups the rows of a refresh. The groups still having members are reused, the others are released.
+void process_groups_update(struct process_groups *groups, all_processes all_procs, enum process_rollup rollup);
+
+void process_groups_free(struct process_groups *groups);
+
+#endif // INTERFACE_PROCESS_GROUPS_H__
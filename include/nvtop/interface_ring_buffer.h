@@ -43,6 +43,9 @@ typedef struct interface_ring_buffer_st {
 void interface_alloc_ring_buffer(unsigned monitored_dev_count, unsigned per_device_data, unsigned buffer_size,
                                  interface_ring_buffer *ring_buffer);
 
+// Grows the buffer to devices_count devices, the new ones being empty
+void interface_ring_buffer_add_devices(interface_ring_buffer *ring_buffer, unsigned devices_count);
+
 void interface_free_ring_buffer(interface_ring_buffer *buffer);
 
 inline unsigned interface_ring_buffer_data_stored(const interface_ring_buffer *buff, unsigned device,
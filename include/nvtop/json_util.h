@@ -0,0 +1,32 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef NVTOP_JSON_UTIL_H__
+#define NVTOP_JSON_UTIL_H__
+
+#include <stddef.h>
+#include <stdio.h>
+
+// Writes string as a JSON string, its first max_length bytes only unless max_length is 0. The quote, the backslash and
+// the control characters are escaped.
+void json_write_string(FILE *file, const char *string, size_t max_length);
+
+#endif // NVTOP_JSON_UTIL_H__
@@ -0,0 +1,60 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef NVTOP_MEMORY_TREND_H__
+#define NVTOP_MEMORY_TREND_H__
+
+#include <stdbool.h>
+
+// The growth of the memory of a process is the least squares slope of its samples over the last MEMORY_TREND_WINDOW
+// seconds. The samples are kept at least MEMORY_TREND_WINDOW / MEMORY_TREND_SAMPLES seconds apart so that the cost
+// does not depend on the refresh rate.
+#define MEMORY_TREND_SAMPLES 30
+#define MEMORY_TREND_WINDOW 300.
+#define MEMORY_TREND_MIN_SPAN 30.
+// A growth projected to exhaust the memory must cover most of the window and follow the fitted line closely, with
+// few decreasing steps: one large allocation is not a leak
+#define MEMORY_TREND_SUSTAINED_SPAN (0.8 * MEMORY_TREND_WINDOW)
+#define MEMORY_TREND_SUSTAINED_R2 0.9
+#define MEMORY_TREND_SUSTAINED_RISING 0.75
+// Processes projected to exhaust the device memory sooner are highlighted
+#define MEMORY_TREND_OOM_WARNING 3600.
+
+struct memory_trend {
+  unsigned count; // Samples kept, the oldest at index next when the ring is full
+  unsigned next;
+  double times[MEMORY_TREND_SAMPLES]; // seconds
+  double bytes[MEMORY_TREND_SAMPLES];
+};
+
+// Keeps the sample unless the previous one is too recent, returns true if it was kept
+bool memory_trend_push(struct memory_trend *trend, double time, double bytes);
+
+// The growth in bytes per second, false until the samples span MEMORY_TREND_MIN_SPAN seconds
+bool memory_trend_slope(const struct memory_trend *trend, double *slope);
+
+// True if the samples show a sustained growth, see MEMORY_TREND_SUSTAINED_SPAN
+bool memory_trend_sustained(const struct memory_trend *trend);
+
+// Seconds until free_bytes are used up at the growth rate, false if the memory does not grow
+bool memory_trend_time_to_exhaust(double slope, double free_bytes, double *seconds);
+
+#endif // NVTOP_MEMORY_TREND_H__
@@ -0,0 +1,59 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef PLOT_SCALE_H__
+#define PLOT_SCALE_H__
+
+#include "nvtop/interface_common.h"
+
+// Labels of the y axis, from the top to the bottom of the plot
+#define PLOT_Y_LABELS 5
+#define PLOT_Y_LABEL_SIZE 4
+
+// Unit of the values saved in the ring buffer for each plot_information
+enum plot_unit {
+  plot_unit_percent,
+  plot_unit_kib_per_second,
+  plot_unit_milliwatt,
+  plot_unit_megahertz,
+  plot_unit_mebibyte,
+  plot_unit_count,
+};
+
+struct plot_scale {
+  double full_scale;     // Value at the top of the plot, in the unit of the ring buffer
+  double display_factor; // From the unit of the ring buffer to the displayed unit
+  const char *unit_name; // Displayed unit
+};
+
+enum plot_unit plot_information_unit(enum plot_information info);
+
+// Round max_value up to 1, 2, 2.5 or 5 times a power of ten, in the largest unit prefix that keeps it under 1000.
+// The percentages always span 0 to 100.
+void plot_autoscale(enum plot_unit unit, double max_value, struct plot_scale *scale);
+
+// Format a displayed value in at most three characters
+void plot_axis_label(double value, char label[PLOT_Y_LABEL_SIZE]);
+
+// The y axis labels of a scale, from full_scale down to 0
+void plot_y_labels(const struct plot_scale *scale, char labels[PLOT_Y_LABELS][PLOT_Y_LABEL_SIZE]);
+
+#endif // PLOT_SCALE_H__
@@ -0,0 +1,60 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef NVTOP_PROCESS_CGROUP_H__
+#define NVTOP_PROCESS_CGROUP_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Large enough for "pod:" followed by a Kubernetes pod UID or for a systemd unit name
+#define PROCESS_CGROUP_LABEL_LEN 64
+
+/**
+ * @brief Derives what owns a process from its cgroup path (e.g. /kubepods.slice/.../cri-containerd-<id>.scope).
+ *
+ * The label is "pod:<uid>" for a Kubernetes pod, "<runtime>:<short id>" for a container of docker, podman, containerd
+ * or CRI-O, the name of the innermost systemd unit (service or scope) otherwise, and the last path component as a
+ * fallback.
+ *
+ * @param path The cgroup path, as found in /proc/<pid>/cgroup
+ * @param label Set to the label
+ * @param size The size of the label buffer
+ */
+void process_cgroup_label(const char *path, char *label, size_t size);
+
+// Large enough for a Slurm array job ("<job>_<task>") or a PBS job id with its server name
+#define PROCESS_JOB_ID_LEN 48
+
+/**
+ * @brief Extracts the batch scheduler job of a process from its cgroup path.
+ *
+ * Slurm places the job steps under .../job_<id>/step_<step>/ (/slurm/uid_<uid>/job_<id> on cgroup v1) and PBS under
+ * /pbs_jobs.service/jobid/<id> (/pbspro/<id> or /torque/<id> on cgroup v1).
+ *
+ * @param path The cgroup path, as found in /proc/<pid>/cgroup
+ * @param job_id Set to the job id when found
+ * @param size The size of the job_id buffer
+ * @return True if the path belongs to a job
+ */
+bool process_cgroup_job_id(const char *path, char *job_id, size_t size);
+
+#endif // NVTOP_PROCESS_CGROUP_H__
@@ -0,0 +1,46 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef NVTOP_PROCESS_SUMMARY_H__
+#define NVTOP_PROCESS_SUMMARY_H__
+
+#include "nvtop/extract_gpuinfo_common.h"
+
+struct process_summary;
+
+/**
+ * @brief Opens a summary table of the processes, with one row per process and device giving its accumulated GPU
+ * time, average usage, peak memory and energy.
+ *
+ * @param path The rows are written to this file as the processes exit. When NULL, the table is printed on the standard
+ * output when closing the summary.
+ * @return The summary, or NULL if the file cannot be created
+ */
+struct process_summary *process_summary_open(const char *path);
+
+// Adds the row of a process, matches gpuinfo_process_exit_callback with the summary as data
+void process_summary_record(const struct gpu_info *device, const struct gpu_process *process, double observed_seconds,
+                            void *summary);
+
+// Prints the table if it goes to the standard output and releases the summary
+void process_summary_close(struct process_summary *summary);
+
+#endif // NVTOP_PROCESS_SUMMARY_H__
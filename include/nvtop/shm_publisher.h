@@ -0,0 +1,38 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef NVTOP_SHM_PUBLISHER_H__
+#define NVTOP_SHM_PUBLISHER_H__
+
+#include "list.h"
+
+struct shm_publisher;
+
+// Creates the shared memory segment name, see nvtop/shm_snapshot.h for its layout. Returns NULL on error.
+struct shm_publisher *shm_publisher_create(const char *name);
+
+// Writes the current data of the devices into the segment
+void shm_publisher_publish(struct shm_publisher *publisher, struct list_head *devices);
+
+// Unmaps and removes the segment
+void shm_publisher_destroy(struct shm_publisher *publisher);
+
+#endif // NVTOP_SHM_PUBLISHER_H__
@@ -0,0 +1,205 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef NVTOP_SHM_SNAPSHOT_H__
+#define NVTOP_SHM_SNAPSHOT_H__
+
+/*
+ * Layout of the snapshot published by nvtop --shm into a POSIX shared memory segment, and helpers to read it.
+ *
+ * This header is self-contained so that external consumers can include it without the rest of nvtop. All the fields
+ * have a fixed size and offset, in host byte order. The layout version is bumped whenever a field moves.
+ *
+ * The publisher updates the segment under a seqlock: the sequence is odd while the data is being written and even
+ * once it is consistent. A reader takes the sequence with nvtop_shm_read_begin, reads the data in place and checks
+ * with nvtop_shm_read_retry that the sequence did not move in the meantime; otherwise it starts over. The waits are
+ * bounded: a publisher killed in the middle of an update leaves the sequence odd for good.
+ */
+
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define NVTOP_SHM_DEFAULT_NAME "/nvtop-snapshot"
+#define NVTOP_SHM_MAGIC UINT32_C(0x4e56534d)
+#define NVTOP_SHM_LAYOUT_VERSION 1
+#define NVTOP_SHM_MAX_DEVICES 64
+#define NVTOP_SHM_MAX_PROCESSES 4096
+// An update takes microseconds, a reader gives up after this many spins or attempts
+#define NVTOP_SHM_READ_SPINS (1u << 24)
+#define NVTOP_SHM_READ_ATTEMPTS 64u
+
+// Bits of nvtop_shm_device.valid
+enum nvtop_shm_device_field {
+  nvtop_shm_device_name = 1u << 0,
+  nvtop_shm_device_gpu_clock = 1u << 1,
+  nvtop_shm_device_mem_clock = 1u << 2,
+  nvtop_shm_device_gpu_util = 1u << 3,
+  nvtop_shm_device_mem_util = 1u << 4,
+  nvtop_shm_device_encoder_util = 1u << 5,
+  nvtop_shm_device_decoder_util = 1u << 6,
+  nvtop_shm_device_temperature = 1u << 7,
+  nvtop_shm_device_fan_speed = 1u << 8,
+  nvtop_shm_device_power_draw = 1u << 9,
+  nvtop_shm_device_power_draw_max = 1u << 10,
+  nvtop_shm_device_pcie_rx = 1u << 11,
+  nvtop_shm_device_pcie_tx = 1u << 12,
+  nvtop_shm_device_total_memory = 1u << 13,
+  nvtop_shm_device_used_memory = 1u << 14,
+  nvtop_shm_device_free_memory = 1u << 15,
+};
+
+struct nvtop_shm_device {
+  char pdev[16]; // PCI address
+  char name[64];
+  uint32_t valid;            // nvtop_shm_device_field bits
+  uint32_t processes_offset; // Index of the first process of this device in nvtop_shm_segment.processes
+  uint32_t processes_count;
+  uint32_t gpu_clock;      // MHz
+  uint32_t mem_clock;      // MHz
+  uint32_t gpu_util;       // %
+  uint32_t mem_util;       // %
+  uint32_t encoder_util;   // %
+  uint32_t decoder_util;   // %
+  uint32_t temperature;    // °C
+  uint32_t fan_speed;      // %
+  uint32_t power_draw;     // mW
+  uint32_t power_draw_max; // mW
+  uint32_t pcie_rx;        // KB/s
+  uint32_t pcie_tx;        // KB/s
+  uint32_t reserved;
+  uint64_t total_memory; // Bytes
+  uint64_t used_memory;  // Bytes
+  uint64_t free_memory;  // Bytes
+};
+
+// Bits of nvtop_shm_process.valid
+enum nvtop_shm_process_field {
+  nvtop_shm_process_gpu_util = 1u << 0,
+  nvtop_shm_process_encoder_util = 1u << 1,
+  nvtop_shm_process_decoder_util = 1u << 2,
+  nvtop_shm_process_gpu_memory = 1u << 3,
+  nvtop_shm_process_gpu_memory_percentage = 1u << 4,
+  nvtop_shm_process_cpu_util = 1u << 5,
+  nvtop_shm_process_cpu_memory = 1u << 6,
+};
+
+// Bits of nvtop_shm_process.type
+enum nvtop_shm_process_type {
+  nvtop_shm_process_graphical = 1u << 0,
+  nvtop_shm_process_compute = 1u << 1,
+};
+
+struct nvtop_shm_process {
+  int32_t pid;
+  uint32_t device_index;
+  uint32_t type;  // nvtop_shm_process_type bits
+  uint32_t valid; // nvtop_shm_process_field bits
+  uint32_t gpu_util;              // %
+  uint32_t encoder_util;          // %
+  uint32_t decoder_util;          // %
+  uint32_t gpu_memory_percentage; // % of the device memory
+  uint32_t cpu_util;              // %
+  uint32_t reserved;
+  uint64_t gpu_memory; // Bytes
+  uint64_t cpu_memory; // Resident bytes
+};
+
+struct nvtop_shm_segment {
+  uint32_t magic;
+  uint32_t layout_version;
+  uint32_t segment_size;
+  uint32_t device_size;
+  uint32_t process_size;
+  uint32_t max_devices;
+  uint32_t max_processes;
+  int32_t publisher_pid;
+  uint64_t sequence;       // Seqlock, odd while an update is in progress
+  uint64_t update_time_ns; // CLOCK_REALTIME of the last update
+  uint32_t devices_count;
+  uint32_t processes_count;
+  struct nvtop_shm_device devices[NVTOP_SHM_MAX_DEVICES];
+  struct nvtop_shm_process processes[NVTOP_SHM_MAX_PROCESSES];
+};
+
+// Maps the segment published under name read-only. Returns NULL if it does not exist or has another layout.
+static inline const struct nvtop_shm_segment *nvtop_shm_open(const char *name) {
+  int fd = shm_open(name, O_RDONLY, 0);
+  if (fd < 0)
+    return NULL;
+  void *mapping = mmap(NULL, sizeof(struct nvtop_shm_segment), PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED)
+    return NULL;
+  const struct nvtop_shm_segment *segment = (const struct nvtop_shm_segment *)mapping;
+  if (segment->magic != NVTOP_SHM_MAGIC || segment->layout_version != NVTOP_SHM_LAYOUT_VERSION ||
+      segment->segment_size != sizeof(struct nvtop_shm_segment)) {
+    munmap(mapping, sizeof(struct nvtop_shm_segment));
+    return NULL;
+  }
+  return segment;
+}
+
+static inline void nvtop_shm_close(const struct nvtop_shm_segment *segment) {
+  munmap((void *)segment, sizeof(struct nvtop_shm_segment));
+}
+
+// Waits for the publisher to leave the segment consistent and stores the sequence to give to nvtop_shm_read_retry.
+// Returns false if the segment stays busy, the publisher likely died during an update and the segment is stale.
+static inline bool nvtop_shm_read_begin(const struct nvtop_shm_segment *segment, uint64_t *sequence) {
+  for (unsigned spins = 0; spins < NVTOP_SHM_READ_SPINS; ++spins) {
+    *sequence = __atomic_load_n(&segment->sequence, __ATOMIC_ACQUIRE);
+    if (!(*sequence & 1))
+      return true;
+  }
+  return false;
+}
+
+// True if the publisher updated the segment since nvtop_shm_read_begin, making what was read inconsistent
+static inline bool nvtop_shm_read_retry(const struct nvtop_shm_segment *segment, uint64_t sequence) {
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  return __atomic_load_n(&segment->sequence, __ATOMIC_RELAXED) != sequence;
+}
+
+// Copies a consistent snapshot of the devices and of their processes; only the used entries of the arrays are copied.
+// Returns false if no consistent snapshot could be taken: the segment is stale or too busy.
+static inline bool nvtop_shm_read(const struct nvtop_shm_segment *segment, struct nvtop_shm_segment *snapshot) {
+  for (unsigned attempt = 0; attempt < NVTOP_SHM_READ_ATTEMPTS; ++attempt) {
+    uint64_t sequence;
+    if (!nvtop_shm_read_begin(segment, &sequence))
+      return false;
+    memcpy(snapshot, segment, offsetof(struct nvtop_shm_segment, devices));
+    uint32_t devices_count = snapshot->devices_count, processes_count = snapshot->processes_count;
+    if (devices_count > NVTOP_SHM_MAX_DEVICES || processes_count > NVTOP_SHM_MAX_PROCESSES)
+      continue;
+    memcpy(snapshot->devices, segment->devices, devices_count * sizeof(*snapshot->devices));
+    memcpy(snapshot->processes, segment->processes, processes_count * sizeof(*snapshot->processes));
+    if (!nvtop_shm_read_retry(segment, sequence))
+      return true;
+  }
+  return false;
+}
+
+#endif // NVTOP_SHM_SNAPSHOT_H__
@@ -0,0 +1,55 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef NVTOP_TRACE_EXPORT_H__
+#define NVTOP_TRACE_EXPORT_H__
+
+#include "list.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct trace_writer;
+
+/**
+ * @brief Opens a trace file recording the device metrics as counter tracks and the lifetime of the processes as
+ * slices. The trace is written in the Perfetto protobuf format if the path ends with .pftrace or .perfetto-trace, in
+ * the Chrome JSON trace event format otherwise.
+ *
+ * @param path The trace file
+ * @return The writer, or NULL if the file cannot be created
+ */
+struct trace_writer *trace_writer_open(const char *path);
+
+/**
+ * @brief Appends the current data of the devices to the trace, stamped with timestamp_ns (CLOCK_BOOTTIME, the default
+ * clock of Perfetto)
+ */
+void trace_writer_sample(struct trace_writer *writer, struct list_head *devices, uint64_t timestamp_ns);
+
+// Ends the slices of the processes still running and closes the file. Returns false, after reporting it, if a write
+// failed along the way and the trace is incomplete.
+bool trace_writer_close(struct trace_writer *writer);
+
+// Current CLOCK_BOOTTIME in nanoseconds
+uint64_t trace_timestamp_now(void);
+
+#endif // NVTOP_TRACE_EXPORT_H__
@@ -0,0 +1,72 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef NVTOP_USAGE_LEDGER_H__
+#define NVTOP_USAGE_LEDGER_H__
+
+#include "nvtop/extract_gpuinfo_common.h"
+
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * The usage ledger accumulates the GPU-seconds, GPU-memory-byte-seconds and energy of the processes per day, user and
+ * job. It is an append-only text file with one record per line:
+ *
+ *   YYYY-MM-DD <tab> user <tab> job <tab> GPU seconds <tab> memory byte-seconds <tab> joules <tab> checksum
+ *
+ * Each flush appends the totals accumulated since the previous one with a single write followed by fsync, and a line
+ * whose checksum does not match (torn by a crash) is ignored. The index file next to the ledger (path.idx) gives the
+ * offset where the records of a day start, synced before the records, so that a report only reads the records of its
+ * date range. A day shows up again in the index when the wall clock is set back.
+ */
+
+#define USAGE_LEDGER_DEFAULT_FLUSH_INTERVAL 60
+
+struct usage_ledger;
+
+// Opens the ledger at path for appending, creating it if needed. Returns NULL on error.
+struct usage_ledger *usage_ledger_open(const char *path);
+
+// Adds the usage of the device processes since the previous sample. The processes must have been accounted by
+// gpuinfo_account_processes; wall_time decides the day of the usage and now_ns is a monotonic timestamp.
+void usage_ledger_sample(struct usage_ledger *ledger, struct list_head *devices, time_t wall_time, uint64_t now_ns);
+
+// Appends the accumulated totals to the ledger and makes them durable
+bool usage_ledger_flush(struct usage_ledger *ledger);
+
+// Flushes and releases the ledger
+void usage_ledger_close(struct usage_ledger *ledger);
+
+// Parses "YYYY-MM-DD" into YYYYMMDD, returns false if malformed
+bool usage_ledger_parse_day(const char *date, unsigned *day);
+
+// Prints the totals per user and per job of the days in [first_day, last_day] (YYYYMMDD, inclusive)
+bool usage_ledger_report(const char *path, unsigned first_day, unsigned last_day, FILE *out);
+
+// Samples the devices every update_interval milliseconds and flushes the ledger every flush_interval seconds until
+// stop becomes non zero
+int usage_ledger_run(const char *path, int update_interval, unsigned flush_interval, volatile sig_atomic_t *stop);
+
+#endif // NVTOP_USAGE_LEDGER_H__
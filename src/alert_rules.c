@@ -0,0 +1,486 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "nvtop/alert_rules.h"
+#include "nvtop/extract_gpuinfo_common.h"
+#include "nvtop/json_util.h"
+#include "uthash.h"
+
+#include <ctype.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+extern char **environ;
+
+static const char *metric_names[alert_metric_count] = {
+    [alert_metric_gpu_util] = "gpu",       [alert_metric_memory] = "mem",   [alert_metric_memory_used] = "memused",
+    [alert_metric_temperature] = "temp",   [alert_metric_power] = "power", [alert_metric_fan] = "fan",
+    [alert_metric_process_memory] = "procmem",
+};
+
+static bool is_byte_metric(enum alert_metric metric) {
+  return metric == alert_metric_memory_used || metric == alert_metric_process_memory;
+}
+
+static const char *skip_spaces(const char *position) {
+  while (isspace((unsigned char)*position))
+    position++;
+  return position;
+}
+
+// Parses the threshold of a clause, returns the end of it or NULL if malformed
+static const char *parse_threshold(const char *position, struct alert_clause *clause) {
+  static const char *references[] = {[alert_reference_slowdown] = "slowdown", [alert_reference_shutdown] = "shutdown"};
+  clause->reference = alert_reference_none;
+  for (enum alert_reference reference = alert_reference_slowdown; reference <= alert_reference_shutdown; ++reference) {
+    if (!strncmp(position, references[reference], strlen(references[reference])))
+      clause->reference = reference;
+  }
+  if (clause->reference != alert_reference_none) {
+    if (clause->metric != alert_metric_temperature)
+      return NULL;
+    position = skip_spaces(position + strlen(references[clause->reference]));
+    clause->threshold = 0.;
+    if (*position != '+' && *position != '-')
+      return position;
+    double sign = *position == '-' ? -1. : 1.;
+    position = skip_spaces(position + 1);
+    char *end;
+    clause->threshold = sign * strtod(position, &end);
+    return end == position ? NULL : end;
+  }
+  char *end;
+  clause->threshold = strtod(position, &end);
+  if (end == position)
+    return NULL;
+  if (is_byte_metric(clause->metric)) {
+    const char *suffix = strchr("KMGT", *end);
+    if (*end && suffix) {
+      for (const char *power = "KMGT"; power <= suffix; ++power)
+        clause->threshold *= 1024.;
+      end++;
+      if (!strncmp(end, "iB", 2))
+        end += 2;
+      else if (*end == 'B')
+        end++;
+    }
+  }
+  return end;
+}
+
+bool alert_condition_parse(const char *condition, unsigned *count, struct alert_clause clauses[ALERT_MAX_CLAUSES]) {
+  *count = 0;
+  const char *position = skip_spaces(condition);
+  while (true) {
+    if (*count == ALERT_MAX_CLAUSES)
+      return false;
+    struct alert_clause *clause = &clauses[*count];
+    size_t name_length = 0;
+    while (isalpha((unsigned char)position[name_length]))
+      name_length++;
+    bool found = false;
+    for (enum alert_metric metric = 0; !found && metric < alert_metric_count; ++metric) {
+      if (strlen(metric_names[metric]) == name_length && !strncmp(position, metric_names[metric], name_length)) {
+        clause->metric = metric;
+        found = true;
+      }
+    }
+    if (!found)
+      return false;
+    position = skip_spaces(position + name_length);
+    if (*position != '<' && *position != '>')
+      return false;
+    clause->below = *position == '<';
+    position = parse_threshold(skip_spaces(position + 1), clause);
+    if (!position)
+      return false;
+    (*count)++;
+    position = skip_spaces(position);
+    if (!*position)
+      return true;
+    if (strncmp(position, "&&", 2))
+      return false;
+    position = skip_spaces(position + 2);
+  }
+}
+
+static char *copy_string(const char *string) {
+  if (!string)
+    return NULL;
+  char *copy = strdup(string);
+  if (!copy) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  return copy;
+}
+
+struct alert_rule *alert_rules_append(unsigned *count, struct alert_rule **rules, const char *name) {
+  *rules = reallocarray(*rules, *count + 1, sizeof(**rules));
+  if (!*rules) {
+    perror("Could not re-allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  struct alert_rule *rule = &(*rules)[(*count)++];
+  memset(rule, 0, sizeof(*rule));
+  rule->name = copy_string(name);
+  rule->cooldown = ALERT_DEFAULT_COOLDOWN;
+  return rule;
+}
+
+static void alert_rule_free(struct alert_rule *rule) {
+  free(rule->name);
+  free(rule->condition);
+  free(rule->command);
+  free(rule->fifo);
+}
+
+void alert_rules_free(unsigned count, struct alert_rule *rules) {
+  for (unsigned i = 0; i < count; ++i)
+    alert_rule_free(&rules[i]);
+  free(rules);
+}
+
+/*
+ *
+ * Evaluation
+ *
+ */
+
+struct compiled_rule {
+  struct alert_rule rule;
+  unsigned clauses_count;
+  struct alert_clause clauses[ALERT_MAX_CLAUSES];
+};
+
+struct alert_state_key {
+  unsigned rule;
+  const struct gpu_info *device;
+};
+
+struct alert_state {
+  struct alert_state_key key;
+  unsigned long long round; // Last evaluation that saw the device
+  bool holding;             // The condition held on the last evaluation
+  double holding_since;
+  bool notified; // The current episode fired, or was dropped
+  bool has_fired;
+  double last_firing;
+  UT_hash_handle hh;
+};
+
+struct alert_engine {
+  unsigned rules_count;
+  struct compiled_rule *rules;
+  struct alert_state *states;
+  unsigned long long round;
+  // Token bucket shared by all the rules
+  double tokens;
+  double tokens_time;
+  unsigned dropped; // Firings dropped since the last delivered one
+  unsigned running_count;
+  pid_t running[ALERT_MAX_RUNNING_COMMANDS];
+};
+
+struct alert_engine *alert_engine_create(unsigned count, const struct alert_rule *rules) {
+  struct alert_engine *engine = calloc(1, sizeof(*engine));
+  if (!engine) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  engine->rules = calloc(count ? count : 1, sizeof(*engine->rules));
+  if (!engine->rules) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  engine->tokens = ALERT_MAX_FIRINGS_PER_MINUTE;
+  engine->tokens_time = -1.;
+  for (unsigned i = 0; i < count; ++i) {
+    const struct alert_rule *rule = &rules[i];
+    struct compiled_rule *compiled = &engine->rules[i];
+    const char *error = NULL;
+    if (!rule->name) {
+      fprintf(stderr, "Error: The [Alert] section number %u has no Name\n", i + 1);
+      alert_engine_destroy(engine);
+      return NULL;
+    }
+    if (!rule->condition)
+      error = "has no Condition";
+    else if (!alert_condition_parse(rule->condition, &compiled->clauses_count, compiled->clauses))
+      error = "has an invalid Condition";
+    else if (!rule->command && !rule->fifo)
+      error = "has neither a Command nor a Fifo";
+    if (error) {
+      fprintf(stderr, "Error: The alert rule \"%s\" %s\n", rule->name, error);
+      alert_engine_destroy(engine);
+      return NULL;
+    }
+    compiled->rule = *rule;
+    compiled->rule.name = copy_string(rule->name);
+    compiled->rule.condition = copy_string(rule->condition);
+    compiled->rule.command = copy_string(rule->command);
+    compiled->rule.fifo = copy_string(rule->fifo);
+    engine->rules_count++;
+  }
+  return engine;
+}
+
+void alert_engine_destroy(struct alert_engine *engine) {
+  if (!engine)
+    return;
+  for (unsigned i = 0; i < engine->rules_count; ++i)
+    alert_rule_free(&engine->rules[i].rule);
+  free(engine->rules);
+  struct alert_state *state, *tmp;
+  HASH_ITER(hh, engine->states, state, tmp) {
+    HASH_DEL(engine->states, state);
+    free(state);
+  }
+  // The hook commands still running are left to finish on their own
+  free(engine);
+}
+
+static bool device_metric(const struct gpu_info *device, enum alert_metric metric, double *value) {
+  const struct gpuinfo_dynamic_info *info = &device->dynamic_info;
+  switch (metric) {
+  case alert_metric_gpu_util:
+    *value = info->gpu_util_rate;
+    return GPUINFO_DYNAMIC_FIELD_VALID(info, gpu_util_rate);
+  case alert_metric_memory:
+    if (!GPUINFO_DYNAMIC_FIELD_VALID(info, used_memory) || !GPUINFO_DYNAMIC_FIELD_VALID(info, total_memory) ||
+        !info->total_memory)
+      return false;
+    *value = 100. * info->used_memory / info->total_memory;
+    return true;
+  case alert_metric_memory_used:
+    *value = info->used_memory;
+    return GPUINFO_DYNAMIC_FIELD_VALID(info, used_memory);
+  case alert_metric_temperature:
+    *value = info->gpu_temp;
+    return GPUINFO_DYNAMIC_FIELD_VALID(info, gpu_temp);
+  case alert_metric_power:
+    *value = info->power_draw / 1000.;
+    return GPUINFO_DYNAMIC_FIELD_VALID(info, power_draw);
+  case alert_metric_fan:
+    *value = info->fan_speed;
+    return GPUINFO_DYNAMIC_FIELD_VALID(info, fan_speed);
+  case alert_metric_process_memory:
+    *value = 0.;
+    for (unsigned i = 0; i < device->processes_count; ++i) {
+      if (GPUINFO_PROCESS_FIELD_VALID(&device->processes[i], gpu_memory_usage) &&
+          device->processes[i].gpu_memory_usage > *value)
+        *value = device->processes[i].gpu_memory_usage;
+    }
+    return true;
+  default:
+    return false;
+  }
+}
+
+static bool clause_threshold(const struct gpu_info *device, const struct alert_clause *clause, double *threshold) {
+  const struct gpuinfo_static_info *info = &device->static_info;
+  switch (clause->reference) {
+  case alert_reference_slowdown:
+    *threshold = info->temperature_slowdown_threshold + clause->threshold;
+    return GPUINFO_STATIC_FIELD_VALID(info, temperature_slowdown_threshold);
+  case alert_reference_shutdown:
+    *threshold = info->temperature_shutdown_threshold + clause->threshold;
+    return GPUINFO_STATIC_FIELD_VALID(info, temperature_shutdown_threshold);
+  default:
+    *threshold = clause->threshold;
+    return true;
+  }
+}
+
+// Returns true if all the clauses hold and writes the values they compared into the message
+static bool condition_holds(const struct compiled_rule *rule, const struct gpu_info *device, char *values,
+                            size_t size) {
+  size_t length = 0;
+  values[0] = '\0';
+  for (unsigned i = 0; i < rule->clauses_count; ++i) {
+    const struct alert_clause *clause = &rule->clauses[i];
+    double value, threshold;
+    if (!device_metric(device, clause->metric, &value) || !clause_threshold(device, clause, &threshold))
+      return false;
+    if (clause->below ? !(value < threshold) : !(value > threshold))
+      return false;
+    if (length < size) {
+      if (is_byte_metric(clause->metric))
+        length += snprintf(values + length, size - length, "%s%s=%.1fGiB", i ? " " : "", metric_names[clause->metric],
+                           value / (1024. * 1024. * 1024.));
+      else
+        length += snprintf(values + length, size - length, "%s%s=%.1f", i ? " " : "", metric_names[clause->metric],
+                           value);
+    }
+  }
+  return true;
+}
+
+// The line is written with a single write, atomic on a FIFO. Nothing is written if no reader has the FIFO open.
+static void write_fifo_line(const char *path, const char *name, unsigned dev, const struct gpu_info *device,
+                            const char *message, unsigned dropped) {
+  int fd = open(path, O_WRONLY | O_APPEND | O_NONBLOCK | O_CLOEXEC);
+  if (fd < 0)
+    return;
+  FILE *file = fdopen(fd, "a");
+  if (!file) {
+    close(fd);
+    return;
+  }
+  struct timespec wall_time;
+  clock_gettime(CLOCK_REALTIME, &wall_time);
+  fprintf(file, "{\"time\":%.3f,\"alert\":", wall_time.tv_sec + wall_time.tv_nsec / 1e9);
+  json_write_string(file, name, 0);
+  fprintf(file, ",\"device\":%u,\"pdev\":", dev);
+  json_write_string(file, device->pdev, 0);
+  fputs(",\"message\":", file);
+  json_write_string(file, message, 0);
+  fprintf(file, ",\"dropped\":%u}\n", dropped);
+  fclose(file);
+}
+
+static void run_command(struct alert_engine *engine, const char *command, const char *name, unsigned dev,
+                        const struct gpu_info *device, const char *message, unsigned dropped) {
+  if (engine->running_count == ALERT_MAX_RUNNING_COMMANDS) {
+    engine->dropped++;
+    return;
+  }
+  char variables[5][320];
+  snprintf(variables[0], sizeof(variables[0]), "NVTOP_ALERT_NAME=%s", name);
+  snprintf(variables[1], sizeof(variables[1]), "NVTOP_ALERT_DEVICE=%u", dev);
+  snprintf(variables[2], sizeof(variables[2]), "NVTOP_ALERT_PDEV=%s", device->pdev);
+  snprintf(variables[3], sizeof(variables[3]), "NVTOP_ALERT_MESSAGE=%s", message);
+  snprintf(variables[4], sizeof(variables[4]), "NVTOP_ALERT_DROPPED=%u", dropped);
+  size_t environment_size = 0;
+  while (environ[environment_size])
+    environment_size++;
+  char **environment = calloc(environment_size + 6, sizeof(*environment));
+  if (!environment) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  memcpy(environment, environ, environment_size * sizeof(*environment));
+  for (unsigned i = 0; i < 5; ++i)
+    environment[environment_size + i] = variables[i];
+
+  // The commands must not draw over the interface
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+  posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+  posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+  char *arguments[] = {"sh", "-c", (char *)command, NULL};
+  pid_t pid;
+  if (posix_spawn(&pid, "/bin/sh", &actions, NULL, arguments, environment) == 0)
+    engine->running[engine->running_count++] = pid;
+  posix_spawn_file_actions_destroy(&actions);
+  free(environment);
+}
+
+static void reap_commands(struct alert_engine *engine) {
+  for (unsigned i = 0; i < engine->running_count;) {
+    if (waitpid(engine->running[i], NULL, WNOHANG) != 0)
+      engine->running[i] = engine->running[--engine->running_count];
+    else
+      i++;
+  }
+}
+
+static void deliver(struct alert_engine *engine, const struct compiled_rule *rule, unsigned dev,
+                    const struct gpu_info *device, const char *values) {
+  char message[256];
+  snprintf(message, sizeof(message), "%s on GPU%u: %s", rule->rule.name, dev, values);
+  unsigned dropped = engine->dropped;
+  engine->dropped = 0;
+  if (rule->rule.fifo)
+    write_fifo_line(rule->rule.fifo, rule->rule.name, dev, device, message, dropped);
+  if (rule->rule.command)
+    run_command(engine, rule->rule.command, rule->rule.name, dev, device, message, dropped);
+}
+
+void alert_engine_evaluate(struct alert_engine *engine, struct list_head *devices, double now) {
+  reap_commands(engine);
+  if (engine->tokens_time >= 0.) {
+    engine->tokens += (now - engine->tokens_time) * ALERT_MAX_FIRINGS_PER_MINUTE / 60.;
+    if (engine->tokens > ALERT_MAX_FIRINGS_PER_MINUTE)
+      engine->tokens = ALERT_MAX_FIRINGS_PER_MINUTE;
+  }
+  engine->tokens_time = now;
+  engine->round++;
+  for (unsigned r = 0; r < engine->rules_count; ++r) {
+    const struct compiled_rule *rule = &engine->rules[r];
+    unsigned dev = 0;
+    struct gpu_info *device;
+    list_for_each_entry(device, devices, list) {
+      struct alert_state_key key;
+      memset(&key, 0, sizeof(key));
+      key.rule = r;
+      key.device = device;
+      struct alert_state *state;
+      HASH_FIND(hh, engine->states, &key, sizeof(key), state);
+      if (!state) {
+        state = calloc(1, sizeof(*state));
+        if (!state) {
+          perror("Cannot allocate memory: ");
+          exit(EXIT_FAILURE);
+        }
+        state->key = key;
+        HASH_ADD(hh, engine->states, key, sizeof(state->key), state);
+      }
+      // A device that was not monitored in between starts a new episode
+      if (state->round + 1 != engine->round) {
+        state->holding = false;
+        state->notified = false;
+      }
+      state->round = engine->round;
+
+      char values[192];
+      if (!condition_holds(rule, device, values, sizeof(values))) {
+        state->holding = false;
+        state->notified = false;
+      } else {
+        if (!state->holding) {
+          state->holding = true;
+          state->holding_since = now;
+        }
+        if (!state->notified && now - state->holding_since >= rule->rule.duration &&
+            (!state->has_fired || now - state->last_firing >= rule->rule.cooldown)) {
+          state->notified = true;
+          if (engine->tokens >= 1.) {
+            engine->tokens -= 1.;
+            state->has_fired = true;
+            state->last_firing = now;
+            deliver(engine, rule, dev, device, values);
+          } else {
+            engine->dropped++;
+          }
+        }
+      }
+      dev++;
+    }
+  }
+}
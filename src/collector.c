@@ -0,0 +1,885 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "nvtop/collector.h"
+#include "nvtop/common.h"
+#include "nvtop/extract_gpuinfo.h"
+#include "nvtop/shm_publisher.h"
+#include "nvtop/time.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Upper bound of a message, protects both ends against garbage on the socket
+#define COLLECTOR_MAX_MESSAGE_SIZE (64u * 1024u * 1024u)
+#define COLLECTOR_CLIENTS_REALLOC_INC 8
+// A client not reading its snapshot, or not completing its request, within this delay gets disconnected
+#define COLLECTOR_CLIENT_TIMEOUT_SEC 1.
+#define COLLECTOR_REQUEST_READ_CHUNK 256
+
+static bool header_is_valid(const struct collector_message_header *header) {
+  return header->magic == COLLECTOR_PROTOCOL_MAGIC && header->version == COLLECTOR_PROTOCOL_VERSION &&
+         header->length <= COLLECTOR_MAX_MESSAGE_SIZE;
+}
+
+// An endpoint containing a '/' is a Unix socket path, anything else is [host][:port]
+static bool endpoint_is_unix(const char *endpoint) { return strchr(endpoint, '/') != NULL; }
+
+static void endpoint_split(const char *endpoint, char *host, size_t host_size, const char **port) {
+  const char *colon = strrchr(endpoint, ':');
+  size_t host_length = colon ? (size_t)(colon - endpoint) : strlen(endpoint);
+  if (host_length >= host_size)
+    host_length = host_size - 1;
+  memcpy(host, endpoint, host_length);
+  host[host_length] = '\0';
+  *port = colon && colon[1] ? colon + 1 : COLLECTOR_DEFAULT_PORT;
+}
+
+static bool fill_unix_address(const char *socket_path, struct sockaddr_un *address) {
+  memset(address, 0, sizeof(*address));
+  address->sun_family = AF_UNIX;
+  if (strlen(socket_path) >= sizeof(address->sun_path))
+    return false;
+  strcpy(address->sun_path, socket_path);
+  return true;
+}
+
+// Only a daemon run by root or by this user is trusted, anyone else could forge the snapshots
+static bool unix_peer_is_trusted(int fd, const char *socket_path) {
+  struct ucred credentials;
+  socklen_t length = sizeof(credentials);
+  uid_t owner;
+  if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &length) == 0 && credentials.pid) {
+    owner = credentials.uid;
+  } else {
+    // Not connected yet, the socket file belongs to the daemon that bound it
+    struct stat socket_stat;
+    if (stat(socket_path, &socket_stat) < 0)
+      return false;
+    owner = socket_stat.st_uid;
+  }
+  return owner == 0 || owner == geteuid();
+}
+
+static int connect_to_unix_socket(const char *socket_path, bool non_blocking) {
+  struct sockaddr_un address;
+  if (!fill_unix_address(socket_path, &address))
+    return -1;
+  int fd = socket(AF_UNIX, SOCK_STREAM | (non_blocking ? SOCK_NONBLOCK : 0), 0);
+  if (fd < 0)
+    return -1;
+  if ((connect(fd, (struct sockaddr *)&address, sizeof(address)) < 0 && errno != EINPROGRESS && errno != EAGAIN) ||
+      !unix_peer_is_trusted(fd, socket_path)) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+static int connect_to_tcp_endpoint(const char *endpoint, bool non_blocking) {
+  char host[NI_MAXHOST];
+  const char *port;
+  endpoint_split(endpoint, host, sizeof(host), &port);
+  struct addrinfo hints = {.ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM}, *addresses;
+  if (getaddrinfo(host[0] ? host : NULL, port, &hints, &addresses) != 0)
+    return -1;
+  int fd = -1;
+  for (struct addrinfo *address = addresses; address && fd < 0; address = address->ai_next) {
+    fd = socket(address->ai_family, address->ai_socktype | (non_blocking ? SOCK_NONBLOCK : 0), address->ai_protocol);
+    if (fd < 0)
+      continue;
+    if (connect(fd, address->ai_addr, address->ai_addrlen) < 0 && errno != EINPROGRESS) {
+      close(fd);
+      fd = -1;
+    }
+  }
+  freeaddrinfo(addresses);
+  if (fd >= 0) {
+    int enable = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+  }
+  return fd;
+}
+
+static int connect_to_endpoint(const char *endpoint, bool non_blocking) {
+  if (endpoint_is_unix(endpoint))
+    return connect_to_unix_socket(endpoint, non_blocking);
+  else
+    return connect_to_tcp_endpoint(endpoint, non_blocking);
+}
+
+/*
+ *
+ * Daemon side
+ *
+ */
+
+static int create_unix_listening_socket(const char *socket_path) {
+  struct sockaddr_un address;
+  if (!fill_unix_address(socket_path, &address)) {
+    fprintf(stderr, "The socket path %s is too long\n", socket_path);
+    return -1;
+  }
+  // Only remove the socket file if no daemon answers on it
+  int running = connect_to_unix_socket(socket_path, false);
+  if (running >= 0) {
+    close(running);
+    fprintf(stderr, "A collector daemon is already listening on %s\n", socket_path);
+    return -1;
+  }
+  unlink(socket_path);
+  if (strcmp(socket_path, COLLECTOR_DEFAULT_SOCKET) == 0 && mkdir(COLLECTOR_DEFAULT_SOCKET_DIR, 0755) < 0 &&
+      errno != EEXIST) {
+    fprintf(stderr, "Cannot create the directory %s: %s\n", COLLECTOR_DEFAULT_SOCKET_DIR, strerror(errno));
+    return -1;
+  }
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    perror("Cannot create the collector socket: ");
+    return -1;
+  }
+  // Every user of the machine may attach, the socket is created with this mode
+  mode_t mask = umask(0111);
+  int bound = bind(fd, (struct sockaddr *)&address, sizeof(address));
+  umask(mask);
+  if (bound < 0) {
+    perror("Cannot bind the collector socket: ");
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+static int create_tcp_listening_socket(const char *endpoint) {
+  char host[NI_MAXHOST];
+  const char *port;
+  endpoint_split(endpoint, host, sizeof(host), &port);
+  // Without a host the daemon only listens on the loopback interface, "*" listens on all the interfaces
+  bool all_interfaces = strcmp(host, "*") == 0;
+  struct addrinfo hints = {.ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM, .ai_flags = all_interfaces ? AI_PASSIVE : 0},
+                  *addresses;
+  int error = getaddrinfo(host[0] && !all_interfaces ? host : NULL, port, &hints, &addresses);
+  if (error) {
+    fprintf(stderr, "Cannot resolve %s: %s\n", endpoint, gai_strerror(error));
+    return -1;
+  }
+  int fd = -1;
+  for (struct addrinfo *address = addresses; address && fd < 0; address = address->ai_next) {
+    fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+    if (fd < 0)
+      continue;
+    int enable = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    if (bind(fd, address->ai_addr, address->ai_addrlen) < 0) {
+      close(fd);
+      fd = -1;
+    }
+  }
+  freeaddrinfo(addresses);
+  if (fd < 0)
+    fprintf(stderr, "Cannot listen on %s: %s\n", endpoint, strerror(errno));
+  return fd;
+}
+
+static int create_listening_socket(const char *endpoint) {
+  int fd = endpoint_is_unix(endpoint) ? create_unix_listening_socket(endpoint) : create_tcp_listening_socket(endpoint);
+  if (fd < 0)
+    return -1;
+  if (listen(fd, SOMAXCONN) < 0) {
+    perror("Cannot listen on the collector socket: ");
+    close(fd);
+    if (endpoint_is_unix(endpoint))
+      unlink(endpoint);
+    return -1;
+  }
+  return fd;
+}
+
+// The client sockets are non-blocking so that no client can stall the daemon, the snapshots that the socket does not
+// accept at once stay in the output buffer of the client
+struct collector_client {
+  bool subscribed;
+  uint64_t sequence;              // Last sequence number sent to a subscribed client
+  struct collector_buffer input;  // Request not completely received yet
+  struct collector_buffer output; // Data not written yet, from output_sent on
+  size_t output_sent;
+  nvtop_time pending_since; // When the pending input or output started
+};
+
+struct collector_daemon_state {
+  unsigned devices_count;
+  struct gpu_info **devices;
+  uint64_t sequence;
+  struct collector_device_history *histories;
+  struct collector_buffer buffer;
+};
+
+static void daemon_refresh(struct list_head *devices, struct collector_daemon_state *state) {
+  gpuinfo_refresh_dynamic_info(devices);
+  gpuinfo_refresh_processes(devices);
+  gpuinfo_utilisation_rate(devices);
+  gpuinfo_account_processes(devices);
+  gpuinfo_fix_dynamic_info_from_process_info(devices);
+  state->sequence++;
+  for (unsigned i = 0; i < state->devices_count; ++i)
+    collector_device_history_update(&state->histories[i], state->devices[i], state->sequence);
+}
+
+// Writes as much of the pending output as the socket takes, returns false if the client has to be disconnected
+static bool daemon_flush_client(int fd, struct collector_client *client) {
+  while (client->output_sent < client->output.size) {
+    ssize_t written =
+        write(fd, client->output.data + client->output_sent, client->output.size - client->output_sent);
+    if (written < 0) {
+      if (errno == EINTR)
+        continue;
+      return errno == EAGAIN;
+    }
+    client->output_sent += (size_t)written;
+  }
+  client->output.size = 0;
+  client->output_sent = 0;
+  return true;
+}
+
+static bool daemon_send_snapshot(int fd, struct collector_client *client, struct collector_daemon_state *state,
+                                 uint64_t client_sequence) {
+  // A client from a previous daemon run gets everything again
+  if (client_sequence > state->sequence)
+    client_sequence = 0;
+  collector_encode_snapshot(state->devices_count, state->devices, state->histories, state->sequence, client_sequence,
+                            &state->buffer);
+  char header[COLLECTOR_HEADER_SIZE];
+  collector_encode_header(collector_message_snapshot, state->buffer.size, header);
+  if (!client->output.size)
+    nvtop_get_current_time(&client->pending_since);
+  collector_buffer_append(&client->output, header, sizeof(header));
+  collector_buffer_append(&client->output, state->buffer.data, state->buffer.size);
+  return daemon_flush_client(fd, client);
+}
+
+// Handles the complete queries and subscriptions received so far, returns false if the client has to be disconnected
+static bool daemon_answer_client(int fd, struct collector_client *client, struct collector_daemon_state *state) {
+  struct collector_message_header header;
+  size_t consumed = 0;
+  bool keep = true;
+  while (keep && client->input.size - consumed >= COLLECTOR_HEADER_SIZE) {
+    collector_decode_header(client->input.data + consumed, &header);
+    if (!header_is_valid(&header) || header.length != COLLECTOR_REQUEST_SIZE - COLLECTOR_HEADER_SIZE)
+      return false;
+    if (client->input.size - consumed < COLLECTOR_REQUEST_SIZE)
+      break;
+    uint64_t client_sequence = collector_request_sequence(client->input.data + consumed);
+    consumed += COLLECTOR_REQUEST_SIZE;
+    switch (header.type) {
+    case collector_message_query:
+      keep = daemon_send_snapshot(fd, client, state, client_sequence);
+      break;
+    case collector_message_subscribe:
+      client->subscribed = true;
+      client->sequence = state->sequence;
+      keep = daemon_send_snapshot(fd, client, state, client_sequence);
+      break;
+    default:
+      return false;
+    }
+  }
+  memmove(client->input.data, client->input.data + consumed, client->input.size - consumed);
+  client->input.size -= consumed;
+  if (client->input.size && consumed)
+    nvtop_get_current_time(&client->pending_since);
+  return keep;
+}
+
+static bool daemon_read_client(int fd, struct collector_client *client, struct collector_daemon_state *state) {
+  char chunk[COLLECTOR_REQUEST_READ_CHUNK];
+  ssize_t got;
+  while ((got = read(fd, chunk, sizeof(chunk))) > 0) {
+    if (!client->input.size)
+      nvtop_get_current_time(&client->pending_since);
+    collector_buffer_append(&client->input, chunk, (size_t)got);
+    if (!daemon_answer_client(fd, client, state))
+      return false;
+  }
+  return got < 0 && (errno == EAGAIN || errno == EINTR);
+}
+
+static bool daemon_client_timed_out(const struct collector_client *client, nvtop_time now) {
+  return (client->input.size || client->output.size) &&
+         nvtop_difftime(client->pending_since, now) > COLLECTOR_CLIENT_TIMEOUT_SEC;
+}
+
+static void daemon_drop_client(struct pollfd *fds, struct collector_client *clients, unsigned *fds_count,
+                               unsigned index) {
+  close(fds[index].fd);
+  collector_buffer_free(&clients[index].input);
+  collector_buffer_free(&clients[index].output);
+  (*fds_count)--;
+  fds[index] = fds[*fds_count];
+  clients[index] = clients[*fds_count];
+}
+
+int collector_daemon_run(const char *endpoint, const char *shm_name, int update_interval,
+                         volatile sig_atomic_t *stop) {
+  unsigned devices_count = 0;
+  LIST_HEAD(devices);
+  if (!gpuinfo_init_info_extraction(&devices_count, &devices))
+    return EXIT_FAILURE;
+  if (devices_count == 0) {
+    fprintf(stderr, "No GPU to monitor.\n");
+    return EXIT_FAILURE;
+  }
+  gpuinfo_populate_static_infos(&devices);
+
+  struct shm_publisher *shm_publisher = NULL;
+  if (shm_name) {
+    shm_publisher = shm_publisher_create(shm_name);
+    if (!shm_publisher) {
+      gpuinfo_shutdown_info_extraction(&devices);
+      return EXIT_FAILURE;
+    }
+  }
+  int listen_fd = create_listening_socket(endpoint);
+  if (listen_fd < 0) {
+    shm_publisher_destroy(shm_publisher);
+    gpuinfo_shutdown_info_extraction(&devices);
+    return EXIT_FAILURE;
+  }
+  // Clients going away while being written to must not kill the daemon
+  signal(SIGPIPE, SIG_IGN);
+
+  struct collector_daemon_state state = {0};
+  state.devices_count = devices_count;
+  state.devices = calloc(devices_count, sizeof(*state.devices));
+  state.histories = calloc(devices_count, sizeof(*state.histories));
+  if (!state.devices || !state.histories) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  struct gpu_info *device;
+  unsigned dev_id = 0;
+  list_for_each_entry(device, &devices, list) { state.devices[dev_id++] = device; }
+
+  // Index 0 is the listening socket, the clients at index i have their state in clients[i]
+  unsigned fds_count = 1, fds_size = COLLECTOR_CLIENTS_REALLOC_INC;
+  struct pollfd *fds = calloc(fds_size, sizeof(*fds));
+  struct collector_client *clients = calloc(fds_size, sizeof(*clients));
+  if (!fds || !clients) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  fds[0].fd = listen_fd;
+  fds[0].events = POLLIN;
+
+  nvtop_time last_refresh;
+  nvtop_get_current_time(&last_refresh);
+  bool refresh_now = true;
+  while (!*stop) {
+    nvtop_time now;
+    nvtop_get_current_time(&now);
+    int time_left = update_interval - (int)(nvtop_difftime(last_refresh, now) * 1000.);
+    if (refresh_now || time_left <= 0) {
+      daemon_refresh(&devices, &state);
+      if (shm_publisher)
+        shm_publisher_publish(shm_publisher, &devices);
+      // A client still writing out a previous snapshot gets the changes of this refresh along with the next one
+      for (unsigned i = fds_count; i-- > 1;) {
+        if (!clients[i].subscribed || clients[i].output.size)
+          continue;
+        if (daemon_send_snapshot(fds[i].fd, &clients[i], &state, clients[i].sequence))
+          clients[i].sequence = state.sequence;
+        else
+          daemon_drop_client(fds, clients, &fds_count, i);
+      }
+      last_refresh = now;
+      time_left = update_interval;
+      refresh_now = false;
+    }
+
+    for (unsigned i = 1; i < fds_count; ++i)
+      fds[i].events = POLLIN | (clients[i].output.size ? POLLOUT : 0);
+    int ready = poll(fds, fds_count, time_left);
+    if (ready < 0)
+      continue;
+
+    nvtop_get_current_time(&now);
+    for (unsigned i = fds_count; i-- > 1;) {
+      bool keep = !(fds[i].revents & (POLLERR | POLLNVAL));
+      if (keep && (fds[i].revents & POLLOUT))
+        keep = daemon_flush_client(fds[i].fd, &clients[i]);
+      if (keep && (fds[i].revents & (POLLIN | POLLHUP)))
+        keep = daemon_read_client(fds[i].fd, &clients[i], &state);
+      if (!keep || daemon_client_timed_out(&clients[i], now))
+        daemon_drop_client(fds, clients, &fds_count, i);
+    }
+
+    if (fds[0].revents & POLLIN) {
+      int client_fd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK);
+      if (client_fd >= 0) {
+        if (!endpoint_is_unix(endpoint)) {
+          int enable = 1;
+          setsockopt(client_fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+        }
+        if (fds_count == fds_size) {
+          fds_size += COLLECTOR_CLIENTS_REALLOC_INC;
+          fds = reallocarray(fds, fds_size, sizeof(*fds));
+          clients = reallocarray(clients, fds_size, sizeof(*clients));
+          if (!fds || !clients) {
+            perror("Could not re-allocate memory: ");
+            exit(EXIT_FAILURE);
+          }
+        }
+        fds[fds_count].fd = client_fd;
+        fds[fds_count].events = POLLIN;
+        fds[fds_count].revents = 0;
+        memset(&clients[fds_count], 0, sizeof(clients[fds_count]));
+        fds_count++;
+      }
+    }
+    for (unsigned i = 0; i < fds_count; ++i)
+      fds[i].revents = 0;
+  }
+
+  close(listen_fd);
+  for (unsigned i = fds_count; i-- > 1;)
+    daemon_drop_client(fds, clients, &fds_count, i);
+  if (endpoint_is_unix(endpoint))
+    unlink(endpoint);
+  shm_publisher_destroy(shm_publisher);
+  free(fds);
+  free(clients);
+  free(state.devices);
+  for (unsigned i = 0; i < devices_count; ++i)
+    collector_device_history_free(&state.histories[i]);
+  free(state.histories);
+  collector_buffer_free(&state.buffer);
+  gpuinfo_shutdown_info_extraction(&devices);
+  return EXIT_SUCCESS;
+}
+
+/*
+ *
+ * Client side, exposed as a vendor whose devices mirror the ones of the daemons. The connections are non-blocking and
+ * multiplexed with epoll so that a slow or dead daemon never stalls the interface.
+ *
+ */
+
+// Time to wait for the first snapshot of every daemon at startup
+#define COLLECTOR_STARTUP_TIMEOUT_MS 2000
+// Daemons push a snapshot every refresh, a silent connection is considered dead after this delay
+#define COLLECTOR_SILENCE_TIMEOUT_SEC 15.
+#define COLLECTOR_RECONNECT_DELAY_SEC 2.
+#define COLLECTOR_READ_CHUNK 65536
+
+enum collector_connection_state {
+  collector_connection_down,
+  collector_connection_connecting,
+  collector_connection_up,
+};
+
+struct gpu_info_collector;
+
+struct collector_connection {
+  char *endpoint;
+  char *host; // Shown in front of the device names, NULL for local daemons
+  unsigned host_id;
+  int fd;
+  enum collector_connection_state state;
+  nvtop_time last_event; // Last received data, or last connection attempt while down
+  struct collector_buffer input;
+  struct collector_snapshot snapshot;
+  unsigned devices_count; // Devices exposed for this daemon, none until it first answers
+  struct gpu_info_collector *devices;
+};
+
+struct gpu_info_collector {
+  struct gpu_info base;
+  struct collector_connection *connection;
+  unsigned index;               // Index of the device on its daemon
+  unsigned number;              // Order in which the devices of all the daemons were exposed
+  unsigned owned_strings_count; // The first processes own copies of the strings of remote daemons
+};
+
+static bool gpuinfo_collector_init(void);
+static void gpuinfo_collector_shutdown(void);
+static const char *gpuinfo_collector_last_error_string(void);
+static bool gpuinfo_collector_get_device_handles(struct list_head *devices, unsigned *count);
+static void gpuinfo_collector_populate_static_info(struct gpu_info *_gpu_info);
+static void gpuinfo_collector_refresh_dynamic_info(struct gpu_info *_gpu_info);
+static void gpuinfo_collector_get_running_processes(struct gpu_info *_gpu_info);
+static unsigned gpuinfo_collector_get_new_device_handles(struct list_head *devices);
+
+struct gpu_vendor gpu_vendor_collector = {
+    .init = gpuinfo_collector_init,
+    .shutdown = gpuinfo_collector_shutdown,
+    .last_error_string = gpuinfo_collector_last_error_string,
+    .get_device_handles = gpuinfo_collector_get_device_handles,
+    .populate_static_info = gpuinfo_collector_populate_static_info,
+    .refresh_dynamic_info = gpuinfo_collector_refresh_dynamic_info,
+    .refresh_running_processes = gpuinfo_collector_get_running_processes,
+    .get_new_device_handles = gpuinfo_collector_get_new_device_handles,
+    .name = "Collector",
+};
+
+static unsigned connections_count;
+static struct collector_connection *connections;
+static int epoll_fd = -1;
+static unsigned exposed_devices_count;
+static unsigned last_refreshed_device;
+static bool refreshed_once;
+
+const char *collector_default_endpoint(bool daemon) {
+  static char user_socket[PATH_MAX];
+  const char *runtime_dir = getenv("XDG_RUNTIME_DIR");
+  if (geteuid() == 0 || !runtime_dir || !runtime_dir[0] || (!daemon && access(COLLECTOR_DEFAULT_SOCKET, F_OK) == 0))
+    return COLLECTOR_DEFAULT_SOCKET;
+  snprintf(user_socket, sizeof(user_socket), "%s/%s", runtime_dir, COLLECTOR_USER_SOCKET_NAME);
+  return user_socket;
+}
+
+void collector_client_enable(const char *endpoints) {
+  char *list = strdup(endpoints);
+  if (!list) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  char *saveptr;
+  for (char *endpoint = strtok_r(list, ",", &saveptr); endpoint; endpoint = strtok_r(NULL, ",", &saveptr)) {
+    connections = reallocarray(connections, connections_count + 1, sizeof(*connections));
+    if (!connections) {
+      perror("Could not re-allocate memory: ");
+      exit(EXIT_FAILURE);
+    }
+    struct collector_connection *connection = &connections[connections_count++];
+    memset(connection, 0, sizeof(*connection));
+    connection->endpoint = strdup(endpoint);
+    connection->fd = -1;
+    if (!endpoint_is_unix(endpoint)) {
+      const char *port;
+      char host[NI_MAXHOST];
+      endpoint_split(endpoint, host, sizeof(host), &port);
+      connection->host = strdup(host);
+      connection->host_id = connections_count;
+    }
+  }
+  free(list);
+  register_exclusive_gpu_vendor(&gpu_vendor_collector);
+}
+
+static void connection_close(struct collector_connection *connection) {
+  if (connection->fd >= 0) {
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, connection->fd, NULL);
+    close(connection->fd);
+  }
+  connection->fd = -1;
+  connection->state = collector_connection_down;
+  connection->input.size = 0;
+  nvtop_get_current_time(&connection->last_event);
+}
+
+static void connection_open(struct collector_connection *connection) {
+  nvtop_get_current_time(&connection->last_event);
+  connection->fd = connect_to_endpoint(connection->endpoint, true);
+  if (connection->fd < 0)
+    return;
+  // Writable once connected
+  struct epoll_event event = {.events = EPOLLIN | EPOLLOUT, .data.ptr = connection};
+  if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, connection->fd, &event) < 0) {
+    connection_close(connection);
+    return;
+  }
+  connection->state = collector_connection_connecting;
+}
+
+static void connection_subscribe(struct collector_connection *connection) {
+  int error = 0;
+  socklen_t error_size = sizeof(error);
+  if (getsockopt(connection->fd, SOL_SOCKET, SO_ERROR, &error, &error_size) < 0 || error) {
+    connection_close(connection);
+    return;
+  }
+  // Small enough to never be partially written on a fresh connection
+  char subscription[COLLECTOR_REQUEST_SIZE];
+  collector_encode_request(collector_message_subscribe, connection->snapshot.sequence, subscription);
+  if (write(connection->fd, subscription, sizeof(subscription)) != (ssize_t)sizeof(subscription)) {
+    connection_close(connection);
+    return;
+  }
+  struct epoll_event event = {.events = EPOLLIN, .data.ptr = connection};
+  epoll_ctl(epoll_fd, EPOLL_CTL_MOD, connection->fd, &event);
+  connection->state = collector_connection_up;
+  nvtop_get_current_time(&connection->last_event);
+}
+
+// Decodes the complete messages buffered so far
+static void connection_process_input(struct collector_connection *connection) {
+  size_t consumed = 0;
+  while (connection->input.size - consumed >= COLLECTOR_HEADER_SIZE) {
+    struct collector_message_header header;
+    collector_decode_header(connection->input.data + consumed, &header);
+    if (!header_is_valid(&header) || header.type != collector_message_snapshot) {
+      connection_close(connection);
+      return;
+    }
+    if (connection->input.size - consumed - COLLECTOR_HEADER_SIZE < header.length)
+      break;
+    const char *payload = connection->input.data + consumed + COLLECTOR_HEADER_SIZE;
+    if (!collector_decode_snapshot(payload, header.length, &connection->snapshot)) {
+      // Start over from a full snapshot
+      connection->snapshot.sequence = 0;
+      connection_close(connection);
+      return;
+    }
+    consumed += COLLECTOR_HEADER_SIZE + header.length;
+  }
+  memmove(connection->input.data, connection->input.data + consumed, connection->input.size - consumed);
+  connection->input.size -= consumed;
+}
+
+static void connection_read(struct collector_connection *connection) {
+  char chunk[COLLECTOR_READ_CHUNK];
+  ssize_t got;
+  while ((got = read(connection->fd, chunk, sizeof(chunk))) > 0) {
+    collector_buffer_append(&connection->input, chunk, (size_t)got);
+    nvtop_get_current_time(&connection->last_event);
+  }
+  if (got == 0 || (errno != EAGAIN && errno != EINTR)) {
+    connection_close(connection);
+    return;
+  }
+  connection_process_input(connection);
+}
+
+// Handles the pending events without waiting more than timeout milliseconds, reconnecting the dead connections
+static void client_process_events(int timeout) {
+  nvtop_time now;
+  nvtop_get_current_time(&now);
+  for (unsigned i = 0; i < connections_count; ++i) {
+    struct collector_connection *connection = &connections[i];
+    double silence = nvtop_difftime(connection->last_event, now);
+    if (connection->state != collector_connection_down && silence > COLLECTOR_SILENCE_TIMEOUT_SEC)
+      connection_close(connection);
+    else if (connection->state == collector_connection_down && silence > COLLECTOR_RECONNECT_DELAY_SEC)
+      connection_open(connection);
+  }
+
+  struct epoll_event events[16];
+  int ready = epoll_wait(epoll_fd, events, sizeof(events) / sizeof(*events), timeout);
+  for (int i = 0; i < ready; ++i) {
+    struct collector_connection *connection = events[i].data.ptr;
+    if (connection->state == collector_connection_connecting) {
+      connection_subscribe(connection);
+    } else if (connection->state == collector_connection_up) {
+      if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+        connection_read(connection);
+    }
+  }
+}
+
+static bool all_connections_settled(void) {
+  for (unsigned i = 0; i < connections_count; ++i) {
+    if (connections[i].state != collector_connection_down && connections[i].snapshot.sequence == 0)
+      return false;
+  }
+  return true;
+}
+
+static bool gpuinfo_collector_init(void) {
+  if (!connections_count)
+    return false;
+  epoll_fd = epoll_create1(0);
+  if (epoll_fd < 0)
+    return false;
+  for (unsigned i = 0; i < connections_count; ++i)
+    connection_open(&connections[i]);
+
+  nvtop_time start, now;
+  nvtop_get_current_time(&start);
+  now = start;
+  int elapsed = 0;
+  while (!all_connections_settled() && elapsed < COLLECTOR_STARTUP_TIMEOUT_MS) {
+    client_process_events(COLLECTOR_STARTUP_TIMEOUT_MS - elapsed);
+    nvtop_get_current_time(&now);
+    elapsed = (int)(nvtop_difftime(start, now) * 1000.);
+  }
+  for (unsigned i = 0; i < connections_count; ++i) {
+    if (!connections[i].snapshot.devices_count)
+      fprintf(stderr, "No device received from %s, its devices are added once it answers\n", connections[i].endpoint);
+  }
+  return true;
+}
+
+static void gpuinfo_collector_shutdown(void) {
+  for (unsigned i = 0; i < connections_count; ++i) {
+    connection_close(&connections[i]);
+    collector_snapshot_free(&connections[i].snapshot);
+    collector_buffer_free(&connections[i].input);
+    free(connections[i].endpoint);
+    free(connections[i].host);
+    free(connections[i].devices);
+  }
+  free(connections);
+  connections = NULL;
+  connections_count = 0;
+  exposed_devices_count = 0;
+  if (epoll_fd >= 0)
+    close(epoll_fd);
+  epoll_fd = -1;
+}
+
+static const char *gpuinfo_collector_last_error_string(void) { return "Cannot reach the collector daemons"; }
+
+// Exposes the devices of a daemon once it sent them
+static unsigned connection_add_devices(struct collector_connection *connection, struct list_head *devices) {
+  if (connection->devices || !connection->snapshot.devices_count)
+    return 0;
+  connection->devices = calloc(connection->snapshot.devices_count, sizeof(*connection->devices));
+  if (!connection->devices) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  connection->devices_count = connection->snapshot.devices_count;
+  for (unsigned i = 0; i < connection->devices_count; ++i) {
+    struct gpu_info_collector *device = &connection->devices[i];
+    device->base.vendor = &gpu_vendor_collector;
+    device->base.host_id = connection->host_id;
+    device->connection = connection;
+    device->index = i;
+    device->number = exposed_devices_count++;
+    strncpy(device->base.pdev, connection->snapshot.devices[i].pdev, PDEV_LEN);
+    list_add_tail(&device->base.list, devices);
+  }
+  return connection->devices_count;
+}
+
+static bool gpuinfo_collector_get_device_handles(struct list_head *devices, unsigned *count) {
+  // The devices of the daemons not reachable at startup are added once they answer
+  *count = 0;
+  for (unsigned i = 0; i < connections_count; ++i)
+    *count += connection_add_devices(&connections[i], devices);
+  return *count > 0;
+}
+
+static unsigned gpuinfo_collector_get_new_device_handles(struct list_head *devices) {
+  unsigned count = 0;
+  for (unsigned i = 0; i < connections_count; ++i)
+    count += connection_add_devices(&connections[i], devices);
+  return count;
+}
+
+static const struct collector_device *collector_device_of(const struct gpu_info_collector *gpu_info) {
+  const struct collector_connection *connection = gpu_info->connection;
+  // The data of a lost daemon is not shown as if it was current
+  if (connection->state != collector_connection_up || gpu_info->index >= connection->snapshot.devices_count)
+    return NULL;
+  return &connection->snapshot.devices[gpu_info->index];
+}
+
+static void gpuinfo_collector_populate_static_info(struct gpu_info *_gpu_info) {
+  struct gpu_info_collector *gpu_info = container_of(_gpu_info, struct gpu_info_collector, base);
+  const struct collector_connection *connection = gpu_info->connection;
+  if (gpu_info->index >= connection->snapshot.devices_count ||
+      !connection->snapshot.devices[gpu_info->index].has_static_info) {
+    RESET_ALL(_gpu_info->static_info.valid);
+    return;
+  }
+  _gpu_info->static_info = connection->snapshot.devices[gpu_info->index].static_info;
+  if (connection->host) {
+    char name[MAX_DEVICE_NAME];
+    const char *device_name = GPUINFO_STATIC_FIELD_VALID(&_gpu_info->static_info, device_name)
+                                  ? _gpu_info->static_info.device_name
+                                  : "N/A";
+    int printed = snprintf(name, sizeof(name), "%s: ", connection->host);
+    if (printed > 0 && (size_t)printed < sizeof(name))
+      strncpy(&name[printed], device_name, sizeof(name) - (size_t)printed - 1);
+    name[sizeof(name) - 1] = '\0';
+    memcpy(_gpu_info->static_info.device_name, name, sizeof(name));
+    SET_VALID(gpuinfo_device_name_valid, _gpu_info->static_info.valid);
+  }
+}
+
+static void gpuinfo_collector_refresh_dynamic_info(struct gpu_info *_gpu_info) {
+  struct gpu_info_collector *gpu_info = container_of(_gpu_info, struct gpu_info_collector, base);
+  // The devices are refreshed in order, going back to a lower device means a new refresh round started. Everything
+  // received since the last round is applied at once, without waiting.
+  if (!refreshed_once || gpu_info->number <= last_refreshed_device)
+    client_process_events(0);
+  refreshed_once = true;
+  last_refreshed_device = gpu_info->number;
+  const struct collector_device *device = collector_device_of(gpu_info);
+  if (device)
+    _gpu_info->dynamic_info = device->dynamic_info;
+  else
+    RESET_ALL(_gpu_info->dynamic_info.valid);
+}
+
+static void gpuinfo_collector_get_running_processes(struct gpu_info *_gpu_info) {
+  struct gpu_info_collector *gpu_info = container_of(_gpu_info, struct gpu_info_collector, base);
+  for (unsigned i = 0; i < gpu_info->owned_strings_count; ++i) {
+    free(_gpu_info->processes[i].cmdline);
+    free(_gpu_info->processes[i].user_name);
+  }
+  gpu_info->owned_strings_count = 0;
+  const struct collector_device *device = collector_device_of(gpu_info);
+  if (!device)
+    return;
+  if (device->processes_count > _gpu_info->processes_array_size) {
+    _gpu_info->processes_array_size = device->processes_count + COMMON_PROCESS_LINEAR_REALLOC_INC;
+    _gpu_info->processes =
+        reallocarray(_gpu_info->processes, _gpu_info->processes_array_size, sizeof(*_gpu_info->processes));
+    if (!_gpu_info->processes) {
+      perror("Could not re-allocate memory: ");
+      exit(EXIT_FAILURE);
+    }
+  }
+  memcpy(_gpu_info->processes, device->processes, device->processes_count * sizeof(*device->processes));
+  _gpu_info->processes_count = device->processes_count;
+  // The snapshot strings do not outlive the next received message, which may come while the processes are frozen.
+  // The processes of a local daemon get theirs from the process cache instead.
+  for (unsigned i = 0; i < device->processes_count; ++i) {
+    struct gpu_process *process = &_gpu_info->processes[i];
+    if (gpu_info->connection->host) {
+      process->cmdline = process->cmdline ? strdup(process->cmdline) : NULL;
+      process->user_name = process->user_name ? strdup(process->user_name) : NULL;
+    } else {
+      process->cmdline = NULL;
+      process->user_name = NULL;
+      RESET_GPUINFO_PROCESS(process, cmdline);
+      RESET_GPUINFO_PROCESS(process, user_name);
+    }
+  }
+  if (gpu_info->connection->host)
+    gpu_info->owned_strings_count = device->processes_count;
+}
@@ -0,0 +1,776 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "nvtop/collector.h"
+#include "nvtop/common.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define COLLECTOR_BUFFER_MIN_CAPACITY 4096
+#define COLLECTOR_MAX_STRING_LENGTH UINT16_MAX
+
+// The enums are sent as unsigned values
+_Static_assert(sizeof(enum gpu_process_type) == sizeof(unsigned), "Unexpected enum size");
+_Static_assert(sizeof(enum gpu_process_starvation) == sizeof(unsigned), "Unexpected enum size");
+_Static_assert(sizeof(enum host_locality) == sizeof(unsigned), "Unexpected enum size");
+
+void collector_buffer_append(struct collector_buffer *buffer, const void *data, size_t size) {
+  if (buffer->size + size > buffer->capacity) {
+    size_t new_capacity = buffer->capacity ? buffer->capacity : COLLECTOR_BUFFER_MIN_CAPACITY;
+    while (buffer->size + size > new_capacity)
+      new_capacity *= 2;
+    buffer->data = reallocarray(buffer->data, new_capacity, 1);
+    if (!buffer->data) {
+      perror("Could not re-allocate memory: ");
+      exit(EXIT_FAILURE);
+    }
+    buffer->capacity = new_capacity;
+  }
+  memcpy(buffer->data + buffer->size, data, size);
+  buffer->size += size;
+}
+
+void collector_buffer_free(struct collector_buffer *buffer) {
+  free(buffer->data);
+  buffer->data = NULL;
+  buffer->size = 0;
+  buffer->capacity = 0;
+}
+
+static void store_le(char *data, uint64_t value, unsigned bytes) {
+  for (unsigned i = 0; i < bytes; ++i)
+    data[i] = (char)(unsigned char)(value >> (8 * i));
+}
+
+static uint64_t load_le(const char *data, unsigned bytes) {
+  uint64_t value = 0;
+  for (unsigned i = 0; i < bytes; ++i)
+    value |= (uint64_t)(unsigned char)data[i] << (8 * i);
+  return value;
+}
+
+static void buffer_append_le(struct collector_buffer *buffer, uint64_t value, unsigned bytes) {
+  char data[sizeof(value)];
+  store_le(data, value, bytes);
+  collector_buffer_append(buffer, data, bytes);
+}
+
+static void buffer_append_text(struct collector_buffer *buffer, const char *text, size_t max_length) {
+  size_t length = text ? strnlen(text, max_length) : 0;
+  buffer_append_le(buffer, length, 2);
+  collector_buffer_append(buffer, text, length);
+}
+
+void collector_encode_header(enum collector_message_type type, uint32_t length, char header[COLLECTOR_HEADER_SIZE]) {
+  store_le(header, COLLECTOR_PROTOCOL_MAGIC, 4);
+  store_le(header + 4, COLLECTOR_PROTOCOL_VERSION, 2);
+  store_le(header + 6, type, 2);
+  store_le(header + 8, length, 4);
+}
+
+void collector_decode_header(const char data[COLLECTOR_HEADER_SIZE], struct collector_message_header *header) {
+  header->magic = (uint32_t)load_le(data, 4);
+  header->version = (uint16_t)load_le(data + 4, 2);
+  header->type = (uint16_t)load_le(data + 6, 2);
+  header->length = (uint32_t)load_le(data + 8, 4);
+}
+
+void collector_encode_request(enum collector_message_type type, uint64_t sequence,
+                              char request[COLLECTOR_REQUEST_SIZE]) {
+  collector_encode_header(type, COLLECTOR_REQUEST_SIZE - COLLECTOR_HEADER_SIZE, request);
+  store_le(request + COLLECTOR_HEADER_SIZE, sequence, 8);
+}
+
+uint64_t collector_request_sequence(const char request[COLLECTOR_REQUEST_SIZE]) {
+  return load_le(request + COLLECTOR_HEADER_SIZE, 8);
+}
+
+/*
+ *
+ * Field tables: how each member of the structures is compared and put on the wire
+ *
+ */
+
+enum wire_type {
+  wire_unsigned,  // unsigned, as a uint32_t
+  wire_ulong,     // unsigned long, as a uint64_t
+  wire_ullong,    // unsigned long long, as a uint64_t
+  wire_uint64,    // uint64_t
+  wire_int,       // int, as an int32_t
+  wire_pid,       // pid_t, as an int32_t
+  wire_bool,      // bool, as a uint8_t
+  wire_double,    // double, its bits as a uint64_t
+  wire_enum,      // enum, as a uint32_t below bound
+  wire_text,      // char[bound], as a uint16_t length and the characters
+  wire_host_mask, // struct host_mask, as uint64_t words
+  wire_string,    // char *, as a uint16_t length and the characters, owned by the decoded structures
+};
+
+struct wire_field {
+  size_t offset;
+  enum wire_type type;
+  int valid; // Valid bit of the field, -1 for the fields always valid
+  unsigned bound;
+};
+
+struct wire_record {
+  const struct wire_field *fields;
+  unsigned count;
+  size_t valid_offset;
+};
+
+#define STATIC_FIELD(field, type, valid, bound) {offsetof(struct gpuinfo_static_info, field), type, valid, bound}
+#define DYNAMIC_FIELD(field, type) {offsetof(struct gpuinfo_dynamic_info, field), type, gpuinfo_##field##_valid, 0}
+#define PROCESS_FIELD(field, type, bound)                                                                              \
+  {offsetof(struct gpu_process, field), type, gpuinfo_process_##field##_valid, bound}
+
+static const struct wire_field static_fields[] = {
+    STATIC_FIELD(device_name, wire_text, gpuinfo_device_name_valid, MAX_DEVICE_NAME),
+    STATIC_FIELD(max_pcie_gen, wire_unsigned, gpuinfo_max_pcie_gen_valid, 0),
+    STATIC_FIELD(max_pcie_link_width, wire_unsigned, gpuinfo_max_pcie_link_width_valid, 0),
+    STATIC_FIELD(temperature_shutdown_threshold, wire_unsigned, gpuinfo_temperature_shutdown_threshold_valid, 0),
+    STATIC_FIELD(temperature_slowdown_threshold, wire_unsigned, gpuinfo_temperature_slowdown_threshold_valid, 0),
+    STATIC_FIELD(n_shared_cores, wire_unsigned, gpuinfo_n_shared_cores_valid, 0),
+    STATIC_FIELD(l2cache_size, wire_unsigned, gpuinfo_l2cache_size_valid, 0),
+    STATIC_FIELD(n_exec_engines, wire_unsigned, gpuinfo_n_exec_engines_valid, 0),
+    STATIC_FIELD(integrated_graphics, wire_bool, -1, 0),
+    STATIC_FIELD(encode_decode_shared, wire_bool, -1, 0),
+    STATIC_FIELD(numa_node, wire_int, gpuinfo_numa_node_valid, 0),
+    STATIC_FIELD(local_cpus, wire_host_mask, gpuinfo_numa_node_valid, 0),
+};
+
+static const struct wire_field dynamic_fields[] = {
+    DYNAMIC_FIELD(gpu_clock_speed, wire_unsigned),     DYNAMIC_FIELD(gpu_clock_speed_max, wire_unsigned),
+    DYNAMIC_FIELD(mem_clock_speed, wire_unsigned),     DYNAMIC_FIELD(mem_clock_speed_max, wire_unsigned),
+    DYNAMIC_FIELD(gpu_util_rate, wire_unsigned),       DYNAMIC_FIELD(mem_util_rate, wire_unsigned),
+    DYNAMIC_FIELD(encoder_rate, wire_unsigned),        DYNAMIC_FIELD(decoder_rate, wire_unsigned),
+    DYNAMIC_FIELD(total_memory, wire_ullong),          DYNAMIC_FIELD(free_memory, wire_ullong),
+    DYNAMIC_FIELD(used_memory, wire_ullong),           DYNAMIC_FIELD(pcie_link_gen, wire_unsigned),
+    DYNAMIC_FIELD(pcie_link_width, wire_unsigned),     DYNAMIC_FIELD(pcie_rx, wire_unsigned),
+    DYNAMIC_FIELD(pcie_tx, wire_unsigned),             DYNAMIC_FIELD(fan_speed, wire_unsigned),
+    DYNAMIC_FIELD(fan_rpm, wire_unsigned),             DYNAMIC_FIELD(gpu_temp, wire_unsigned),
+    DYNAMIC_FIELD(power_draw, wire_unsigned),          DYNAMIC_FIELD(power_draw_max, wire_unsigned),
+    DYNAMIC_FIELD(multi_instance_mode, wire_bool),     DYNAMIC_FIELD(energy_counter, wire_ullong),
+    DYNAMIC_FIELD(energy_consumed, wire_ullong),       DYNAMIC_FIELD(throttle_reasons, wire_unsigned),
+};
+
+static const struct wire_field process_fields[] = {
+    {offsetof(struct gpu_process, type), wire_enum, -1, gpu_process_type_count},
+    PROCESS_FIELD(cmdline, wire_string, 0),
+    PROCESS_FIELD(user_name, wire_string, 0),
+    PROCESS_FIELD(gfx_engine_used, wire_uint64, 0),
+    PROCESS_FIELD(compute_engine_used, wire_uint64, 0),
+    PROCESS_FIELD(enc_engine_used, wire_uint64, 0),
+    PROCESS_FIELD(dec_engine_used, wire_uint64, 0),
+    PROCESS_FIELD(gpu_usage, wire_unsigned, 0),
+    PROCESS_FIELD(encode_usage, wire_unsigned, 0),
+    PROCESS_FIELD(decode_usage, wire_unsigned, 0),
+    PROCESS_FIELD(gpu_memory_usage, wire_ullong, 0),
+    PROCESS_FIELD(gpu_memory_percentage, wire_unsigned, 0),
+    PROCESS_FIELD(cpu_usage, wire_unsigned, 0),
+    PROCESS_FIELD(cpu_memory_virt, wire_ulong, 0),
+    PROCESS_FIELD(cpu_memory_res, wire_ulong, 0),
+    PROCESS_FIELD(gpu_cycles, wire_uint64, 0),
+    PROCESS_FIELD(sample_delta, wire_uint64, 0),
+    PROCESS_FIELD(parent_pid, wire_pid, 0),
+    PROCESS_FIELD(cpu_io_wait, wire_unsigned, 0),
+    PROCESS_FIELD(voluntary_ctx_switches, wire_ulong, 0),
+    PROCESS_FIELD(involuntary_ctx_switches, wire_ulong, 0),
+    PROCESS_FIELD(io_read_rate, wire_ullong, 0),
+    PROCESS_FIELD(starvation, wire_enum, gpu_process_starvation_count),
+    PROCESS_FIELD(locality, wire_enum, host_locality_count),
+    PROCESS_FIELD(energy, wire_ullong, 0),
+    PROCESS_FIELD(gpu_time, wire_uint64, 0),
+    PROCESS_FIELD(gpu_memory_peak, wire_ullong, 0),
+    PROCESS_FIELD(gpu_usage_average, wire_unsigned, 0),
+    PROCESS_FIELD(idle_time, wire_uint64, 0),
+    PROCESS_FIELD(idle_memory_time, wire_double, 0),
+    PROCESS_FIELD(gpu_memory_growth, wire_double, 0),
+    PROCESS_FIELD(time_to_oom, wire_double, 0),
+    PROCESS_FIELD(namespace_pid, wire_pid, 0),
+    PROCESS_FIELD(cgroup, wire_text, PROCESS_CGROUP_LABEL_LEN),
+    PROCESS_FIELD(job_id, wire_text, PROCESS_JOB_ID_LEN),
+};
+
+_Static_assert(sizeof(dynamic_fields) / sizeof(*dynamic_fields) == gpuinfo_dynamic_info_count,
+               "Every dynamic field must be sent");
+_Static_assert(sizeof(process_fields) / sizeof(*process_fields) == COLLECTOR_PROCESS_FIELDS,
+               "Every process field must be sent");
+
+#define WIRE_RECORD(fields, type) {fields, sizeof(fields) / sizeof(*fields), offsetof(type, valid)}
+
+static const struct wire_record static_record = WIRE_RECORD(static_fields, struct gpuinfo_static_info);
+static const struct wire_record dynamic_record = WIRE_RECORD(dynamic_fields, struct gpuinfo_dynamic_info);
+static const struct wire_record process_record = WIRE_RECORD(process_fields, struct gpu_process);
+
+static size_t field_size(const struct wire_field *field) {
+  switch (field->type) {
+  case wire_unsigned:
+  case wire_enum:
+    return sizeof(unsigned);
+  case wire_ulong:
+    return sizeof(unsigned long);
+  case wire_ullong:
+    return sizeof(unsigned long long);
+  case wire_uint64:
+    return sizeof(uint64_t);
+  case wire_int:
+    return sizeof(int);
+  case wire_pid:
+    return sizeof(pid_t);
+  case wire_bool:
+    return sizeof(bool);
+  case wire_double:
+    return sizeof(double);
+  case wire_text:
+    return field->bound;
+  case wire_host_mask:
+    return sizeof(struct host_mask);
+  case wire_string:
+  default:
+    return sizeof(char *);
+  }
+}
+
+static bool field_is_valid(const struct wire_record *record, const struct wire_field *field, const void *data) {
+  const unsigned char *valid = (const unsigned char *)data + record->valid_offset;
+  return field->valid < 0 || IS_VALID(field->valid, valid);
+}
+
+static void field_set_valid(const struct wire_record *record, const struct wire_field *field, void *data,
+                            bool is_valid) {
+  unsigned char *valid = (unsigned char *)data + record->valid_offset;
+  if (field->valid < 0)
+    return;
+  if (is_valid)
+    SET_VALID(field->valid, valid);
+  else
+    RESET_VALID(field->valid, valid);
+}
+
+static bool field_equal(const struct wire_record *record, const struct wire_field *field, const void *data1,
+                        const void *data2) {
+  bool valid1 = field_is_valid(record, field, data1), valid2 = field_is_valid(record, field, data2);
+  if (valid1 != valid2)
+    return false;
+  if (!valid1)
+    return true;
+  const char *value1 = (const char *)data1 + field->offset, *value2 = (const char *)data2 + field->offset;
+  switch (field->type) {
+  case wire_text:
+    return strncmp(value1, value2, field->bound) == 0;
+  case wire_string: {
+    const char *string1, *string2;
+    memcpy(&string1, value1, sizeof(string1));
+    memcpy(&string2, value2, sizeof(string2));
+    return (!string1 && !string2) || (string1 && string2 && strcmp(string1, string2) == 0);
+  }
+  default:
+    return memcmp(value1, value2, field_size(field)) == 0;
+  }
+}
+
+static void field_copy(const struct wire_record *record, const struct wire_field *field, void *destination,
+                       const void *source) {
+  bool valid = field_is_valid(record, field, source);
+  field_set_valid(record, field, destination, valid);
+  char *to = (char *)destination + field->offset;
+  const char *from = (const char *)source + field->offset;
+  if (field->type != wire_string) {
+    memcpy(to, from, field_size(field));
+    return;
+  }
+  char *string;
+  memcpy(&string, to, sizeof(string));
+  free(string);
+  string = NULL;
+  if (valid) {
+    const char *source_string;
+    memcpy(&source_string, from, sizeof(source_string));
+    if (source_string) {
+      string = strdup(source_string);
+      if (!string) {
+        perror("Cannot allocate memory: ");
+        exit(EXIT_FAILURE);
+      }
+    }
+  }
+  memcpy(to, &string, sizeof(string));
+}
+
+static void field_encode(struct collector_buffer *buffer, const struct wire_field *field, const void *data) {
+  const char *value = (const char *)data + field->offset;
+  switch (field->type) {
+  case wire_unsigned:
+  case wire_enum: {
+    unsigned number;
+    memcpy(&number, value, sizeof(number));
+    buffer_append_le(buffer, number, 4);
+  } break;
+  case wire_ulong: {
+    unsigned long number;
+    memcpy(&number, value, sizeof(number));
+    buffer_append_le(buffer, number, 8);
+  } break;
+  case wire_ullong: {
+    unsigned long long number;
+    memcpy(&number, value, sizeof(number));
+    buffer_append_le(buffer, number, 8);
+  } break;
+  case wire_uint64: {
+    uint64_t number;
+    memcpy(&number, value, sizeof(number));
+    buffer_append_le(buffer, number, 8);
+  } break;
+  case wire_int: {
+    int number;
+    memcpy(&number, value, sizeof(number));
+    buffer_append_le(buffer, (uint32_t)(int32_t)number, 4);
+  } break;
+  case wire_pid: {
+    pid_t number;
+    memcpy(&number, value, sizeof(number));
+    buffer_append_le(buffer, (uint32_t)(int32_t)number, 4);
+  } break;
+  case wire_bool: {
+    bool boolean;
+    memcpy(&boolean, value, sizeof(boolean));
+    buffer_append_le(buffer, boolean, 1);
+  } break;
+  case wire_double: {
+    uint64_t bits;
+    memcpy(&bits, value, sizeof(bits));
+    buffer_append_le(buffer, bits, 8);
+  } break;
+  case wire_text:
+    buffer_append_text(buffer, value, field->bound - 1);
+    break;
+  case wire_host_mask: {
+    struct host_mask mask;
+    memcpy(&mask, value, sizeof(mask));
+    for (unsigned i = 0; i < sizeof(mask.bits) / sizeof(*mask.bits); ++i)
+      buffer_append_le(buffer, mask.bits[i], 8);
+  } break;
+  case wire_string: {
+    const char *string;
+    memcpy(&string, value, sizeof(string));
+    buffer_append_text(buffer, string, COLLECTOR_MAX_STRING_LENGTH);
+  } break;
+  }
+}
+
+// Appends the fields that changed after since, or all of them when changes is NULL
+static void fields_encode(struct collector_buffer *buffer, const struct wire_record *record, const void *data,
+                          const uint64_t *changes, uint64_t since) {
+  size_t count_offset = buffer->size;
+  unsigned count = 0;
+  buffer_append_le(buffer, 0, 1);
+  for (unsigned i = 0; i < record->count; ++i) {
+    if (changes && changes[i] <= since)
+      continue;
+    const struct wire_field *field = &record->fields[i];
+    bool valid = field_is_valid(record, field, data);
+    buffer_append_le(buffer, i, 1);
+    buffer_append_le(buffer, valid, 1);
+    if (valid)
+      field_encode(buffer, field, data);
+    count++;
+  }
+  buffer->data[count_offset] = (char)count;
+}
+
+static void device_history_free_process(struct collector_process_history *process) {
+  free(process->process.cmdline);
+  free(process->process.user_name);
+  process->process.cmdline = NULL;
+  process->process.user_name = NULL;
+}
+
+// The processes mostly come in the same order from one refresh to the next
+// entries start with a struct gpu_process and are stride bytes apart
+static unsigned find_process(const void *entries, unsigned count, size_t stride, pid_t pid, unsigned hint) {
+  for (unsigned i = 0; i < count; ++i) {
+    unsigned index = (hint + i) % count;
+    const struct gpu_process *process = (const struct gpu_process *)((const char *)entries + index * stride);
+    if (process->pid == pid)
+      return index;
+  }
+  return count;
+}
+
+void collector_device_history_update(struct collector_device_history *history, const struct gpu_info *device,
+                                     uint64_t sequence) {
+  for (unsigned i = 0; i < dynamic_record.count; ++i) {
+    const struct wire_field *field = &dynamic_record.fields[i];
+    if (!field_equal(&dynamic_record, field, &history->dynamic_info, &device->dynamic_info)) {
+      field_copy(&dynamic_record, field, &history->dynamic_info, &device->dynamic_info);
+      history->dynamic_changes[i] = sequence;
+      history->dynamic_changed = sequence;
+    }
+  }
+
+  struct collector_process_history *processes = NULL;
+  if (device->processes_count) {
+    processes = calloc(device->processes_count, sizeof(*processes));
+    if (!processes) {
+      perror("Cannot allocate memory: ");
+      exit(EXIT_FAILURE);
+    }
+  }
+  for (unsigned i = 0; i < device->processes_count; ++i) {
+    const struct gpu_process *current = &device->processes[i];
+    struct collector_process_history *process = &processes[i];
+    unsigned previous = find_process(history->processes, history->processes_count,
+                                     sizeof(*history->processes), current->pid, i);
+    if (previous < history->processes_count) {
+      *process = history->processes[previous];
+      // Taken over, the strings now belong to the new entry
+      history->processes[previous].process.pid = -1;
+      history->processes[previous].process.cmdline = NULL;
+      history->processes[previous].process.user_name = NULL;
+      if (previous != i)
+        history->processes_changed = sequence;
+    } else {
+      process->process.pid = current->pid;
+      process->added = sequence;
+      history->processes_changed = sequence;
+    }
+    for (unsigned j = 0; j < process_record.count; ++j) {
+      const struct wire_field *field = &process_record.fields[j];
+      if (process->added == sequence || !field_equal(&process_record, field, &process->process, current)) {
+        field_copy(&process_record, field, &process->process, current);
+        process->changes[j] = sequence;
+        history->processes_changed = sequence;
+      }
+    }
+  }
+  for (unsigned i = 0; i < history->processes_count; ++i) {
+    if (history->processes[i].process.pid != -1) {
+      device_history_free_process(&history->processes[i]);
+      history->processes_changed = sequence;
+    }
+  }
+  free(history->processes);
+  history->processes = processes;
+  history->processes_count = device->processes_count;
+}
+
+void collector_device_history_free(struct collector_device_history *history) {
+  for (unsigned i = 0; i < history->processes_count; ++i)
+    device_history_free_process(&history->processes[i]);
+  free(history->processes);
+  history->processes = NULL;
+  history->processes_count = 0;
+}
+
+static uint32_t device_flags(const struct collector_device_history *history, uint64_t client_sequence) {
+  if (client_sequence == 0)
+    return COLLECTOR_DEVICE_HAS_STATIC_INFO | COLLECTOR_DEVICE_HAS_DYNAMIC_INFO | COLLECTOR_DEVICE_HAS_PROCESSES;
+  uint32_t flags = 0;
+  if (history->dynamic_changed > client_sequence)
+    flags |= COLLECTOR_DEVICE_HAS_DYNAMIC_INFO;
+  if (history->processes_changed > client_sequence)
+    flags |= COLLECTOR_DEVICE_HAS_PROCESSES;
+  return flags;
+}
+
+void collector_encode_snapshot(unsigned devices_count, struct gpu_info *const *devices,
+                               const struct collector_device_history *histories, uint64_t sequence,
+                               uint64_t client_sequence, struct collector_buffer *buffer) {
+  buffer->size = 0;
+  buffer_append_le(buffer, sequence, 8);
+  buffer_append_le(buffer, devices_count, 4);
+
+  uint32_t included = 0;
+  for (unsigned i = 0; i < devices_count; ++i) {
+    if (device_flags(&histories[i], client_sequence))
+      included++;
+  }
+  buffer_append_le(buffer, included, 4);
+
+  for (unsigned i = 0; i < devices_count; ++i) {
+    uint32_t flags = device_flags(&histories[i], client_sequence);
+    if (!flags)
+      continue;
+    const struct collector_device_history *history = &histories[i];
+    const uint64_t *dynamic_changes = client_sequence ? history->dynamic_changes : NULL;
+    buffer_append_le(buffer, i, 4);
+    buffer_append_le(buffer, flags, 1);
+    buffer_append_text(buffer, devices[i]->pdev, PDEV_LEN - 1);
+    if (flags & COLLECTOR_DEVICE_HAS_STATIC_INFO)
+      fields_encode(buffer, &static_record, &devices[i]->static_info, NULL, 0);
+    if (flags & COLLECTOR_DEVICE_HAS_DYNAMIC_INFO)
+      fields_encode(buffer, &dynamic_record, &history->dynamic_info, dynamic_changes, client_sequence);
+    if (!(flags & COLLECTOR_DEVICE_HAS_PROCESSES))
+      continue;
+    buffer_append_le(buffer, history->processes_count, 4);
+    for (unsigned j = 0; j < history->processes_count; ++j) {
+      const struct collector_process_history *process = &history->processes[j];
+      // A process unknown to the client may reuse the pid of one it knows, all its fields are sent
+      bool is_new = process->added > client_sequence;
+      buffer_append_le(buffer, (uint32_t)(int32_t)process->process.pid, 4);
+      fields_encode(buffer, &process_record, &process->process, is_new ? NULL : process->changes, client_sequence);
+    }
+  }
+}
+
+struct payload_reader {
+  const char *data;
+  size_t length;
+  size_t offset;
+};
+
+static bool read_le(struct payload_reader *reader, unsigned bytes, uint64_t *value) {
+  if (reader->length - reader->offset < bytes)
+    return false;
+  *value = load_le(reader->data + reader->offset, bytes);
+  reader->offset += bytes;
+  return true;
+}
+
+// Reads a text into a buffer of size characters, always NUL terminated
+static bool read_text(struct payload_reader *reader, char *text, size_t size) {
+  uint64_t length;
+  if (!read_le(reader, 2, &length) || length >= size || reader->length - reader->offset < length)
+    return false;
+  memcpy(text, reader->data + reader->offset, length);
+  text[length] = '\0';
+  reader->offset += length;
+  return true;
+}
+
+static bool field_decode(struct payload_reader *reader, const struct wire_field *field, void *data) {
+  char *value = (char *)data + field->offset;
+  uint64_t number;
+  switch (field->type) {
+  case wire_unsigned:
+  case wire_enum: {
+    if (!read_le(reader, 4, &number) || (field->type == wire_enum && number >= field->bound))
+      return false;
+    unsigned converted = (unsigned)number;
+    memcpy(value, &converted, sizeof(converted));
+  } break;
+  case wire_ulong: {
+    if (!read_le(reader, 8, &number))
+      return false;
+    unsigned long converted = (unsigned long)number;
+    memcpy(value, &converted, sizeof(converted));
+  } break;
+  case wire_ullong: {
+    if (!read_le(reader, 8, &number))
+      return false;
+    unsigned long long converted = number;
+    memcpy(value, &converted, sizeof(converted));
+  } break;
+  case wire_uint64:
+  case wire_double:
+    if (!read_le(reader, 8, &number))
+      return false;
+    memcpy(value, &number, sizeof(number));
+    break;
+  case wire_int: {
+    if (!read_le(reader, 4, &number))
+      return false;
+    int converted = (int32_t)(uint32_t)number;
+    memcpy(value, &converted, sizeof(converted));
+  } break;
+  case wire_pid: {
+    if (!read_le(reader, 4, &number))
+      return false;
+    pid_t converted = (int32_t)(uint32_t)number;
+    memcpy(value, &converted, sizeof(converted));
+  } break;
+  case wire_bool: {
+    if (!read_le(reader, 1, &number) || number > 1)
+      return false;
+    bool converted = number;
+    memcpy(value, &converted, sizeof(converted));
+  } break;
+  case wire_text:
+    return read_text(reader, value, field->bound);
+  case wire_host_mask: {
+    struct host_mask mask;
+    for (unsigned i = 0; i < sizeof(mask.bits) / sizeof(*mask.bits); ++i) {
+      if (!read_le(reader, 8, &number))
+        return false;
+      mask.bits[i] = number;
+    }
+    memcpy(value, &mask, sizeof(mask));
+  } break;
+  case wire_string: {
+    char *string;
+    memcpy(&string, value, sizeof(string));
+    free(string);
+    string = NULL;
+    memcpy(value, &string, sizeof(string));
+    if (!read_le(reader, 2, &number) || reader->length - reader->offset < number)
+      return false;
+    string = malloc(number + 1);
+    if (!string) {
+      perror("Cannot allocate memory: ");
+      exit(EXIT_FAILURE);
+    }
+    memcpy(string, reader->data + reader->offset, number);
+    string[number] = '\0';
+    reader->offset += number;
+    memcpy(value, &string, sizeof(string));
+  } break;
+  }
+  return true;
+}
+
+static bool fields_decode(struct payload_reader *reader, const struct wire_record *record, void *data) {
+  uint64_t count;
+  if (!read_le(reader, 1, &count))
+    return false;
+  for (uint64_t i = 0; i < count; ++i) {
+    uint64_t index, valid;
+    if (!read_le(reader, 1, &index) || index >= record->count || !read_le(reader, 1, &valid) || valid > 1)
+      return false;
+    const struct wire_field *field = &record->fields[index];
+    if (field->valid < 0 && !valid)
+      return false;
+    if (valid) {
+      if (!field_decode(reader, field, data))
+        return false;
+    } else if (field->type == wire_string) {
+      char *string;
+      memcpy(&string, (char *)data + field->offset, sizeof(string));
+      free(string);
+      string = NULL;
+      memcpy((char *)data + field->offset, &string, sizeof(string));
+    }
+    field_set_valid(record, field, data, valid);
+  }
+  return true;
+}
+
+static void collector_device_free_processes(struct collector_device *device) {
+  for (unsigned i = 0; i < device->processes_count; ++i) {
+    free(device->processes[i].cmdline);
+    free(device->processes[i].user_name);
+  }
+  free(device->processes);
+  device->processes = NULL;
+  device->processes_count = 0;
+}
+
+// Process entries are 4 bytes of pid and at least one byte of fields
+#define COLLECTOR_MIN_PROCESS_SIZE 5
+#define COLLECTOR_MIN_DEVICE_SIZE 7
+
+static bool decode_processes(struct payload_reader *reader, struct collector_device *device) {
+  uint64_t processes_count;
+  if (!read_le(reader, 4, &processes_count) ||
+      (reader->length - reader->offset) / COLLECTOR_MIN_PROCESS_SIZE < processes_count)
+    return false;
+  struct gpu_process *processes = NULL;
+  if (processes_count) {
+    processes = calloc(processes_count, sizeof(*processes));
+    if (!processes) {
+      perror("Cannot allocate memory: ");
+      exit(EXIT_FAILURE);
+    }
+  }
+  bool success = true;
+  unsigned decoded = 0;
+  for (; success && decoded < processes_count; ++decoded) {
+    uint64_t pid;
+    struct gpu_process *process = &processes[decoded];
+    if (!read_le(reader, 4, &pid)) {
+      success = false;
+      break;
+    }
+    // Start over from what the client knows about this process
+    pid_t process_pid = (int32_t)(uint32_t)pid;
+    unsigned previous =
+        find_process(device->processes, device->processes_count, sizeof(*device->processes), process_pid, decoded);
+    if (previous < device->processes_count) {
+      *process = device->processes[previous];
+      device->processes[previous].pid = -1;
+      device->processes[previous].cmdline = NULL;
+      device->processes[previous].user_name = NULL;
+    } else {
+      process->pid = process_pid;
+    }
+    success = fields_decode(reader, &process_record, process);
+  }
+  collector_device_free_processes(device);
+  device->processes = processes;
+  device->processes_count = decoded;
+  return success;
+}
+
+bool collector_decode_snapshot(const char *payload, size_t length, struct collector_snapshot *snapshot) {
+  struct payload_reader reader = {.data = payload, .length = length, .offset = 0};
+  uint64_t sequence, devices_count, included;
+  if (!read_le(&reader, 8, &sequence) || !read_le(&reader, 4, &devices_count) || !read_le(&reader, 4, &included))
+    return false;
+  // Bounded before allocating anything, each included device takes at least its index, flags and empty address
+  if (devices_count > COLLECTOR_MAX_DEVICES || included > devices_count ||
+      (reader.length - reader.offset) / COLLECTOR_MIN_DEVICE_SIZE < included)
+    return false;
+
+  if (devices_count != snapshot->devices_count) {
+    collector_snapshot_free(snapshot);
+    if (devices_count) {
+      snapshot->devices = calloc(devices_count, sizeof(*snapshot->devices));
+      if (!snapshot->devices) {
+        perror("Cannot allocate memory: ");
+        exit(EXIT_FAILURE);
+      }
+    }
+    snapshot->devices_count = devices_count;
+  }
+
+  for (uint64_t i = 0; i < included; ++i) {
+    uint64_t index, flags;
+    if (!read_le(&reader, 4, &index) || !read_le(&reader, 1, &flags) || index >= devices_count)
+      return false;
+    struct collector_device *device = &snapshot->devices[index];
+    if (!read_text(&reader, device->pdev, PDEV_LEN))
+      return false;
+    if (flags & COLLECTOR_DEVICE_HAS_STATIC_INFO) {
+      memset(&device->static_info, 0, sizeof(device->static_info));
+      if (!fields_decode(&reader, &static_record, &device->static_info))
+        return false;
+      device->has_static_info = true;
+    }
+    if ((flags & COLLECTOR_DEVICE_HAS_DYNAMIC_INFO) && !fields_decode(&reader, &dynamic_record, &device->dynamic_info))
+      return false;
+    if ((flags & COLLECTOR_DEVICE_HAS_PROCESSES) && !decode_processes(&reader, device))
+      return false;
+  }
+  snapshot->sequence = sequence;
+  return true;
+}
+
+void collector_snapshot_free(struct collector_snapshot *snapshot) {
+  for (unsigned i = 0; i < snapshot->devices_count; ++i)
+    collector_device_free_processes(&snapshot->devices[i]);
+  free(snapshot->devices);
+  snapshot->devices = NULL;
+  snapshot->devices_count = 0;
+  snapshot->sequence = 0;
+}
@@ -0,0 +1,240 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "nvtop/device_topology.h"
+
+#include <ctype.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+extern inline const struct topology_pair *device_topology_pair(const struct device_topology *topology, unsigned dev1,
+                                                               unsigned dev2);
+
+#define TOPOLOGY_MAX_PATH_DEPTH 32
+// Enough for NVML_NVLINK_MAX_LINKS
+#define TOPOLOGY_MAX_PEER_LINKS 32
+
+struct path_component {
+  const char *name;
+  size_t length;
+};
+
+// Splits a sysfs device path into the PCIe root ("pciDDDD:BB") followed by the bridges and the device itself
+static unsigned split_pcie_path(const char *path, struct path_component components[TOPOLOGY_MAX_PATH_DEPTH]) {
+  unsigned count = 0;
+  const char *current = path;
+  while (*current != '\0' && count < TOPOLOGY_MAX_PATH_DEPTH) {
+    while (*current == '/')
+      current++;
+    if (*current == '\0')
+      break;
+    size_t length = strcspn(current, "/");
+    if (count > 0 || strncmp(current, "pci", 3) == 0) {
+      components[count].name = current;
+      components[count].length = length;
+      count++;
+    }
+    current += length;
+  }
+  return count;
+}
+
+static bool path_component_equal(const struct path_component *comp1, const struct path_component *comp2) {
+  return comp1->length == comp2->length && strncmp(comp1->name, comp2->name, comp1->length) == 0;
+}
+
+enum topology_link topology_pcie_link_between(const char *path1, int node1, const char *path2, int node2) {
+  struct path_component components1[TOPOLOGY_MAX_PATH_DEPTH], components2[TOPOLOGY_MAX_PATH_DEPTH];
+  unsigned count1 = split_pcie_path(path1, components1);
+  unsigned count2 = split_pcie_path(path2, components2);
+  // At least a root and a device
+  if (count1 < 2 || count2 < 2)
+    return topology_link_unknown;
+  if (!path_component_equal(&components1[0], &components2[0]))
+    return node1 == node2 ? topology_link_numa_node : topology_link_system;
+
+  unsigned bridges1 = count1 - 2, bridges2 = count2 - 2;
+  unsigned common = 0;
+  while (common < bridges1 && common < bridges2 &&
+         path_component_equal(&components1[common + 1], &components2[common + 1]))
+    common++;
+  if (common == 0)
+    return topology_link_host_bridge;
+  if (bridges1 - common <= 1 && bridges2 - common <= 1)
+    return topology_link_pcie_switch;
+  return topology_link_pcie_bridges;
+}
+
+double topology_pcie_bandwidth(double speed, unsigned width) {
+  // 8b/10b encoding up to 5 GT/s, 128b/130b starting from 8 GT/s
+  double encoding = speed < 8. ? 8. / 10. : 128. / 130.;
+  return speed * encoding * width / 8.;
+}
+
+static bool read_sysfs_attribute(const char *dir, const char *attribute, char *buffer, size_t size) {
+  char path[PATH_MAX];
+  int written = snprintf(path, sizeof(path), "%s/%s", dir, attribute);
+  if (written < 0 || (size_t)written >= sizeof(path))
+    return false;
+  FILE *attribute_file = fopen(path, "r");
+  if (!attribute_file)
+    return false;
+  bool success = fgets(buffer, size, attribute_file) != NULL;
+  fclose(attribute_file);
+  return success;
+}
+
+static bool resolve_pci_device_path(const char *pdev, char resolved[PATH_MAX]) {
+  if (pdev[0] == '\0')
+    return false;
+  char link[64];
+  int written = snprintf(link, sizeof(link), "/sys/bus/pci/devices/%s", pdev);
+  if (written < 0 || (size_t)written >= sizeof(link))
+    return false;
+  // The sysfs PCI addresses are lower case while some drivers report them in upper case
+  for (char *c = link + strlen("/sys/bus/pci/devices/"); *c != '\0'; ++c)
+    *c = tolower(*c);
+  return realpath(link, resolved) != NULL;
+}
+
+// Smallest current link bandwidth from the device up to its root port, same walk as the PCIe link of the device
+// windows
+static double pcie_path_bandwidth(const char *resolved) {
+  char path[PATH_MAX];
+  strncpy(path, resolved, PATH_MAX - 1);
+  path[PATH_MAX - 1] = '\0';
+  double bandwidth = 0.;
+  char *last_component;
+  while ((last_component = strrchr(path, '/')) != NULL && strncmp(last_component + 1, "pci", 3) != 0) {
+    char speed_str[64], width_str[64];
+    double speed;
+    unsigned width;
+    if (read_sysfs_attribute(path, "current_link_speed", speed_str, sizeof(speed_str)) &&
+        read_sysfs_attribute(path, "current_link_width", width_str, sizeof(width_str)) &&
+        sscanf(speed_str, "%lf", &speed) == 1 && sscanf(width_str, "%u", &width) == 1 && width > 0) {
+      double link_bandwidth = topology_pcie_bandwidth(speed, width);
+      if (bandwidth <= 0. || link_bandwidth < bandwidth)
+        bandwidth = link_bandwidth;
+    }
+    *last_component = '\0';
+  }
+  return bandwidth;
+}
+
+void device_topology_compute(struct list_head *devices, struct device_topology *topology) {
+  unsigned devices_count = 0;
+  struct gpu_info *device;
+  list_for_each_entry(device, devices, list) { devices_count++; }
+
+  topology->devices_count = devices_count;
+  topology->pairs = NULL;
+  topology->pcie_bandwidth = NULL;
+  if (!devices_count)
+    return;
+  topology->pairs = calloc(devices_count * devices_count, sizeof(*topology->pairs));
+  topology->pcie_bandwidth = calloc(devices_count, sizeof(*topology->pcie_bandwidth));
+  struct gpu_info **device_array = calloc(devices_count, sizeof(*device_array));
+  char(*paths)[PATH_MAX] = calloc(devices_count, sizeof(*paths));
+  bool *has_path = calloc(devices_count, sizeof(*has_path));
+  unsigned long long *xgmi_hive = calloc(devices_count, sizeof(*xgmi_hive));
+  if (!topology->pairs || !topology->pcie_bandwidth || !device_array || !paths || !has_path || !xgmi_hive) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+
+  unsigned dev_id = 0;
+  list_for_each_entry(device, devices, list) {
+    device_array[dev_id] = device;
+    has_path[dev_id] = resolve_pci_device_path(device->pdev, paths[dev_id]);
+    if (has_path[dev_id]) {
+      topology->pcie_bandwidth[dev_id] = pcie_path_bandwidth(paths[dev_id]);
+      char hive_str[64];
+      // 0 when the device is not part of a hive
+      if (read_sysfs_attribute(paths[dev_id], "xgmi_hive_info/xgmi_hive_id", hive_str, sizeof(hive_str)))
+        xgmi_hive[dev_id] = strtoull(hive_str, NULL, 0);
+    }
+    dev_id++;
+  }
+
+  for (unsigned dev1 = 0; dev1 < devices_count; ++dev1) {
+    int node1 = GPUINFO_STATIC_FIELD_VALID(&device_array[dev1]->static_info, numa_node)
+                    ? device_array[dev1]->static_info.numa_node
+                    : -1;
+    for (unsigned dev2 = 0; dev2 < devices_count; ++dev2) {
+      struct topology_pair *pair = &topology->pairs[dev1 * devices_count + dev2];
+      int node2 = GPUINFO_STATIC_FIELD_VALID(&device_array[dev2]->static_info, numa_node)
+                      ? device_array[dev2]->static_info.numa_node
+                      : -1;
+      if (dev1 == dev2) {
+        pair->link = topology_link_self;
+      } else if (xgmi_hive[dev1] && xgmi_hive[dev1] == xgmi_hive[dev2]) {
+        pair->link = topology_link_xgmi;
+      } else if (has_path[dev1] && has_path[dev2]) {
+        pair->link = topology_pcie_link_between(paths[dev1], node1, paths[dev2], node2);
+        if (topology->pcie_bandwidth[dev1] > 0. && topology->pcie_bandwidth[dev2] > 0.)
+          pair->bandwidth = topology->pcie_bandwidth[dev1] < topology->pcie_bandwidth[dev2]
+                                ? topology->pcie_bandwidth[dev1]
+                                : topology->pcie_bandwidth[dev2];
+      } else {
+        pair->link = topology_link_unknown;
+      }
+    }
+  }
+
+  // Direct links take precedence over the PCIe path
+  struct gpu_peer_link links[TOPOLOGY_MAX_PEER_LINKS];
+  for (unsigned dev1 = 0; dev1 < devices_count; ++dev1) {
+    if (!device_array[dev1]->vendor->get_peer_links)
+      continue;
+    unsigned links_count =
+        device_array[dev1]->vendor->get_peer_links(device_array[dev1], TOPOLOGY_MAX_PEER_LINKS, links);
+    for (unsigned link = 0; link < links_count; ++link) {
+      for (unsigned dev2 = 0; dev2 < devices_count; ++dev2) {
+        if (dev2 == dev1 || strncasecmp(links[link].peer_pdev, device_array[dev2]->pdev, PDEV_LEN) != 0)
+          continue;
+        struct topology_pair *pair = &topology->pairs[dev1 * devices_count + dev2];
+        if (pair->link != topology_link_nvlink) {
+          pair->link = topology_link_nvlink;
+          pair->links_count = 0;
+          pair->bandwidth = 0.;
+        }
+        pair->links_count++;
+        pair->bandwidth += links[link].bandwidth;
+      }
+    }
+  }
+
+  free(device_array);
+  free(paths);
+  free(has_path);
+  free(xgmi_hive);
+}
+
+void device_topology_free(struct device_topology *topology) {
+  free(topology->pairs);
+  free(topology->pcie_bandwidth);
+  topology->pairs = NULL;
+  topology->pcie_bandwidth = NULL;
+  topology->devices_count = 0;
+}
@@ -21,6 +21,7 @@
 
 #include <assert.h>
 #include <ctype.h>
+#include <limits.h>
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -30,6 +31,7 @@
 #include "nvtop/extract_gpuinfo_common.h"
 #include "nvtop/extract_processinfo_fdinfo.h"
 #include "nvtop/get_process_info.h"
+#include "nvtop/memory_trend.h"
 #include "nvtop/time.h"
 #include "uthash.h"
 
@@ -42,9 +44,19 @@ const char drm_client_id[] = "drm-client-id";
 
 struct process_info_cache {
   pid_t pid;
+  unsigned long long start_time; // Tells the process from a later one reusing its pid
   char *cmdline;
   char *user_name;
+  char cgroup[PROCESS_CGROUP_LABEL_LEN];
+  char job_id[PROCESS_JOB_ID_LEN];
   double last_total_consumed_cpu_time;
+  double last_total_io_wait_time;
+  unsigned long last_voluntary_ctx_switches;
+  unsigned long last_involuntary_ctx_switches;
+  unsigned long long last_read_bytes;
+  bool last_io_wait_valid;
+  bool last_ctx_switches_valid;
+  bool last_read_bytes_valid;
   nvtop_time last_measurement_timestamp;
   UT_hash_handle hh;
 };
@@ -52,10 +64,50 @@ struct process_info_cache {
 struct process_info_cache *cached_process_info = NULL;
 struct process_info_cache *updated_process_info = NULL;
 
+// The same process on two devices is accounted separately, and a later process reusing its pid as well
+struct process_accounting_key {
+  const struct gpu_info *device;
+  pid_t pid;
+  unsigned long long start_time;
+};
+
+// Values accumulated over the observed lifetime of a process on a device
+struct process_accounting {
+  struct process_accounting_key key;
+  double energy;             // millijoules
+  uint64_t gpu_time;         // nanoseconds
+  uint64_t last_engine_time; // Sum of the engine time counters at the previous refresh
+  bool last_engine_time_valid;
+  unsigned long long gpu_memory_peak;
+  unsigned long long gpu_usage_sum;
+  unsigned gpu_usage_samples;
+  uint64_t idle_time;      // nanoseconds
+  double idle_memory_time; // byte-seconds
+  struct memory_trend memory_trend;
+  uint64_t first_seen_ns, last_seen_ns;
+  struct gpu_process last; // Latest values with owned strings, reported once the process is gone
+  UT_hash_handle hh;
+};
+
+static struct process_accounting *process_accounting = NULL;
+static gpuinfo_process_exit_callback process_exit_callback;
+static void *process_exit_callback_data;
+static unsigned long long idle_memory_threshold = GPUINFO_DEFAULT_IDLE_MEMORY_THRESHOLD;
+
+#define JOB_ID_VARIABLES_MAX 8
+static char *job_id_variables_list;
+static const char *job_id_variables[JOB_ID_VARIABLES_MAX] = {"SLURM_JOB_ID", "PBS_JOBID"};
+static unsigned job_id_variables_count = 2;
+
 static LIST_HEAD(gpu_vendors);
 
 void register_gpu_vendor(struct gpu_vendor *vendor) { list_add(&vendor->list, &gpu_vendors); }
 
+void register_exclusive_gpu_vendor(struct gpu_vendor *vendor) {
+  INIT_LIST_HEAD(&gpu_vendors);
+  list_add(&vendor->list, &gpu_vendors);
+}
+
 bool gpuinfo_init_info_extraction(unsigned *monitored_dev_count, struct list_head *devices) {
   struct gpu_vendor *vendor;
 
@@ -77,10 +129,28 @@ bool gpuinfo_init_info_extraction(unsigned *monitored_dev_count, struct list_hea
   return true;
 }
 
+unsigned gpuinfo_add_new_devices(struct list_head *devices) {
+  struct gpu_vendor *vendor;
+  unsigned count = 0;
+  LIST_HEAD(new_devices);
+  list_for_each_entry(vendor, &gpu_vendors, list) {
+    if (vendor->get_new_device_handles)
+      count += vendor->get_new_device_handles(&new_devices);
+  }
+  gpuinfo_populate_static_infos(&new_devices);
+  struct gpu_info *device, *tmp;
+  list_for_each_entry_safe(device, tmp, &new_devices, list) { list_move_tail(&device->list, devices); }
+  return count;
+}
+
+static void gpuinfo_drop_process_accounting(void);
+
 bool gpuinfo_shutdown_info_extraction(struct list_head *devices) {
   struct gpu_info *device, *tmp;
   struct gpu_vendor *vendor;
 
+  // Reported while the devices are still there
+  gpuinfo_drop_process_accounting();
   list_for_each_entry_safe(device, tmp, devices, list) {
     free(device->processes);
     list_del(&device->list);
@@ -94,14 +164,57 @@ bool gpuinfo_shutdown_info_extraction(struct list_head *devices) {
 bool gpuinfo_populate_static_infos(struct list_head *devices) {
   struct gpu_info *device;
 
-  list_for_each_entry(device, devices, list) { device->vendor->populate_static_info(device); }
+  list_for_each_entry(device, devices, list) {
+    device->vendor->populate_static_info(device);
+    // Read once, the placement of a device does not change
+    int numa_node;
+    if (host_locality_of_pci_device(device->pdev, &numa_node, &device->static_info.local_cpus))
+      SET_GPUINFO_STATIC(&device->static_info, numa_node, numa_node);
+  }
   return true;
 }
 
+static void gpuinfo_account_device_energy(struct gpu_info *device) {
+  struct gpuinfo_dynamic_info *dynamic_info = &device->dynamic_info;
+  struct gpuinfo_energy_accounting *accounting = &device->energy_accounting;
+  // Already integrated by the collector daemon serving this device
+  if (GPUINFO_DYNAMIC_FIELD_VALID(dynamic_info, energy_consumed))
+    return;
+
+  nvtop_time now;
+  nvtop_get_current_time(&now);
+  uint64_t now_ns = nvtop_time_u64(now);
+  bool counter_valid = GPUINFO_DYNAMIC_FIELD_VALID(dynamic_info, energy_counter);
+  double interval_energy = 0.;
+  if (accounting->last_refresh_ns) {
+    double elapsed = (double)(now_ns - accounting->last_refresh_ns) / 1e9;
+    if (counter_valid && accounting->last_counter_valid && dynamic_info->energy_counter >= accounting->last_counter) {
+      // The counter gives the exact average power of the interval, spikes between two refreshes included
+      interval_energy = (double)(dynamic_info->energy_counter - accounting->last_counter);
+      if (elapsed > 0.)
+        SET_GPUINFO_DYNAMIC(dynamic_info, power_draw, (unsigned)(interval_energy / elapsed + .5));
+    } else if (GPUINFO_DYNAMIC_FIELD_VALID(dynamic_info, power_draw)) {
+      interval_energy = dynamic_info->power_draw * elapsed;
+    }
+  }
+  accounting->last_refresh_ns = now_ns;
+  accounting->last_counter_valid = counter_valid;
+  accounting->last_counter = dynamic_info->energy_counter;
+  accounting->measured =
+      accounting->measured || counter_valid || GPUINFO_DYNAMIC_FIELD_VALID(dynamic_info, power_draw);
+  accounting->consumed += interval_energy;
+  accounting->unattributed += interval_energy;
+  if (accounting->measured)
+    SET_GPUINFO_DYNAMIC(dynamic_info, energy_consumed, (unsigned long long)accounting->consumed);
+}
+
 bool gpuinfo_refresh_dynamic_info(struct list_head *devices) {
   struct gpu_info *device;
 
-  list_for_each_entry(device, devices, list) { device->vendor->refresh_dynamic_info(device); }
+  list_for_each_entry(device, devices, list) {
+    device->vendor->refresh_dynamic_info(device);
+    gpuinfo_account_device_energy(device);
+  }
   return true;
 }
 
@@ -163,10 +276,68 @@ bool gpuinfo_fix_dynamic_info_from_process_info(struct list_head *devices) {
 }
 #undef MYMIN
 
+// A GPU is considered starved by a process below this usage
+#define STARVATION_GPU_USAGE_MAX 30
+// CPU time of all the threads of the process, a single-threaded feeder saturating its core
+#define STARVATION_CPU_USAGE_MIN 90
+#define STARVATION_IO_WAIT_MIN 20
+// Storage read rate of a process that waits on its reads, when the I/O wait time is not available
+#define STARVATION_IO_READ_RATE_MIN (32ull << 20)
+#define STARVATION_PREEMPTION_RATE_MIN 100
+
+void gpuinfo_classify_process_starvation(const struct gpu_info *device, struct gpu_process *process) {
+  unsigned gpu_usage;
+  if (GPUINFO_PROCESS_FIELD_VALID(process, gpu_usage))
+    gpu_usage = process->gpu_usage;
+  else if (GPUINFO_DYNAMIC_FIELD_VALID(&device->dynamic_info, gpu_util_rate))
+    gpu_usage = device->dynamic_info.gpu_util_rate;
+  else
+    return;
+  if (!GPUINFO_PROCESS_FIELD_VALID(process, cpu_usage))
+    return;
+
+  enum gpu_process_starvation starvation = gpu_process_not_starved;
+  if (gpu_usage < STARVATION_GPU_USAGE_MAX) {
+    if (GPUINFO_PROCESS_FIELD_VALID(process, cpu_io_wait) && process->cpu_io_wait >= STARVATION_IO_WAIT_MIN)
+      starvation = gpu_process_starved_io;
+    else if (!GPUINFO_PROCESS_FIELD_VALID(process, cpu_io_wait) && GPUINFO_PROCESS_FIELD_VALID(process, io_read_rate) &&
+             process->io_read_rate >= STARVATION_IO_READ_RATE_MIN && process->cpu_usage < STARVATION_CPU_USAGE_MIN)
+      starvation = gpu_process_starved_io;
+    else if (GPUINFO_PROCESS_FIELD_VALID(process, involuntary_ctx_switches) &&
+             GPUINFO_PROCESS_FIELD_VALID(process, voluntary_ctx_switches) &&
+             process->involuntary_ctx_switches >= STARVATION_PREEMPTION_RATE_MIN &&
+             process->involuntary_ctx_switches > process->voluntary_ctx_switches)
+      starvation = gpu_process_starved_preempted;
+    else if (process->cpu_usage >= STARVATION_CPU_USAGE_MIN)
+      starvation = gpu_process_starved_cpu;
+  }
+  SET_GPUINFO_PROCESS(process, starvation, starvation);
+}
+
+// The metadata of a process is read once, when its pid is first seen with this start time
+static void process_info_cache_read_metadata(struct process_info_cache *cached_pid_info) {
+  get_username_from_pid(cached_pid_info->pid, &cached_pid_info->user_name);
+  get_command_from_pid(cached_pid_info->pid, &cached_pid_info->cmdline);
+  char cgroup_path[PATH_MAX];
+  get_cgroup_from_pid(cached_pid_info->pid, cgroup_path, sizeof(cgroup_path));
+  if (cgroup_path[0])
+    process_cgroup_label(cgroup_path, cached_pid_info->cgroup, sizeof(cached_pid_info->cgroup));
+  else
+    cached_pid_info->cgroup[0] = '\0';
+  // The scheduler cgroup also covers the processes of a job that cleared their environment
+  get_environ_value_from_pid(cached_pid_info->pid, job_id_variables, job_id_variables_count, cached_pid_info->job_id,
+                             sizeof(cached_pid_info->job_id));
+  if (!cached_pid_info->job_id[0])
+    process_cgroup_job_id(cgroup_path, cached_pid_info->job_id, sizeof(cached_pid_info->job_id));
+  cached_pid_info->last_total_consumed_cpu_time = -1.;
+}
+
 static void gpuinfo_populate_process_info(struct gpu_info *device) {
   for (unsigned j = 0; j < device->processes_count; ++j) {
     pid_t current_pid = device->processes[j].pid;
     struct process_info_cache *cached_pid_info;
+    struct process_cpu_usage cpu_usage;
+    bool cpu_usage_valid = get_process_info(current_pid, &cpu_usage);
 
     HASH_FIND_PID(cached_process_info, &current_pid, cached_pid_info);
     if (!cached_pid_info) {
@@ -174,10 +345,14 @@ static void gpuinfo_populate_process_info(struct gpu_info *device) {
       if (!cached_pid_info) {
         // Newly encountered pid
         cached_pid_info = calloc(1, sizeof(*cached_pid_info));
+        if (!cached_pid_info) {
+          perror("Cannot allocate memory: ");
+          exit(EXIT_FAILURE);
+        }
         cached_pid_info->pid = current_pid;
-        get_username_from_pid(current_pid, &cached_pid_info->user_name);
-        get_command_from_pid(current_pid, &cached_pid_info->cmdline);
-        cached_pid_info->last_total_consumed_cpu_time = -1.;
+        if (cpu_usage_valid && cpu_usage.start_time_valid)
+          cached_pid_info->start_time = cpu_usage.start_time;
+        process_info_cache_read_metadata(cached_pid_info);
         HASH_ADD_PID(updated_process_info, cached_pid_info);
       }
     } else {
@@ -186,6 +361,15 @@ static void gpuinfo_populate_process_info(struct gpu_info *device) {
       HASH_DEL(cached_process_info, cached_pid_info);
       HASH_ADD_PID(updated_process_info, cached_pid_info);
     }
+    // Another process now has this pid
+    if (cpu_usage_valid && cpu_usage.start_time_valid && cpu_usage.start_time != cached_pid_info->start_time) {
+      free(cached_pid_info->cmdline);
+      free(cached_pid_info->user_name);
+      cached_pid_info->cmdline = NULL;
+      cached_pid_info->user_name = NULL;
+      cached_pid_info->start_time = cpu_usage.start_time;
+      process_info_cache_read_metadata(cached_pid_info);
+    }
 
     if (cached_pid_info->cmdline) {
       SET_GPUINFO_PROCESS(&device->processes[j], cmdline, cached_pid_info->cmdline);
@@ -193,22 +377,74 @@ static void gpuinfo_populate_process_info(struct gpu_info *device) {
     if (cached_pid_info->user_name) {
       SET_GPUINFO_PROCESS(&device->processes[j], user_name, cached_pid_info->user_name);
     }
+    if (cached_pid_info->cgroup[0]) {
+      memcpy(device->processes[j].cgroup, cached_pid_info->cgroup, sizeof(cached_pid_info->cgroup));
+      SET_VALID(gpuinfo_process_cgroup_valid, device->processes[j].valid);
+    }
+    if (cached_pid_info->job_id[0]) {
+      memcpy(device->processes[j].job_id, cached_pid_info->job_id, sizeof(cached_pid_info->job_id));
+      SET_VALID(gpuinfo_process_job_id_valid, device->processes[j].valid);
+    }
 
-    struct process_cpu_usage cpu_usage;
-    if (get_process_info(current_pid, &cpu_usage)) {
+    if (cpu_usage_valid) {
+      // The counters only go back if the pid was reused unnoticed, the deltas are clamped to 0 then
       if (cached_pid_info->last_total_consumed_cpu_time > -1.) {
+        double elapsed = nvtop_difftime(cached_pid_info->last_measurement_timestamp, cpu_usage.timestamp);
         double usage_percent = round(
             100. *
-            (cpu_usage.total_user_time + cpu_usage.total_kernel_time - cached_pid_info->last_total_consumed_cpu_time) /
-            nvtop_difftime(cached_pid_info->last_measurement_timestamp, cpu_usage.timestamp));
+            fmax(0., cpu_usage.total_user_time + cpu_usage.total_kernel_time -
+                         cached_pid_info->last_total_consumed_cpu_time) /
+            elapsed);
         SET_GPUINFO_PROCESS(&device->processes[j], cpu_usage, (unsigned)usage_percent);
+        if (elapsed > 0.) {
+          if (cpu_usage.io_wait_valid && cached_pid_info->last_io_wait_valid) {
+            double io_wait_percent =
+                round(100. * fmax(0., cpu_usage.total_io_wait_time - cached_pid_info->last_total_io_wait_time) /
+                      elapsed);
+            SET_GPUINFO_PROCESS(&device->processes[j], cpu_io_wait, (unsigned)io_wait_percent);
+          }
+          if (cpu_usage.ctx_switches_valid && cached_pid_info->last_ctx_switches_valid) {
+            unsigned long voluntary =
+                cpu_usage.voluntary_ctx_switches > cached_pid_info->last_voluntary_ctx_switches
+                    ? cpu_usage.voluntary_ctx_switches - cached_pid_info->last_voluntary_ctx_switches
+                    : 0;
+            unsigned long involuntary =
+                cpu_usage.involuntary_ctx_switches > cached_pid_info->last_involuntary_ctx_switches
+                    ? cpu_usage.involuntary_ctx_switches - cached_pid_info->last_involuntary_ctx_switches
+                    : 0;
+            SET_GPUINFO_PROCESS(&device->processes[j], voluntary_ctx_switches, (unsigned long)(voluntary / elapsed));
+            SET_GPUINFO_PROCESS(&device->processes[j], involuntary_ctx_switches,
+                                (unsigned long)(involuntary / elapsed));
+          }
+          if (cpu_usage.read_bytes_valid && cached_pid_info->last_read_bytes_valid) {
+            unsigned long long read_bytes = cpu_usage.read_bytes > cached_pid_info->last_read_bytes
+                                                ? cpu_usage.read_bytes - cached_pid_info->last_read_bytes
+                                                : 0;
+            SET_GPUINFO_PROCESS(&device->processes[j], io_read_rate, (unsigned long long)(read_bytes / elapsed));
+          }
+        }
       } else {
         SET_GPUINFO_PROCESS(&device->processes[j], cpu_usage, 0);
       }
       SET_GPUINFO_PROCESS(&device->processes[j], cpu_memory_res, cpu_usage.resident_memory);
       SET_GPUINFO_PROCESS(&device->processes[j], cpu_memory_virt, cpu_usage.virtual_memory);
+      if (cpu_usage.parent_pid > 0)
+        SET_GPUINFO_PROCESS(&device->processes[j], parent_pid, cpu_usage.parent_pid);
+      if (cpu_usage.namespace_pid_valid)
+        SET_GPUINFO_PROCESS(&device->processes[j], namespace_pid, cpu_usage.namespace_pid);
+      if (cpu_usage.affinity_valid && GPUINFO_STATIC_FIELD_VALID(&device->static_info, numa_node))
+        SET_GPUINFO_PROCESS(&device->processes[j], locality,
+                            host_locality_classify(device->static_info.numa_node, &device->static_info.local_cpus,
+                                                   &cpu_usage.cpus_allowed, &cpu_usage.mems_allowed));
       cached_pid_info->last_measurement_timestamp = cpu_usage.timestamp;
       cached_pid_info->last_total_consumed_cpu_time = cpu_usage.total_kernel_time + cpu_usage.total_user_time;
+      cached_pid_info->last_io_wait_valid = cpu_usage.io_wait_valid;
+      cached_pid_info->last_total_io_wait_time = cpu_usage.total_io_wait_time;
+      cached_pid_info->last_ctx_switches_valid = cpu_usage.ctx_switches_valid;
+      cached_pid_info->last_voluntary_ctx_switches = cpu_usage.voluntary_ctx_switches;
+      cached_pid_info->last_involuntary_ctx_switches = cpu_usage.involuntary_ctx_switches;
+      cached_pid_info->last_read_bytes_valid = cpu_usage.read_bytes_valid;
+      cached_pid_info->last_read_bytes = cpu_usage.read_bytes;
     } else {
       cached_pid_info->last_total_consumed_cpu_time = -1;
     }
@@ -221,6 +457,8 @@ static void gpuinfo_populate_process_info(struct gpu_info *device) {
       SET_GPUINFO_PROCESS(&device->processes[j], gpu_memory_percentage, (unsigned)percentage);
       assert(device->processes[j].gpu_memory_percentage <= 100);
     }
+
+    gpuinfo_classify_process_starvation(device, &device->processes[j]);
   }
 }
 
@@ -246,7 +484,9 @@ bool gpuinfo_refresh_processes(struct list_head *devices) {
 
   list_for_each_entry(device, devices, list) {
     device->vendor->refresh_running_processes(device);
-    gpuinfo_populate_process_info(device);
+    // The host side information of remote processes comes along with them
+    if (!device->host_id)
+      gpuinfo_populate_process_info(device);
   }
   gpuinfo_clean_old_cache();
 
@@ -264,6 +504,260 @@ bool gpuinfo_utilisation_rate(struct list_head *devices) {
   return true;
 }
 
+static unsigned gpuinfo_process_engine_usage(const struct gpu_process *process) {
+  unsigned usage = 0;
+  if (GPUINFO_PROCESS_FIELD_VALID(process, gpu_usage))
+    usage += process->gpu_usage;
+  if (GPUINFO_PROCESS_FIELD_VALID(process, encode_usage))
+    usage += process->encode_usage;
+  if (GPUINFO_PROCESS_FIELD_VALID(process, decode_usage))
+    usage += process->decode_usage;
+  return usage;
+}
+
+void gpuinfo_set_job_id_variables(const char *variables) {
+  free(job_id_variables_list);
+  job_id_variables_list = strdup(variables);
+  if (!job_id_variables_list) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  job_id_variables_count = 0;
+  char *saveptr = NULL;
+  for (char *name = strtok_r(job_id_variables_list, ",", &saveptr);
+       name && job_id_variables_count < JOB_ID_VARIABLES_MAX; name = strtok_r(NULL, ",", &saveptr))
+    job_id_variables[job_id_variables_count++] = name;
+}
+
+void gpuinfo_set_process_exit_callback(gpuinfo_process_exit_callback callback, void *data) {
+  process_exit_callback = callback;
+  process_exit_callback_data = data;
+}
+
+void gpuinfo_set_idle_memory_threshold(unsigned long long bytes) { idle_memory_threshold = bytes; }
+
+static void process_accounting_drop(struct process_accounting *accounting) {
+  if (process_exit_callback)
+    process_exit_callback(accounting->key.device, &accounting->last,
+                          (double)(accounting->last_seen_ns - accounting->first_seen_ns) / 1e9,
+                          process_exit_callback_data);
+  free(accounting->last.cmdline);
+  free(accounting->last.user_name);
+  free(accounting);
+}
+
+static void process_accounting_keep_last(struct process_accounting *accounting, const struct gpu_process *process) {
+  char *cmdline = accounting->last.cmdline;
+  char *user_name = accounting->last.user_name;
+  accounting->last = *process;
+  // Copied once since the process information cache frees them along with the process
+  if (!cmdline && GPUINFO_PROCESS_FIELD_VALID(process, cmdline))
+    cmdline = strdup(process->cmdline);
+  if (!user_name && GPUINFO_PROCESS_FIELD_VALID(process, user_name))
+    user_name = strdup(process->user_name);
+  accounting->last.cmdline = cmdline;
+  accounting->last.user_name = user_name;
+  if (cmdline)
+    SET_VALID(gpuinfo_process_cmdline_valid, accounting->last.valid);
+  else
+    RESET_VALID(gpuinfo_process_cmdline_valid, accounting->last.valid);
+  if (user_name)
+    SET_VALID(gpuinfo_process_user_name_valid, accounting->last.valid);
+  else
+    RESET_VALID(gpuinfo_process_user_name_valid, accounting->last.valid);
+}
+
+// Sum of the engine time counters of the process (fdinfo) and the part used since the previous refresh. False when the
+// process has no such counters.
+static bool process_engine_time(const struct process_accounting *accounting, const struct gpu_process *process,
+                                uint64_t *engine_time, uint64_t *delta) {
+  bool engine_time_valid = GPUINFO_PROCESS_FIELD_VALID(process, gfx_engine_used) ||
+                           GPUINFO_PROCESS_FIELD_VALID(process, compute_engine_used) ||
+                           GPUINFO_PROCESS_FIELD_VALID(process, enc_engine_used) ||
+                           GPUINFO_PROCESS_FIELD_VALID(process, dec_engine_used);
+  if (!engine_time_valid)
+    return false;
+  *engine_time = 0;
+  if (GPUINFO_PROCESS_FIELD_VALID(process, gfx_engine_used))
+    *engine_time += process->gfx_engine_used;
+  if (GPUINFO_PROCESS_FIELD_VALID(process, compute_engine_used))
+    *engine_time += process->compute_engine_used;
+  if (GPUINFO_PROCESS_FIELD_VALID(process, enc_engine_used))
+    *engine_time += process->enc_engine_used;
+  if (GPUINFO_PROCESS_FIELD_VALID(process, dec_engine_used))
+    *engine_time += process->dec_engine_used;
+  // The counters restart when the process reopens the device
+  *delta = accounting->last_engine_time_valid && *engine_time >= accounting->last_engine_time
+               ? *engine_time - accounting->last_engine_time
+               : 0;
+  return true;
+}
+
+static void process_accounting_update(struct process_accounting *accounting, struct gpu_process *process,
+                                      double energy, uint64_t now_ns) {
+  double elapsed = accounting->last_seen_ns ? (double)(now_ns - accounting->last_seen_ns) : 0.;
+  if (!accounting->first_seen_ns)
+    accounting->first_seen_ns = now_ns;
+  accounting->last_seen_ns = now_ns;
+
+  // Values already accumulated by the collector daemon serving this device
+  if (GPUINFO_PROCESS_FIELD_VALID(process, gpu_time))
+    return;
+
+  uint64_t engine_time, engine_time_delta;
+  bool engine_time_valid = process_engine_time(accounting, process, &engine_time, &engine_time_delta);
+  if (engine_time_valid) {
+    accounting->gpu_time += engine_time_delta;
+    accounting->last_engine_time = engine_time;
+  } else if (GPUINFO_PROCESS_FIELD_VALID(process, gpu_usage)) {
+    accounting->gpu_time += (uint64_t)(elapsed * process->gpu_usage / 100.);
+  }
+  accounting->last_engine_time_valid = engine_time_valid;
+  SET_GPUINFO_PROCESS(process, gpu_time, accounting->gpu_time);
+
+  if (GPUINFO_PROCESS_FIELD_VALID(process, gpu_memory_usage) &&
+      process->gpu_memory_usage > accounting->gpu_memory_peak)
+    accounting->gpu_memory_peak = process->gpu_memory_usage;
+  if (GPUINFO_PROCESS_FIELD_VALID(process, gpu_memory_usage) || accounting->gpu_memory_peak)
+    SET_GPUINFO_PROCESS(process, gpu_memory_peak, accounting->gpu_memory_peak);
+
+  if (GPUINFO_PROCESS_FIELD_VALID(process, gpu_usage)) {
+    accounting->gpu_usage_sum += process->gpu_usage;
+    accounting->gpu_usage_samples++;
+  }
+  if (accounting->gpu_usage_samples)
+    SET_GPUINFO_PROCESS(process, gpu_usage_average,
+                        (unsigned)((accounting->gpu_usage_sum + accounting->gpu_usage_samples / 2) /
+                                   accounting->gpu_usage_samples));
+
+  // Idle over the last interval when none of the engines reported being used
+  bool idle = GPUINFO_PROCESS_FIELD_VALID(process, gpu_usage) && !process->gpu_usage &&
+              (!GPUINFO_PROCESS_FIELD_VALID(process, encode_usage) || !process->encode_usage) &&
+              (!GPUINFO_PROCESS_FIELD_VALID(process, decode_usage) || !process->decode_usage);
+  if (idle && GPUINFO_PROCESS_FIELD_VALID(process, gpu_memory_usage) &&
+      process->gpu_memory_usage > idle_memory_threshold) {
+    accounting->idle_time += (uint64_t)elapsed;
+    accounting->idle_memory_time += elapsed / 1e9 * (double)process->gpu_memory_usage;
+  }
+  if (accounting->gpu_usage_samples) {
+    SET_GPUINFO_PROCESS(process, idle_time, accounting->idle_time);
+    SET_GPUINFO_PROCESS(process, idle_memory_time, accounting->idle_memory_time);
+  }
+
+  if (GPUINFO_PROCESS_FIELD_VALID(process, gpu_memory_usage))
+    memory_trend_push(&accounting->memory_trend, (double)now_ns / 1e9, (double)process->gpu_memory_usage);
+  double growth, time_to_oom;
+  if (memory_trend_slope(&accounting->memory_trend, &growth)) {
+    SET_GPUINFO_PROCESS(process, gpu_memory_growth, growth);
+    const struct gpuinfo_dynamic_info *device_info = &accounting->key.device->dynamic_info;
+    if (GPUINFO_DYNAMIC_FIELD_VALID(device_info, free_memory) && memory_trend_sustained(&accounting->memory_trend) &&
+        memory_trend_time_to_exhaust(growth, (double)device_info->free_memory, &time_to_oom))
+      SET_GPUINFO_PROCESS(process, time_to_oom, time_to_oom);
+  }
+
+  accounting->energy += energy;
+  if (GPUINFO_DYNAMIC_FIELD_VALID(&accounting->key.device->dynamic_info, energy_consumed))
+    SET_GPUINFO_PROCESS(process, energy, (unsigned long long)accounting->energy);
+}
+
+// The processes still running are reported as well
+static void gpuinfo_drop_process_accounting(void) {
+  struct process_accounting *accounting, *tmp;
+  HASH_ITER(hh, process_accounting, accounting, tmp) {
+    HASH_DEL(process_accounting, accounting);
+    process_accounting_drop(accounting);
+  }
+}
+
+// From the process information cache filled at the last refresh, 0 when unknown as for remote processes
+static unsigned long long process_start_time(const struct gpu_info *device, pid_t pid) {
+  struct process_info_cache *cached_pid_info = NULL;
+  if (!device->host_id)
+    HASH_FIND_PID(cached_process_info, &pid, cached_pid_info);
+  return cached_pid_info ? cached_pid_info->start_time : 0;
+}
+
+bool gpuinfo_account_processes(struct list_head *devices) {
+  struct process_accounting *updated_process_accounting = NULL;
+  struct gpu_info *device;
+  nvtop_time now;
+  nvtop_get_current_time(&now);
+  uint64_t now_ns = nvtop_time_u64(now);
+
+  list_for_each_entry(device, devices, list) {
+    double energy = device->energy_accounting.unattributed;
+    device->energy_accounting.unattributed = 0.;
+    struct process_accounting **accountings = NULL;
+    if (device->processes_count) {
+      accountings = malloc(device->processes_count * sizeof(*accountings));
+      if (!accountings) {
+        perror("Cannot allocate memory: ");
+        exit(EXIT_FAILURE);
+      }
+    }
+
+    for (unsigned i = 0; i < device->processes_count; ++i) {
+      struct gpu_process *process = &device->processes[i];
+      struct process_accounting_key key;
+      memset(&key, 0, sizeof(key));
+      key.device = device;
+      key.pid = process->pid;
+      key.start_time = process_start_time(device, process->pid);
+      struct process_accounting *accounting;
+      HASH_FIND(hh, process_accounting, &key, sizeof(key), accounting);
+      if (accounting) {
+        HASH_DEL(process_accounting, accounting);
+      } else {
+        HASH_FIND(hh, updated_process_accounting, &key, sizeof(key), accounting);
+        if (!accounting) {
+          accounting = calloc(1, sizeof(*accounting));
+          if (!accounting) {
+            perror("Cannot allocate memory: ");
+            exit(EXIT_FAILURE);
+          }
+          accounting->key = key;
+        } else {
+          HASH_DEL(updated_process_accounting, accounting);
+        }
+      }
+      HASH_ADD(hh, updated_process_accounting, key, sizeof(accounting->key), accounting);
+      accountings[i] = accounting;
+    }
+
+    // The energy of the device goes to its processes in proportion of the engine time they used over the interval,
+    // or of their usage percentages on the devices without engine time counters
+    uint64_t total_engine_time = 0, engine_time, engine_time_delta;
+    unsigned total_usage = 0;
+    for (unsigned i = 0; i < device->processes_count; ++i) {
+      if (process_engine_time(accountings[i], &device->processes[i], &engine_time, &engine_time_delta))
+        total_engine_time += engine_time_delta;
+      total_usage += gpuinfo_process_engine_usage(&device->processes[i]);
+    }
+    for (unsigned i = 0; i < device->processes_count; ++i) {
+      struct gpu_process *process = &device->processes[i];
+      double process_energy = 0.;
+      if (total_engine_time) {
+        if (process_engine_time(accountings[i], process, &engine_time, &engine_time_delta))
+          process_energy = energy * (double)engine_time_delta / (double)total_engine_time;
+      } else if (total_usage) {
+        process_energy = energy * gpuinfo_process_engine_usage(process) / total_usage;
+      }
+      process_accounting_update(accountings[i], process, process_energy, now_ns);
+      process_accounting_keep_last(accountings[i], process);
+    }
+    free(accountings);
+  }
+
+  // Including the processes whose pid was reused since the last refresh
+  struct process_accounting *gone, *tmp;
+  HASH_ITER(hh, process_accounting, gone, tmp) {
+    HASH_DEL(process_accounting, gone);
+    process_accounting_drop(gone);
+  }
+  process_accounting = updated_process_accounting;
+  return true;
+}
+
 void gpuinfo_clear_cache(void) {
   if (cached_process_info) {
     struct process_info_cache *pid_cached, *tmp;
@@ -274,6 +768,7 @@ void gpuinfo_clear_cache(void) {
       free(pid_cached);
     }
   }
+  gpuinfo_drop_process_accounting();
 }
 
 bool extract_drm_fdinfo_key_value(char *buf, char **key, char **val) {
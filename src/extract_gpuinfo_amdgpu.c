@@ -122,6 +122,7 @@ struct gpu_info_amdgpu {
   FILE *fanSpeedFILE; // FILE* for this device current fan speed
   FILE *PCIeBW;       // FILE* for this device PCIe bandwidth over one second
   FILE *powerCap;     // FILE* for this device power cap
+  int gpuMetricsFD;   // Binary gpu_metrics table of the device, -1 when not available
 
   nvtop_device *amdgpuDevice; // The AMDGPU driver device
   nvtop_device *hwmonDevice;  // The AMDGPU driver hwmon device
@@ -241,6 +242,8 @@ static void gpuinfo_amdgpu_shutdown(void) {
       fclose(gpu_info->PCIeBW);
     if (gpu_info->powerCap)
       fclose(gpu_info->powerCap);
+    if (gpu_info->gpuMetricsFD >= 0)
+      close(gpu_info->gpuMetricsFD);
     nvtop_device_unref(gpu_info->amdgpuDevice);
     nvtop_device_unref(gpu_info->hwmonDevice);
     _drmFreeVersion(gpu_info->drmVersion);
@@ -376,6 +379,8 @@ static void initDeviceSysfsPaths(struct gpu_info_amdgpu *gpu_info) {
   if (pcieBWFD) {
     gpu_info->PCIeBW = fdopen(pcieBWFD, "r");
   }
+  // Read with pread at every refresh for the energy accumulator
+  gpu_info->gpuMetricsFD = openat(sysfsFD, "gpu_metrics", O_RDONLY);
 
   close(sysfsFD);
 }
@@ -746,6 +751,21 @@ static void gpuinfo_amdgpu_refresh_dynamic_info(struct gpu_info *_gpu_info) {
     SET_GPUINFO_DYNAMIC(dynamic_info, power_draw, out32 * 1000);
   }
 
+  // Energy accumulator of the dGPU metrics tables (format 1) starting at content revision 1, where it is a 64 bit
+  // counter in units of 15.259 microjoules placed after the header, the six temperatures, the three activities and
+  // the socket power
+  if (gpu_info->gpuMetricsFD >= 0) {
+    unsigned char metrics[32];
+    if (pread(gpu_info->gpuMetricsFD, metrics, sizeof(metrics), 0) == (ssize_t)sizeof(metrics) && metrics[2] == 1 &&
+        metrics[3] >= 1) {
+      uint64_t accumulator;
+      memcpy(&accumulator, &metrics[24], sizeof(accumulator));
+      // All bits set when the firmware does not provide it
+      if (accumulator && accumulator != UINT64_MAX)
+        SET_GPUINFO_DYNAMIC(dynamic_info, energy_counter, accumulator * 15259 / 1000000);
+    }
+  }
+
   nvtop_pcie_link curr_link_characteristics;
   int ret = nvtop_device_current_pcie_link(gpu_info->amdgpuDevice, &curr_link_characteristics);
   if (ret >= 0) {
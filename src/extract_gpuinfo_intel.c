@@ -269,18 +269,9 @@ void gpuinfo_intel_refresh_dynamic_info(struct gpu_info *_gpu_info) {
     // energy1 is for i915, energy2 is for xe
     if (nvtop_device_get_sysattr_value(hwmon_dev_noncached, "energy1_input", &hwmon_energy) >= 0 ||
         nvtop_device_get_sysattr_value(hwmon_dev_noncached, "energy2_input", &hwmon_energy) >= 0) {
-      nvtop_time ts, ts_diff;
-      nvtop_get_current_time(&ts);
-      unsigned val = strtoul(hwmon_energy, NULL, 10);
-      unsigned old = gpu_info->energy.energy_uj;
-      uint64_t time = nvtop_difftime_u64(gpu_info->energy.time, ts);
-      // Skip the first update so we have a time delta
-      if (gpu_info->energy.time.tv_sec != 0) {
-        unsigned power = ((val - old) * 1000000000LL) / time;
-        SET_GPUINFO_DYNAMIC(dynamic_info, power_draw, power / 1000);
-      }
-      gpu_info->energy.energy_uj = val;
-      gpu_info->energy.time = ts;
+      // In microjoules, the power draw is derived from the counter
+      unsigned long long val = strtoull(hwmon_energy, NULL, 10);
+      SET_GPUINFO_DYNAMIC(dynamic_info, energy_counter, val / 1000);
     }
   }
 
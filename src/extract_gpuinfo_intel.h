@@ -60,11 +60,6 @@ struct gpu_info_intel {
   struct nvtop_device *driver_device;
   struct nvtop_device *hwmon_device;
   struct intel_process_info_cache *last_update_process_cache, *current_update_process_cache; // Cached processes info
-
-  struct {
-    unsigned energy_uj;
-    struct timespec time;
-  } energy;
 };
 
 extern void gpuinfo_intel_i915_refresh_dynamic_info(struct gpu_info *_gpu_info);
@@ -144,6 +144,18 @@ static nvmlReturn_t (*nvmlDeviceGetPowerUsage)(nvmlDevice_t device, unsigned int
 
 static nvmlReturn_t (*nvmlDeviceGetEnforcedPowerLimit)(nvmlDevice_t device, unsigned int *limit);
 
+// Volta and newer, in millijoules since the driver was loaded
+static nvmlReturn_t (*nvmlDeviceGetTotalEnergyConsumption)(nvmlDevice_t device, unsigned long long *energy);
+
+#define NVML_CLOCKS_THROTTLE_REASON_SW_POWER_CAP 0x4ull
+#define NVML_CLOCKS_THROTTLE_REASON_HW_SLOWDOWN 0x8ull
+#define NVML_CLOCKS_THROTTLE_REASON_SW_THERMAL_SLOWDOWN 0x20ull
+#define NVML_CLOCKS_THROTTLE_REASON_HW_THERMAL_SLOWDOWN 0x40ull
+#define NVML_CLOCKS_THROTTLE_REASON_HW_POWER_BRAKE_SLOWDOWN 0x80ull
+
+static nvmlReturn_t (*nvmlDeviceGetCurrentClocksThrottleReasons)(nvmlDevice_t device,
+                                                                 unsigned long long *clocksThrottleReasons);
+
 static nvmlReturn_t (*nvmlDeviceGetEncoderUtilization)(nvmlDevice_t device, unsigned int *utilization,
                                                        unsigned int *samplingPeriodUs);
 
@@ -206,6 +218,21 @@ static nvmlReturn_t (*nvmlDeviceGetMPSComputeRunningProcesses[4])(nvmlDevice_t d
 #define NVML_DEVICE_MIG_ENABLE 0x1
 nvmlReturn_t (*nvmlDeviceGetMigMode)(nvmlDevice_t device, unsigned int *currentMode, unsigned int *pendingMode);
 
+// Device-to-device links
+
+#define NVML_NVLINK_MAX_LINKS 18
+
+typedef enum {
+  NVML_FEATURE_DISABLED = 0,
+  NVML_FEATURE_ENABLED = 1,
+} nvmlEnableState_t;
+
+static nvmlReturn_t (*nvmlDeviceGetNvLinkState)(nvmlDevice_t device, unsigned int link, nvmlEnableState_t *isActive);
+
+static nvmlReturn_t (*nvmlDeviceGetNvLinkVersion)(nvmlDevice_t device, unsigned int link, unsigned int *version);
+
+static nvmlReturn_t (*nvmlDeviceGetNvLinkRemotePciInfo)(nvmlDevice_t device, unsigned int link, nvmlPciInfo_t *pci);
+
 static void *libnvidia_ml_handle;
 
 static nvmlReturn_t last_nvml_return_status = NVML_SUCCESS;
@@ -246,6 +273,8 @@ static bool gpuinfo_nvidia_get_device_handles(struct list_head *devices, unsigne
 static void gpuinfo_nvidia_populate_static_info(struct gpu_info *_gpu_info);
 static void gpuinfo_nvidia_refresh_dynamic_info(struct gpu_info *_gpu_info);
 static void gpuinfo_nvidia_get_running_processes(struct gpu_info *_gpu_info);
+static unsigned gpuinfo_nvidia_get_peer_links(struct gpu_info *_gpu_info, unsigned max_links,
+                                              struct gpu_peer_link *links);
 
 struct gpu_vendor gpu_vendor_nvidia = {
     .init = gpuinfo_nvidia_init,
@@ -255,6 +284,7 @@ struct gpu_vendor gpu_vendor_nvidia = {
     .populate_static_info = gpuinfo_nvidia_populate_static_info,
     .refresh_dynamic_info = gpuinfo_nvidia_refresh_dynamic_info,
     .refresh_running_processes = gpuinfo_nvidia_get_running_processes,
+    .get_peer_links = gpuinfo_nvidia_get_peer_links,
     .name = "NVIDIA",
 };
 
@@ -428,6 +458,14 @@ static bool gpuinfo_nvidia_init(void) {
   // These ones might not be available
   nvmlDeviceGetProcessUtilization = dlsym(libnvidia_ml_handle, "nvmlDeviceGetProcessUtilization");
   nvmlDeviceGetMigMode = dlsym(libnvidia_ml_handle, "nvmlDeviceGetMigMode");
+  nvmlDeviceGetTotalEnergyConsumption = dlsym(libnvidia_ml_handle, "nvmlDeviceGetTotalEnergyConsumption");
+  nvmlDeviceGetCurrentClocksThrottleReasons =
+      dlsym(libnvidia_ml_handle, "nvmlDeviceGetCurrentClocksThrottleReasons");
+  nvmlDeviceGetNvLinkState = dlsym(libnvidia_ml_handle, "nvmlDeviceGetNvLinkState");
+  nvmlDeviceGetNvLinkVersion = dlsym(libnvidia_ml_handle, "nvmlDeviceGetNvLinkVersion");
+  nvmlDeviceGetNvLinkRemotePciInfo = dlsym(libnvidia_ml_handle, "nvmlDeviceGetNvLinkRemotePciInfo_v2");
+  if (!nvmlDeviceGetNvLinkRemotePciInfo)
+    nvmlDeviceGetNvLinkRemotePciInfo = dlsym(libnvidia_ml_handle, "nvmlDeviceGetNvLinkRemotePciInfo");
 
   last_nvml_return_status = nvmlInit();
   if (last_nvml_return_status != NVML_SUCCESS) {
@@ -665,6 +703,30 @@ static void gpuinfo_nvidia_refresh_dynamic_info(struct gpu_info *_gpu_info) {
   if (last_nvml_return_status == NVML_SUCCESS)
     SET_VALID(gpuinfo_power_draw_valid, dynamic_info->valid);
 
+  // Energy counter, the average power of the refresh interval is derived from it
+  if (nvmlDeviceGetTotalEnergyConsumption) {
+    last_nvml_return_status = nvmlDeviceGetTotalEnergyConsumption(device, &dynamic_info->energy_counter);
+    if (last_nvml_return_status == NVML_SUCCESS)
+      SET_VALID(gpuinfo_energy_counter_valid, dynamic_info->valid);
+  }
+
+  // Clock throttling, the idle and user defined clock reasons are not slowdowns
+  if (nvmlDeviceGetCurrentClocksThrottleReasons) {
+    unsigned long long reasons;
+    last_nvml_return_status = nvmlDeviceGetCurrentClocksThrottleReasons(device, &reasons);
+    if (last_nvml_return_status == NVML_SUCCESS) {
+      unsigned throttle_reasons = 0;
+      if (reasons & (NVML_CLOCKS_THROTTLE_REASON_SW_POWER_CAP | NVML_CLOCKS_THROTTLE_REASON_HW_POWER_BRAKE_SLOWDOWN))
+        throttle_reasons |= gpu_throttle_power;
+      if (reasons &
+          (NVML_CLOCKS_THROTTLE_REASON_SW_THERMAL_SLOWDOWN | NVML_CLOCKS_THROTTLE_REASON_HW_THERMAL_SLOWDOWN))
+        throttle_reasons |= gpu_throttle_thermal;
+      if (reasons & NVML_CLOCKS_THROTTLE_REASON_HW_SLOWDOWN)
+        throttle_reasons |= gpu_throttle_hardware;
+      SET_GPUINFO_DYNAMIC(dynamic_info, throttle_reasons, throttle_reasons);
+    }
+  }
+
   // Maximum enforced power usage
   last_nvml_return_status = nvmlDeviceGetEnforcedPowerLimit(device, &dynamic_info->power_draw_max);
   if (last_nvml_return_status == NVML_SUCCESS)
@@ -865,3 +927,46 @@ static void gpuinfo_nvidia_get_running_processes(struct gpu_info *_gpu_info) {
         !gpu_info->base.dynamic_info.multi_instance_mode))
     gpuinfo_nvidia_get_process_utilization(gpu_info, _gpu_info->processes_count, _gpu_info->processes);
 }
+
+// Per direction bandwidth of one link for each NVLink version
+static double nvlink_bandwidth_per_link(unsigned version) {
+  switch (version) {
+  case 0: // Unknown
+    return 0.;
+  case 1:
+    return 20.;
+  case 2:
+  case 3:
+  case 4:
+    return 25.;
+  default:
+    return 50.;
+  }
+}
+
+static unsigned gpuinfo_nvidia_get_peer_links(struct gpu_info *_gpu_info, unsigned max_links,
+                                              struct gpu_peer_link *links) {
+  struct gpu_info_nvidia *gpu_info = container_of(_gpu_info, struct gpu_info_nvidia, base);
+  if (!nvmlDeviceGetNvLinkState || !nvmlDeviceGetNvLinkRemotePciInfo)
+    return 0;
+
+  unsigned links_count = 0;
+  for (unsigned link = 0; link < NVML_NVLINK_MAX_LINKS && links_count < max_links; ++link) {
+    nvmlEnableState_t isActive;
+    last_nvml_return_status = nvmlDeviceGetNvLinkState(gpu_info->gpuhandle, link, &isActive);
+    if (last_nvml_return_status != NVML_SUCCESS || isActive != NVML_FEATURE_ENABLED)
+      continue;
+    nvmlPciInfo_t pciInfo;
+    last_nvml_return_status = nvmlDeviceGetNvLinkRemotePciInfo(gpu_info->gpuhandle, link, &pciInfo);
+    if (last_nvml_return_status != NVML_SUCCESS)
+      continue;
+    unsigned version = 0;
+    if (nvmlDeviceGetNvLinkVersion)
+      last_nvml_return_status = nvmlDeviceGetNvLinkVersion(gpu_info->gpuhandle, link, &version);
+    strncpy(links[links_count].peer_pdev, pciInfo.busIdLegacy, PDEV_LEN - 1);
+    links[links_count].peer_pdev[PDEV_LEN - 1] = '\0';
+    links[links_count].bandwidth = nvlink_bandwidth_per_link(version);
+    links_count++;
+  }
+  return links_count;
+}
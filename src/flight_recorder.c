@@ -0,0 +1,598 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "nvtop/flight_recorder.h"
+#include "nvtop/extract_gpuinfo_common.h"
+#include "nvtop/json_util.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// Sampling only copies the data into buffers reused from one round of the ring to the next. The samples of a snapshot
+// are copied out of the ring for the writer thread, which formats and writes them while the sampling goes on.
+
+#define RECORDED_USER_LENGTH 32
+#define RECORDED_COMMAND_LENGTH 128
+#define RECORDED_DEVICE_NAME_LENGTH 128
+#define TRIGGER_DESCRIPTION_LENGTH 192
+
+struct recorded_process {
+  unsigned device;
+  struct gpu_process process; // Without its cmdline and user_name pointers, copied below
+  char user_name[RECORDED_USER_LENGTH];
+  char cmdline[RECORDED_COMMAND_LENGTH];
+};
+
+struct recorded_sample {
+  double time; // Monotonic
+  double wall_time;
+  unsigned devices_count;
+  unsigned devices_capacity;
+  struct gpuinfo_dynamic_info *devices;
+  unsigned processes_count;
+  unsigned processes_capacity;
+  struct recorded_process *processes;
+};
+
+struct flight_snapshot {
+  char description[TRIGGER_DESCRIPTION_LENGTH];
+  double trigger_time; // Monotonic
+  double trigger_wall_time;
+  double before, after;
+  unsigned devices_count;
+  char (*device_names)[RECORDED_DEVICE_NAME_LENGTH];
+  unsigned samples_count;
+  struct recorded_sample *samples;
+  struct flight_snapshot *next;
+};
+
+struct flight_recorder {
+  char *directory;
+  unsigned triggers_count;
+  struct flight_trigger triggers[FLIGHT_RECORDER_MAX_TRIGGERS];
+  double before, after;
+  // Ring of the samples of the last before + after seconds, grown when the sampling gets faster
+  unsigned capacity;
+  unsigned start;
+  unsigned count;
+  struct recorded_sample *samples;
+  // Snapshot waiting for the samples following its trigger
+  struct flight_snapshot *capture;
+  char capture_description[TRIGGER_DESCRIPTION_LENGTH];
+  // Shared with the writer thread
+  pthread_t writer;
+  pthread_mutex_t lock;
+  pthread_cond_t wake_up;
+  bool stopping;
+  struct flight_snapshot *queue_head;
+  struct flight_snapshot **queue_tail;
+};
+
+static const char *trigger_names[flight_trigger_kind_count] = {
+    [flight_trigger_gpu_util] = "gpu",    [flight_trigger_memory] = "mem",
+    [flight_trigger_temperature] = "temp", [flight_trigger_power] = "power",
+    [flight_trigger_throttle] = "throttle", [flight_trigger_process_exit] = "exit",
+};
+
+bool flight_triggers_parse(const char *spec, unsigned *count,
+                           struct flight_trigger triggers[FLIGHT_RECORDER_MAX_TRIGGERS]) {
+  *count = 0;
+  const char *token = spec;
+  while (*token) {
+    size_t length = strcspn(token, ",");
+    if (*count == FLIGHT_RECORDER_MAX_TRIGGERS)
+      return false;
+    struct flight_trigger *trigger = &triggers[*count];
+    size_t name_length = strcspn(token, "<>,");
+    bool found = false;
+    for (enum flight_trigger_kind kind = 0; !found && kind < flight_trigger_kind_count; ++kind) {
+      if (strlen(trigger_names[kind]) == name_length && !strncmp(token, trigger_names[kind], name_length)) {
+        trigger->kind = kind;
+        found = true;
+      }
+    }
+    if (!found)
+      return false;
+    bool has_threshold = trigger->kind != flight_trigger_throttle && trigger->kind != flight_trigger_process_exit;
+    if (has_threshold) {
+      if (name_length == length)
+        return false;
+      trigger->below = token[name_length] == '<';
+      char *end;
+      trigger->threshold = strtod(token + name_length + 1, &end);
+      if (end != token + length || end == token + name_length + 1)
+        return false;
+    } else if (name_length != length) {
+      return false;
+    }
+    (*count)++;
+    token += length;
+    if (*token == ',')
+      token++;
+  }
+  return *count > 0;
+}
+
+static bool device_metric(const struct gpuinfo_dynamic_info *info, enum flight_trigger_kind kind, double *value) {
+  switch (kind) {
+  case flight_trigger_gpu_util:
+    if (!GPUINFO_DYNAMIC_FIELD_VALID(info, gpu_util_rate))
+      return false;
+    *value = info->gpu_util_rate;
+    return true;
+  case flight_trigger_memory:
+    if (!GPUINFO_DYNAMIC_FIELD_VALID(info, used_memory) || !GPUINFO_DYNAMIC_FIELD_VALID(info, total_memory) ||
+        !info->total_memory)
+      return false;
+    *value = 100. * info->used_memory / info->total_memory;
+    return true;
+  case flight_trigger_temperature:
+    if (!GPUINFO_DYNAMIC_FIELD_VALID(info, gpu_temp))
+      return false;
+    *value = info->gpu_temp;
+    return true;
+  case flight_trigger_power:
+    if (!GPUINFO_DYNAMIC_FIELD_VALID(info, power_draw))
+      return false;
+    *value = info->power_draw / 1000.;
+    return true;
+  default:
+    return false;
+  }
+}
+
+static const char *throttle_reason_names[] = {"power", "thermal", "hardware"};
+#define THROTTLE_REASONS_COUNT (sizeof(throttle_reason_names) / sizeof(*throttle_reason_names))
+
+// Returns true and describes the trigger if it fires between the previous and the current sample
+static bool trigger_fires(const struct flight_trigger *trigger, const struct recorded_sample *previous,
+                          const struct recorded_sample *current, char description[TRIGGER_DESCRIPTION_LENGTH]) {
+  unsigned devices_count = previous->devices_count < current->devices_count ? previous->devices_count
+                                                                            : current->devices_count;
+  for (unsigned dev = 0; dev < devices_count; ++dev) {
+    const struct gpuinfo_dynamic_info *before = &previous->devices[dev], *now = &current->devices[dev];
+    double value_before, value_now;
+    switch (trigger->kind) {
+    case flight_trigger_throttle: {
+      if (!GPUINFO_DYNAMIC_FIELD_VALID(now, throttle_reasons))
+        break;
+      unsigned new_reasons = now->throttle_reasons;
+      if (GPUINFO_DYNAMIC_FIELD_VALID(before, throttle_reasons))
+        new_reasons &= ~before->throttle_reasons;
+      for (unsigned reason = 0; reason < THROTTLE_REASONS_COUNT; ++reason) {
+        if (new_reasons & (1u << reason)) {
+          snprintf(description, TRIGGER_DESCRIPTION_LENGTH, "GPU%u throttle %s", dev, throttle_reason_names[reason]);
+          return true;
+        }
+      }
+    } break;
+    case flight_trigger_process_exit:
+      for (unsigned i = 0; i < previous->processes_count; ++i) {
+        const struct recorded_process *gone = &previous->processes[i];
+        if (gone->device != dev)
+          continue;
+        bool still_running = false;
+        for (unsigned j = 0; !still_running && j < current->processes_count; ++j)
+          still_running = current->processes[j].device == dev && current->processes[j].process.pid == gone->process.pid;
+        if (!still_running) {
+          snprintf(description, TRIGGER_DESCRIPTION_LENGTH, "GPU%u exit %d %.100s", dev, (int)gone->process.pid,
+                   gone->cmdline);
+          return true;
+        }
+      }
+      break;
+    default:
+      if (!device_metric(before, trigger->kind, &value_before) || !device_metric(now, trigger->kind, &value_now))
+        break;
+      bool was_beyond = trigger->below ? value_before < trigger->threshold : value_before > trigger->threshold;
+      bool is_beyond = trigger->below ? value_now < trigger->threshold : value_now > trigger->threshold;
+      if (!was_beyond && is_beyond) {
+        snprintf(description, TRIGGER_DESCRIPTION_LENGTH, "GPU%u %s%c%g (%.1f)", dev, trigger_names[trigger->kind],
+                 trigger->below ? '<' : '>', trigger->threshold, value_now);
+        return true;
+      }
+      break;
+    }
+  }
+  return false;
+}
+
+/*
+ *
+ * Snapshot writer thread
+ *
+ */
+
+static void write_device(FILE *file, unsigned id, const struct gpuinfo_dynamic_info *info) {
+  fprintf(file, "{\"id\":%u", id);
+  if (GPUINFO_DYNAMIC_FIELD_VALID(info, gpu_util_rate))
+    fprintf(file, ",\"gpu_util\":%u", info->gpu_util_rate);
+  if (GPUINFO_DYNAMIC_FIELD_VALID(info, mem_util_rate))
+    fprintf(file, ",\"mem_util\":%u", info->mem_util_rate);
+  if (GPUINFO_DYNAMIC_FIELD_VALID(info, used_memory))
+    fprintf(file, ",\"used_memory\":%llu", info->used_memory);
+  if (GPUINFO_DYNAMIC_FIELD_VALID(info, total_memory))
+    fprintf(file, ",\"total_memory\":%llu", info->total_memory);
+  if (GPUINFO_DYNAMIC_FIELD_VALID(info, gpu_clock_speed))
+    fprintf(file, ",\"gpu_clock_mhz\":%u", info->gpu_clock_speed);
+  if (GPUINFO_DYNAMIC_FIELD_VALID(info, mem_clock_speed))
+    fprintf(file, ",\"mem_clock_mhz\":%u", info->mem_clock_speed);
+  if (GPUINFO_DYNAMIC_FIELD_VALID(info, power_draw))
+    fprintf(file, ",\"power_mw\":%u", info->power_draw);
+  if (GPUINFO_DYNAMIC_FIELD_VALID(info, gpu_temp))
+    fprintf(file, ",\"temp_c\":%u", info->gpu_temp);
+  if (GPUINFO_DYNAMIC_FIELD_VALID(info, fan_speed))
+    fprintf(file, ",\"fan\":%u", info->fan_speed);
+  if (GPUINFO_DYNAMIC_FIELD_VALID(info, pcie_rx))
+    fprintf(file, ",\"pcie_rx_kib\":%u", info->pcie_rx);
+  if (GPUINFO_DYNAMIC_FIELD_VALID(info, pcie_tx))
+    fprintf(file, ",\"pcie_tx_kib\":%u", info->pcie_tx);
+  if (GPUINFO_DYNAMIC_FIELD_VALID(info, encoder_rate))
+    fprintf(file, ",\"encoder\":%u", info->encoder_rate);
+  if (GPUINFO_DYNAMIC_FIELD_VALID(info, decoder_rate))
+    fprintf(file, ",\"decoder\":%u", info->decoder_rate);
+  if (GPUINFO_DYNAMIC_FIELD_VALID(info, throttle_reasons)) {
+    fputs(",\"throttle\":[", file);
+    bool first = true;
+    for (unsigned reason = 0; reason < THROTTLE_REASONS_COUNT; ++reason) {
+      if (info->throttle_reasons & (1u << reason)) {
+        fprintf(file, "%s\"%s\"", first ? "" : ",", throttle_reason_names[reason]);
+        first = false;
+      }
+    }
+    fputc(']', file);
+  }
+  fputc('}', file);
+}
+
+static void write_process(FILE *file, const struct recorded_process *recorded) {
+  const struct gpu_process *process = &recorded->process;
+  fprintf(file, "{\"device\":%u,\"pid\":%d", recorded->device, (int)process->pid);
+  fputs(",\"user\":", file);
+  json_write_string(file, recorded->user_name, 0);
+  fputs(",\"command\":", file);
+  json_write_string(file, recorded->cmdline, 0);
+  if (GPUINFO_PROCESS_FIELD_VALID(process, gpu_usage))
+    fprintf(file, ",\"gpu_usage\":%u", process->gpu_usage);
+  if (GPUINFO_PROCESS_FIELD_VALID(process, gpu_memory_usage))
+    fprintf(file, ",\"gpu_memory\":%llu", process->gpu_memory_usage);
+  if (GPUINFO_PROCESS_FIELD_VALID(process, encode_usage))
+    fprintf(file, ",\"encode_usage\":%u", process->encode_usage);
+  if (GPUINFO_PROCESS_FIELD_VALID(process, decode_usage))
+    fprintf(file, ",\"decode_usage\":%u", process->decode_usage);
+  if (GPUINFO_PROCESS_FIELD_VALID(process, cpu_usage))
+    fprintf(file, ",\"cpu_usage\":%u", process->cpu_usage);
+  if (GPUINFO_PROCESS_FIELD_VALID(process, cpu_memory_res))
+    fprintf(file, ",\"cpu_memory\":%lu", process->cpu_memory_res);
+  fputc('}', file);
+}
+
+static void snapshot_file_name(const char *directory, double trigger_time, char *path, size_t size) {
+  time_t seconds = (time_t)trigger_time;
+  struct tm local;
+  char date[32] = "unknown";
+  if (localtime_r(&seconds, &local))
+    strftime(date, sizeof(date), "%Y%m%d-%H%M%S", &local);
+  snprintf(path, size, "%s/nvtop-flight-%s-%03d.jsonl", directory, date,
+           (int)((trigger_time - (double)seconds) * 1000.) % 1000);
+}
+
+static void write_snapshot(const char *directory, const struct flight_snapshot *snapshot) {
+  char path[4096];
+  snapshot_file_name(directory, snapshot->trigger_wall_time, path, sizeof(path));
+  FILE *file = fopen(path, "wx");
+  if (!file) {
+    fprintf(stderr, "Cannot write the flight recording %s: %s\n", path, strerror(errno));
+    return;
+  }
+  fputs("{\"trigger\":", file);
+  json_write_string(file, snapshot->description, 0);
+  fprintf(file, ",\"time\":%.3f,\"before\":%g,\"after\":%g,\"devices\":[", snapshot->trigger_wall_time,
+          snapshot->before, snapshot->after);
+  for (unsigned dev = 0; dev < snapshot->devices_count; ++dev) {
+    if (dev)
+      fputc(',', file);
+    json_write_string(file, snapshot->device_names[dev], 0);
+  }
+  fputs("]}\n", file);
+  for (unsigned i = 0; i < snapshot->samples_count; ++i) {
+    const struct recorded_sample *sample = &snapshot->samples[i];
+    fprintf(file, "{\"time\":%.3f,\"devices\":[", sample->wall_time);
+    for (unsigned dev = 0; dev < sample->devices_count; ++dev) {
+      if (dev)
+        fputc(',', file);
+      write_device(file, dev, &sample->devices[dev]);
+    }
+    fputs("],\"processes\":[", file);
+    for (unsigned j = 0; j < sample->processes_count; ++j) {
+      if (j)
+        fputc(',', file);
+      write_process(file, &sample->processes[j]);
+    }
+    fputs("]}\n", file);
+  }
+  // A truncated recording would still look like a valid one
+  bool failed = ferror(file);
+  if (fclose(file) != 0 || failed) {
+    fprintf(stderr, "Cannot write the flight recording %s: %s\n", path, strerror(errno));
+    unlink(path);
+  }
+}
+
+static void free_sample_buffers(struct recorded_sample *sample) {
+  free(sample->devices);
+  free(sample->processes);
+}
+
+static void free_snapshot(struct flight_snapshot *snapshot) {
+  for (unsigned i = 0; i < snapshot->samples_count; ++i)
+    free_sample_buffers(&snapshot->samples[i]);
+  free(snapshot->samples);
+  free(snapshot->device_names);
+  free(snapshot);
+}
+
+static void *snapshot_writer(void *arg) {
+  struct flight_recorder *recorder = arg;
+  pthread_mutex_lock(&recorder->lock);
+  while (true) {
+    while (!recorder->queue_head && !recorder->stopping)
+      pthread_cond_wait(&recorder->wake_up, &recorder->lock);
+    struct flight_snapshot *snapshot = recorder->queue_head;
+    if (!snapshot)
+      break;
+    recorder->queue_head = snapshot->next;
+    if (!recorder->queue_head)
+      recorder->queue_tail = &recorder->queue_head;
+    pthread_mutex_unlock(&recorder->lock);
+    write_snapshot(recorder->directory, snapshot);
+    free_snapshot(snapshot);
+    pthread_mutex_lock(&recorder->lock);
+  }
+  pthread_mutex_unlock(&recorder->lock);
+  return NULL;
+}
+
+/*
+ *
+ * Sampling side
+ *
+ */
+
+#define FLIGHT_RECORDER_INITIAL_CAPACITY 16
+
+struct flight_recorder *flight_recorder_open(const char *directory, const char *triggers, double before, double after) {
+  struct flight_trigger parsed[FLIGHT_RECORDER_MAX_TRIGGERS];
+  unsigned triggers_count;
+  if (!flight_triggers_parse(triggers, &triggers_count, parsed)) {
+    fprintf(stderr, "Invalid flight recorder triggers: %s\n", triggers);
+    return NULL;
+  }
+  if (access(directory, W_OK | X_OK) != 0) {
+    fprintf(stderr, "Cannot write the flight recordings to %s: %s\n", directory, strerror(errno));
+    return NULL;
+  }
+  struct flight_recorder *recorder = calloc(1, sizeof(*recorder));
+  if (!recorder) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  recorder->directory = strdup(directory);
+  recorder->triggers_count = triggers_count;
+  memcpy(recorder->triggers, parsed, triggers_count * sizeof(*parsed));
+  recorder->before = before;
+  recorder->after = after;
+  recorder->capacity = FLIGHT_RECORDER_INITIAL_CAPACITY;
+  recorder->samples = calloc(recorder->capacity, sizeof(*recorder->samples));
+  if (!recorder->directory || !recorder->samples) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  recorder->queue_tail = &recorder->queue_head;
+  pthread_mutex_init(&recorder->lock, NULL);
+  pthread_cond_init(&recorder->wake_up, NULL);
+  if (pthread_create(&recorder->writer, NULL, snapshot_writer, recorder) != 0) {
+    fprintf(stderr, "Cannot start the flight recorder writer thread\n");
+    pthread_mutex_destroy(&recorder->lock);
+    pthread_cond_destroy(&recorder->wake_up);
+    free(recorder->samples);
+    free(recorder->directory);
+    free(recorder);
+    return NULL;
+  }
+  return recorder;
+}
+
+static struct recorded_sample *ring_sample(struct flight_recorder *recorder, unsigned index) {
+  unsigned location = recorder->start + index;
+  if (location >= recorder->capacity)
+    location -= recorder->capacity;
+  return &recorder->samples[location];
+}
+
+static void record_sample(struct recorded_sample *sample, struct list_head *devices, double time, double wall_time) {
+  sample->time = time;
+  sample->wall_time = wall_time;
+  sample->devices_count = 0;
+  sample->processes_count = 0;
+  struct gpu_info *device;
+  list_for_each_entry(device, devices, list) {
+    if (sample->devices_count == sample->devices_capacity) {
+      sample->devices_capacity = sample->devices_capacity ? 2 * sample->devices_capacity : 4;
+      sample->devices = reallocarray(sample->devices, sample->devices_capacity, sizeof(*sample->devices));
+      if (!sample->devices) {
+        perror("Could not re-allocate memory: ");
+        exit(EXIT_FAILURE);
+      }
+    }
+    unsigned dev = sample->devices_count++;
+    sample->devices[dev] = device->dynamic_info;
+    for (unsigned i = 0; i < device->processes_count; ++i) {
+      if (sample->processes_count == sample->processes_capacity) {
+        sample->processes_capacity = sample->processes_capacity ? 2 * sample->processes_capacity : 8;
+        sample->processes = reallocarray(sample->processes, sample->processes_capacity, sizeof(*sample->processes));
+        if (!sample->processes) {
+          perror("Could not re-allocate memory: ");
+          exit(EXIT_FAILURE);
+        }
+      }
+      struct recorded_process *recorded = &sample->processes[sample->processes_count++];
+      const struct gpu_process *process = &device->processes[i];
+      recorded->device = dev;
+      recorded->process = *process;
+      recorded->process.cmdline = NULL;
+      recorded->process.user_name = NULL;
+      snprintf(recorded->cmdline, sizeof(recorded->cmdline), "%s",
+               GPUINFO_PROCESS_FIELD_VALID(process, cmdline) ? process->cmdline : "");
+      snprintf(recorded->user_name, sizeof(recorded->user_name), "%s",
+               GPUINFO_PROCESS_FIELD_VALID(process, user_name) ? process->user_name : "");
+    }
+  }
+}
+
+static void copy_sample(const struct recorded_sample *sample, struct recorded_sample *copy) {
+  *copy = *sample;
+  copy->devices_capacity = sample->devices_count;
+  copy->processes_capacity = sample->processes_count;
+  copy->devices = malloc(sample->devices_count * sizeof(*copy->devices));
+  copy->processes = malloc(sample->processes_count * sizeof(*copy->processes));
+  if ((sample->devices_count && !copy->devices) || (sample->processes_count && !copy->processes)) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  memcpy(copy->devices, sample->devices, sample->devices_count * sizeof(*copy->devices));
+  memcpy(copy->processes, sample->processes, sample->processes_count * sizeof(*copy->processes));
+}
+
+static void start_capture(struct flight_recorder *recorder, struct list_head *devices, double time, double wall_time) {
+  struct flight_snapshot *snapshot = calloc(1, sizeof(*snapshot));
+  if (!snapshot) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  snprintf(snapshot->description, sizeof(snapshot->description), "%s", recorder->capture_description);
+  snapshot->trigger_time = time;
+  snapshot->trigger_wall_time = wall_time;
+  snapshot->before = recorder->before;
+  snapshot->after = recorder->after;
+  struct gpu_info *device;
+  list_for_each_entry(device, devices, list) { snapshot->devices_count++; }
+  snapshot->device_names = calloc(snapshot->devices_count + 1, sizeof(*snapshot->device_names));
+  if (!snapshot->device_names) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  unsigned dev = 0;
+  list_for_each_entry(device, devices, list) {
+    snprintf(snapshot->device_names[dev++], RECORDED_DEVICE_NAME_LENGTH, "%s",
+             GPUINFO_STATIC_FIELD_VALID(&device->static_info, device_name) ? device->static_info.device_name
+                                                                          : device->pdev);
+  }
+  recorder->capture = snapshot;
+}
+
+// Copies the samples of the window out of the ring and hands them over to the writer thread
+static void queue_capture(struct flight_recorder *recorder) {
+  struct flight_snapshot *snapshot = recorder->capture;
+  recorder->capture = NULL;
+  unsigned first = 0;
+  while (first < recorder->count && ring_sample(recorder, first)->time < snapshot->trigger_time - recorder->before)
+    first++;
+  snapshot->samples_count = recorder->count - first;
+  snapshot->samples = malloc(snapshot->samples_count * sizeof(*snapshot->samples));
+  if (snapshot->samples_count && !snapshot->samples) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  for (unsigned i = 0; i < snapshot->samples_count; ++i)
+    copy_sample(ring_sample(recorder, first + i), &snapshot->samples[i]);
+
+  pthread_mutex_lock(&recorder->lock);
+  *recorder->queue_tail = snapshot;
+  recorder->queue_tail = &snapshot->next;
+  pthread_cond_signal(&recorder->wake_up);
+  pthread_mutex_unlock(&recorder->lock);
+}
+
+// Unrolls the ring into a larger one, the samples keep their buffers
+static void grow_ring(struct flight_recorder *recorder) {
+  unsigned capacity = 2 * recorder->capacity;
+  struct recorded_sample *samples = calloc(capacity, sizeof(*samples));
+  if (!samples) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  for (unsigned i = 0; i < recorder->capacity; ++i)
+    samples[i] = *ring_sample(recorder, i);
+  free(recorder->samples);
+  recorder->samples = samples;
+  recorder->capacity = capacity;
+  recorder->start = 0;
+}
+
+void flight_recorder_sample(struct flight_recorder *recorder, struct list_head *devices, double time,
+                            double wall_time) {
+  // The samples older than any window are evicted by age, whatever the update interval. The latest one stays for the
+  // triggers to compare against.
+  while (recorder->count > 1 && ring_sample(recorder, 0)->time < time - recorder->before - recorder->after) {
+    recorder->start = recorder->start + 1 == recorder->capacity ? 0 : recorder->start + 1;
+    recorder->count--;
+  }
+  if (recorder->count == recorder->capacity)
+    grow_ring(recorder);
+  struct recorded_sample *sample = ring_sample(recorder, recorder->count++);
+  record_sample(sample, devices, time, wall_time);
+
+  // The triggers firing while a snapshot is being recorded are part of it
+  if (!recorder->capture && recorder->count >= 2) {
+    const struct recorded_sample *previous = ring_sample(recorder, recorder->count - 2);
+    for (unsigned i = 0; !recorder->capture && i < recorder->triggers_count; ++i) {
+      if (trigger_fires(&recorder->triggers[i], previous, sample, recorder->capture_description))
+        start_capture(recorder, devices, time, wall_time);
+    }
+  }
+  if (recorder->capture && time >= recorder->capture->trigger_time + recorder->after)
+    queue_capture(recorder);
+}
+
+void flight_recorder_close(struct flight_recorder *recorder) {
+  if (!recorder)
+    return;
+  if (recorder->capture)
+    queue_capture(recorder);
+  pthread_mutex_lock(&recorder->lock);
+  recorder->stopping = true;
+  pthread_cond_signal(&recorder->wake_up);
+  pthread_mutex_unlock(&recorder->lock);
+  pthread_join(recorder->writer, NULL);
+  pthread_mutex_destroy(&recorder->lock);
+  pthread_cond_destroy(&recorder->wake_up);
+  for (unsigned i = 0; i < recorder->capacity; ++i)
+    free_sample_buffers(&recorder->samples[i]);
+  free(recorder->samples);
+  free(recorder->directory);
+  free(recorder);
+}
@@ -25,6 +25,7 @@
 #include <pwd.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -100,6 +101,74 @@ void get_command_from_pid(pid_t pid, char **buffer) {
   }
 }
 
+void get_cgroup_from_pid(pid_t pid, char *buffer, size_t size) {
+  buffer[0] = '\0';
+  int written = snprintf(pid_path, pid_path_size, "/proc/%" PRIdMAX "/cgroup", (intmax_t)pid);
+  if (written == pid_path_size)
+    return;
+  FILE *cgroup_file = fopen(pid_path, "r");
+  if (!cgroup_file)
+    return;
+  // Lines are "hierarchy-ID:controllers:path", the unified hierarchy has ID 0 and no controller
+  char line[pid_path_size + 64];
+  bool unified_found = false;
+  while (!unified_found && fgets(line, sizeof(line), cgroup_file)) {
+    const char *controllers = strchr(line, ':');
+    const char *path = controllers ? strchr(controllers + 1, ':') : NULL;
+    if (!path)
+      continue;
+    unified_found = strncmp(line, "0::", 3) == 0;
+    if (unified_found || strncmp(controllers + 1, "name=systemd:", strlen("name=systemd:")) == 0) {
+      snprintf(buffer, size, "%s", path + 1);
+      buffer[strcspn(buffer, "\n")] = '\0';
+    }
+  }
+  fclose(cgroup_file);
+}
+
+#define environ_increment 4096
+
+void get_environ_value_from_pid(pid_t pid, const char *const *names, unsigned names_count, char *buffer,
+                                size_t size) {
+  buffer[0] = '\0';
+  int written = snprintf(pid_path, pid_path_size, "/proc/%" PRIdMAX "/environ", (intmax_t)pid);
+  if (written == pid_path_size)
+    return;
+  // Only readable by the owner of the process (or root)
+  FILE *environ_file = fopen(pid_path, "r");
+  if (!environ_file)
+    return;
+  size_t environ_size = 0, total_read = 0;
+  char *environment = NULL;
+  do {
+    if (total_read == environ_size) {
+      environ_size += environ_increment;
+      environment = realloc(environment, environ_size + 1);
+      if (!environment) {
+        perror("Could not re-allocate memory: ");
+        exit(EXIT_FAILURE);
+      }
+    }
+    total_read += fread(&environment[total_read], 1, environ_size - total_read, environ_file);
+  } while (!feof(environ_file) && !ferror(environ_file));
+  fclose(environ_file);
+  environment[total_read] = '\0';
+
+  // The entries are "NAME=value" separated by null characters, the first name in the list wins
+  bool found = false;
+  for (unsigned name_idx = 0; !found && name_idx < names_count; ++name_idx) {
+    size_t name_length = strlen(names[name_idx]);
+    for (size_t entry = 0; !found && entry < total_read; entry += strlen(&environment[entry]) + 1) {
+      if (strncmp(&environment[entry], names[name_idx], name_length) == 0 && environment[entry + name_length] == '=' &&
+          environment[entry + name_length + 1]) {
+        snprintf(buffer, size, "%s", &environment[entry + name_length + 1]);
+        found = true;
+      }
+    }
+  }
+  free(environment);
+}
+
 /*
  *
  * From man 5 proc of /proc/<pid>/stat
@@ -176,6 +245,63 @@ void get_command_from_pid(pid_t pid, char **buffer) {
  *
  */
 
+// Large enough for the Cpus_allowed_list of a fragmented 1024 CPUs mask
+#define keyed_value_size 4096
+
+// Reads the "key: value" lines of /proc/<pid>/status and /proc/<pid>/io. Values not found are set to an empty string.
+static void get_process_keyed_values(pid_t pid, const char *file, unsigned num_keys, const char *keys[num_keys],
+                                     char values[num_keys][keyed_value_size]) {
+  for (unsigned i = 0; i < num_keys; ++i)
+    values[i][0] = '\0';
+  int written = snprintf(pid_path, pid_path_size, "/proc/%" PRIdMAX "/%s", (intmax_t)pid, file);
+  if (written == pid_path_size)
+    return;
+  FILE *keyed_file = fopen(pid_path, "r");
+  if (!keyed_file)
+    return;
+  unsigned found = 0;
+  char line[keyed_value_size];
+  while (found < num_keys && fgets(line, sizeof(line), keyed_file)) {
+    for (unsigned i = 0; i < num_keys; ++i) {
+      size_t key_len = strlen(keys[i]);
+      if (strncmp(line, keys[i], key_len) == 0 && line[key_len] == ':') {
+        const char *value = &line[key_len + 1];
+        while (*value == ' ' || *value == '\t')
+          value++;
+        strncpy(values[i], value, keyed_value_size - 1);
+        values[i][keyed_value_size - 1] = '\0';
+        values[i][strcspn(values[i], "\n")] = '\0';
+        found++;
+        break;
+      }
+    }
+  }
+  fclose(keyed_file);
+}
+
+static bool keyed_value_to_ull(const char *value, unsigned long long *result) {
+  char *end;
+  *result = strtoull(value, &end, 10);
+  return end != value;
+}
+
+// The kernel reports no block I/O delay at all without the delay accounting. The sysctl appeared in Linux 5.14, before
+// it the accounting is on unless booted with nodelayacct.
+static bool delay_accounting_enabled(void) {
+  static int enabled = -1;
+  if (enabled < 0) {
+    int value = 1;
+    FILE *sysctl = fopen("/proc/sys/kernel/task_delayacct", "r");
+    if (sysctl) {
+      if (fscanf(sysctl, "%d", &value) != 1)
+        value = 1;
+      fclose(sysctl);
+    }
+    enabled = value != 0;
+  }
+  return enabled;
+}
+
 bool get_process_info(pid_t pid, struct process_cpu_usage *usage) {
   double clock_ticks_per_second = sysconf(_SC_CLK_TCK);
   size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
@@ -188,21 +314,56 @@ bool get_process_info(pid_t pid, struct process_cpu_usage *usage) {
     return false;
   }
   nvtop_get_current_time(&usage->timestamp);
+  int parent_pid;
   unsigned long total_user_time;   // in clock_ticks
   unsigned long total_kernel_time; // in clock_ticks
   unsigned long virtual_memory;    // In bytes
   long resident_memory;            // In page number?
+  unsigned long long start_time;   // in clock_ticks since boot
+  unsigned long long io_delays;    // in clock_ticks, requires the kernel delay accounting
 
   int retval = fscanf(stat_file,
-                      "%*d %*[^)]) %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u "
-                      "%*u %lu %lu %*d %*d %*d %*d %*d %*d %*u %lu %ld",
-                      &total_user_time, &total_kernel_time, &virtual_memory, &resident_memory);
+                      "%*d %*[^)]) %*c %d %*d %*d %*d %*d %*u %*u %*u %*u "
+                      "%*u %lu %lu %*d %*d %*d %*d %*d %*d %llu %lu %ld "
+                      "%*u %*u %*u %*u %*u %*u %*u %*u %*u %*u %*u %*u %*u %*d %*d %*u %*u %llu",
+                      &parent_pid, &total_user_time, &total_kernel_time, &start_time, &virtual_memory,
+                      &resident_memory, &io_delays);
   fclose(stat_file);
-  if (retval != 4)
+  if (retval < 6)
     return false;
+  usage->parent_pid = parent_pid;
   usage->total_user_time = total_user_time / clock_ticks_per_second;
   usage->total_kernel_time = total_kernel_time / clock_ticks_per_second;
   usage->virtual_memory = virtual_memory;
   usage->resident_memory = (size_t)resident_memory * page_size;
+  usage->start_time = start_time;
+  usage->start_time_valid = true;
+  usage->io_wait_valid = retval == 7 && delay_accounting_enabled();
+  if (usage->io_wait_valid)
+    usage->total_io_wait_time = io_delays / clock_ticks_per_second;
+
+  // The context switches are the ones of the thread group leader only, the kernel does not sum them over the threads
+  static const char *status_keys[] = {"voluntary_ctxt_switches", "nonvoluntary_ctxt_switches", "Cpus_allowed_list",
+                                      "Mems_allowed_list", "NSpid"};
+  static char values[5][keyed_value_size];
+  get_process_keyed_values(pid, "status", 5, status_keys, values);
+  unsigned long long voluntary, involuntary;
+  usage->ctx_switches_valid = keyed_value_to_ull(values[0], &voluntary) && keyed_value_to_ull(values[1], &involuntary);
+  if (usage->ctx_switches_valid) {
+    usage->voluntary_ctx_switches = voluntary;
+    usage->involuntary_ctx_switches = involuntary;
+  }
+  usage->affinity_valid = host_mask_from_list(values[2], &usage->cpus_allowed) &&
+                          host_mask_from_list(values[3], &usage->mems_allowed);
+  // One pid per nested namespace, the last one being seen from inside the innermost
+  const char *innermost_pid = strrchr(values[4], '\t');
+  usage->namespace_pid_valid = innermost_pid != NULL;
+  if (usage->namespace_pid_valid)
+    usage->namespace_pid = (pid_t)strtol(innermost_pid + 1, NULL, 10);
+
+  // Only readable by the owner of the process
+  static const char *io_keys[] = {"read_bytes"};
+  get_process_keyed_values(pid, "io", 1, io_keys, values);
+  usage->read_bytes_valid = keyed_value_to_ull(values[0], &usage->read_bytes);
   return true;
 }
@@ -114,6 +114,21 @@ error_free_procargs:
   return;
 }
 
+void get_cgroup_from_pid(pid_t pid, char *buffer, size_t size) {
+  (void)pid;
+  (void)size;
+  buffer[0] = '\0';
+}
+
+void get_environ_value_from_pid(pid_t pid, const char *const *names, unsigned names_count, char *buffer,
+                                size_t size) {
+  (void)pid;
+  (void)names;
+  (void)names_count;
+  (void)size;
+  buffer[0] = '\0';
+}
+
 bool get_process_info(pid_t pid, struct process_cpu_usage *usage) {
   struct proc_taskinfo proc;
   const int st = proc_pidinfo(pid, PROC_PIDTASKINFO, 0, &proc, PROC_PIDTASKINFO_SIZE);
@@ -133,5 +148,18 @@ bool get_process_info(pid_t pid, struct process_cpu_usage *usage) {
   usage->total_kernel_time = (proc.pti_total_system * nanoseconds_per_tick) / 1000000000.0;
   usage->virtual_memory = proc.pti_virtual_size;
   usage->resident_memory = proc.pti_resident_size;
+  usage->io_wait_valid = false;
+  usage->ctx_switches_valid = false;
+  usage->read_bytes_valid = false;
+  usage->affinity_valid = false;
+  usage->namespace_pid_valid = false;
+  usage->start_time_valid = false;
+
+  struct proc_bsdshortinfo bsdinfo;
+  if (proc_pidinfo(pid, PROC_PIDT_SHORTBSDINFO, 0, &bsdinfo, PROC_PIDT_SHORTBSDINFO_SIZE) ==
+      PROC_PIDT_SHORTBSDINFO_SIZE)
+    usage->parent_pid = bsdinfo.pbsi_ppid;
+  else
+    usage->parent_pid = -1;
   return true;
 }
@@ -0,0 +1,139 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "nvtop/host_locality.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void host_mask_set(struct host_mask *mask, unsigned id) {
+  if (id < HOST_MASK_MAX_IDS)
+    mask->bits[id / 64] |= UINT64_C(1) << (id % 64);
+}
+
+bool host_mask_is_set(const struct host_mask *mask, unsigned id) {
+  if (id >= HOST_MASK_MAX_IDS)
+    return false;
+  return mask->bits[id / 64] & (UINT64_C(1) << (id % 64));
+}
+
+bool host_mask_from_list(const char *list, struct host_mask *mask) {
+  memset(mask, 0, sizeof(*mask));
+  const char *current = list;
+  while (isspace(*current))
+    current++;
+  if (*current == '\0')
+    return false;
+  while (*current != '\0' && !isspace(*current)) {
+    char *end;
+    unsigned long first = strtoul(current, &end, 10);
+    if (end == current)
+      return false;
+    unsigned long last = first;
+    current = end;
+    if (*current == '-') {
+      current++;
+      last = strtoul(current, &end, 10);
+      if (end == current || last < first)
+        return false;
+      current = end;
+    }
+    // Ids past the mask size are dropped
+    for (unsigned long id = first; id <= last && id < HOST_MASK_MAX_IDS; ++id)
+      host_mask_set(mask, id);
+    if (*current == ',')
+      current++;
+    else if (*current != '\0' && !isspace(*current))
+      return false;
+  }
+  return true;
+}
+
+bool host_mask_intersects(const struct host_mask *mask1, const struct host_mask *mask2) {
+  for (unsigned i = 0; i < HOST_MASK_MAX_IDS / 64; ++i) {
+    if (mask1->bits[i] & mask2->bits[i])
+      return true;
+  }
+  return false;
+}
+
+bool host_mask_is_subset(const struct host_mask *subset, const struct host_mask *mask) {
+  for (unsigned i = 0; i < HOST_MASK_MAX_IDS / 64; ++i) {
+    if (subset->bits[i] & ~mask->bits[i])
+      return false;
+  }
+  return true;
+}
+
+#ifdef __linux__
+
+static bool read_pci_device_attribute(const char *pdev, const char *attribute, char *buffer, size_t size) {
+  char path[256];
+  int written = snprintf(path, sizeof(path), "/sys/bus/pci/devices/%s/%s", pdev, attribute);
+  if (written < 0 || (size_t)written >= sizeof(path))
+    return false;
+  // The sysfs PCI addresses are lower case while some drivers report them in upper case
+  for (char *c = path + strlen("/sys/bus/pci/devices/"); *c != '/'; ++c)
+    *c = tolower(*c);
+  FILE *attribute_file = fopen(path, "r");
+  if (!attribute_file)
+    return false;
+  bool success = fgets(buffer, size, attribute_file) != NULL;
+  fclose(attribute_file);
+  return success;
+}
+
+bool host_locality_of_pci_device(const char *pdev, int *numa_node, struct host_mask *local_cpus) {
+  char buffer[4096];
+  if (pdev[0] == '\0' || !read_pci_device_attribute(pdev, "numa_node", buffer, sizeof(buffer)))
+    return false;
+  // -1 on single node machines
+  *numa_node = atoi(buffer);
+  if (*numa_node < 0)
+    return false;
+  if (!read_pci_device_attribute(pdev, "local_cpulist", buffer, sizeof(buffer)))
+    return false;
+  return host_mask_from_list(buffer, local_cpus);
+}
+
+#else
+
+bool host_locality_of_pci_device(const char *pdev, int *numa_node, struct host_mask *local_cpus) {
+  (void)pdev;
+  (void)numa_node;
+  (void)local_cpus;
+  return false;
+}
+
+#endif
+
+enum host_locality host_locality_classify(int device_node, const struct host_mask *device_cpus,
+                                          const struct host_mask *cpus_allowed, const struct host_mask *mems_allowed) {
+  if (!host_mask_intersects(cpus_allowed, device_cpus) || !host_mask_is_set(mems_allowed, device_node))
+    return host_locality_remote;
+  struct host_mask device_node_mask = {0};
+  host_mask_set(&device_node_mask, device_node);
+  if (host_mask_is_subset(cpus_allowed, device_cpus) && host_mask_is_subset(mems_allowed, &device_node_mask))
+    return host_locality_local;
+  return host_locality_any;
+}
@@ -0,0 +1,126 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "nvtop/idle_report.h"
+#include "nvtop/common.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define IDLE_REPORT_USER_LEN 16
+#define IDLE_REPORT_COMMAND_LEN 96
+
+struct idle_report_entry {
+  pid_t pid;
+  char pdev[PDEV_LEN];
+  char user_name[IDLE_REPORT_USER_LEN];
+  char cmdline[IDLE_REPORT_COMMAND_LEN];
+  double idle_memory_time; // byte-seconds
+  double idle_seconds;
+  double observed_seconds;
+  unsigned long long gpu_memory_peak;
+};
+
+struct idle_report {
+  unsigned long long threshold;
+  unsigned size;
+  unsigned count;
+  struct idle_report_entry *entries; // Sorted from the most memory·time held while idle
+};
+
+struct idle_report *idle_report_open(unsigned count, unsigned long long threshold) {
+  struct idle_report *report = calloc(1, sizeof(*report));
+  if (!report) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  report->threshold = threshold;
+  report->size = count;
+  report->entries = calloc(count ? count : 1, sizeof(*report->entries));
+  if (!report->entries) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  return report;
+}
+
+void idle_report_record(const struct gpu_info *device, const struct gpu_process *process, double observed_seconds,
+                        void *data) {
+  struct idle_report *report = data;
+  if (!GPUINFO_PROCESS_FIELD_VALID(process, idle_memory_time) || process->idle_memory_time <= 0.)
+    return;
+  // Only the worst offenders are kept
+  unsigned position = report->count;
+  while (position > 0 && report->entries[position - 1].idle_memory_time < process->idle_memory_time)
+    position--;
+  if (position == report->size)
+    return;
+  unsigned moved = report->count < report->size ? report->count - position : report->count - position - 1;
+  memmove(&report->entries[position + 1], &report->entries[position], moved * sizeof(*report->entries));
+  if (report->count < report->size)
+    report->count++;
+
+  struct idle_report_entry *entry = &report->entries[position];
+  memset(entry, 0, sizeof(*entry));
+  entry->pid = process->pid;
+  snprintf(entry->pdev, sizeof(entry->pdev), "%s", device->pdev);
+  snprintf(entry->user_name, sizeof(entry->user_name), "%s",
+           GPUINFO_PROCESS_FIELD_VALID(process, user_name) ? process->user_name : "N/A");
+  snprintf(entry->cmdline, sizeof(entry->cmdline), "%s",
+           GPUINFO_PROCESS_FIELD_VALID(process, cmdline) ? process->cmdline : "");
+  entry->idle_memory_time = process->idle_memory_time;
+  entry->idle_seconds = GPUINFO_PROCESS_FIELD_VALID(process, idle_time) ? (double)process->idle_time / 1e9 : 0.;
+  entry->observed_seconds = observed_seconds;
+  entry->gpu_memory_peak = GPUINFO_PROCESS_FIELD_VALID(process, gpu_memory_peak) ? process->gpu_memory_peak : 0ull;
+}
+
+static void format_seconds(char *buffer, size_t size, double seconds) {
+  if (seconds < 60.)
+    snprintf(buffer, size, "%.1fs", seconds);
+  else if (seconds < 3600.)
+    snprintf(buffer, size, "%um%02us", (unsigned)seconds / 60, (unsigned)seconds % 60);
+  else
+    snprintf(buffer, size, "%uh%02um", (unsigned)seconds / 3600, (unsigned)seconds / 60 % 60);
+}
+
+void idle_report_close(struct idle_report *report, FILE *file) {
+  if (!report)
+    return;
+  double threshold_gib = report->threshold / 1073741824.;
+  if (!report->count) {
+    fprintf(file, "No process held more than %.1f GiB of GPU memory while idle\n", threshold_gib);
+  } else {
+    fprintf(file, "Processes holding the most GPU memory while idle (above %.1f GiB)\n", threshold_gib);
+    fputs("RANK     PID DEVICE           USER        IDLE HELD IDLE TIME  OBSERVED   PEAK MEM COMMAND\n", file);
+    for (unsigned i = 0; i < report->count; ++i) {
+      const struct idle_report_entry *entry = &report->entries[i];
+      char held[24], idle[16], observed[16], peak[24];
+      snprintf(held, sizeof(held), "%.2fGiBh", entry->idle_memory_time / (1073741824. * 3600.));
+      format_seconds(idle, sizeof(idle), entry->idle_seconds);
+      format_seconds(observed, sizeof(observed), entry->observed_seconds);
+      snprintf(peak, sizeof(peak), "%lluMiB", entry->gpu_memory_peak / 1048576ull);
+      fprintf(file, "%4u %7d %-16s %-10.10s %10s %9s %9s %10s %s\n", i + 1, (int)entry->pid, entry->pdev,
+              entry->user_name, held, idle, observed, peak, entry->cmdline);
+    }
+  }
+  free(report->entries);
+  free(report);
+}
@@ -23,24 +23,32 @@
 #include "nvtop/common.h"
 #include "nvtop/extract_gpuinfo_common.h"
 #include "nvtop/interface_common.h"
+#include "nvtop/interface_heatmap.h"
+#include "nvtop/interface_imbalance.h"
 #include "nvtop/interface_internal_common.h"
 #include "nvtop/interface_layout_selection.h"
 #include "nvtop/interface_options.h"
+#include "nvtop/interface_process_groups.h"
 #include "nvtop/interface_ring_buffer.h"
 #include "nvtop/interface_setup_win.h"
+#include "nvtop/memory_trend.h"
 #include "nvtop/plot.h"
+#include "nvtop/plot_scale.h"
 #include "nvtop/time.h"
 
 #include <assert.h>
 #include <inttypes.h>
+#include <limits.h>
 #include <ncurses.h>
 #include <signal.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/ioctl.h>
 #include <tgmath.h>
 #include <unistd.h>
+#include <uthash.h>
 
 static unsigned int sizeof_device_field[device_field_count] = {
     [device_name] = 11,       [device_fan_speed] = 11,  [device_temperature] = 10,
@@ -52,7 +60,11 @@ static unsigned int sizeof_process_field[process_field_count] = {
     [process_pid] = 7,       [process_user] = 4,          [process_gpu_id] = 3,   [process_type] = 8,
     [process_gpu_rate] = 4,  [process_enc_rate] = 4,      [process_dec_rate] = 4,
     [process_memory] = 14, // 9 for mem 5 for %
-    [process_cpu_usage] = 6, [process_cpu_mem_usage] = 9, [process_command] = 0,
+    [process_cpu_usage] = 6, [process_cpu_mem_usage] = 9, [process_io_read] = 9,
+    [process_starvation] = 7, [process_numa] = 6,         [process_energy] = 7,
+    [process_gpu_time] = 8,   [process_memory_peak] = 9,  [process_gpu_average] = 7,
+    [process_idle_held] = 9,  [process_memory_growth] = 9, [process_time_to_oom] = 6,
+    [process_namespace_pid] = 7, [process_job_id] = 3,   [process_command] = 0,
 };
 
 static void alloc_device_window(unsigned int start_row, unsigned int start_col, unsigned int totalcol,
@@ -214,6 +226,7 @@ static void alloc_process_with_option(struct nvtop_interface *interface, unsigne
   }
   interface->process.selected_row = 0;
   interface->process.selected_pid = -1;
+  interface->process.selected_host_id = 0;
   interface->process.offset_column = 0;
   interface->process.offset = 0;
 
@@ -225,63 +238,43 @@ static void alloc_process_with_option(struct nvtop_interface *interface, unsigne
   interface->process.option_window.selected_row = 0;
 }
 
-static void initialize_gpu_mem_plot(struct plot_window *plot, struct window_position *position,
-                                    nvtop_interface_option *options) {
-  unsigned rows = position->sizeY;
-  unsigned cols = position->sizeX;
-  cols -= 5;
-  rows -= 2;
-  plot->plot_window = newwin(rows, cols, position->posY + 1, position->posX + 4);
-  draw_rectangle(plot->win, 3, 0, cols + 2, rows + 2);
-  mvwprintw(plot->win, 1 + rows * 3 / 4, 0, " 25");
-  mvwprintw(plot->win, 1 + rows / 4, 0, " 75");
-  mvwprintw(plot->win, 1 + rows / 2, 0, " 50");
-  mvwprintw(plot->win, 1, 0, "100");
-  mvwprintw(plot->win, rows, 0, "  0");
-  plot->data = calloc(cols, sizeof(*plot->data));
-  plot->num_data = cols;
-
-  unsigned column_divisor = 0;
-  for (unsigned i = 0; i < plot->num_devices_to_plot; ++i) {
-    unsigned dev_id = plot->devices_ids[i];
-    plot_info_to_draw to_draw = options->gpu_specific_opts[dev_id].to_draw;
-    column_divisor += plot_count_draw_info(to_draw);
-  }
-  assert(column_divisor > 0);
+// Seconds elapsed at the quarters of the x axis, one sample every column_divisor columns
+static void draw_plot_time_axis(WINDOW *win, const struct window_position *position, unsigned cols,
+                                unsigned column_divisor, const nvtop_interface_option *options) {
   char elapsedSeconds[5];
   char *err = "err";
   char *zeroSec = "0s";
   if (options->plot_left_to_right) {
     char *toPrint = zeroSec;
-    mvwprintw(plot->win, position->sizeY - 1, 4, "%s", toPrint);
+    mvwprintw(win, position->sizeY - 1, 4, "%s", toPrint);
 
     int retval = snprintf(elapsedSeconds, 5, "%ds", options->update_interval * cols / 4 / column_divisor / 1000);
     if (retval > 4)
       toPrint = err;
     else
       toPrint = elapsedSeconds;
-    mvwprintw(plot->win, position->sizeY - 1, 4 + cols / 4 - strlen(toPrint) / 2, "%s", toPrint);
+    mvwprintw(win, position->sizeY - 1, 4 + cols / 4 - strlen(toPrint) / 2, "%s", toPrint);
 
     retval = snprintf(elapsedSeconds, 5, "%ds", options->update_interval * cols / 2 / column_divisor / 1000);
     if (retval > 4)
       toPrint = err;
     else
       toPrint = elapsedSeconds;
-    mvwprintw(plot->win, position->sizeY - 1, 4 + cols / 2 - strlen(toPrint) / 2, "%s", toPrint);
+    mvwprintw(win, position->sizeY - 1, 4 + cols / 2 - strlen(toPrint) / 2, "%s", toPrint);
 
     retval = snprintf(elapsedSeconds, 5, "%ds", options->update_interval * cols * 3 / 4 / column_divisor / 1000);
     if (retval > 4)
       toPrint = err;
     else
       toPrint = elapsedSeconds;
-    mvwprintw(plot->win, position->sizeY - 1, 4 + cols * 3 / 4 - strlen(toPrint) / 2, "%s", toPrint);
+    mvwprintw(win, position->sizeY - 1, 4 + cols * 3 / 4 - strlen(toPrint) / 2, "%s", toPrint);
 
     retval = snprintf(elapsedSeconds, 5, "%ds", options->update_interval * cols / column_divisor / 1000);
     if (retval > 4)
       toPrint = err;
     else
       toPrint = elapsedSeconds;
-    mvwprintw(plot->win, position->sizeY - 1, 4 + cols - strlen(toPrint), "%s", toPrint);
+    mvwprintw(win, position->sizeY - 1, 4 + cols - strlen(toPrint), "%s", toPrint);
   } else {
     char *toPrint;
     int retval = snprintf(elapsedSeconds, 5, "%ds", options->update_interval * cols / column_divisor / 1000);
@@ -289,44 +282,84 @@ static void initialize_gpu_mem_plot(struct plot_window *plot, struct window_posi
       toPrint = err;
     else
       toPrint = elapsedSeconds;
-    mvwprintw(plot->win, position->sizeY - 1, 4, "%s", toPrint);
+    mvwprintw(win, position->sizeY - 1, 4, "%s", toPrint);
 
     retval = snprintf(elapsedSeconds, 5, "%ds", options->update_interval * cols * 3 / 4 / column_divisor / 1000);
     if (retval > 4)
       toPrint = err;
     else
       toPrint = elapsedSeconds;
-    mvwprintw(plot->win, position->sizeY - 1, 4 + cols / 4 - strlen(toPrint) / 2, "%s", toPrint);
+    mvwprintw(win, position->sizeY - 1, 4 + cols / 4 - strlen(toPrint) / 2, "%s", toPrint);
 
     retval = snprintf(elapsedSeconds, 5, "%ds", options->update_interval * cols / 2 / column_divisor / 1000);
     if (retval > 4)
       toPrint = err;
     else
       toPrint = elapsedSeconds;
-    mvwprintw(plot->win, position->sizeY - 1, 4 + cols / 2 - strlen(toPrint) / 2, "%s", toPrint);
+    mvwprintw(win, position->sizeY - 1, 4 + cols / 2 - strlen(toPrint) / 2, "%s", toPrint);
 
     retval = snprintf(elapsedSeconds, 5, "%ds", options->update_interval * cols / 4 / column_divisor / 1000);
     if (retval > 4)
       toPrint = err;
     else
       toPrint = elapsedSeconds;
-    mvwprintw(plot->win, position->sizeY - 1, 4 + cols * 3 / 4 - strlen(toPrint) / 2, "%s", toPrint);
+    mvwprintw(win, position->sizeY - 1, 4 + cols * 3 / 4 - strlen(toPrint) / 2, "%s", toPrint);
 
     toPrint = zeroSec;
-    mvwprintw(plot->win, position->sizeY - 1, 4 + cols - strlen(toPrint), "%s", toPrint);
+    mvwprintw(win, position->sizeY - 1, 4 + cols - strlen(toPrint), "%s", toPrint);
+  }
+}
+
+static void draw_plot_y_labels(WINDOW *win, unsigned rows, char y_labels[PLOT_Y_LABELS][PLOT_Y_LABEL_SIZE]) {
+  const unsigned label_rows[PLOT_Y_LABELS] = {1, 1 + rows / 4, 1 + rows / 2, 1 + rows * 3 / 4, rows};
+  for (unsigned i = 0; i < PLOT_Y_LABELS; ++i)
+    mvwprintw(win, label_rows[i], 0, "%3s", y_labels[i]);
+}
+
+// The frame, the y axis labels and the time axis around the chart area
+static void draw_plot_frame(struct plot_window *plot, const struct window_position *position,
+                            const nvtop_interface_option *options) {
+  unsigned rows = position->sizeY - 2;
+  unsigned cols = position->sizeX - 5;
+  werase(plot->win);
+  draw_rectangle(plot->win, 3, 0, cols + 2, rows + 2);
+  struct plot_scale percent;
+  char y_labels[PLOT_Y_LABELS][PLOT_Y_LABEL_SIZE];
+  plot_autoscale(plot_unit_percent, 100., &percent);
+  plot_y_labels(&percent, y_labels);
+  draw_plot_y_labels(plot->win, rows, y_labels);
+
+  unsigned column_divisor = 0;
+  for (unsigned i = 0; i < plot->num_devices_to_plot; ++i) {
+    unsigned dev_id = plot->devices_ids[i];
+    plot_info_to_draw to_draw = options->gpu_specific_opts[dev_id].to_draw;
+    column_divisor += plot_count_draw_info(to_draw);
   }
+  assert(column_divisor > 0);
+  draw_plot_time_axis(plot->win, position, cols, column_divisor, options);
   wnoutrefresh(plot->win);
 }
 
+static void initialize_gpu_mem_plot(struct plot_window *plot, struct window_position *position,
+                                    nvtop_interface_option *options) {
+  unsigned rows = position->sizeY;
+  unsigned cols = position->sizeX;
+  cols -= 5;
+  rows -= 2;
+  plot->plot_window = newwin(rows, cols, position->posY + 1, position->posX + 4);
+  plot->data = calloc(cols, sizeof(*plot->data));
+  plot->num_data = cols;
+  draw_plot_frame(plot, position, options);
+}
+
 static void alloc_plot_window(unsigned devices_count, struct window_position *plot_positions,
                               unsigned map_device_to_plot[devices_count], struct nvtop_interface *interface) {
   if (!interface->num_plots) {
     interface->plots = NULL;
     return;
   }
-  interface->plots = malloc(interface->num_plots * sizeof(*interface->plots));
+  interface->plots = calloc(interface->num_plots, sizeof(*interface->plots));
   for (size_t i = 0; i < interface->num_plots; ++i) {
-    interface->plots[i].num_devices_to_plot = 0;
     for (unsigned dev_id = 0; dev_id < devices_count; ++dev_id) {
       if (map_device_to_plot[dev_id] == i) {
         interface->plots[i].devices_ids[interface->plots[i].num_devices_to_plot] = dev_id;
@@ -339,6 +372,53 @@ static void alloc_plot_window(unsigned devices_count, struct window_position *pl
   }
 }
 
+// The heatmap spans the area of every chart, one row per device charting at least one metric
+static void alloc_heatmap_window(unsigned devices_count, unsigned num_plots,
+                                 const struct window_position plot_positions[num_plots],
+                                 struct nvtop_interface *interface) {
+  struct heatmap_window *heatmap = &interface->heatmap;
+  unsigned left = UINT_MAX, top = UINT_MAX, right = 0, bottom = 0;
+  for (unsigned i = 0; i < num_plots; ++i) {
+    left = min(left, plot_positions[i].posX);
+    top = min(top, plot_positions[i].posY);
+    right = max(right, plot_positions[i].posX + plot_positions[i].sizeX);
+    bottom = max(bottom, plot_positions[i].posY + plot_positions[i].sizeY);
+  }
+  struct window_position area = {.posX = left, .posY = top, .sizeX = right - left, .sizeY = bottom - top};
+  unsigned rows = area.sizeY - 2;
+  unsigned cols = area.sizeX - 5;
+
+  heatmap->devices_ids = malloc(devices_count * sizeof(*heatmap->devices_ids));
+  if (devices_count && !heatmap->devices_ids) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  // The devices past the last row are not drawn
+  heatmap->num_devices_to_plot = 0;
+  for (unsigned dev_id = 0; dev_id < devices_count && heatmap->num_devices_to_plot < rows; ++dev_id) {
+    if (plot_count_draw_info(interface->options.gpu_specific_opts[dev_id].to_draw))
+      heatmap->devices_ids[heatmap->num_devices_to_plot++] = dev_id;
+  }
+
+  heatmap->win = newwin(area.sizeY, area.sizeX, area.posY, area.posX);
+  heatmap->plot_window = newwin(rows, cols, area.posY + 1, area.posX + 4);
+  draw_rectangle(heatmap->win, 3, 0, cols + 2, rows + 2);
+  draw_plot_time_axis(heatmap->win, &area, cols, 1, &interface->options);
+  heatmap_alloc(heatmap->num_devices_to_plot, cols, interface->options.plot_left_to_right, &heatmap->cells);
+  wnoutrefresh(heatmap->win);
+}
+
+static void free_heatmap_window(struct heatmap_window *heatmap) {
+  delwin(heatmap->plot_window);
+  delwin(heatmap->win);
+  heatmap->plot_window = NULL;
+  heatmap->win = NULL;
+  free(heatmap->devices_ids);
+  heatmap->devices_ids = NULL;
+  heatmap->num_devices_to_plot = 0;
+  heatmap_free(&heatmap->cells);
+}
+
 static unsigned device_length(void) {
   return max(sizeof_device_field[device_name] + sizeof_device_field[device_pcie] + 1,
 
@@ -346,6 +426,20 @@ static unsigned device_length(void) {
                  sizeof_device_field[device_fan_speed] + sizeof_device_field[device_power] + 4);
 }
 
+static void alloc_device_grid_windows(struct nvtop_interface *dwin, int rows, int cols,
+                                      const struct window_position *device_positions,
+                                      const struct window_position *grid_legend_position) {
+  // The cells past the bottom of the screen are not drawn
+  unsigned grid_rows = min(grid_legend_position->posY, (unsigned)rows - 1);
+  dwin->device_grid = grid_rows ? newwin(grid_rows, cols, 0, 0) : NULL;
+  dwin->device_grid_legend =
+      grid_legend_position->posY < (unsigned)rows - 1 ? newwin(1, cols, grid_legend_position->posY, 0) : NULL;
+  for (unsigned int i = 0; i < dwin->monitored_dev_count; ++i) {
+    dwin->devices_win[i].grid_posX = device_positions[i].posX;
+    dwin->devices_win[i].grid_posY = device_positions[i].posY;
+  }
+}
+
 static pid_t nvtop_pid;
 
 static void initialize_all_windows(struct nvtop_interface *dwin) {
@@ -356,20 +450,30 @@ static void initialize_all_windows(struct nvtop_interface *dwin) {
 
   struct window_position device_positions[devices_count];
   unsigned map_device_to_plot[devices_count];
+  struct window_position grid_legend_position;
   struct window_position process_position;
   struct window_position plot_positions[MAX_CHARTS];
   struct window_position setup_position;
 
   compute_sizes_from_layout(devices_count, dwin->options.has_gpu_info_bar ? 4 : 3, device_length(), rows - 1, cols,
-                            dwin->options.gpu_specific_opts, dwin->options.process_fields_displayed, device_positions,
-                            &dwin->num_plots, plot_positions, map_device_to_plot, &process_position, &setup_position,
+                            dwin->options.gpu_specific_opts, dwin->options.process_fields_displayed,
+                            &dwin->header_layout, device_positions, &grid_legend_position, &dwin->num_plots,
+                            plot_positions, map_device_to_plot, &process_position, &setup_position,
                             dwin->options.hide_processes_list);
 
+  if (dwin->options.plot_heatmap && dwin->num_plots) {
+    alloc_heatmap_window(devices_count, dwin->num_plots, plot_positions, dwin);
+    dwin->num_plots = 0;
+  }
   alloc_plot_window(devices_count, plot_positions, map_device_to_plot, dwin);
 
-  for (unsigned int i = 0; i < devices_count; ++i) {
-    alloc_device_window(device_positions[i].posY, device_positions[i].posX, device_positions[i].sizeX,
-                        &dwin->devices_win[i]);
+  if (dwin->header_layout == device_header_full) {
+    for (unsigned int i = 0; i < devices_count; ++i) {
+      alloc_device_window(device_positions[i].posY, device_positions[i].posX, device_positions[i].sizeX,
+                          &dwin->devices_win[i]);
+    }
+  } else {
+    alloc_device_grid_windows(dwin, rows, cols, device_positions, &grid_legend_position);
   }
 
   alloc_process_with_option(dwin, process_position.posX, process_position.posY, process_position.sizeX,
@@ -378,12 +482,33 @@ static void initialize_all_windows(struct nvtop_interface *dwin) {
   dwin->shortcut_window = newwin(1, cols, rows - 1, 0);
 
   alloc_setup_window(&setup_position, &dwin->setup_win);
+  dwin->topology.win = newwin(setup_position.sizeY, setup_position.sizeX, setup_position.posY, setup_position.posX);
   nvtop_pid = getpid();
 }
 
+static void free_history_navigation(struct nvtop_interface *interface) {
+  struct history_navigation *navigation = &interface->navigation;
+  if (!navigation->active)
+    return;
+  for (unsigned plot_id = 0; plot_id < interface->num_plots; ++plot_id) {
+    for (unsigned line = 0; line < MAX_LINES_PER_PLOT; ++line)
+      history_series_free(&interface->plots[plot_id].history[line]);
+  }
+  free(navigation->times);
+  navigation->times = NULL;
+  navigation->active = false;
+}
+
 static void delete_all_windows(struct nvtop_interface *dwin) {
-  for (unsigned int i = 0; i < dwin->monitored_dev_count; ++i) {
-    free_device_windows(&dwin->devices_win[i]);
+  if (dwin->header_layout == device_header_full) {
+    for (unsigned int i = 0; i < dwin->monitored_dev_count; ++i) {
+      free_device_windows(&dwin->devices_win[i]);
+    }
+  } else {
+    delwin(dwin->device_grid);
+    delwin(dwin->device_grid_legend);
+    dwin->device_grid = NULL;
+    dwin->device_grid_legend = NULL;
   }
   delwin(dwin->process.process_win);
   delwin(dwin->process.process_with_option_win);
@@ -391,14 +516,145 @@ static void delete_all_windows(struct nvtop_interface *dwin) {
   dwin->process.process_with_option_win = NULL;
   delwin(dwin->shortcut_window);
   delwin(dwin->process.option_window.option_win);
+  free_history_navigation(dwin);
   for (size_t i = 0; i < dwin->num_plots; ++i) {
+    delwin(dwin->plots[i].plot_window);
     delwin(dwin->plots[i].win);
     free(dwin->plots[i].data);
   }
+  if (dwin->heatmap.win)
+    free_heatmap_window(&dwin->heatmap);
   free_setup_window(&dwin->setup_win);
+  delwin(dwin->topology.win);
+  dwin->topology.win = NULL;
   free(dwin->plots);
 }
 
+// A window that does not fit on the screen at its previous size is recreated
+static WINDOW *resize_and_move_window(WINDOW *win, int rows, int cols, int posY, int posX) {
+  if (win && wresize(win, rows, cols) == OK && mvwin(win, posY, posX) == OK)
+    return win;
+  delwin(win);
+  return newwin(rows, cols, posY, posX);
+}
+
+static void move_device_window(struct device_window *dev, int posY, int posX) {
+  WINDOW *windows[] = {dev->name_win,         dev->gpu_util_enc_dec,        dev->gpu_util_no_enc_or_dec,
+                       dev->gpu_util_no_enc_and_dec, dev->mem_util_enc_dec, dev->mem_util_no_enc_or_dec,
+                       dev->mem_util_no_enc_and_dec, dev->encode_util,      dev->decode_util,
+                       dev->encdec_util,      dev->fan_speed,               dev->temperature,
+                       dev->power_info,       dev->gpu_clock_info,          dev->mem_clock_info,
+                       dev->pcie_info,        dev->shader_cores,            dev->l2_cache_size,
+                       dev->exec_engines};
+  int deltaY = posY - getbegy(dev->name_win);
+  int deltaX = posX - getbegx(dev->name_win);
+  for (size_t i = 0; i < sizeof(windows) / sizeof(*windows); ++i) {
+    if (windows[i])
+      mvwin(windows[i], getbegy(windows[i]) + deltaY, getbegx(windows[i]) + deltaX);
+  }
+}
+
+// Fit the existing windows to the terminal size, keeping the process list selection and scrolling. Return false when
+// the new size changes the header layout, the charts or hides the process list: the windows must be recreated then.
+static bool resize_all_windows(struct nvtop_interface *dwin) {
+  int rows, cols;
+  getmaxyx(stdscr, rows, cols);
+
+  unsigned int devices_count = dwin->monitored_dev_count;
+
+  struct window_position device_positions[devices_count];
+  unsigned map_device_to_plot[devices_count];
+  struct window_position grid_legend_position;
+  struct window_position process_position;
+  struct window_position plot_positions[MAX_CHARTS];
+  struct window_position setup_position;
+  enum device_header_layout header_layout;
+  unsigned num_plots;
+
+  compute_sizes_from_layout(devices_count, dwin->options.has_gpu_info_bar ? 4 : 3, device_length(), rows - 1, cols,
+                            dwin->options.gpu_specific_opts, dwin->options.process_fields_displayed, &header_layout,
+                            device_positions, &grid_legend_position, &num_plots, plot_positions, map_device_to_plot,
+                            &process_position, &setup_position, dwin->options.hide_processes_list);
+
+  if (header_layout != dwin->header_layout)
+    return false;
+  if ((process_position.sizeY > 0) != (dwin->process.process_win != NULL))
+    return false;
+  bool heatmap = dwin->options.plot_heatmap && num_plots;
+  if (heatmap != (dwin->heatmap.win != NULL))
+    return false;
+  if (!heatmap) {
+    if (num_plots != dwin->num_plots)
+      return false;
+    for (unsigned i = 0; i < num_plots; ++i) {
+      unsigned devices_in_plot = 0;
+      for (unsigned dev_id = 0; dev_id < devices_count; ++dev_id)
+        devices_in_plot += map_device_to_plot[dev_id] == i;
+      if (devices_in_plot != dwin->plots[i].num_devices_to_plot)
+        return false;
+      for (unsigned j = 0; j < dwin->plots[i].num_devices_to_plot; ++j) {
+        if (map_device_to_plot[dwin->plots[i].devices_ids[j]] != i)
+          return false;
+      }
+    }
+  }
+
+  if (header_layout == device_header_full) {
+    for (unsigned i = 0; i < devices_count; ++i)
+      move_device_window(&dwin->devices_win[i], device_positions[i].posY, device_positions[i].posX);
+  } else {
+    // The grid and its legend are redrawn whole at each refresh
+    delwin(dwin->device_grid);
+    delwin(dwin->device_grid_legend);
+    alloc_device_grid_windows(dwin, rows, cols, device_positions, &grid_legend_position);
+  }
+
+  if (heatmap) {
+    // The heatmap cells are filled again from the ring buffer
+    free_heatmap_window(&dwin->heatmap);
+    alloc_heatmap_window(devices_count, num_plots, plot_positions, dwin);
+  } else {
+    for (unsigned i = 0; i < num_plots; ++i) {
+      struct plot_window *plot = &dwin->plots[i];
+      const struct window_position *position = &plot_positions[i];
+      unsigned plot_cols = position->sizeX - 5;
+      plot->win = resize_and_move_window(plot->win, position->sizeY, position->sizeX, position->posY, position->posX);
+      plot->plot_window = resize_and_move_window(plot->plot_window, position->sizeY - 2, plot_cols,
+                                                 position->posY + 1, position->posX + 4);
+      if (plot_cols != plot->num_data) {
+        free(plot->data);
+        plot->data = calloc(plot_cols, sizeof(*plot->data));
+        plot->num_data = plot_cols;
+      }
+      draw_plot_frame(plot, position, &dwin->options);
+    }
+  }
+
+  if (process_position.sizeY > 0) {
+    dwin->process.process_win =
+        resize_and_move_window(dwin->process.process_win, process_position.sizeY, process_position.sizeX,
+                               process_position.posY, process_position.posX);
+    dwin->process.process_with_option_win = resize_and_move_window(
+        dwin->process.process_with_option_win, process_position.sizeY, process_position.sizeX - option_window_size,
+        process_position.posY, process_position.posX + option_window_size);
+    dwin->process.option_window.option_win =
+        resize_and_move_window(dwin->process.option_window.option_win, process_position.sizeY, option_window_size,
+                               process_position.posY, process_position.posX);
+  }
+
+  dwin->shortcut_window = resize_and_move_window(dwin->shortcut_window, 1, cols, rows - 1, 0);
+
+  bool setup_visible = dwin->setup_win.visible;
+  free_setup_window(&dwin->setup_win);
+  alloc_setup_window(&setup_position, &dwin->setup_win);
+  dwin->setup_win.visible = setup_visible;
+  if (setup_visible)
+    wnoutrefresh(dwin->setup_win.clean_space);
+  dwin->topology.win = resize_and_move_window(dwin->topology.win, setup_position.sizeY, setup_position.sizeX,
+                                              setup_position.posY, setup_position.posX);
+  return true;
+}
+
 static void initialize_colors(void) {
   start_color();
   short background_color;
@@ -418,8 +674,11 @@ static void initialize_colors(void) {
   init_pair(magenta_color, COLOR_MAGENTA, background_color);
 }
 
-struct nvtop_interface *initialize_curses(unsigned total_devices, unsigned devices_count, unsigned largest_device_name,
-                                          nvtop_interface_option options) {
+// The chart history has one slot per device, monitored or not, and is handed over when the interface is recreated
+static struct nvtop_interface *initialize_interface(unsigned total_devices, unsigned devices_count,
+                                                    unsigned largest_device_name, nvtop_interface_option options,
+                                                    const interface_ring_buffer *history,
+                                                    const struct sample_clock *history_times) {
   struct nvtop_interface *interface = calloc(1, sizeof(*interface));
   interface->options = options;
   interface->devices_win = calloc(devices_count, sizeof(*interface->devices_win));
@@ -450,18 +709,36 @@ struct nvtop_interface *initialize_curses(unsigned total_devices, unsigned devic
     }
   }
 
-  interface_alloc_ring_buffer(devices_count, 4, 10 * 60 * 1000, &interface->saved_data_ring);
+  if (history) {
+    interface->saved_data_ring = *history;
+    interface->saved_data_times = *history_times;
+  } else {
+    interface_alloc_ring_buffer(total_devices, 4, 10 * 60 * 1000, &interface->saved_data_ring);
+    sample_clock_alloc(interface->saved_data_ring.buffer_size, &interface->saved_data_times);
+  }
+  imbalance_tracker_alloc(devices_count, &interface->imbalance);
   initialize_all_windows(interface);
   return interface;
 }
 
+struct nvtop_interface *initialize_curses(unsigned total_devices, unsigned devices_count, unsigned largest_device_name,
+                                          nvtop_interface_option options) {
+  return initialize_interface(total_devices, devices_count, largest_device_name, options, NULL, NULL);
+}
+
 void clean_ncurses(struct nvtop_interface *interface) {
   endwin();
   delete_all_windows(interface);
   free(interface->options.gpu_specific_opts);
   free(interface->options.config_file_location);
+  alert_rules_free(interface->options.alert_rules_count, interface->options.alert_rules);
   free(interface->devices_win);
+  free(interface->process.expanded_groups);
+  process_groups_free(&interface->process.groups);
   interface_free_ring_buffer(&interface->saved_data_ring);
+  sample_clock_free(&interface->saved_data_times);
+  imbalance_tracker_free(&interface->imbalance);
+  device_topology_free(&interface->topology.topology);
   free(interface);
 }
 
@@ -621,14 +898,128 @@ static void encode_decode_show_select(struct device_window *dev, bool encode_val
   }
 }
 
+// Heat of a percentage in the device grid
+static enum interface_color grid_usage_color(unsigned percentage) {
+  if (percentage >= 80)
+    return red_color;
+  if (percentage >= 50)
+    return yellow_color;
+  return green_color;
+}
+
+// Same thresholds as draw_temp_color
+static enum interface_color grid_temperature_color(unsigned temp, unsigned temp_slowdown) {
+  if (!temp_slowdown || temp + 5 < temp_slowdown)
+    return green_color;
+  if (temp < temp_slowdown)
+    return yellow_color;
+  return red_color;
+}
+
+// A value of a grid cell on its heat color: the value itself in the wide cells, its tens digit in the narrow ones
+static void draw_device_grid_value(WINDOW *win, bool wide, bool valid, unsigned value, enum interface_color color) {
+  if (wide)
+    waddch(win, ' ');
+  if (!valid) {
+    wprintw(win, wide ? "N/A" : "-");
+    return;
+  }
+  wattr_set(win, A_REVERSE, color, NULL);
+  if (wide)
+    wprintw(win, "%3u", min(value, 999));
+  else
+    waddch(win, '0' + min(value / 10, 9));
+  wstandend(win);
+}
+
+static void draw_device_grid_legend_sample(WINDOW *win, enum interface_color color, const char *text) {
+  waddch(win, ' ');
+  wattr_set(win, A_REVERSE, color, NULL);
+  wprintw(win, "%s", text);
+  wstandend(win);
+}
+
+static void draw_device_grid(struct list_head *devices, struct nvtop_interface *interface) {
+  bool wide = interface->header_layout == device_header_grid_wide;
+  bool celsius = !interface->options.temperature_in_fahrenheit;
+  int index_cols = snprintf(NULL, 0, "%u", interface->monitored_dev_count ? interface->monitored_dev_count - 1 : 0);
+
+  WINDOW *grid = interface->device_grid;
+  if (grid) {
+    werase(grid);
+    unsigned grid_rows = getmaxy(grid);
+    struct gpu_info *device;
+    unsigned dev_id = 0;
+    list_for_each_entry(device, devices, list) {
+      const struct device_window *dev = &interface->devices_win[dev_id];
+      if (dev->grid_posY < grid_rows) {
+        bool straggler = imbalance_device_is_straggler(&interface->imbalance, dev_id);
+        wcolor_set(grid, straggler ? red_color : cyan_color, NULL);
+        mvwprintw(grid, dev->grid_posY, dev->grid_posX, "%*u", index_cols, dev_id);
+        wstandend(grid);
+        if (!wide)
+          waddch(grid, ' ');
+
+        bool valid = GPUINFO_DYNAMIC_FIELD_VALID(&device->dynamic_info, gpu_util_rate);
+        unsigned value = valid ? device->dynamic_info.gpu_util_rate : 0;
+        draw_device_grid_value(grid, wide, valid, value, grid_usage_color(value));
+
+        valid = GPUINFO_DYNAMIC_FIELD_VALID(&device->dynamic_info, total_memory) &&
+                GPUINFO_DYNAMIC_FIELD_VALID(&device->dynamic_info, used_memory) && device->dynamic_info.total_memory;
+        value = valid ? (unsigned)(100. * device->dynamic_info.used_memory / device->dynamic_info.total_memory) : 0;
+        draw_device_grid_value(grid, wide, valid, value, grid_usage_color(value));
+
+        valid = GPUINFO_DYNAMIC_FIELD_VALID(&device->dynamic_info, gpu_temp);
+        unsigned temp = valid ? device->dynamic_info.gpu_temp : 0;
+        unsigned temp_slowdown = GPUINFO_STATIC_FIELD_VALID(&device->static_info, temperature_slowdown_threshold)
+                                     ? device->static_info.temperature_slowdown_threshold
+                                     : 0;
+        value = celsius ? temp : (unsigned)(32 + nearbyint(temp * 1.8));
+        draw_device_grid_value(grid, wide, valid, value, grid_temperature_color(temp, temp_slowdown));
+      }
+      dev_id++;
+    }
+    wnoutrefresh(grid);
+  }
+
+  WINDOW *legend = interface->device_grid_legend;
+  if (legend) {
+    werase(legend);
+    wcolor_set(legend, cyan_color, NULL);
+    if (wide)
+      mvwprintw(legend, 0, 0, "DEV GPU%% MEM%% TEMP");
+    else
+      mvwprintw(legend, 0, 0, "DEV GPU MEM TEMP (tens of %% and ");
+    waddch(legend, ACS_DEGREE);
+    waddch(legend, celsius ? 'C' : 'F');
+    wprintw(legend, wide ? " " : ") ");
+    wstandend(legend);
+    wprintw(legend, " usage");
+    draw_device_grid_legend_sample(legend, green_color, "<50");
+    draw_device_grid_legend_sample(legend, yellow_color, "<80");
+    draw_device_grid_legend_sample(legend, red_color, ">=80");
+    wprintw(legend, "  temperature");
+    draw_device_grid_legend_sample(legend, green_color, "ok");
+    draw_device_grid_legend_sample(legend, yellow_color, "near slowdown");
+    draw_device_grid_legend_sample(legend, red_color, "slowdown");
+    wnoutrefresh(legend);
+  }
+}
+
 static void draw_devices(struct list_head *devices, struct nvtop_interface *interface) {
   struct gpu_info *device;
   unsigned dev_id = 0;
 
+  if (interface->header_layout != device_header_full) {
+    draw_device_grid(devices, interface);
+    return;
+  }
+
   list_for_each_entry(device, devices, list) {
     struct device_window *dev = &interface->devices_win[dev_id];
 
-    wcolor_set(dev->name_win, cyan_color, NULL);
+    bool straggler = imbalance_device_is_straggler(&interface->imbalance, dev_id);
+    wcolor_set(dev->name_win, straggler ? red_color : cyan_color, NULL);
     mvwprintw(dev->name_win, 0, 0, "Device %-2u", dev_id);
     wstandend(dev->name_win);
     if (GPUINFO_STATIC_FIELD_VALID(&device->static_info, device_name)) {
@@ -683,7 +1074,11 @@ static void draw_devices(struct list_head *devices, struct nvtop_interface *inte
         draw_percentage_meter(decode_win, "DEC", rate, buff);
     }
     if (GPUINFO_DYNAMIC_FIELD_VALID(&device->dynamic_info, gpu_util_rate)) {
-      snprintf(buff, 1024, "%u%%", device->dynamic_info.gpu_util_rate);
+      if (straggler)
+        snprintf(buff, 1024, "%u%% lag -%u%%", device->dynamic_info.gpu_util_rate,
+                 imbalance_device_usage_gap(&interface->imbalance, dev_id));
+      else
+        snprintf(buff, 1024, "%u%%", device->dynamic_info.gpu_util_rate);
       draw_percentage_meter(gpu_util_win, "GPU", device->dynamic_info.gpu_util_rate, buff);
     } else {
       snprintf(buff, 1024, "N/A");
@@ -700,8 +1095,11 @@ static void draw_devices(struct list_head *devices, struct nvtop_interface *inte
         total_prefixed /= 1024.;
         used_prefixed /= 1024.;
       }
-      snprintf(buff, 1024, "%.3f%s/%.3f%s", used_prefixed, memory_prefix[prefix_off], total_prefixed,
-               memory_prefix[prefix_off]);
+      int printed = snprintf(buff, 1024, "%.3f%s/%.3f%s", used_prefixed, memory_prefix[prefix_off], total_prefixed,
+                             memory_prefix[prefix_off]);
+      unsigned memory_imbalance = imbalance_device_memory_imbalance(&interface->imbalance, dev_id);
+      if (straggler && memory_imbalance >= IMBALANCE_LAG_THRESHOLD)
+        snprintf(&buff[printed], 1024 - printed, " skew %u%%", memory_imbalance);
       draw_percentage_meter(mem_util_win, "MEM", (unsigned int)(100. * used_mem / total_mem), buff);
     } else if (GPUINFO_DYNAMIC_FIELD_VALID(&device->dynamic_info, total_memory)) {
       double total_mem = device->dynamic_info.total_memory;
@@ -864,14 +1262,6 @@ static void draw_devices(struct list_head *devices, struct nvtop_interface *inte
   }
 }
 
-typedef struct {
-  unsigned processes_count;
-  struct gpuid_and_process {
-    unsigned gpu_id;
-    struct gpu_process *process;
-  } *processes;
-} all_processes;
-
 static all_processes all_processes_array(struct list_head *devices) {
   unsigned total_processes_count = 0;
   struct gpu_info *device;
@@ -895,6 +1285,9 @@ static all_processes all_processes_array(struct list_head *devices) {
   list_for_each_entry(device, devices, list) {
     for (unsigned int j = 0; j < device->processes_count; ++j) {
       merged_devices_processes.processes[offset].gpu_id = dev_id;
+      merged_devices_processes.processes[offset].host_id = device->host_id;
+      merged_devices_processes.processes[offset].group = NULL;
+      merged_devices_processes.processes[offset].group_member = false;
       merged_devices_processes.processes[offset++].process = &device->processes[j];
     }
 
@@ -969,6 +1362,147 @@ static int compare_cpu_mem_usage_desc(const void *pp1, const void *pp2) {
 
 static int compare_cpu_mem_usage_asc(const void *pp1, const void *pp2) { return compare_cpu_mem_usage_desc(pp2, pp1); }
 
+static int compare_io_read_desc(const void *pp1, const void *pp2) {
+  const struct gpuid_and_process *p1 = (const struct gpuid_and_process *)pp1;
+  const struct gpuid_and_process *p2 = (const struct gpuid_and_process *)pp2;
+  if (GPUINFO_PROCESS_FIELD_VALID(p1->process, io_read_rate) && GPUINFO_PROCESS_FIELD_VALID(p2->process, io_read_rate))
+    return p1->process->io_read_rate >= p2->process->io_read_rate ? -1 : 1;
+  else
+    return 0;
+}
+
+static int compare_io_read_asc(const void *pp1, const void *pp2) { return compare_io_read_desc(pp2, pp1); }
+
+static int compare_starvation_desc(const void *pp1, const void *pp2) {
+  const struct gpuid_and_process *p1 = (const struct gpuid_and_process *)pp1;
+  const struct gpuid_and_process *p2 = (const struct gpuid_and_process *)pp2;
+  if (GPUINFO_PROCESS_FIELD_VALID(p1->process, starvation) && GPUINFO_PROCESS_FIELD_VALID(p2->process, starvation))
+    return p1->process->starvation >= p2->process->starvation ? -1 : 1;
+  else
+    return 0;
+}
+
+static int compare_starvation_asc(const void *pp1, const void *pp2) { return compare_starvation_desc(pp2, pp1); }
+
+static int compare_locality_desc(const void *pp1, const void *pp2) {
+  const struct gpuid_and_process *p1 = (const struct gpuid_and_process *)pp1;
+  const struct gpuid_and_process *p2 = (const struct gpuid_and_process *)pp2;
+  if (GPUINFO_PROCESS_FIELD_VALID(p1->process, locality) && GPUINFO_PROCESS_FIELD_VALID(p2->process, locality))
+    return p1->process->locality >= p2->process->locality ? -1 : 1;
+  else
+    return 0;
+}
+
+static int compare_locality_asc(const void *pp1, const void *pp2) { return compare_locality_desc(pp2, pp1); }
+
+static int compare_energy_desc(const void *pp1, const void *pp2) {
+  const struct gpuid_and_process *p1 = (const struct gpuid_and_process *)pp1;
+  const struct gpuid_and_process *p2 = (const struct gpuid_and_process *)pp2;
+  if (GPUINFO_PROCESS_FIELD_VALID(p1->process, energy) && GPUINFO_PROCESS_FIELD_VALID(p2->process, energy))
+    return p1->process->energy >= p2->process->energy ? -1 : 1;
+  else
+    return 0;
+}
+
+static int compare_energy_asc(const void *pp1, const void *pp2) { return compare_energy_desc(pp2, pp1); }
+
+static int compare_gpu_time_desc(const void *pp1, const void *pp2) {
+  const struct gpuid_and_process *p1 = (const struct gpuid_and_process *)pp1;
+  const struct gpuid_and_process *p2 = (const struct gpuid_and_process *)pp2;
+  if (GPUINFO_PROCESS_FIELD_VALID(p1->process, gpu_time) && GPUINFO_PROCESS_FIELD_VALID(p2->process, gpu_time))
+    return p1->process->gpu_time >= p2->process->gpu_time ? -1 : 1;
+  else
+    return 0;
+}
+
+static int compare_gpu_time_asc(const void *pp1, const void *pp2) { return compare_gpu_time_desc(pp2, pp1); }
+
+static int compare_memory_peak_desc(const void *pp1, const void *pp2) {
+  const struct gpuid_and_process *p1 = (const struct gpuid_and_process *)pp1;
+  const struct gpuid_and_process *p2 = (const struct gpuid_and_process *)pp2;
+  if (GPUINFO_PROCESS_FIELD_VALID(p1->process, gpu_memory_peak) &&
+      GPUINFO_PROCESS_FIELD_VALID(p2->process, gpu_memory_peak))
+    return p1->process->gpu_memory_peak >= p2->process->gpu_memory_peak ? -1 : 1;
+  else
+    return 0;
+}
+
+static int compare_memory_peak_asc(const void *pp1, const void *pp2) { return compare_memory_peak_desc(pp2, pp1); }
+
+static int compare_gpu_average_desc(const void *pp1, const void *pp2) {
+  const struct gpuid_and_process *p1 = (const struct gpuid_and_process *)pp1;
+  const struct gpuid_and_process *p2 = (const struct gpuid_and_process *)pp2;
+  if (GPUINFO_PROCESS_FIELD_VALID(p1->process, gpu_usage_average) &&
+      GPUINFO_PROCESS_FIELD_VALID(p2->process, gpu_usage_average))
+    return p1->process->gpu_usage_average >= p2->process->gpu_usage_average ? -1 : 1;
+  else
+    return 0;
+}
+
+static int compare_gpu_average_asc(const void *pp1, const void *pp2) { return compare_gpu_average_desc(pp2, pp1); }
+
+static int compare_idle_held_desc(const void *pp1, const void *pp2) {
+  const struct gpuid_and_process *p1 = (const struct gpuid_and_process *)pp1;
+  const struct gpuid_and_process *p2 = (const struct gpuid_and_process *)pp2;
+  if (GPUINFO_PROCESS_FIELD_VALID(p1->process, idle_memory_time) &&
+      GPUINFO_PROCESS_FIELD_VALID(p2->process, idle_memory_time))
+    return p1->process->idle_memory_time >= p2->process->idle_memory_time ? -1 : 1;
+  else
+    return 0;
+}
+
+static int compare_idle_held_asc(const void *pp1, const void *pp2) { return compare_idle_held_desc(pp2, pp1); }
+
+static int compare_memory_growth_desc(const void *pp1, const void *pp2) {
+  const struct gpuid_and_process *p1 = (const struct gpuid_and_process *)pp1;
+  const struct gpuid_and_process *p2 = (const struct gpuid_and_process *)pp2;
+  if (GPUINFO_PROCESS_FIELD_VALID(p1->process, gpu_memory_growth) &&
+      GPUINFO_PROCESS_FIELD_VALID(p2->process, gpu_memory_growth))
+    return p1->process->gpu_memory_growth >= p2->process->gpu_memory_growth ? -1 : 1;
+  else
+    return 0;
+}
+
+static int compare_memory_growth_asc(const void *pp1, const void *pp2) {
+  return compare_memory_growth_desc(pp2, pp1);
+}
+
+static int compare_time_to_oom_desc(const void *pp1, const void *pp2) {
+  const struct gpuid_and_process *p1 = (const struct gpuid_and_process *)pp1;
+  const struct gpuid_and_process *p2 = (const struct gpuid_and_process *)pp2;
+  if (GPUINFO_PROCESS_FIELD_VALID(p1->process, time_to_oom) && GPUINFO_PROCESS_FIELD_VALID(p2->process, time_to_oom))
+    return p1->process->time_to_oom >= p2->process->time_to_oom ? -1 : 1;
+  else
+    return 0;
+}
+
+static int compare_time_to_oom_asc(const void *pp1, const void *pp2) { return compare_time_to_oom_desc(pp2, pp1); }
+
+static int compare_namespace_pid_desc(const void *pp1, const void *pp2) {
+  const struct gpuid_and_process *p1 = (const struct gpuid_and_process *)pp1;
+  const struct gpuid_and_process *p2 = (const struct gpuid_and_process *)pp2;
+  if (GPUINFO_PROCESS_FIELD_VALID(p1->process, namespace_pid) &&
+      GPUINFO_PROCESS_FIELD_VALID(p2->process, namespace_pid))
+    return p1->process->namespace_pid >= p2->process->namespace_pid ? -1 : 1;
+  else
+    return 0;
+}
+
+static int compare_namespace_pid_asc(const void *pp1, const void *pp2) {
+  return compare_namespace_pid_desc(pp2, pp1);
+}
+
+static int compare_job_id_desc(const void *pp1, const void *pp2) {
+  const struct gpuid_and_process *p1 = (const struct gpuid_and_process *)pp1;
+  const struct gpuid_and_process *p2 = (const struct gpuid_and_process *)pp2;
+  if (GPUINFO_PROCESS_FIELD_VALID(p1->process, job_id) && GPUINFO_PROCESS_FIELD_VALID(p2->process, job_id))
+    return -strcmp(p1->process->job_id, p2->process->job_id);
+  else
+    return 0;
+}
+
+static int compare_job_id_asc(const void *pp1, const void *pp2) { return compare_job_id_desc(pp2, pp1); }
+
 static int compare_gpu_desc(const void *pp1, const void *pp2) {
   const struct gpuid_and_process *p1 = (const struct gpuid_and_process *)pp1;
   const struct gpuid_and_process *p2 = (const struct gpuid_and_process *)pp2;
@@ -1099,47 +1633,225 @@ static void sort_process(all_processes all_procs, enum process_field criterion,
     else
       sort_fun = compare_cpu_mem_usage_desc;
     break;
-  case process_gpu_rate:
+  case process_io_read:
     if (asc_sort)
-      sort_fun = compare_process_gpu_rate_asc;
+      sort_fun = compare_io_read_asc;
     else
-      sort_fun = compare_process_gpu_rate_desc;
+      sort_fun = compare_io_read_desc;
     break;
-  case process_enc_rate:
+  case process_starvation:
     if (asc_sort)
-      sort_fun = compare_process_enc_rate_asc;
+      sort_fun = compare_starvation_asc;
     else
-      sort_fun = compare_process_enc_rate_desc;
+      sort_fun = compare_starvation_desc;
     break;
-  case process_dec_rate:
+  case process_numa:
     if (asc_sort)
-      sort_fun = compare_process_dec_rate_asc;
+      sort_fun = compare_locality_asc;
     else
-      sort_fun = compare_process_dec_rate_desc;
+      sort_fun = compare_locality_desc;
     break;
-  case process_field_count:
-    return;
-  }
-  qsort(all_procs.processes, all_procs.processes_count, sizeof(*all_procs.processes), sort_fun);
-}
-
-static void filter_out_nvtop_pid(all_processes *all_procs, struct nvtop_interface *interface) {
-  if (interface->options.filter_nvtop_pid) {
-    for (unsigned procId = 0; procId < all_procs->processes_count; ++procId) {
-      if (all_procs->processes[procId].process->pid == nvtop_pid) {
-        memmove(&all_procs->processes[procId], &all_procs->processes[procId + 1],
-                (all_procs->processes_count - procId - 1) * sizeof(*all_procs->processes));
-        all_procs->processes_count = all_procs->processes_count - 1;
-        break;
-      }
-    }
-  }
-}
-
-static const char *columnName[process_field_count] = {
-    "PID", "USER", "DEV", "TYPE", "GPU", "ENC", "DEC", "GPU MEM", "CPU", "HOST MEM", "Command",
-};
-
+  case process_energy:
+    if (asc_sort)
+      sort_fun = compare_energy_asc;
+    else
+      sort_fun = compare_energy_desc;
+    break;
+  case process_gpu_time:
+    if (asc_sort)
+      sort_fun = compare_gpu_time_asc;
+    else
+      sort_fun = compare_gpu_time_desc;
+    break;
+  case process_memory_peak:
+    if (asc_sort)
+      sort_fun = compare_memory_peak_asc;
+    else
+      sort_fun = compare_memory_peak_desc;
+    break;
+  case process_gpu_average:
+    if (asc_sort)
+      sort_fun = compare_gpu_average_asc;
+    else
+      sort_fun = compare_gpu_average_desc;
+    break;
+  case process_idle_held:
+    if (asc_sort)
+      sort_fun = compare_idle_held_asc;
+    else
+      sort_fun = compare_idle_held_desc;
+    break;
+  case process_memory_growth:
+    if (asc_sort)
+      sort_fun = compare_memory_growth_asc;
+    else
+      sort_fun = compare_memory_growth_desc;
+    break;
+  case process_time_to_oom:
+    if (asc_sort)
+      sort_fun = compare_time_to_oom_asc;
+    else
+      sort_fun = compare_time_to_oom_desc;
+    break;
+  case process_namespace_pid:
+    if (asc_sort)
+      sort_fun = compare_namespace_pid_asc;
+    else
+      sort_fun = compare_namespace_pid_desc;
+    break;
+  case process_job_id:
+    if (asc_sort)
+      sort_fun = compare_job_id_asc;
+    else
+      sort_fun = compare_job_id_desc;
+    break;
+  case process_gpu_rate:
+    if (asc_sort)
+      sort_fun = compare_process_gpu_rate_asc;
+    else
+      sort_fun = compare_process_gpu_rate_desc;
+    break;
+  case process_enc_rate:
+    if (asc_sort)
+      sort_fun = compare_process_enc_rate_asc;
+    else
+      sort_fun = compare_process_enc_rate_desc;
+    break;
+  case process_dec_rate:
+    if (asc_sort)
+      sort_fun = compare_process_dec_rate_asc;
+    else
+      sort_fun = compare_process_dec_rate_desc;
+    break;
+  case process_field_count:
+    return;
+  }
+  qsort(all_procs.processes, all_procs.processes_count, sizeof(*all_procs.processes), sort_fun);
+}
+
+static void filter_out_nvtop_pid(all_processes *all_procs, struct nvtop_interface *interface) {
+  if (interface->options.filter_nvtop_pid) {
+    for (unsigned procId = 0; procId < all_procs->processes_count; ++procId) {
+      if (all_procs->processes[procId].process->pid == nvtop_pid) {
+        memmove(&all_procs->processes[procId], &all_procs->processes[procId + 1],
+                (all_procs->processes_count - procId - 1) * sizeof(*all_procs->processes));
+        all_procs->processes_count = all_procs->processes_count - 1;
+        break;
+      }
+    }
+  }
+}
+
+static bool process_group_is_expanded(const struct process_window *process, int64_t key) {
+  for (unsigned i = 0; i < process->expanded_groups_count; ++i) {
+    if (process->expanded_groups[i] == key)
+      return true;
+  }
+  return false;
+}
+
+static void process_group_toggle_expanded(struct process_window *process, int64_t key) {
+  for (unsigned i = 0; i < process->expanded_groups_count; ++i) {
+    if (process->expanded_groups[i] == key) {
+      process->expanded_groups[i] = process->expanded_groups[--process->expanded_groups_count];
+      return;
+    }
+  }
+  if (process->expanded_groups_count == process->expanded_groups_size) {
+    process->expanded_groups_size += 4;
+    process->expanded_groups =
+        reallocarray(process->expanded_groups, process->expanded_groups_size, sizeof(*process->expanded_groups));
+    if (!process->expanded_groups) {
+      perror("Could not re-allocate memory: ");
+      exit(EXIT_FAILURE);
+    }
+  }
+  process->expanded_groups[process->expanded_groups_count++] = key;
+}
+
+// Forget about the expanded groups that are no longer running on multiple devices or whose user left
+static void process_groups_prune_expanded(struct process_window *process, const struct process_groups *groups) {
+  for (unsigned i = 0; i < process->expanded_groups_count;) {
+    struct process_group *group;
+    HASH_FIND(hh, groups->groups_by_pid, &process->expanded_groups[i], sizeof(process->expanded_groups[i]), group);
+    if (!group || (group->members_count < 2 && !group->rollup))
+      process->expanded_groups[i] = process->expanded_groups[--process->expanded_groups_count];
+    else
+      i++;
+  }
+}
+
+// One row per group, sorted, followed by the rows of its members when the group is expanded
+static all_processes process_groups_to_rows(all_processes all_procs, const struct process_groups *groups,
+                                            const struct process_window *process, enum process_field criterion,
+                                            bool asc_sort) {
+  all_processes group_rows = {groups->groups_count, NULL};
+  if (!groups->groups_count)
+    return group_rows;
+  group_rows.processes = malloc(groups->groups_count * sizeof(*group_rows.processes));
+  if (!group_rows.processes) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  unsigned expanded_members = 0;
+  for (unsigned i = 0; i < groups->groups_count; ++i) {
+    const struct process_group *group = groups->groups[i];
+    if (group->members_count == 1 && !group->rollup) {
+      group_rows.processes[i] = all_procs.processes[group->first_member];
+    } else {
+      group_rows.processes[i].gpu_id = all_procs.processes[group->first_member].gpu_id;
+      group_rows.processes[i].host_id = all_procs.processes[group->first_member].host_id;
+      group_rows.processes[i].process = (struct gpu_process *)&group->merged;
+      group_rows.processes[i].group = group;
+      group_rows.processes[i].group_member = false;
+      if (process_group_is_expanded(process, group->key))
+        expanded_members += group->members_count;
+    }
+  }
+  sort_process(group_rows, criterion, asc_sort);
+  if (!expanded_members)
+    return group_rows;
+
+  all_processes rows = {group_rows.processes_count + expanded_members, NULL};
+  rows.processes = malloc(rows.processes_count * sizeof(*rows.processes));
+  if (!rows.processes) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  unsigned offset = 0;
+  for (unsigned i = 0; i < group_rows.processes_count; ++i) {
+    rows.processes[offset++] = group_rows.processes[i];
+    const struct process_group *group = group_rows.processes[i].group;
+    if (group && process_group_is_expanded(process, group->key)) {
+      for (unsigned member = group->first_member; member != PROCESS_GROUP_NO_MEMBER;
+           member = groups->next_member[member]) {
+        rows.processes[offset] = all_procs.processes[member];
+        rows.processes[offset++].group_member = true;
+      }
+    }
+  }
+  free(group_rows.processes);
+  return rows;
+}
+
+static const char *columnName[process_field_count] = {
+    "PID", "USER", "DEV", "TYPE", "GPU", "ENC", "DEC", "GPU MEM", "CPU", "HOST MEM", "IO READ", "STARVED", "NUMA", "ENERGY", "GPU TIME", "PEAK MEM",
+    "AVG GPU", "IDLE HELD", "GROWTH", "OOM IN", "NSPID", "JOB", "Command",
+};
+
+static const char *starvation_names[gpu_process_starvation_count] = {
+    [gpu_process_not_starved] = "-",
+    [gpu_process_starved_cpu] = "CPU",
+    [gpu_process_starved_io] = "IO",
+    [gpu_process_starved_preempted] = "PREEMPT",
+};
+
+static const char *locality_names[host_locality_count] = {
+    [host_locality_local] = "local",
+    [host_locality_any] = "any",
+    [host_locality_remote] = "remote",
+};
+
 static void update_selected_offset_with_window_size(unsigned int *selected_row, unsigned int *offset,
                                                     unsigned int row_available_to_draw, unsigned int num_to_draw) {
 
@@ -1163,7 +1875,8 @@ static void update_selected_offset_with_window_size(unsigned int *selected_row,
 static char process_print_buffer[process_buffer_line_size];
 
 static void print_processes_on_screen(all_processes all_procs, struct process_window *process,
-                                      enum process_field sort_criterion, process_field_displayed fields_to_display) {
+                                      enum process_field sort_criterion, process_field_displayed fields_to_display,
+                                      const struct imbalance_tracker *imbalance) {
   WINDOW *win = process->option_window.state == nvtop_option_state_hidden ? process->process_win
                                                                           : process->process_with_option_win;
   struct gpuid_and_process *processes = all_procs.processes;
@@ -1180,9 +1893,19 @@ static void print_processes_on_screen(all_processes all_procs, struct process_wi
 
   char pid_str[sizeof_process_field[process_pid] + 1];
   char guid_str[sizeof_process_field[process_gpu_id] + 1];
+  char gpu_rate[sizeof_process_field[process_gpu_rate] + 1];
   char memory[sizeof_process_field[process_memory] + 1];
   char cpu_percent[sizeof_process_field[process_cpu_usage] + 1];
   char cpu_mem[sizeof_process_field[process_cpu_mem_usage] + 1];
+  char io_read[sizeof_process_field[process_io_read] + 1];
+  char energy[sizeof_process_field[process_energy] + 1];
+  char gpu_time[sizeof_process_field[process_gpu_time] + 1];
+  char memory_peak[sizeof_process_field[process_memory_peak] + 1];
+  char gpu_average[sizeof_process_field[process_gpu_average] + 1];
+  char idle_held[sizeof_process_field[process_idle_held] + 1];
+  char memory_growth[sizeof_process_field[process_memory_growth] + 1];
+  char time_to_oom[sizeof_process_field[process_time_to_oom] + 1];
+  char namespace_pid[sizeof_process_field[process_namespace_pid] + 1];
 
   unsigned int start_at_process = process->offset;
   unsigned int end_at_process = start_at_process + rows;
@@ -1214,6 +1937,53 @@ static void print_processes_on_screen(all_processes all_procs, struct process_wi
   }
   int end_col_process_type = start_col_process_type + sizeof_process_field[process_type];
 
+  int start_col_gpu_id = 0;
+  for (enum process_field i = process_pid; i < process_gpu_id; ++i) {
+    if (process_is_field_displayed(i, fields_to_display))
+      start_col_gpu_id += sizeof_process_field[i] + 1;
+  }
+  int end_col_gpu_id = start_col_gpu_id + sizeof_process_field[process_gpu_id];
+
+  int start_col_cpu_usage = 0;
+  for (enum process_field i = process_pid; i < process_cpu_usage; ++i) {
+    if (process_is_field_displayed(i, fields_to_display))
+      start_col_cpu_usage += sizeof_process_field[i] + 1;
+  }
+  int end_col_cpu_usage = start_col_cpu_usage + sizeof_process_field[process_cpu_usage];
+
+  int start_col_numa = 0;
+  for (enum process_field i = process_pid; i < process_numa; ++i) {
+    if (process_is_field_displayed(i, fields_to_display))
+      start_col_numa += sizeof_process_field[i] + 1;
+  }
+  int end_col_numa = start_col_numa + sizeof_process_field[process_numa];
+
+  int start_col_starvation = 0;
+  for (enum process_field i = process_pid; i < process_starvation; ++i) {
+    if (process_is_field_displayed(i, fields_to_display))
+      start_col_starvation += sizeof_process_field[i] + 1;
+  }
+  int end_col_starvation = start_col_starvation + sizeof_process_field[process_starvation];
+
+  int start_col_memory = 0;
+  for (enum process_field i = process_pid; i < process_memory; ++i) {
+    if (process_is_field_displayed(i, fields_to_display))
+      start_col_memory += sizeof_process_field[i] + 1;
+  }
+  int end_col_memory = start_col_memory + sizeof_process_field[process_memory];
+
+  int start_col_memory_growth = 0;
+  for (enum process_field i = process_pid; i < process_memory_growth; ++i) {
+    if (process_is_field_displayed(i, fields_to_display))
+      start_col_memory_growth += sizeof_process_field[i] + 1;
+  }
+  // The growth and time to OOM columns are adjacent
+  int end_col_time_to_oom = start_col_memory_growth;
+  for (enum process_field i = process_memory_growth; i <= process_time_to_oom; ++i) {
+    if (process_is_field_displayed(i, fields_to_display))
+      end_col_time_to_oom += sizeof_process_field[i] + 1;
+  }
+
   static unsigned printed_last_call = 0;
   unsigned last_line_printed = 0;
   for (unsigned int i = start_at_process; i < end_at_process && i < all_procs.processes_count; ++i) {
@@ -1221,8 +1991,12 @@ static void print_processes_on_screen(all_processes all_procs, struct process_wi
 
     printed = 0;
     if (process_is_field_displayed(process_pid, fields_to_display)) {
-      size_t size =
-          snprintf(pid_str, sizeof_process_field[process_pid] + 1, "%" PRIdMAX, (intmax_t)processes[i].process->pid);
+      size_t size = 0;
+      if (processes[i].group && processes[i].group->rollup)
+        pid_str[0] = '\0';
+      else
+        size = snprintf(pid_str, sizeof_process_field[process_pid] + 1, "%" PRIdMAX,
+                        (intmax_t)processes[i].process->pid);
       if (size == sizeof_process_field[process_pid] + 1)
         pid_str[sizeof_process_field[process_pid]] = '\0';
       printed += snprintf(&process_print_buffer[printed], process_buffer_line_size, "%*s ",
@@ -1242,7 +2016,11 @@ static void print_processes_on_screen(all_processes all_procs, struct process_wi
     }
 
     if (process_is_field_displayed(process_gpu_id, fields_to_display)) {
-      size_t size = snprintf(guid_str, sizeof_process_field[process_gpu_id] + 1, "%u", processes[i].gpu_id);
+      size_t size;
+      if (processes[i].group)
+        size = snprintf(guid_str, sizeof_process_field[process_gpu_id] + 1, "%s", processes[i].group->devices);
+      else
+        size = snprintf(guid_str, sizeof_process_field[process_gpu_id] + 1, "%u", processes[i].gpu_id);
       if (size >= sizeof_process_field[process_gpu_id] + 1)
         pid_str[sizeof_process_field[process_gpu_id]] = '\0';
       printed += snprintf(&process_print_buffer[printed], process_buffer_line_size - printed, "%*s ",
@@ -1266,10 +2044,16 @@ static void print_processes_on_screen(all_processes all_procs, struct process_wi
       unsigned gpu_usage = 0;
       if (GPUINFO_PROCESS_FIELD_VALID(processes[i].process, gpu_usage)) {
         gpu_usage = processes[i].process->gpu_usage;
-        printed += snprintf(&process_print_buffer[printed], process_buffer_line_size - printed, "%3u%% ", gpu_usage);
+        if (processes[i].group && !processes[i].group->rollup)
+          snprintf(gpu_rate, sizeof_process_field[process_gpu_rate] + 1, "%3u%% %3u-%-3u", gpu_usage,
+                   processes[i].group->gpu_usage_min, processes[i].group->gpu_usage_max);
+        else
+          snprintf(gpu_rate, sizeof_process_field[process_gpu_rate] + 1, "%3u%%", gpu_usage);
       } else {
-        printed += snprintf(&process_print_buffer[printed], process_buffer_line_size - printed, "N/A  ");
+        snprintf(gpu_rate, sizeof_process_field[process_gpu_rate] + 1, "N/A");
       }
+      printed += snprintf(&process_print_buffer[printed], process_buffer_line_size - printed, "%-*s ",
+                          sizeof_process_field[process_gpu_rate], gpu_rate);
     }
 
     if (process_is_field_displayed(process_enc_rate, fields_to_display)) {
@@ -1328,7 +2112,164 @@ static void print_processes_on_screen(all_processes all_procs, struct process_wi
                           sizeof_process_field[process_cpu_mem_usage], cpu_mem);
     }
 
+    if (process_is_field_displayed(process_io_read, fields_to_display)) {
+      if (GPUINFO_PROCESS_FIELD_VALID(processes[i].process, io_read_rate)) {
+        unsigned long long rate = processes[i].process->io_read_rate;
+        if (rate >= 1048576ull)
+          snprintf(io_read, sizeof_process_field[process_io_read] + 1, "%lluMiB/s", rate / 1048576ull);
+        else
+          snprintf(io_read, sizeof_process_field[process_io_read] + 1, "%lluKiB/s", rate / 1024ull);
+      } else {
+        snprintf(io_read, sizeof_process_field[process_io_read] + 1, "N/A");
+      }
+      printed += snprintf(&process_print_buffer[printed], process_buffer_line_size - printed, "%*s ",
+                          sizeof_process_field[process_io_read], io_read);
+    }
+
+    if (process_is_field_displayed(process_starvation, fields_to_display)) {
+      const char *starvation = "N/A";
+      if (GPUINFO_PROCESS_FIELD_VALID(processes[i].process, starvation))
+        starvation = starvation_names[processes[i].process->starvation];
+      printed += snprintf(&process_print_buffer[printed], process_buffer_line_size - printed, "%*s ",
+                          sizeof_process_field[process_starvation], starvation);
+    }
+
+    if (process_is_field_displayed(process_numa, fields_to_display)) {
+      const char *locality = "N/A";
+      if (GPUINFO_PROCESS_FIELD_VALID(processes[i].process, locality))
+        locality = locality_names[processes[i].process->locality];
+      printed += snprintf(&process_print_buffer[printed], process_buffer_line_size - printed, "%*s ",
+                          sizeof_process_field[process_numa], locality);
+    }
+
+    if (process_is_field_displayed(process_energy, fields_to_display)) {
+      if (GPUINFO_PROCESS_FIELD_VALID(processes[i].process, energy)) {
+        unsigned long long joules = processes[i].process->energy / 1000ull;
+        if (joules >= 10000000ull)
+          snprintf(energy, sizeof_process_field[process_energy] + 1, "%lluMJ", joules / 1000000ull);
+        else if (joules >= 100000ull)
+          snprintf(energy, sizeof_process_field[process_energy] + 1, "%llukJ", joules / 1000ull);
+        else
+          snprintf(energy, sizeof_process_field[process_energy] + 1, "%lluJ", joules);
+      } else {
+        snprintf(energy, sizeof_process_field[process_energy] + 1, "N/A");
+      }
+      printed += snprintf(&process_print_buffer[printed], process_buffer_line_size - printed, "%*s ",
+                          sizeof_process_field[process_energy], energy);
+    }
+
+    if (process_is_field_displayed(process_gpu_time, fields_to_display)) {
+      if (GPUINFO_PROCESS_FIELD_VALID(processes[i].process, gpu_time)) {
+        unsigned long long seconds = processes[i].process->gpu_time / 1000000000ull;
+        if (seconds < 60ull)
+          snprintf(gpu_time, sizeof_process_field[process_gpu_time] + 1, "%.1fs",
+                   (double)processes[i].process->gpu_time / 1e9);
+        else if (seconds < 3600ull)
+          snprintf(gpu_time, sizeof_process_field[process_gpu_time] + 1, "%llum%02llus", seconds / 60ull,
+                   seconds % 60ull);
+        else
+          snprintf(gpu_time, sizeof_process_field[process_gpu_time] + 1, "%lluh%02llum", seconds / 3600ull,
+                   seconds / 60ull % 60ull);
+      } else {
+        snprintf(gpu_time, sizeof_process_field[process_gpu_time] + 1, "N/A");
+      }
+      printed += snprintf(&process_print_buffer[printed], process_buffer_line_size - printed, "%*s ",
+                          sizeof_process_field[process_gpu_time], gpu_time);
+    }
+
+    if (process_is_field_displayed(process_memory_peak, fields_to_display)) {
+      if (GPUINFO_PROCESS_FIELD_VALID(processes[i].process, gpu_memory_peak))
+        snprintf(memory_peak, sizeof_process_field[process_memory_peak] + 1, "%lluMiB",
+                 processes[i].process->gpu_memory_peak / 1048576ull);
+      else
+        snprintf(memory_peak, sizeof_process_field[process_memory_peak] + 1, "N/A");
+      printed += snprintf(&process_print_buffer[printed], process_buffer_line_size - printed, "%*s ",
+                          sizeof_process_field[process_memory_peak], memory_peak);
+    }
+
+    if (process_is_field_displayed(process_gpu_average, fields_to_display)) {
+      if (GPUINFO_PROCESS_FIELD_VALID(processes[i].process, gpu_usage_average))
+        snprintf(gpu_average, sizeof_process_field[process_gpu_average] + 1, "%u%%",
+                 processes[i].process->gpu_usage_average);
+      else
+        snprintf(gpu_average, sizeof_process_field[process_gpu_average] + 1, "N/A");
+      printed += snprintf(&process_print_buffer[printed], process_buffer_line_size - printed, "%*s ",
+                          sizeof_process_field[process_gpu_average], gpu_average);
+    }
+
+    if (process_is_field_displayed(process_idle_held, fields_to_display)) {
+      if (GPUINFO_PROCESS_FIELD_VALID(processes[i].process, idle_memory_time)) {
+        double gib_hours = processes[i].process->idle_memory_time / (1073741824. * 3600.);
+        snprintf(idle_held, sizeof_process_field[process_idle_held] + 1, "%.*fGiBh",
+                 gib_hours < 10. ? 2 : gib_hours < 100. ? 1 : 0, gib_hours);
+      } else {
+        snprintf(idle_held, sizeof_process_field[process_idle_held] + 1, "N/A");
+      }
+      printed += snprintf(&process_print_buffer[printed], process_buffer_line_size - printed, "%*s ",
+                          sizeof_process_field[process_idle_held], idle_held);
+    }
+
+    if (process_is_field_displayed(process_memory_growth, fields_to_display)) {
+      if (GPUINFO_PROCESS_FIELD_VALID(processes[i].process, gpu_memory_growth)) {
+        double mib_per_minute = processes[i].process->gpu_memory_growth * 60. / 1048576.;
+        if (fabs(mib_per_minute) < 100.)
+          snprintf(memory_growth, sizeof_process_field[process_memory_growth] + 1, "%+.1fM/m", mib_per_minute);
+        else if (fabs(mib_per_minute) < 1024.)
+          snprintf(memory_growth, sizeof_process_field[process_memory_growth] + 1, "%+.0fM/m", mib_per_minute);
+        else
+          snprintf(memory_growth, sizeof_process_field[process_memory_growth] + 1, "%+.1fG/m",
+                   mib_per_minute / 1024.);
+      } else {
+        snprintf(memory_growth, sizeof_process_field[process_memory_growth] + 1, "N/A");
+      }
+      printed += snprintf(&process_print_buffer[printed], process_buffer_line_size - printed, "%*s ",
+                          sizeof_process_field[process_memory_growth], memory_growth);
+    }
+
+    if (process_is_field_displayed(process_time_to_oom, fields_to_display)) {
+      if (GPUINFO_PROCESS_FIELD_VALID(processes[i].process, time_to_oom)) {
+        double seconds = processes[i].process->time_to_oom;
+        if (seconds < 60.)
+          snprintf(time_to_oom, sizeof_process_field[process_time_to_oom] + 1, "%us", (unsigned)seconds);
+        else if (seconds < 3600.)
+          snprintf(time_to_oom, sizeof_process_field[process_time_to_oom] + 1, "%um", (unsigned)(seconds / 60.));
+        else if (seconds < 86400.)
+          snprintf(time_to_oom, sizeof_process_field[process_time_to_oom] + 1, "%uh", (unsigned)(seconds / 3600.));
+        else if (seconds < 1000. * 86400.)
+          snprintf(time_to_oom, sizeof_process_field[process_time_to_oom] + 1, "%ud",
+                   (unsigned)(seconds / 86400.));
+        else
+          snprintf(time_to_oom, sizeof_process_field[process_time_to_oom] + 1, ">999d");
+      } else {
+        snprintf(time_to_oom, sizeof_process_field[process_time_to_oom] + 1, "N/A");
+      }
+      printed += snprintf(&process_print_buffer[printed], process_buffer_line_size - printed, "%*s ",
+                          sizeof_process_field[process_time_to_oom], time_to_oom);
+    }
+
+    if (process_is_field_displayed(process_namespace_pid, fields_to_display)) {
+      if (GPUINFO_PROCESS_FIELD_VALID(processes[i].process, namespace_pid))
+        snprintf(namespace_pid, sizeof_process_field[process_namespace_pid] + 1, "%" PRIdMAX,
+                 (intmax_t)processes[i].process->namespace_pid);
+      else
+        snprintf(namespace_pid, sizeof_process_field[process_namespace_pid] + 1, "N/A");
+      printed += snprintf(&process_print_buffer[printed], process_buffer_line_size - printed, "%*s ",
+                          sizeof_process_field[process_namespace_pid], namespace_pid);
+    }
+
+    if (process_is_field_displayed(process_job_id, fields_to_display)) {
+      const char *job_id =
+          GPUINFO_PROCESS_FIELD_VALID(processes[i].process, job_id) ? processes[i].process->job_id : "N/A";
+      printed += snprintf(&process_print_buffer[printed], process_buffer_line_size - printed, "%*.*s ",
+                          sizeof_process_field[process_job_id], sizeof_process_field[process_job_id], job_id);
+    }
+
     if (process_is_field_displayed(process_command, fields_to_display)) {
+      if (processes[i].group)
+        printed += snprintf(&process_print_buffer[printed], process_buffer_line_size - printed, "[%c] ",
+                            process_group_is_expanded(process, processes[i].group->key) ? '-' : '+');
+      else if (processes[i].group_member)
+        printed += snprintf(&process_print_buffer[printed], process_buffer_line_size - printed, " `- ");
       if (GPUINFO_PROCESS_FIELD_VALID(processes[i].process, cmdline))
         printed += snprintf(&process_print_buffer[printed], process_buffer_line_size - printed, "%.*s",
                             process_buffer_line_size - printed, processes[i].process->cmdline);
@@ -1361,6 +2302,38 @@ static void print_processes_on_screen(all_processes all_procs, struct process_wi
                                 end_col_process_type - (int)process->offset_column, 0, magenta_color);
         }
       }
+      if (process_is_field_displayed(process_gpu_id, fields_to_display)) {
+        bool straggler = processes[i].group ? processes[i].group->straggler_member
+                                            : imbalance_device_is_straggler(imbalance, processes[i].gpu_id);
+        if (straggler)
+          set_attribute_between(win, write_at, start_col_gpu_id - (int)process->offset_column,
+                                end_col_gpu_id - (int)process->offset_column, 0, red_color);
+      }
+      if (process_is_field_displayed(process_starvation, fields_to_display) &&
+          GPUINFO_PROCESS_FIELD_VALID(processes[i].process, starvation) &&
+          processes[i].process->starvation != gpu_process_not_starved)
+        set_attribute_between(win, write_at, start_col_starvation - (int)process->offset_column,
+                              end_col_starvation - (int)process->offset_column, 0, red_color);
+      // Remote placement is flagged on the CPU usage too, the NUMA column being hidden by default
+      if (GPUINFO_PROCESS_FIELD_VALID(processes[i].process, locality) &&
+          processes[i].process->locality == host_locality_remote) {
+        if (process_is_field_displayed(process_cpu_usage, fields_to_display))
+          set_attribute_between(win, write_at, start_col_cpu_usage - (int)process->offset_column,
+                                end_col_cpu_usage - (int)process->offset_column, 0, red_color);
+        if (process_is_field_displayed(process_numa, fields_to_display))
+          set_attribute_between(win, write_at, start_col_numa - (int)process->offset_column,
+                                end_col_numa - (int)process->offset_column, 0, red_color);
+      }
+      // Processes on course to exhaust the device memory soon are flagged on their memory usage
+      if (GPUINFO_PROCESS_FIELD_VALID(processes[i].process, time_to_oom) &&
+          processes[i].process->time_to_oom < MEMORY_TREND_OOM_WARNING) {
+        if (process_is_field_displayed(process_memory, fields_to_display))
+          set_attribute_between(win, write_at, start_col_memory - (int)process->offset_column,
+                                end_col_memory - (int)process->offset_column, 0, red_color);
+        if (end_col_time_to_oom > start_col_memory_growth)
+          set_attribute_between(win, write_at, start_col_memory_growth - (int)process->offset_column,
+                                end_col_time_to_oom - (int)process->offset_column - 1, 0, red_color);
+      }
     }
   }
   if (printed_last_call > last_line_printed) {
@@ -1375,6 +2348,9 @@ static void print_processes_on_screen(all_processes all_procs, struct process_wi
 
 static void update_process_option_win(struct nvtop_interface *interface);
 
+// The PBS job ids end with the (long) name of their server
+#define PROCESS_JOB_ID_COLUMN_MAX 16
+
 static void draw_processes(struct list_head *devices, struct nvtop_interface *interface) {
   if (interface->options.hide_processes_list)
     return;
@@ -1393,15 +2369,61 @@ static void draw_processes(struct list_head *devices, struct nvtop_interface *in
 
   all_processes all_procs = all_processes_array(devices);
   filter_out_nvtop_pid(&all_procs, interface);
-  sort_process(all_procs, interface->options.sort_processes_by, !interface->options.sort_descending_order);
+  struct process_groups *groups = &interface->process.groups;
+  sizeof_process_field[process_gpu_id] = 3;
+  sizeof_process_field[process_gpu_rate] = 4;
+  enum process_rollup rollup = interface->options.process_rollup;
+  if (rollup != process_rollup_none || interface->options.group_multi_device_processes) {
+    // The rows only change with a refresh, the groups are not rebuilt at every key press
+    if (!groups->generation || groups->rollup != rollup ||
+        interface->process.groups_refresh != interface->saved_data_count ||
+        interface->process.groups_filter_nvtop_pid != interface->options.filter_nvtop_pid) {
+      process_groups_update(groups, all_procs, rollup);
+      interface->process.groups_refresh = interface->saved_data_count;
+      interface->process.groups_filter_nvtop_pid = interface->options.filter_nvtop_pid;
+    }
+    process_groups_prune_expanded(&interface->process, groups);
+    for (unsigned i = 0; i < groups->groups_count; ++i) {
+      groups->groups[i]->straggler_member = false;
+      for (unsigned member = groups->groups[i]->first_member; member != PROCESS_GROUP_NO_MEMBER;
+           member = groups->next_member[member]) {
+        if (imbalance_device_is_straggler(&interface->imbalance, all_procs.processes[member].gpu_id))
+          groups->groups[i]->straggler_member = true;
+      }
+    }
+    all_processes group_rows =
+        process_groups_to_rows(all_procs, groups, &interface->process, interface->options.sort_processes_by,
+                               !interface->options.sort_descending_order);
+    free(all_procs.processes);
+    all_procs = group_rows;
+    for (unsigned i = 0; i < groups->groups_count; ++i) {
+      if (groups->groups[i]->members_count > 1 || groups->groups[i]->rollup) {
+        unsigned length = strlen(groups->groups[i]->devices);
+        if (length > sizeof_process_field[process_gpu_id])
+          sizeof_process_field[process_gpu_id] = length;
+        // Mean followed by the min-max range
+        if (!groups->groups[i]->rollup)
+          sizeof_process_field[process_gpu_rate] = 12;
+      }
+    }
+  } else {
+    sort_process(all_procs, interface->options.sort_processes_by, !interface->options.sort_descending_order);
+  }
 
   if (all_procs.processes_count > 0) {
     if (interface->process.selected_row >= all_procs.processes_count)
       interface->process.selected_row = all_procs.processes_count - 1;
-    interface->process.selected_pid = all_procs.processes[interface->process.selected_row].process->pid;
+    const struct gpuid_and_process *selected = &all_procs.processes[interface->process.selected_row];
+    interface->process.selected_pid = selected->process->pid;
+    interface->process.selected_host_id = selected->host_id;
+    interface->process.selected_is_group = selected->group != NULL || selected->group_member;
+    interface->process.selected_group_key =
+        selected->group ? selected->group->key : process_group_key_of(selected, rollup);
   } else {
     interface->process.selected_row = 0;
     interface->process.selected_pid = -1;
+    interface->process.selected_host_id = 0;
+    interface->process.selected_is_group = false;
   }
 
   unsigned largest_username = 4;
@@ -1414,8 +2436,19 @@ static void draw_processes(struct list_head *devices, struct nvtop_interface *in
   }
   sizeof_process_field[process_user] = largest_username;
 
+  unsigned largest_job_id = 3;
+  for (unsigned i = 0; i < all_procs.processes_count; ++i) {
+    if (GPUINFO_PROCESS_FIELD_VALID(all_procs.processes[i].process, job_id)) {
+      unsigned length = strlen(all_procs.processes[i].process->job_id);
+      if (length > largest_job_id)
+        largest_job_id = length;
+    }
+  }
+  sizeof_process_field[process_job_id] = largest_job_id < PROCESS_JOB_ID_COLUMN_MAX ? largest_job_id
+                                                                                     : PROCESS_JOB_ID_COLUMN_MAX;
+
   print_processes_on_screen(all_procs, &interface->process, interface->options.sort_processes_by,
-                            interface->options.process_fields_displayed);
+                            interface->options.process_fields_displayed, &interface->imbalance);
   free(all_procs.processes);
 }
 
@@ -1635,6 +2668,7 @@ void save_current_data_to_ring(struct list_head *devices, struct nvtop_interface
   unsigned dev_id = 0;
 
   list_for_each_entry(device, devices, list) {
+    unsigned slot = interface->options.gpu_specific_opts[dev_id].history_slot;
     unsigned data_index = 0;
     for (enum plot_information info = plot_gpu_rate; info < plot_information_count; ++info) {
       if (plot_isset_draw_info(info, interface->options.gpu_specific_opts[dev_id].to_draw)) {
@@ -1688,22 +2722,131 @@ void save_current_data_to_ring(struct list_head *devices, struct nvtop_interface
             data_val = device->dynamic_info.mem_clock_speed * 100 / device->dynamic_info.mem_clock_speed_max;
           }
           break;
+        case plot_pcie_rx:
+          if (GPUINFO_DYNAMIC_FIELD_VALID(&device->dynamic_info, pcie_rx))
+            data_val = device->dynamic_info.pcie_rx;
+          break;
+        case plot_pcie_tx:
+          if (GPUINFO_DYNAMIC_FIELD_VALID(&device->dynamic_info, pcie_tx))
+            data_val = device->dynamic_info.pcie_tx;
+          break;
+        case plot_gpu_power_draw:
+          if (GPUINFO_DYNAMIC_FIELD_VALID(&device->dynamic_info, power_draw))
+            data_val = device->dynamic_info.power_draw;
+          break;
+        case plot_gpu_clock:
+          if (GPUINFO_DYNAMIC_FIELD_VALID(&device->dynamic_info, gpu_clock_speed))
+            data_val = device->dynamic_info.gpu_clock_speed;
+          break;
+        case plot_gpu_mem_clock:
+          if (GPUINFO_DYNAMIC_FIELD_VALID(&device->dynamic_info, mem_clock_speed))
+            data_val = device->dynamic_info.mem_clock_speed;
+          break;
+        case plot_gpu_mem_used:
+          // Saved in MiB to fit the ring buffer
+          if (GPUINFO_DYNAMIC_FIELD_VALID(&device->dynamic_info, used_memory))
+            data_val = device->dynamic_info.used_memory / 1048576;
+          break;
         case plot_information_count:
           break;
         }
-        interface_ring_buffer_push(&interface->saved_data_ring, dev_id, data_index, data_val);
+        interface_ring_buffer_push(&interface->saved_data_ring, slot, data_index, data_val);
         data_index++;
       }
     }
 
     dev_id++;
   }
+  nvtop_time now;
+  nvtop_get_current_time(&now);
+  sample_clock_push(&interface->saved_data_times, now.tv_sec + now.tv_nsec / 1e9);
+  interface->saved_data_count++;
 }
 
+// The processes of a batch scheduler job, or of a container or cgroup, running on several devices are considered part
+// of the same job. Sharing a parent is not enough, it may be the login shell or the launcher of unrelated jobs.
+static int64_t imbalance_job_key(unsigned host_id, const struct gpu_process *process) {
+  if (GPUINFO_PROCESS_FIELD_VALID(process, job_id))
+    return process_group_name_key(host_id, process->job_id);
+  if (GPUINFO_PROCESS_FIELD_VALID(process, cgroup) && strcmp(process->cgroup, "/"))
+    return process_group_name_key(host_id, process->cgroup);
+  return process_group_key(host_id, process->pid);
+}
+
+void interface_track_imbalance(struct list_head *devices, struct nvtop_interface *interface) {
+  unsigned total_processes_count = 0;
+  struct gpu_info *device;
+  list_for_each_entry(device, devices, list) { total_processes_count += device->processes_count; }
+
+  struct imbalance_sample *samples = NULL;
+  if (total_processes_count) {
+    samples = malloc(total_processes_count * sizeof(*samples));
+    if (!samples) {
+      perror("Cannot allocate memory: ");
+      exit(EXIT_FAILURE);
+    }
+  }
+  unsigned dev_id = 0, samples_count = 0;
+  list_for_each_entry(device, devices, list) {
+    for (unsigned i = 0; i < device->processes_count; ++i) {
+      const struct gpu_process *process = &device->processes[i];
+      struct imbalance_sample *sample = &samples[samples_count++];
+      sample->job_id = imbalance_job_key(device->host_id, process);
+      sample->device = dev_id;
+      sample->gpu_usage_valid = GPUINFO_PROCESS_FIELD_VALID(process, gpu_usage);
+      sample->gpu_usage = sample->gpu_usage_valid ? process->gpu_usage : 0;
+      sample->gpu_memory = GPUINFO_PROCESS_FIELD_VALID(process, gpu_memory_usage) ? process->gpu_memory_usage : 0;
+    }
+    dev_id++;
+  }
+  imbalance_tracker_push(&interface->imbalance, samples_count, samples);
+  free(samples);
+}
+
+// The maximum of the samples in the plot column age columns away from the newest edge, or the last sample before the
+// column when it holds none. False when the column is older than the series.
+static bool navigation_column_value(const struct history_navigation *navigation, const struct history_series *series,
+                                    unsigned age, unsigned *value, unsigned *last_sample) {
+  double column_end = navigation->newest_edge - age * navigation->column_seconds;
+  unsigned first = history_lower_bound(navigation->samples, navigation->times, column_end - navigation->column_seconds);
+  unsigned past_last = history_lower_bound(navigation->samples, navigation->times, column_end);
+  unsigned series_start = navigation->samples - series->size;
+  if (past_last <= series_start)
+    return false;
+  first = first > series_start ? first - series_start : 0;
+  past_last -= series_start;
+  if (first == past_last)
+    first--;
+  *value = history_series_max(series, first, past_last);
+  *last_sample = series_start + past_last - 1;
+  return true;
+}
+
+static const char *plot_legend_names[plot_information_count] = {
+    [plot_gpu_rate] = "%",
+    [plot_gpu_mem_rate] = "mem%",
+    [plot_encoder_rate] = "encode%",
+    [plot_decoder_rate] = "decode%",
+    [plot_gpu_temperature] = "temp(c)",
+    [plot_gpu_power_draw_rate] = "power%",
+    [plot_fan_speed] = "fan%",
+    [plot_gpu_clock_rate] = "clock%",
+    [plot_gpu_mem_clock_rate] = "mem clock%",
+    [plot_pcie_rx] = "rx",
+    [plot_pcie_tx] = "tx",
+    [plot_gpu_power_draw] = "power",
+    [plot_gpu_clock] = "clock",
+    [plot_gpu_mem_clock] = "mem clock",
+    [plot_gpu_mem_used] = "mem",
+};
+
+// The values in absolute units are scaled to 0-100 against the rounded maximum of their unit over the displayed
+// history. The y axis shows that unit when the plot has a single one and stays in percent otherwise.
 static unsigned populate_plot_data_from_ring_buffer(const struct nvtop_interface *interface,
                                                     struct plot_window *plot_win, unsigned size_data_buff,
                                                     double data[size_data_buff],
-                                                    char plot_legend[MAX_LINES_PER_PLOT][PLOT_MAX_LEGEND_SIZE]) {
+                                                    char plot_legend[MAX_LINES_PER_PLOT][PLOT_MAX_LEGEND_SIZE],
+                                                    char y_labels[PLOT_Y_LABELS][PLOT_Y_LABEL_SIZE]) {
 
   memset(data, 0, size_data_buff * sizeof(*data));
   unsigned total_to_draw = 0;
@@ -1719,90 +2862,355 @@ static unsigned populate_plot_data_from_ring_buffer(const struct nvtop_interface
   double(*data_split)[total_to_draw] = (double(*)[total_to_draw])data;
 
   unsigned in_processing = 0;
+  unsigned line_devices[MAX_LINES_PER_PLOT];
+  enum plot_information line_infos[MAX_LINES_PER_PLOT];
+  enum plot_unit line_units[MAX_LINES_PER_PLOT];
+  double unit_max[plot_unit_count] = {0};
   for (unsigned i = 0; i < plot_win->num_devices_to_plot; ++i) {
     unsigned dev_id = plot_win->devices_ids[i];
     plot_info_to_draw to_draw = interface->options.gpu_specific_opts[dev_id].to_draw;
+    unsigned slot = interface->options.gpu_specific_opts[dev_id].history_slot;
     unsigned data_ring_index = 0;
     for (enum plot_information info = plot_gpu_rate; info < plot_information_count; ++info) {
       if (plot_isset_draw_info(info, to_draw)) {
-        // Populate the legend
-        switch (info) {
-        case plot_gpu_rate:
-          snprintf(plot_legend[in_processing], PLOT_MAX_LEGEND_SIZE, "GPU%u %%", dev_id);
-          break;
-        case plot_gpu_mem_rate:
-          snprintf(plot_legend[in_processing], PLOT_MAX_LEGEND_SIZE, "GPU%u mem%%", dev_id);
-          break;
-        case plot_encoder_rate:
-          snprintf(plot_legend[in_processing], PLOT_MAX_LEGEND_SIZE, "GPU%u encode%%", dev_id);
-          break;
-        case plot_decoder_rate:
-          snprintf(plot_legend[in_processing], PLOT_MAX_LEGEND_SIZE, "GPU%u decode%%", dev_id);
-          break;
-        case plot_gpu_temperature:
-          snprintf(plot_legend[in_processing], PLOT_MAX_LEGEND_SIZE, "GPU%u temp(c)", dev_id);
-          break;
-        case plot_gpu_power_draw_rate:
-          snprintf(plot_legend[in_processing], PLOT_MAX_LEGEND_SIZE, "GPU%u power%%", dev_id);
-          break;
-        case plot_fan_speed:
-          snprintf(plot_legend[in_processing], PLOT_MAX_LEGEND_SIZE, "GPU%u fan%%", dev_id);
-          break;
-        case plot_gpu_clock_rate:
-          snprintf(plot_legend[in_processing], PLOT_MAX_LEGEND_SIZE, "GPU%u clock%%", dev_id);
-          break;
-        case plot_gpu_mem_clock_rate:
-          snprintf(plot_legend[in_processing], PLOT_MAX_LEGEND_SIZE, "GPU%u mem clock%%", dev_id);
-          break;
-        case plot_information_count:
-          break;
-        }
+        line_devices[in_processing] = dev_id;
+        line_infos[in_processing] = info;
+        line_units[in_processing] = plot_information_unit(info);
         // Copy the data
-        unsigned data_in_ring = interface_ring_buffer_data_stored(&interface->saved_data_ring, dev_id, data_ring_index);
-        if (interface->options.plot_left_to_right) {
+        unsigned data_in_ring = interface_ring_buffer_data_stored(&interface->saved_data_ring, slot, data_ring_index);
+        if (interface->navigation.active) {
+          for (unsigned age = 0; age < max_data_to_copy; ++age) {
+            unsigned value, sample;
+            if (navigation_column_value(&interface->navigation, &plot_win->history[in_processing], age, &value,
+                                        &sample)) {
+              unsigned j = interface->options.plot_left_to_right ? age : max_data_to_copy - age - 1;
+              data_split[j][in_processing] = value;
+            }
+          }
+        } else if (interface->options.plot_left_to_right) {
           for (unsigned j = 0; j < data_in_ring && j < max_data_to_copy; ++j) {
             data_split[j][in_processing] =
-                interface_ring_buffer_get(&interface->saved_data_ring, dev_id, data_ring_index, data_in_ring - j - 1);
+                interface_ring_buffer_get(&interface->saved_data_ring, slot, data_ring_index, data_in_ring - j - 1);
           }
         } else {
           for (unsigned j = 0; j < data_in_ring && j < max_data_to_copy; ++j) {
             data_split[max_data_to_copy - j - 1][in_processing] =
-                interface_ring_buffer_get(&interface->saved_data_ring, dev_id, data_ring_index, data_in_ring - j - 1);
+                interface_ring_buffer_get(&interface->saved_data_ring, slot, data_ring_index, data_in_ring - j - 1);
           }
         }
+        for (unsigned j = 0; j < max_data_to_copy; ++j)
+          unit_max[line_units[in_processing]] = fmax(unit_max[line_units[in_processing]], data_split[j][in_processing]);
         data_ring_index++;
         in_processing++;
       }
     }
   }
+
+  struct plot_scale scales[plot_unit_count];
+  bool single_unit = true;
+  for (unsigned line = 0; line < total_to_draw; ++line) {
+    plot_autoscale(line_units[line], unit_max[line_units[line]], &scales[line_units[line]]);
+    single_unit = single_unit && line_units[line] == line_units[0];
+  }
+  for (unsigned line = 0; line < total_to_draw; ++line) {
+    const struct plot_scale *scale = &scales[line_units[line]];
+    const char *name = plot_legend_names[line_infos[line]];
+    if (line_units[line] == plot_unit_percent) {
+      snprintf(plot_legend[line], PLOT_MAX_LEGEND_SIZE, "GPU%u %s", line_devices[line], name);
+      continue;
+    }
+    for (unsigned j = 0; j < max_data_to_copy; ++j)
+      data_split[j][line] = data_split[j][line] * 100. / scale->full_scale;
+    if (single_unit) {
+      snprintf(plot_legend[line], PLOT_MAX_LEGEND_SIZE, "GPU%u %s %s", line_devices[line], name, scale->unit_name);
+    } else {
+      char full_scale[PLOT_Y_LABEL_SIZE];
+      plot_axis_label(scale->full_scale * scale->display_factor, full_scale);
+      snprintf(plot_legend[line], PLOT_MAX_LEGEND_SIZE, "GPU%u %s 0-%s%s", line_devices[line], name, full_scale,
+               scale->unit_name);
+    }
+  }
+  if (!single_unit)
+    plot_autoscale(plot_unit_percent, 100., &scales[plot_unit_percent]);
+  plot_y_labels(&scales[single_unit ? line_units[0] : plot_unit_percent], y_labels);
   return total_to_draw;
 }
 
+static void format_wall_clock(double wall_time, char buffer[16]) {
+  time_t seconds = (time_t)wall_time;
+  struct tm local;
+  if (!localtime_r(&seconds, &local)) {
+    snprintf(buffer, 16, "?");
+    return;
+  }
+  snprintf(buffer, 16, "%02d:%02d:%02d.%d", local.tm_hour, local.tm_min, local.tm_sec,
+           (int)((wall_time - seconds) * 10.) % 10);
+}
+
+// The cursor column, the values under it on the top border and the time of the plot edges on the bottom one
+static void draw_history_navigation(const struct nvtop_interface *interface, const struct plot_window *plot,
+                                    unsigned num_lines) {
+  const struct history_navigation *navigation = &interface->navigation;
+  bool newest_left = interface->options.plot_left_to_right;
+  unsigned columns = plot->num_data / num_lines;
+  int rows = getmaxy(plot->plot_window);
+  if (navigation->cursor < columns) {
+    unsigned column = newest_left ? navigation->cursor : columns - 1 - navigation->cursor;
+    for (int row = 0; row < rows; ++row)
+      mvwchgat(plot->plot_window, row, column * num_lines, num_lines, A_REVERSE, 0, NULL);
+  }
+
+  char readout[256];
+  int written = 0;
+  unsigned line = 0;
+  double cursor_time = navigation->newest_edge - (navigation->cursor + .5) * navigation->column_seconds;
+  for (unsigned i = 0; i < plot->num_devices_to_plot; ++i) {
+    unsigned dev_id = plot->devices_ids[i];
+    plot_info_to_draw to_draw = interface->options.gpu_specific_opts[dev_id].to_draw;
+    for (enum plot_information info = plot_gpu_rate; info < plot_information_count; ++info) {
+      if (!plot_isset_draw_info(info, to_draw))
+        continue;
+      unsigned value, sample;
+      char value_str[24] = "-";
+      if (navigation_column_value(navigation, &plot->history[line], navigation->cursor, &value, &sample)) {
+        cursor_time = navigation->times[sample];
+        enum plot_unit unit = plot_information_unit(info);
+        if (unit == plot_unit_percent) {
+          snprintf(value_str, sizeof(value_str), "%u", value);
+        } else {
+          struct plot_scale scale;
+          plot_autoscale(unit, value, &scale);
+          snprintf(value_str, sizeof(value_str), "%.3g%s", value * scale.display_factor, scale.unit_name);
+        }
+      }
+      if (written < (int)sizeof(readout))
+        written += snprintf(readout + written, sizeof(readout) - written, " GPU%u %s=%s", dev_id,
+                            plot_legend_names[info], value_str);
+      line++;
+    }
+  }
+  char cursor_clock[16];
+  format_wall_clock(cursor_time + navigation->wall_clock_offset, cursor_clock);
+  int width = getmaxx(plot->win) - 5;
+  int height = getmaxy(plot->win);
+  mvwhline(plot->win, 0, 4, 0, width);
+  wattron(plot->win, A_BOLD);
+  mvwprintw(plot->win, 0, 4, " %.*s", width - 1, cursor_clock);
+  wattroff(plot->win, A_BOLD);
+  waddnstr(plot->win, readout, max(width - 1 - (int)strlen(cursor_clock), 0));
+
+  char newest_clock[16], oldest_clock[16], zoom[24];
+  format_wall_clock(navigation->newest_edge + navigation->wall_clock_offset, newest_clock);
+  format_wall_clock(navigation->newest_edge - columns * navigation->column_seconds + navigation->wall_clock_offset,
+                    oldest_clock);
+  snprintf(zoom, sizeof(zoom), "%gs/col", navigation->column_seconds);
+  mvwhline(plot->win, height - 1, 4, 0, width);
+  if (width > (int)(strlen(newest_clock) + strlen(oldest_clock) + strlen(zoom) + 2)) {
+    mvwprintw(plot->win, height - 1, 4, "%s", newest_left ? newest_clock : oldest_clock);
+    mvwprintw(plot->win, height - 1, 4 + (width - strlen(zoom)) / 2, "%s", zoom);
+    mvwprintw(plot->win, height - 1, 4 + width - strlen(newest_clock), "%s", newest_left ? oldest_clock : newest_clock);
+  }
+}
+
 static void draw_plots(struct nvtop_interface *interface) {
   for (unsigned plot_id = 0; plot_id < interface->num_plots; ++plot_id) {
     werase(interface->plots[plot_id].plot_window);
 
     char plot_legend[MAX_LINES_PER_PLOT][PLOT_MAX_LEGEND_SIZE];
+    char y_labels[PLOT_Y_LABELS][PLOT_Y_LABEL_SIZE];
 
     unsigned num_lines =
         populate_plot_data_from_ring_buffer(interface, &interface->plots[plot_id], interface->plots[plot_id].num_data,
-                                            interface->plots[plot_id].data, plot_legend);
+                                            interface->plots[plot_id].data, plot_legend, y_labels);
 
     nvtop_line_plot(interface->plots[plot_id].plot_window, interface->plots[plot_id].num_data,
                     interface->plots[plot_id].data, num_lines, !interface->options.plot_left_to_right, plot_legend);
 
+    draw_plot_y_labels(interface->plots[plot_id].win, getmaxy(interface->plots[plot_id].plot_window), y_labels);
+    if (interface->navigation.active)
+      draw_history_navigation(interface, &interface->plots[plot_id], num_lines);
+    wnoutrefresh(interface->plots[plot_id].win);
     wnoutrefresh(interface->plots[plot_id].plot_window);
   }
 }
 
+// Ten intensity levels, from idle to fully used
+static const char heatmap_levels[] = " .:-=+*#%@";
+
+static void draw_heatmap_cell(WINDOW *win, unsigned char value) {
+  if (value == HEATMAP_NO_DATA) {
+    waddch(win, ' ');
+    return;
+  }
+  wcolor_set(win, grid_usage_color(value), NULL);
+  waddch(win, heatmap_levels[min(value / 10, 9)]);
+}
+
+// Index in the ring buffer of the first percentage drawn, or UINT_MAX when only absolute units are drawn
+static unsigned first_percent_data_index(plot_info_to_draw to_draw) {
+  unsigned data_index = 0;
+  for (enum plot_information info = plot_gpu_rate; info < plot_information_count; ++info) {
+    if (plot_isset_draw_info(info, to_draw)) {
+      if (plot_information_unit(info) == plot_unit_percent)
+        return data_index;
+      data_index++;
+    }
+  }
+  return UINT_MAX;
+}
+
+// Only the columns of the samples recorded since the last draw are read back from the ring buffer
+static void draw_heatmap(struct nvtop_interface *interface) {
+  struct heatmap_window *heatmap = &interface->heatmap;
+  unsigned to_fill = heatmap_advance(&heatmap->cells, interface->saved_data_count);
+  for (unsigned row = 0; row < heatmap->num_devices_to_plot; ++row) {
+    unsigned dev_id = heatmap->devices_ids[row];
+    unsigned slot = interface->options.gpu_specific_opts[dev_id].history_slot;
+    unsigned data_index = first_percent_data_index(interface->options.gpu_specific_opts[dev_id].to_draw);
+    unsigned data_in_ring = 0;
+    if (data_index != UINT_MAX)
+      data_in_ring = interface_ring_buffer_data_stored(&interface->saved_data_ring, slot, data_index);
+    for (unsigned age = 0; age < to_fill; ++age) {
+      unsigned char value = HEATMAP_NO_DATA;
+      if (age < data_in_ring)
+        value = min(interface_ring_buffer_get(&interface->saved_data_ring, slot, data_index, data_in_ring - age - 1),
+                    100);
+      *heatmap_cell(&heatmap->cells, row, age) = value;
+    }
+  }
+
+  WINDOW *win = heatmap->win;
+  for (unsigned row = 0; row < heatmap->num_devices_to_plot; ++row) {
+    unsigned dev_id = heatmap->devices_ids[row];
+    bool straggler = imbalance_device_is_straggler(&interface->imbalance, dev_id);
+    wcolor_set(win, straggler ? red_color : cyan_color, NULL);
+    mvwprintw(win, row + 1, 0, "%3u", dev_id);
+  }
+  wstandend(win);
+  static const char legend[] = " First chart percentage per GPU ";
+  if ((size_t)getmaxx(win) > 5 + strlen(legend) + sizeof(heatmap_levels) + 8) {
+    mvwprintw(win, 0, 5, "%s", legend);
+    for (unsigned level = 0; level < sizeof(heatmap_levels) - 1; ++level)
+      draw_heatmap_cell(win, level * 10);
+    wstandend(win);
+    wprintw(win, " 0-100%% ");
+  }
+  wnoutrefresh(win);
+
+  WINDOW *plot_win = heatmap->plot_window;
+  for (unsigned row = 0; row < heatmap->cells.rows; ++row) {
+    wmove(plot_win, row, 0);
+    for (unsigned col = 0; col < heatmap->cells.cols; ++col)
+      draw_heatmap_cell(plot_win, heatmap->cells.cells[row * heatmap->cells.cols + col]);
+  }
+  wstandend(plot_win);
+  wnoutrefresh(plot_win);
+}
+
+static const char *topology_link_names[topology_link_count] = {
+    [topology_link_self] = "X",           [topology_link_nvlink] = "NV",        [topology_link_xgmi] = "XGMI",
+    [topology_link_pcie_switch] = "PIX",  [topology_link_pcie_bridges] = "PXB", [topology_link_host_bridge] = "PHB",
+    [topology_link_numa_node] = "NODE",   [topology_link_system] = "SYS",       [topology_link_unknown] = "?",
+};
+
+#define TOPOLOGY_CELL_WIDTH 7
+
+static void draw_topology(struct list_head *devices, struct nvtop_interface *interface) {
+  struct topology_window *topology_win = &interface->topology;
+  if (!topology_win->computed) {
+    device_topology_compute(devices, &topology_win->topology);
+    topology_win->computed = true;
+  }
+  const struct device_topology *topology = &topology_win->topology;
+  WINDOW *win = topology_win->win;
+  werase(win);
+
+  mvwprintw(win, 0, 0, "Device topology");
+  mvwchgat(win, 0, 0, -1, A_STANDOUT, green_color, NULL);
+
+  // Distance matrix, along with the NUMA node and the PCIe bandwidth of each device
+  wmove(win, 1, 0);
+  wprintw(win, "%-*s", TOPOLOGY_CELL_WIDTH, "");
+  for (unsigned dev = 0; dev < topology->devices_count; ++dev)
+    wprintw(win, "%*s%-*u", TOPOLOGY_CELL_WIDTH - 4, "DEV", 4, dev);
+  wprintw(win, "%*s %*s", TOPOLOGY_CELL_WIDTH, "NUMA", 11, "PCIe GB/s");
+  mvwchgat(win, 1, 0, -1, A_STANDOUT, cyan_color, NULL);
+
+  unsigned row = 2;
+  struct gpu_info *device;
+  unsigned dev1 = 0;
+  list_for_each_entry(device, devices, list) {
+    if (dev1 >= topology->devices_count)
+      break;
+    wmove(win, row, 0);
+    wcolor_set(win, cyan_color, NULL);
+    wprintw(win, "DEV %-*u", TOPOLOGY_CELL_WIDTH - 4, dev1);
+    wstandend(win);
+    for (unsigned dev2 = 0; dev2 < topology->devices_count; ++dev2) {
+      const struct topology_pair *pair = device_topology_pair(topology, dev1, dev2);
+      char cell[TOPOLOGY_CELL_WIDTH + 1];
+      if (pair->link == topology_link_nvlink)
+        snprintf(cell, sizeof(cell), "NV%u", pair->links_count);
+      else
+        snprintf(cell, sizeof(cell), "%s", topology_link_names[pair->link]);
+      wprintw(win, "%*s", TOPOLOGY_CELL_WIDTH, cell);
+    }
+    if (GPUINFO_STATIC_FIELD_VALID(&device->static_info, numa_node))
+      wprintw(win, "%*d", TOPOLOGY_CELL_WIDTH, device->static_info.numa_node);
+    else
+      wprintw(win, "%*s", TOPOLOGY_CELL_WIDTH, "N/A");
+    if (topology->pcie_bandwidth[dev1] > 0.)
+      wprintw(win, " %*.1f", 11, topology->pcie_bandwidth[dev1]);
+    else
+      wprintw(win, " %*s", 11, "N/A");
+    row++;
+    dev1++;
+  }
+
+  // Bandwidth matrix
+  row++;
+  wmove(win, row++, 0);
+  wprintw(win, "%-*s", TOPOLOGY_CELL_WIDTH, "GB/s");
+  for (unsigned dev = 0; dev < topology->devices_count; ++dev)
+    wprintw(win, "%*s%-*u", TOPOLOGY_CELL_WIDTH - 4, "DEV", 4, dev);
+  mvwchgat(win, row - 1, 0, -1, A_STANDOUT, cyan_color, NULL);
+  for (dev1 = 0; dev1 < topology->devices_count; ++dev1) {
+    wmove(win, row++, 0);
+    wcolor_set(win, cyan_color, NULL);
+    wprintw(win, "DEV %-*u", TOPOLOGY_CELL_WIDTH - 4, dev1);
+    wstandend(win);
+    for (unsigned dev2 = 0; dev2 < topology->devices_count; ++dev2) {
+      const struct topology_pair *pair = device_topology_pair(topology, dev1, dev2);
+      if (pair->link == topology_link_self)
+        wprintw(win, "%*s", TOPOLOGY_CELL_WIDTH, "-");
+      else if (pair->bandwidth > 0.)
+        wprintw(win, "%*.1f", TOPOLOGY_CELL_WIDTH, pair->bandwidth);
+      else
+        wprintw(win, "%*s", TOPOLOGY_CELL_WIDTH, "N/A");
+    }
+  }
+
+  row++;
+  mvwprintw(win, row++, 0, "NV#  = NVLink with # links          XGMI = Same AMD xGMI hive");
+  mvwprintw(win, row++, 0, "PIX  = At most one PCIe bridge      PXB  = Multiple PCIe bridges");
+  mvwprintw(win, row++, 0, "PHB  = Through the PCIe host bridge NODE = Between host bridges of a NUMA node");
+  mvwprintw(win, row++, 0, "SYS  = Between NUMA nodes");
+  wnoutrefresh(win);
+}
+
 void draw_gpu_info_ncurses(unsigned devices_count, struct list_head *devices, struct nvtop_interface *interface) {
 
   draw_devices(devices, interface);
-  if (!interface->setup_win.visible) {
-    draw_plots(interface);
-    draw_processes(devices, interface);
-  } else {
+  if (interface->setup_win.visible) {
     draw_setup_window(devices_count, devices, interface);
+  } else if (interface->topology.visible) {
+    draw_topology(devices, interface);
+  } else {
+    if (interface->heatmap.win)
+      draw_heatmap(interface);
+    else
+      draw_plots(interface);
+    draw_processes(devices, interface);
   }
   draw_shortcuts(interface);
   doupdate();
@@ -1817,8 +3225,22 @@ void update_window_size_to_terminal_size(struct nvtop_interface *inter) {
   initialize_all_windows(inter);
 }
 
+void interface_resize_to_terminal_size(struct nvtop_interface *inter) {
+  struct winsize size;
+  if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) != 0 || !is_term_resized(size.ws_row, size.ws_col))
+    return;
+  resizeterm(size.ws_row, size.ws_col);
+  if (!resize_all_windows(inter)) {
+    erase();
+    refresh();
+    delete_all_windows(inter);
+    initialize_all_windows(inter);
+  }
+}
+
 bool is_escape_for_quit(struct nvtop_interface *interface) {
-  if (interface->process.option_window.state == nvtop_option_state_hidden && !interface->setup_win.visible)
+  if (interface->process.option_window.state == nvtop_option_state_hidden && !interface->setup_win.visible &&
+      !interface->topology.visible && !interface->navigation.active)
     return true;
   else
     return false;
@@ -1829,6 +3251,9 @@ static void option_do_kill(struct nvtop_interface *interface) {
     return;
   pid_t pid = interface->process.selected_pid;
   int sig = signalValues[interface->process.option_window.selected_row];
+  // The process runs on another host
+  if (interface->process.selected_host_id)
+    return;
   if (pid > 0) {
     kill(pid, sig);
   }
@@ -1849,14 +3274,171 @@ static void option_change_sort(struct nvtop_interface *interface) {
   }
 }
 
+static unsigned plot_lines_count(const struct nvtop_interface *interface, const struct plot_window *plot) {
+  unsigned lines = 0;
+  for (unsigned i = 0; i < plot->num_devices_to_plot; ++i)
+    lines += plot_count_draw_info(interface->options.gpu_specific_opts[plot->devices_ids[i]].to_draw);
+  return lines;
+}
+
+// Number of columns of the widest plot
+static unsigned navigation_columns(const struct nvtop_interface *interface) {
+  unsigned columns = 1;
+  for (unsigned plot_id = 0; plot_id < interface->num_plots; ++plot_id) {
+    unsigned lines = plot_lines_count(interface, &interface->plots[plot_id]);
+    columns = max(columns, (unsigned)interface->plots[plot_id].num_data / lines);
+  }
+  return columns;
+}
+
+static void start_history_navigation(struct nvtop_interface *interface) {
+  struct history_navigation *navigation = &interface->navigation;
+  const struct sample_clock *clock = &interface->saved_data_times;
+  if (navigation->active || !interface->num_plots || !clock->count)
+    return;
+  navigation->samples = clock->count;
+  navigation->times = malloc(clock->count * sizeof(*navigation->times));
+  if (!navigation->times) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  sample_clock_copy(clock, navigation->times);
+  nvtop_time now;
+  struct timespec wall_now;
+  nvtop_get_current_time(&now);
+  clock_gettime(CLOCK_REALTIME, &wall_now);
+  navigation->wall_clock_offset = wall_now.tv_sec + wall_now.tv_nsec / 1e9 - (now.tv_sec + now.tv_nsec / 1e9);
+  navigation->column_seconds = interface->options.update_interval / 1000.;
+  navigation->newest_edge = navigation->times[navigation->samples - 1] + navigation->column_seconds / 2.;
+  navigation->cursor = 0;
+
+  // The newest samples of a line are the ones of the newest times
+  for (unsigned plot_id = 0; plot_id < interface->num_plots; ++plot_id) {
+    struct plot_window *plot = &interface->plots[plot_id];
+    unsigned line = 0;
+    for (unsigned i = 0; i < plot->num_devices_to_plot; ++i) {
+      unsigned dev_id = plot->devices_ids[i];
+      plot_info_to_draw to_draw = interface->options.gpu_specific_opts[dev_id].to_draw;
+      unsigned slot = interface->options.gpu_specific_opts[dev_id].history_slot;
+      unsigned lines = plot_count_draw_info(to_draw);
+      for (unsigned data_index = 0; data_index < lines; ++data_index) {
+        unsigned stored = interface_ring_buffer_data_stored(&interface->saved_data_ring, slot, data_index);
+        unsigned used = min(stored, navigation->samples);
+        history_series_alloc(used, &plot->history[line]);
+        unsigned *samples = history_series_samples(&plot->history[line]);
+        for (unsigned j = 0; j < used; ++j)
+          samples[j] = interface_ring_buffer_get(&interface->saved_data_ring, slot, data_index, stored - used + j);
+        history_series_build(&plot->history[line]);
+        line++;
+      }
+    }
+  }
+  navigation->active = true;
+}
+
+static void stop_history_navigation(struct nvtop_interface *interface) {
+  free_history_navigation(interface);
+  for (unsigned plot_id = 0; plot_id < interface->num_plots; ++plot_id) {
+    struct plot_window *plot = &interface->plots[plot_id];
+    struct window_position position;
+    getbegyx(plot->win, position.posY, position.posX);
+    getmaxyx(plot->win, position.sizeY, position.sizeX);
+    draw_plot_frame(plot, &position, &interface->options);
+  }
+}
+
+// Keep the first sample in the plots and the newest edge no further than the newest sample
+static void clamp_history_navigation(struct history_navigation *navigation) {
+  double half_column = navigation->column_seconds / 2.;
+  navigation->newest_edge = min(navigation->newest_edge, navigation->times[navigation->samples - 1] + half_column);
+  navigation->newest_edge = max(navigation->newest_edge, navigation->times[0] + half_column);
+}
+
+// Positive towards the older samples
+static void move_history_cursor(struct nvtop_interface *interface, int columns) {
+  struct history_navigation *navigation = &interface->navigation;
+  int cursor = (int)navigation->cursor + columns;
+  int last_column = navigation_columns(interface) - 1;
+  if (cursor < 0 || cursor > last_column) {
+    int overflow = cursor < 0 ? cursor : cursor - last_column;
+    navigation->newest_edge -= overflow * navigation->column_seconds;
+    clamp_history_navigation(navigation);
+    cursor = cursor < 0 ? 0 : last_column;
+  }
+  navigation->cursor = cursor;
+}
+
+static void pan_history(struct nvtop_interface *interface, int columns) {
+  interface->navigation.newest_edge -= columns * interface->navigation.column_seconds;
+  clamp_history_navigation(&interface->navigation);
+}
+
+// The time under the cursor stays in place
+static void zoom_history(struct nvtop_interface *interface, double factor) {
+  struct history_navigation *navigation = &interface->navigation;
+  double min_column_seconds = interface->options.update_interval / 1000.;
+  double span = navigation->times[navigation->samples - 1] - navigation->times[0];
+  if (factor < 1. && navigation->column_seconds <= min_column_seconds)
+    return;
+  if (factor > 1. && navigation->column_seconds * navigation_columns(interface) > span)
+    return;
+  double cursor_offset = navigation->cursor + .5;
+  double cursor_time = navigation->newest_edge - cursor_offset * navigation->column_seconds;
+  navigation->column_seconds *= factor;
+  navigation->newest_edge = cursor_time + cursor_offset * navigation->column_seconds;
+  clamp_history_navigation(navigation);
+}
+
+// Return false when the key is not one of the navigation ones
+static bool handle_history_navigation_key(int keyId, struct nvtop_interface *interface) {
+  // The plots are drawn with the newest samples on the left or on the right
+  int left = interface->options.plot_left_to_right ? -1 : 1;
+  switch (keyId) {
+  case 'h':
+  case KEY_LEFT:
+    move_history_cursor(interface, left);
+    return true;
+  case 'l':
+  case KEY_RIGHT:
+    move_history_cursor(interface, -left);
+    return true;
+  case '[':
+    pan_history(interface, left * (int)navigation_columns(interface) / 2);
+    return true;
+  case ']':
+    pan_history(interface, -left * (int)navigation_columns(interface) / 2);
+    return true;
+  case '+':
+    zoom_history(interface, .5);
+    return true;
+  case '-':
+    zoom_history(interface, 2.);
+    return true;
+  case 'z':
+  case 27:
+    stop_history_navigation(interface);
+    return true;
+  default:
+    return false;
+  }
+}
+
 void interface_key(int keyId, struct nvtop_interface *interface) {
   if (interface->setup_win.visible) {
     handle_setup_win_keypress(keyId, interface);
     return;
   }
+  if (interface->navigation.active && handle_history_navigation_key(keyId, interface))
+    return;
   switch (keyId) {
+  case 'z':
+    if (interface->process.option_window.state == nvtop_option_state_hidden && !interface->topology.visible)
+      start_history_navigation(interface);
+    break;
   case KEY_F(2):
     if (interface->process.option_window.state == nvtop_option_state_hidden && !interface->setup_win.visible) {
+      if (interface->navigation.active)
+        stop_history_navigation(interface);
       show_setup_window(interface);
     }
     break;
@@ -1935,11 +3517,44 @@ void interface_key(int keyId, struct nvtop_interface *interface) {
       interface->process.option_window.state = nvtop_option_state_hidden;
       break;
     case nvtop_option_state_hidden:
+      if (interface->process.selected_is_group)
+        process_group_toggle_expanded(&interface->process, interface->process.selected_group_key);
+      break;
     default:
       break;
     }
     break;
+  case 'g':
+    if (interface->process.option_window.state == nvtop_option_state_hidden)
+      interface->options.group_multi_device_processes = !interface->options.group_multi_device_processes;
+    break;
+  case 'u':
+    if (interface->process.option_window.state == nvtop_option_state_hidden)
+      interface->options.process_rollup =
+          interface->options.process_rollup == process_rollup_user ? process_rollup_none : process_rollup_user;
+    break;
+  case 'c':
+    if (interface->process.option_window.state == nvtop_option_state_hidden)
+      interface->options.process_rollup =
+          interface->options.process_rollup == process_rollup_cgroup ? process_rollup_none : process_rollup_cgroup;
+    break;
+  case 'J':
+    if (interface->process.option_window.state == nvtop_option_state_hidden)
+      interface->options.process_rollup =
+          interface->options.process_rollup == process_rollup_job ? process_rollup_none : process_rollup_job;
+    break;
+  case 't':
+    if (interface->process.option_window.state == nvtop_option_state_hidden) {
+      interface->topology.visible = !interface->topology.visible;
+      if (!interface->topology.visible)
+        update_window_size_to_terminal_size(interface);
+    }
+    break;
   case 27:
+    if (interface->topology.visible) {
+      interface->topology.visible = false;
+      update_window_size_to_terminal_size(interface);
+    }
     interface->process.option_window.state = nvtop_option_state_hidden;
     break;
   default:
@@ -1974,15 +3589,63 @@ void interface_check_monitored_gpu_change(struct nvtop_interface **interface, un
     nvtop_interface_option options_copy = (*interface)->options;
     options_copy.has_monitored_set_changed = false;
     memset(&(*interface)->options, 0, sizeof(options_copy));
+    // The history of a device was not recorded while it was not monitored: the newest samples of its slot are not the
+    // ones of the newest times anymore, start over
+    for (unsigned i = (*interface)->monitored_dev_count; i < allDevCount; ++i) {
+      if (!options_copy.gpu_specific_opts[i].doNotMonitor)
+        interface_ring_buffer_empty(&(*interface)->saved_data_ring, options_copy.gpu_specific_opts[i].history_slot);
+    }
     *num_monitored_gpus =
         interface_check_and_fix_monitored_gpus(allDevCount, monitoredGpus, nonMonitoredGpus, &options_copy);
+    // The history slots moved along with the devices
+    interface_ring_buffer history = (*interface)->saved_data_ring;
+    struct sample_clock history_times = (*interface)->saved_data_times;
+    memset(&(*interface)->saved_data_ring, 0, sizeof(history));
+    memset(&(*interface)->saved_data_times, 0, sizeof(history_times));
     clean_ncurses(*interface);
-    *interface =
-        initialize_curses(allDevCount, *num_monitored_gpus, interface_largest_gpu_name(monitoredGpus), options_copy);
+    *interface = initialize_interface(allDevCount, *num_monitored_gpus, interface_largest_gpu_name(monitoredGpus),
+                                      options_copy, &history, &history_times);
     timeout(interface_update_interval(*interface));
   }
 }
 
+void interface_add_devices(struct nvtop_interface **interface, unsigned *allDevCount, struct list_head *newGpus,
+                           unsigned *num_monitored_gpus, struct list_head *monitoredGpus,
+                           struct list_head *nonMonitoredGpus) {
+  nvtop_interface_option options = (*interface)->options;
+  unsigned total_devices = *allDevCount;
+  struct gpu_info *device, *list_tmp;
+  list_for_each_entry(device, newGpus, list) { total_devices++; }
+  options.gpu_specific_opts = reallocarray(options.gpu_specific_opts, total_devices, sizeof(*options.gpu_specific_opts));
+  if (!options.gpu_specific_opts) {
+    perror("Could not re-allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  // The options of the non monitored devices come last, the new devices join them before getting monitored
+  unsigned idx = *allDevCount;
+  list_for_each_entry_safe(device, list_tmp, newGpus, list) {
+    memset(&options.gpu_specific_opts[idx], 0, sizeof(*options.gpu_specific_opts));
+    options.gpu_specific_opts[idx].linkedGpu = device;
+    options.gpu_specific_opts[idx].history_slot = idx;
+    options.gpu_specific_opts[idx].to_draw = plot_default_draw_info();
+    list_move_tail(&device->list, nonMonitoredGpus);
+    idx++;
+  }
+  *allDevCount = total_devices;
+  *num_monitored_gpus = interface_check_and_fix_monitored_gpus(total_devices, monitoredGpus, nonMonitoredGpus, &options);
+
+  interface_ring_buffer history = (*interface)->saved_data_ring;
+  struct sample_clock history_times = (*interface)->saved_data_times;
+  interface_ring_buffer_add_devices(&history, total_devices);
+  memset(&(*interface)->saved_data_ring, 0, sizeof(history));
+  memset(&(*interface)->saved_data_times, 0, sizeof(history_times));
+  memset(&(*interface)->options, 0, sizeof(options));
+  clean_ncurses(*interface);
+  *interface = initialize_interface(total_devices, *num_monitored_gpus, interface_largest_gpu_name(monitoredGpus),
+                                    options, &history, &history_times);
+  timeout(interface_update_interval(*interface));
+}
+
 static char dontShowAgain[] = "<Don't Show Again>";
 static char okay[] = "<Ok>";
 static char interactKeys[] = "Press Enter to select, arrows \">\" and \"<\" to switch options";
@@ -0,0 +1,72 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "nvtop/interface_heatmap.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void heatmap_alloc(unsigned rows, unsigned cols, bool newest_first, struct heatmap *heatmap) {
+  heatmap->rows = rows;
+  heatmap->cols = cols;
+  heatmap->newest_first = newest_first;
+  heatmap->filled = false;
+  heatmap->samples_drawn = 0;
+  heatmap->cells = NULL;
+  if (rows && cols) {
+    heatmap->cells = malloc((size_t)rows * cols);
+    if (!heatmap->cells) {
+      perror("Cannot allocate memory: ");
+      exit(EXIT_FAILURE);
+    }
+    memset(heatmap->cells, HEATMAP_NO_DATA, (size_t)rows * cols);
+  }
+}
+
+void heatmap_free(struct heatmap *heatmap) {
+  free(heatmap->cells);
+  heatmap->cells = NULL;
+  heatmap->rows = 0;
+  heatmap->cols = 0;
+}
+
+unsigned heatmap_advance(struct heatmap *heatmap, unsigned long samples_recorded) {
+  unsigned long shift = samples_recorded - heatmap->samples_drawn;
+  heatmap->samples_drawn = samples_recorded;
+  if (!heatmap->filled || shift >= heatmap->cols) {
+    heatmap->filled = true;
+    return heatmap->cols;
+  }
+  if (!shift)
+    return 0;
+  unsigned kept = heatmap->cols - shift;
+  for (unsigned row = 0; row < heatmap->rows; ++row) {
+    unsigned char *cells = &heatmap->cells[row * heatmap->cols];
+    if (heatmap->newest_first)
+      memmove(cells + shift, cells, kept);
+    else
+      memmove(cells, cells + shift, kept);
+  }
+  return shift;
+}
+
+extern inline unsigned char *heatmap_cell(const struct heatmap *heatmap, unsigned row, unsigned age);
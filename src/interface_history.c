@@ -0,0 +1,119 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "nvtop/interface_history.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void sample_clock_alloc(unsigned capacity, struct sample_clock *clock) {
+  clock->capacity = capacity;
+  clock->start = 0;
+  clock->count = 0;
+  clock->times = malloc(capacity * sizeof(*clock->times));
+  if (!clock->times) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+}
+
+void sample_clock_free(struct sample_clock *clock) {
+  free(clock->times);
+  clock->times = NULL;
+  clock->capacity = 0;
+  clock->count = 0;
+}
+
+void sample_clock_push(struct sample_clock *clock, double time) {
+  unsigned end = clock->start + clock->count;
+  if (end >= clock->capacity)
+    end -= clock->capacity;
+  clock->times[end] = time;
+  if (clock->count < clock->capacity) {
+    clock->count++;
+  } else {
+    clock->start++;
+    if (clock->start == clock->capacity)
+      clock->start = 0;
+  }
+}
+
+void sample_clock_copy(const struct sample_clock *clock, double *times) {
+  unsigned before_wrap = clock->capacity - clock->start;
+  if (before_wrap > clock->count)
+    before_wrap = clock->count;
+  memcpy(times, &clock->times[clock->start], before_wrap * sizeof(*times));
+  memcpy(times + before_wrap, clock->times, (clock->count - before_wrap) * sizeof(*times));
+}
+
+unsigned history_lower_bound(unsigned count, const double times[], double time) {
+  unsigned low = 0, high = count;
+  while (low < high) {
+    unsigned middle = low + (high - low) / 2;
+    if (times[middle] < time)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+  return low;
+}
+
+void history_series_alloc(unsigned size, struct history_series *series) {
+  series->size = size;
+  series->tree = calloc(2 * (size_t)size, sizeof(*series->tree));
+  if (size && !series->tree) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+}
+
+void history_series_free(struct history_series *series) {
+  free(series->tree);
+  series->tree = NULL;
+  series->size = 0;
+}
+
+void history_series_build(struct history_series *series) {
+  for (unsigned node = series->size; node-- > 1;) {
+    unsigned left = series->tree[2 * node], right = series->tree[2 * node + 1];
+    series->tree[node] = left > right ? left : right;
+  }
+}
+
+unsigned history_series_max(const struct history_series *series, unsigned begin, unsigned end) {
+  assert(begin < end && end <= series->size);
+  unsigned max = 0;
+  for (begin += series->size, end += series->size; begin < end; begin /= 2, end /= 2) {
+    if (begin & 1) {
+      unsigned value = series->tree[begin++];
+      max = value > max ? value : max;
+    }
+    if (end & 1) {
+      unsigned value = series->tree[--end];
+      max = value > max ? value : max;
+    }
+  }
+  return max;
+}
+
+extern inline unsigned *history_series_samples(struct history_series *series);
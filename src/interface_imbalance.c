@@ -0,0 +1,203 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "nvtop/interface_imbalance.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <uthash.h>
+
+#define IMBALANCE_WINDOW_MASK ((UINT32_C(1) << IMBALANCE_WINDOW_SIZE) - 1)
+
+void imbalance_tracker_alloc(unsigned devices_count, struct imbalance_tracker *tracker) {
+  tracker->devices_count = devices_count;
+  tracker->next_slot = 0;
+  tracker->devices = NULL;
+  if (devices_count) {
+    tracker->devices = calloc(devices_count, sizeof(*tracker->devices));
+    if (!tracker->devices) {
+      perror("Cannot allocate memory: ");
+      exit(EXIT_FAILURE);
+    }
+  }
+}
+
+void imbalance_tracker_free(struct imbalance_tracker *tracker) {
+  free(tracker->devices);
+  tracker->devices = NULL;
+  tracker->devices_count = 0;
+}
+
+struct job_device_key {
+  int64_t job_id;
+  int64_t device;
+};
+
+// Processes of the same job on the same device are accumulated
+struct job_on_device {
+  struct job_device_key key;
+  bool gpu_usage_valid;
+  unsigned gpu_usage;
+  unsigned long long gpu_memory;
+  UT_hash_handle hh;
+};
+
+struct job_summary {
+  int64_t job_id;
+  unsigned devices_count;
+  unsigned usage_devices_count;
+  unsigned usage_sum;
+  unsigned long long memory_min, memory_max;
+  UT_hash_handle hh;
+};
+
+static unsigned bits_set(uint32_t value) {
+  unsigned count = 0;
+  for (; value; value &= value - 1)
+    count++;
+  return count;
+}
+
+void imbalance_tracker_push(struct imbalance_tracker *tracker, unsigned samples_count,
+                            const struct imbalance_sample *samples) {
+  unsigned slot = tracker->next_slot;
+  for (unsigned dev = 0; dev < tracker->devices_count; ++dev) {
+    struct device_imbalance_window *window = &tracker->devices[dev];
+    window->sampled = (window->sampled << 1) & IMBALANCE_WINDOW_MASK;
+    window->lagging = (window->lagging << 1) & IMBALANCE_WINDOW_MASK;
+    window->usage_gap[slot] = 0;
+    window->memory_imbalance[slot] = 0;
+  }
+  tracker->next_slot = (slot + 1) % IMBALANCE_WINDOW_SIZE;
+  if (!samples_count)
+    return;
+
+  struct job_on_device *per_device = calloc(samples_count, sizeof(*per_device));
+  struct job_summary *jobs = calloc(samples_count, sizeof(*jobs));
+  if (!per_device || !jobs) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+
+  unsigned per_device_count = 0;
+  struct job_on_device *per_device_hash = NULL;
+  for (unsigned i = 0; i < samples_count; ++i) {
+    if (samples[i].device >= tracker->devices_count)
+      continue;
+    struct job_device_key key = {.job_id = samples[i].job_id, .device = samples[i].device};
+    struct job_on_device *entry;
+    HASH_FIND(hh, per_device_hash, &key, sizeof(key), entry);
+    if (!entry) {
+      entry = &per_device[per_device_count++];
+      entry->key = key;
+      HASH_ADD(hh, per_device_hash, key, sizeof(entry->key), entry);
+    }
+    if (samples[i].gpu_usage_valid) {
+      entry->gpu_usage_valid = true;
+      entry->gpu_usage += samples[i].gpu_usage;
+    }
+    entry->gpu_memory += samples[i].gpu_memory;
+  }
+
+  unsigned jobs_count = 0;
+  struct job_summary *jobs_hash = NULL;
+  for (unsigned i = 0; i < per_device_count; ++i) {
+    struct job_summary *job;
+    HASH_FIND(hh, jobs_hash, &per_device[i].key.job_id, sizeof(per_device[i].key.job_id), job);
+    if (!job) {
+      job = &jobs[jobs_count++];
+      job->job_id = per_device[i].key.job_id;
+      job->memory_min = job->memory_max = per_device[i].gpu_memory;
+      HASH_ADD(hh, jobs_hash, job_id, sizeof(job->job_id), job);
+    }
+    job->devices_count++;
+    if (per_device[i].gpu_usage_valid) {
+      job->usage_devices_count++;
+      job->usage_sum += per_device[i].gpu_usage;
+    }
+    if (per_device[i].gpu_memory < job->memory_min)
+      job->memory_min = per_device[i].gpu_memory;
+    if (per_device[i].gpu_memory > job->memory_max)
+      job->memory_max = per_device[i].gpu_memory;
+  }
+
+  for (unsigned i = 0; i < per_device_count; ++i) {
+    struct job_summary *job;
+    HASH_FIND(hh, jobs_hash, &per_device[i].key.job_id, sizeof(per_device[i].key.job_id), job);
+    if (job->devices_count < 2)
+      continue;
+    struct device_imbalance_window *window = &tracker->devices[per_device[i].key.device];
+    window->sampled |= 1;
+    if (job->memory_max) {
+      unsigned memory_imbalance = (unsigned)((job->memory_max - job->memory_min) * 100 / job->memory_max);
+      if (memory_imbalance > window->memory_imbalance[slot])
+        window->memory_imbalance[slot] = memory_imbalance;
+    }
+    if (per_device[i].gpu_usage_valid && job->usage_devices_count > 1) {
+      unsigned mean_usage = (job->usage_sum + job->usage_devices_count / 2) / job->usage_devices_count;
+      if (per_device[i].gpu_usage < mean_usage) {
+        unsigned gap = mean_usage - per_device[i].gpu_usage;
+        if (gap > 100)
+          gap = 100;
+        if (gap > window->usage_gap[slot])
+          window->usage_gap[slot] = gap;
+        if (gap >= IMBALANCE_LAG_THRESHOLD)
+          window->lagging |= 1;
+      }
+    }
+  }
+
+  HASH_CLEAR(hh, per_device_hash);
+  HASH_CLEAR(hh, jobs_hash);
+  free(per_device);
+  free(jobs);
+}
+
+bool imbalance_device_is_straggler(const struct imbalance_tracker *tracker, unsigned device) {
+  if (device >= tracker->devices_count)
+    return false;
+  unsigned sampled = bits_set(tracker->devices[device].sampled);
+  unsigned lagging = bits_set(tracker->devices[device].lagging);
+  return sampled >= IMBALANCE_WINDOW_SIZE / 2 && 4 * lagging >= 3 * sampled;
+}
+
+static unsigned mean_over_sampled(const struct device_imbalance_window *window,
+                                  const unsigned char values[IMBALANCE_WINDOW_SIZE]) {
+  unsigned sampled = bits_set(window->sampled);
+  if (!sampled)
+    return 0;
+  unsigned sum = 0;
+  for (unsigned i = 0; i < IMBALANCE_WINDOW_SIZE; ++i)
+    sum += values[i];
+  return (sum + sampled / 2) / sampled;
+}
+
+unsigned imbalance_device_usage_gap(const struct imbalance_tracker *tracker, unsigned device) {
+  if (device >= tracker->devices_count)
+    return 0;
+  return mean_over_sampled(&tracker->devices[device], tracker->devices[device].usage_gap);
+}
+
+unsigned imbalance_device_memory_imbalance(const struct imbalance_tracker *tracker, unsigned device) {
+  if (device >= tracker->devices_count)
+    return 0;
+  return mean_over_sampled(&tracker->devices[device], tracker->devices[device].memory_imbalance);
+}
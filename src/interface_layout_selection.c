@@ -3,11 +3,13 @@
 #include "nvtop/interface_options.h"
 
 #include <assert.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <uthash.h>
 
 #define max(a, b) ((a) > (b) ? (a) : (b))
 #define min(a, b) ((a) < (b) ? (a) : (b))
@@ -202,6 +204,88 @@ static void preliminary_plot_positioning(unsigned rows_for_plots, unsigned plot_
   }
 }
 
+static unsigned decimal_digits(unsigned value) {
+  unsigned digits = 1;
+  for (; value >= 10; value /= 10)
+    digits++;
+  return digits;
+}
+
+// A wide cell is "<index> GPU MEM TEMP" with three columns per value, a narrow one uses a single digit per value
+unsigned device_grid_cell_cols(unsigned devices_count, enum device_header_layout layout) {
+  unsigned index_cols = decimal_digits(devices_count ? devices_count - 1 : 0);
+  switch (layout) {
+  case device_header_grid_wide:
+    return index_cols + 3 * 4;
+  case device_header_grid_narrow:
+    return index_cols + 1 + 3;
+  default:
+    return 0;
+  }
+}
+
+static unsigned device_grid_cells_per_row(unsigned devices_count, enum device_header_layout layout, unsigned cols) {
+  return max(1, (cols + 1) / (device_grid_cell_cols(devices_count, layout) + 1));
+}
+
+// The grid cells are wide unless the grid would take more than a quarter of the screen
+static enum device_header_layout select_device_header_layout(unsigned devices_count, unsigned rows, unsigned cols) {
+  if (devices_count < DEVICE_GRID_MIN_DEVICES)
+    return device_header_full;
+  unsigned wide_per_row = device_grid_cells_per_row(devices_count, device_header_grid_wide, cols);
+  if ((devices_count + wide_per_row - 1) / wide_per_row + 1 <= rows / 4)
+    return device_header_grid_wide;
+  return device_header_grid_narrow;
+}
+
+// Packs the devices in order into plots of at most lines_per_plot lines. Returns the number of plots, or UINT_MAX if a
+// device has more lines than that.
+static unsigned pack_devices_in_plots(unsigned lines_per_plot, unsigned devices_count,
+                                      const nvtop_interface_gpu_opts gpuOpts[devices_count],
+                                      unsigned map_device_to_plot[devices_count]) {
+  unsigned plots = 0, lines_in_plot = 0;
+  for (unsigned dev_id = 0; dev_id < devices_count; ++dev_id) {
+    unsigned lines = plot_count_draw_info(gpuOpts[dev_id].to_draw);
+    if (lines > lines_per_plot)
+      return UINT_MAX;
+    if (!lines) {
+      map_device_to_plot[dev_id] = UINT_MAX;
+      continue;
+    }
+    if (!plots || lines_in_plot + lines > lines_per_plot) {
+      plots++;
+      lines_in_plot = 0;
+    }
+    lines_in_plot += lines;
+    map_device_to_plot[dev_id] = plots - 1;
+  }
+  return plots;
+}
+
+// Plots for a grid of devices: the devices are packed in as few plots as possible, in a single linear pass, where the
+// merging search of preliminary_plot_positioning grows quadratically with the number of devices.
+static void grid_plot_positioning(unsigned rows_for_plots, unsigned plot_total_cols, unsigned devices_count,
+                                  const nvtop_interface_gpu_opts gpuOpts[devices_count],
+                                  unsigned map_device_to_plot[devices_count], unsigned plot_in_stack[MAX_CHARTS],
+                                  unsigned *num_plots, unsigned *plot_stack_count) {
+  *num_plots = 0;
+  *plot_stack_count = 0;
+  unsigned stacks_available = rows_for_plots / min_plot_rows;
+  unsigned plots_per_stack = plot_total_cols / min_plot_cols(MAX_LINES_PER_PLOT);
+  if (!stacks_available || !plots_per_stack)
+    return;
+  unsigned plots = pack_devices_in_plots(MAX_LINES_PER_PLOT, devices_count, gpuOpts, map_device_to_plot);
+  if (plots == UINT_MAX || plots > MAX_CHARTS)
+    return;
+  unsigned stacks = (plots + plots_per_stack - 1) / plots_per_stack;
+  if (stacks > stacks_available)
+    return;
+  for (unsigned plot_id = 0; plot_id < plots; ++plot_id)
+    plot_in_stack[plot_id] = plot_id / plots_per_stack;
+  *num_plots = plots;
+  *plot_stack_count = stacks;
+}
+
 static void balance_info_on_stacks_preserving_plot_order(unsigned stack_max_cols, unsigned stack_count,
                                                          unsigned plot_count, unsigned num_info_per_plot[plot_count],
                                                          unsigned cols_allocated_in_stacks[stack_count],
@@ -230,19 +314,31 @@ static void balance_info_on_stacks_preserving_plot_order(unsigned stack_max_cols
     moving_plot_id--;
   }
 }
-void compute_sizes_from_layout(unsigned devices_count, unsigned device_header_rows, unsigned device_header_cols,
-                               unsigned rows, unsigned cols, const nvtop_interface_gpu_opts *gpuOpts,
-                               process_field_displayed process_displayed, struct window_position *device_positions,
-                               unsigned *num_plots, struct window_position plot_positions[MAX_CHARTS],
-                               unsigned *map_device_to_plot, struct window_position *process_position,
-                               struct window_position *setup_position, bool process_win_hide) {
+static void compute_layout(unsigned devices_count, unsigned device_header_rows, unsigned device_header_cols,
+                           unsigned rows, unsigned cols, const nvtop_interface_gpu_opts *gpuOpts,
+                           process_field_displayed process_displayed, enum device_header_layout *header_layout,
+                           struct window_position *device_positions, struct window_position *grid_legend_position,
+                           unsigned *num_plots, struct window_position plot_positions[MAX_CHARTS],
+                           unsigned *map_device_to_plot, struct window_position *process_position,
+                           struct window_position *setup_position, bool process_win_hide) {
+
+  *header_layout = select_device_header_layout(devices_count, rows, cols);
+  bool grid = *header_layout != device_header_full;
+  // A grid cell is a single line, followed by one space
+  if (grid) {
+    device_header_rows = 1;
+    device_header_cols = device_grid_cell_cols(devices_count, *header_layout);
+  }
 
   unsigned min_rows_for_header = 0, header_stacks = 0, num_device_per_row = 0;
-  num_device_per_row = max(1, cols / device_header_cols);
+  if (grid)
+    num_device_per_row = device_grid_cells_per_row(devices_count, *header_layout, cols);
+  else
+    num_device_per_row = max(1, cols / device_header_cols);
   header_stacks = max(1, devices_count / num_device_per_row + ((devices_count % num_device_per_row) > 0));
-  if (devices_count % header_stacks == 0)
+  if (!grid && devices_count % header_stacks == 0)
     num_device_per_row = devices_count / header_stacks;
-  min_rows_for_header = header_stacks * device_header_rows;
+  min_rows_for_header = header_stacks * device_header_rows + grid;
 
   unsigned min_rows_for_process =
       process_field_displayed_count(process_displayed) ? min_rows_taken_by_process(rows, devices_count) : 0;
@@ -266,14 +362,18 @@ void compute_sizes_from_layout(unsigned devices_count, unsigned device_header_ro
 
   unsigned num_plot_stacks = 0;
   unsigned plot_in_stack[MAX_CHARTS];
-  preliminary_plot_positioning(rows_for_plots, cols, devices_count, gpuOpts, map_device_to_plot, plot_in_stack,
-                               num_plots, &num_plot_stacks);
+  if (grid)
+    grid_plot_positioning(rows_for_plots, cols, devices_count, gpuOpts, map_device_to_plot, plot_in_stack, num_plots,
+                          &num_plot_stacks);
+  else
+    preliminary_plot_positioning(rows_for_plots, cols, devices_count, gpuOpts, map_device_to_plot, plot_in_stack,
+                                 num_plots, &num_plot_stacks);
 
   // Transfer some lines to the header to separate the devices
   unsigned transferable_lines = rows_for_plots - num_plot_stacks * min_plot_rows;
   unsigned space_for_header = header_stacks == 0 ? 0 : header_stacks - 1;
   bool space_between_header_stack = false;
-  if (transferable_lines >= space_for_header) {
+  if (!grid && transferable_lines >= space_for_header) {
     rows_for_header += space_for_header;
     rows_for_plots -= space_for_header;
     space_between_header_stack = true;
@@ -304,12 +404,16 @@ void compute_sizes_from_layout(unsigned devices_count, unsigned device_header_ro
   unsigned cols_header_left = cols - num_device_per_row * device_header_cols;
   bool space_between_header_col = false;
   bool space_before_header = false;
-  if (cols_header_left > num_device_per_row) {
+  if (grid) {
     space_between_header_col = true;
-    cols_header_left -= num_device_per_row - 1;
+  } else {
+    if (cols_header_left > num_device_per_row) {
+      space_between_header_col = true;
+      cols_header_left -= num_device_per_row - 1;
+    }
+    if (cols_header_left > 0)
+      space_before_header = true;
   }
-  if (cols_header_left > 0)
-    space_before_header = true;
 
   unsigned num_this_row = 0;
   unsigned headerPosX = space_before_header;
@@ -328,6 +432,10 @@ void compute_sizes_from_layout(unsigned devices_count, unsigned device_header_ro
       headerPosX += device_header_cols + space_between_header_col;
     }
   }
+  grid_legend_position->posX = 0;
+  grid_legend_position->posY = header_stacks * device_header_rows;
+  grid_legend_position->sizeX = grid ? cols : 0;
+  grid_legend_position->sizeY = grid;
 
   unsigned rows_left_for_process = 0;
   if (*num_plots > 0) {
@@ -380,3 +488,108 @@ void compute_sizes_from_layout(unsigned devices_count, unsigned device_header_ro
   setup_position->sizeY = rows - rows_for_header;
   setup_position->sizeX = cols;
 }
+
+// The layout only depends on the number of metrics charted for each device, not on which ones
+struct layout_key {
+  unsigned devices_count;
+  unsigned device_header_rows;
+  unsigned device_header_cols;
+  unsigned rows;
+  unsigned cols;
+  process_field_displayed process_displayed;
+  bool process_win_hide;
+};
+
+struct layout_cache_entry {
+  unsigned char *key; // A struct layout_key followed by the number of metrics charted for each device
+  size_t key_size;
+  enum device_header_layout header_layout;
+  struct window_position *device_positions;
+  unsigned *map_device_to_plot;
+  struct window_position grid_legend_position;
+  unsigned num_plots;
+  struct window_position plot_positions[MAX_CHARTS];
+  struct window_position process_position;
+  struct window_position setup_position;
+  UT_hash_handle hh;
+};
+
+// Ordered from the least to the most recently used
+static struct layout_cache_entry *layout_cache = NULL;
+
+static void free_layout_cache_entry(struct layout_cache_entry *entry) {
+  HASH_DEL(layout_cache, entry);
+  free(entry->key);
+  free(entry->device_positions);
+  free(entry->map_device_to_plot);
+  free(entry);
+}
+
+void layout_cache_clear(void) {
+  struct layout_cache_entry *entry, *tmp;
+  HASH_ITER(hh, layout_cache, entry, tmp) { free_layout_cache_entry(entry); }
+}
+
+static void *layout_cache_alloc(size_t size) {
+  void *ptr = malloc(size ? size : 1);
+  if (!ptr) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  return ptr;
+}
+
+void compute_sizes_from_layout(unsigned devices_count, unsigned device_header_rows, unsigned device_header_cols,
+                               unsigned rows, unsigned cols, const nvtop_interface_gpu_opts *gpuOpts,
+                               process_field_displayed process_displayed, enum device_header_layout *header_layout,
+                               struct window_position *device_positions, struct window_position *grid_legend_position,
+                               unsigned *num_plots, struct window_position plot_positions[MAX_CHARTS],
+                               unsigned *map_device_to_plot, struct window_position *process_position,
+                               struct window_position *setup_position, bool process_win_hide) {
+  // Zeroed so that the padding bytes compare equal
+  struct layout_key key_header;
+  memset(&key_header, 0, sizeof(key_header));
+  key_header.devices_count = devices_count;
+  key_header.device_header_rows = device_header_rows;
+  key_header.device_header_cols = device_header_cols;
+  key_header.rows = rows;
+  key_header.cols = cols;
+  key_header.process_displayed = process_displayed;
+  key_header.process_win_hide = process_win_hide;
+  size_t key_size = sizeof(struct layout_key) + devices_count;
+  unsigned char key[key_size];
+  memcpy(key, &key_header, sizeof(key_header));
+  for (unsigned dev_id = 0; dev_id < devices_count; ++dev_id)
+    key[sizeof(struct layout_key) + dev_id] = plot_count_draw_info(gpuOpts[dev_id].to_draw);
+
+  struct layout_cache_entry *entry;
+  HASH_FIND(hh, layout_cache, key, key_size, entry);
+  if (entry) {
+    // Move to the most recently used end
+    HASH_DEL(layout_cache, entry);
+    HASH_ADD_KEYPTR(hh, layout_cache, entry->key, entry->key_size, entry);
+  } else {
+    if (HASH_COUNT(layout_cache) >= LAYOUT_CACHE_SIZE)
+      free_layout_cache_entry(layout_cache);
+    entry = layout_cache_alloc(sizeof(*entry));
+    entry->key = layout_cache_alloc(key_size);
+    memcpy(entry->key, key, key_size);
+    entry->key_size = key_size;
+    entry->device_positions = layout_cache_alloc(devices_count * sizeof(*entry->device_positions));
+    entry->map_device_to_plot = layout_cache_alloc(devices_count * sizeof(*entry->map_device_to_plot));
+    compute_layout(devices_count, device_header_rows, device_header_cols, rows, cols, gpuOpts, process_displayed,
+                   &entry->header_layout, entry->device_positions, &entry->grid_legend_position, &entry->num_plots,
+                   entry->plot_positions, entry->map_device_to_plot, &entry->process_position,
+                   &entry->setup_position, process_win_hide);
+    HASH_ADD_KEYPTR(hh, layout_cache, entry->key, entry->key_size, entry);
+  }
+
+  *header_layout = entry->header_layout;
+  memcpy(device_positions, entry->device_positions, devices_count * sizeof(*device_positions));
+  memcpy(map_device_to_plot, entry->map_device_to_plot, devices_count * sizeof(*map_device_to_plot));
+  *grid_legend_position = entry->grid_legend_position;
+  *num_plots = entry->num_plots;
+  memcpy(plot_positions, entry->plot_positions, entry->num_plots * sizeof(*plot_positions));
+  *process_position = entry->process_position;
+  *setup_position = entry->setup_position;
+}
@@ -25,6 +25,7 @@
 #include "nvtop/interface_common.h"
 
 #include <assert.h>
+#include <ctype.h>
 #include <errno.h>
 #include <libgen.h>
 #include <limits.h>
@@ -115,8 +116,13 @@ void alloc_interface_options_internals(char *config_location, unsigned num_devic
   }
   unsigned idx = 0;
   struct gpu_info *device;
-  list_for_each_entry(device, devices, list) { options->gpu_specific_opts[idx++].linkedGpu = device; }
+  list_for_each_entry(device, devices, list) {
+    options->gpu_specific_opts[idx].linkedGpu = device;
+    options->gpu_specific_opts[idx].history_slot = idx;
+    idx++;
+  }
   options->plot_left_to_right = false;
+  options->plot_heatmap = false;
   options->use_color = true;
   options->encode_decode_hiding_timer = 30.;
   options->temperature_in_fahrenheit = false;
@@ -128,7 +134,11 @@ void alloc_interface_options_internals(char *config_location, unsigned num_devic
   options->has_monitored_set_changed = false;
   options->show_startup_messages = true;
   options->filter_nvtop_pid = true;
+  options->group_multi_device_processes = false;
+  options->process_rollup = process_rollup_none;
   options->has_gpu_info_bar = false;
+  options->alert_rules_count = 0;
+  options->alert_rules = NULL;
   if (config_location) {
     options->config_file_location = malloc(strlen(config_location) + 1);
     if (!options->config_file_location) {
@@ -160,7 +170,9 @@ static const char do_not_modify_notice[] = "; Please do not edit this file.\n"
                                            "F12.\n"
                                            "; If you wish to modify an option, use nvtop's setup window (F2) and "
                                            "follow "
-                                           "up by saving the preference (F12).\n";
+                                           "up by saving the preference (F12).\n"
+                                           "; The [Alert] sections are the exception, they are only set here and kept "
+                                           "when saving.\n";
 
 static const char general_section[] = "GeneralOption";
 static const char general_value_use_color[] = "UseColor";
@@ -174,14 +186,18 @@ static const char header_value_gpu_info_bar[] = "GPUInfoBar";
 
 static const char chart_section[] = "ChartOption";
 static const char chart_value_reverse[] = "ReverseChart";
+static const char chart_value_heatmap[] = "HeatmapChart";
 
 static const char process_list_section[] = "ProcessListOption";
 static const char process_hide_nvtop_process_list[] = "HideNvtopProcessList";
 static const char process_hide_nvtop_process[] = "HideNvtopProcess";
+static const char process_group_multi_device[] = "GroupMultiDevice";
+static const char process_value_rollup[] = "RollUp";
+static const char *process_rollup_vals[process_rollup_count] = {"none", "user", "cgroup", "job"};
 static const char process_value_sortby[] = "SortBy";
 static const char process_value_display_field[] = "DisplayField";
 static const char *process_sortby_vals[process_field_count + 1] = {
-    "pId", "user", "gpuId", "type", "gpuRate", "encRate", "decRate", "memory", "cpuUsage", "cpuMem", "cmdline", "none"};
+    "pId", "user", "gpuId", "type", "gpuRate", "encRate", "decRate", "memory", "cpuUsage", "cpuMem", "ioRead", "starvation", "numa", "energy", "gpuTime", "memoryPeak", "gpuAverage", "idleHeld", "memoryGrowth", "timeToOom", "nsPid", "jobId", "cmdline", "none"};
 static const char process_value_sort_order[] = "SortOrder";
 static const char process_sort_descending[] = "descending";
 static const char process_sort_ascending[] = "ascending";
@@ -191,11 +207,50 @@ static const char device_pdev[] = "Pdev";
 static const char device_monitor[] = "Monitor";
 static const char device_shown_value[] = "ShownInfo";
 static const char *device_draw_vals[plot_information_count + 1] = {
-    "gpuRate",       "gpuMemRate", "encodeRate",   "decodeRate",      "temperature",
-    "powerDrawRate", "fanSpeed",   "gpuClockRate", "gpuMemClockRate", "none"};
+    "gpuRate",       "gpuMemRate", "encodeRate",   "decodeRate",      "temperature", "powerDrawRate",
+    "fanSpeed",      "gpuClockRate", "gpuMemClockRate", "pcieRx",      "pcieTx",      "powerDraw",
+    "gpuClock",      "gpuMemClock",  "gpuMemUsed",      "none"};
+
+static const char alert_section[] = "Alert";
+static const char alert_name[] = "Name";
+static const char alert_condition[] = "Condition";
+static const char alert_duration[] = "Duration";
+static const char alert_cooldown[] = "Cooldown";
+static const char alert_command[] = "Command";
+static const char alert_fifo[] = "Fifo";
+
+static void replace_string(char **string, const char *value) {
+  free(*string);
+  *string = strdup(value);
+  if (!*string) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+}
+
+// The parser keeps the inline comments (INI_ALLOW_INLINE_COMMENTS is 0), a ';' preceded by a space starts one
+static const char *strip_inline_comment(const char *value, char uncommented[INI_MAX_LINE]) {
+  size_t length = 0;
+  for (; value[length] && !(value[length] == ';' && length && isspace((unsigned char)value[length - 1])); ++length)
+    uncommented[length] = value[length];
+  while (length && isspace((unsigned char)uncommented[length - 1]))
+    length--;
+  uncommented[length] = '\0';
+  return uncommented;
+}
 
 static int nvtop_option_ini_handler(void *user, const char *section, const char *name, const char *value) {
   struct nvtop_option_ini_data *ini_data = (struct nvtop_option_ini_data *)user;
+  // Called with no name at the start of a section (INI_CALL_HANDLER_ON_NEW_SECTION), each [Alert] section is a rule
+  if (!name) {
+    if (strcmp(section, alert_section) == 0)
+      alert_rules_append(&ini_data->options->alert_rules_count, &ini_data->options->alert_rules, NULL);
+    return 1;
+  }
+  // The alert commands keep their " ;" separating shell commands
+  char uncommented[INI_MAX_LINE];
+  if (strcmp(section, alert_section) || (strcmp(name, alert_command) && strcmp(name, alert_fifo)))
+    value = strip_inline_comment(value, uncommented);
   // General Options
   if (strcmp(section, general_section) == 0) {
     if (strcmp(name, general_value_use_color) == 0) {
@@ -254,6 +309,14 @@ static int nvtop_option_ini_handler(void *user, const char *section, const char
         ini_data->options->plot_left_to_right = false;
       }
     }
+    if (strcmp(name, chart_value_heatmap) == 0) {
+      if (strcmp(value, "true") == 0) {
+        ini_data->options->plot_heatmap = true;
+      }
+      if (strcmp(value, "false") == 0) {
+        ini_data->options->plot_heatmap = false;
+      }
+    }
   }
   // Process List Options
   if (strcmp(section, process_list_section) == 0) {
@@ -273,6 +336,21 @@ static int nvtop_option_ini_handler(void *user, const char *section, const char
         ini_data->options->filter_nvtop_pid = false;
       }
     }
+    if (strcmp(name, process_group_multi_device) == 0) {
+      if (strcmp(value, "true") == 0) {
+        ini_data->options->group_multi_device_processes = true;
+      }
+      if (strcmp(value, "false") == 0) {
+        ini_data->options->group_multi_device_processes = false;
+      }
+    }
+    if (strcmp(name, process_value_rollup) == 0) {
+      for (enum process_rollup i = process_rollup_none; i < process_rollup_count; ++i) {
+        if (strcmp(value, process_rollup_vals[i]) == 0) {
+          ini_data->options->process_rollup = i;
+        }
+      }
+    }
     if (strcmp(name, process_value_sortby) == 0) {
       for (enum process_field i = process_pid; i < process_field_count; ++i) {
         if (strcmp(value, process_sortby_vals[i]) == 0) {
@@ -329,6 +407,23 @@ static int nvtop_option_ini_handler(void *user, const char *section, const char
       }
     }
   }
+  // Alert Rules, the rule of the current section. A rule without a name is reported when the rules are compiled.
+  if (strcmp(section, alert_section) == 0) {
+    struct alert_rule *rule = &ini_data->options->alert_rules[ini_data->options->alert_rules_count - 1];
+    if (strcmp(name, alert_name) == 0)
+      replace_string(&rule->name, value);
+    if (strcmp(name, alert_condition) == 0)
+      replace_string(&rule->condition, value);
+    if (strcmp(name, alert_command) == 0)
+      replace_string(&rule->command, value);
+    if (strcmp(name, alert_fifo) == 0)
+      replace_string(&rule->fifo, value);
+    double value_double;
+    if (strcmp(name, alert_duration) == 0 && sscanf(value, "%le", &value_double) == 1)
+      rule->duration = value_double;
+    if (strcmp(name, alert_cooldown) == 0 && sscanf(value, "%le", &value_double) == 1)
+      rule->cooldown = value_double;
+  }
   return 1;
 }
 
@@ -404,11 +499,15 @@ bool save_interface_options_to_config_file(unsigned total_dev_count, const nvtop
   // Chart Options
   fprintf(config_file, "\n[%s]\n", chart_section);
   fprintf(config_file, "%s = %s\n", chart_value_reverse, boolean_string(options->plot_left_to_right));
+  fprintf(config_file, "%s = %s\n", chart_value_heatmap, boolean_string(options->plot_heatmap));
 
   // Process Options
   fprintf(config_file, "\n[%s]\n", process_list_section);
   fprintf(config_file, "%s = %s\n", process_hide_nvtop_process_list, boolean_string(options->hide_processes_list));
   fprintf(config_file, "%s = %s\n", process_hide_nvtop_process, boolean_string(options->filter_nvtop_pid));
+  fprintf(config_file, "%s = %s\n", process_group_multi_device,
+          boolean_string(options->group_multi_device_processes));
+  fprintf(config_file, "%s = %s\n", process_value_rollup, process_rollup_vals[options->process_rollup]);
   fprintf(config_file, "%s = %s\n", process_value_sort_order,
           options->sort_descending_order ? process_sort_descending : process_sort_ascending);
   fprintf(config_file, "%s = %s\n", process_value_sortby, process_sortby_vals[options->sort_processes_by]);
@@ -439,6 +538,22 @@ bool save_interface_options_to_config_file(unsigned total_dev_count, const nvtop
     fprintf(config_file, "\n");
   }
 
+  // Alert Rules
+  for (unsigned i = 0; i < options->alert_rules_count; ++i) {
+    const struct alert_rule *rule = &options->alert_rules[i];
+    fprintf(config_file, "\n[%s]\n", alert_section);
+    if (rule->name)
+      fprintf(config_file, "%s = %s\n", alert_name, rule->name);
+    if (rule->condition)
+      fprintf(config_file, "%s = %s\n", alert_condition, rule->condition);
+    fprintf(config_file, "%s = %g\n", alert_duration, rule->duration);
+    fprintf(config_file, "%s = %g\n", alert_cooldown, rule->cooldown);
+    if (rule->command)
+      fprintf(config_file, "%s = %s\n", alert_command, rule->command);
+    if (rule->fifo)
+      fprintf(config_file, "%s = %s\n", alert_fifo, rule->fifo);
+  }
+
   fclose(config_file);
   return true;
 }
@@ -474,6 +589,30 @@ enum process_field process_default_sort_by_from(process_field_displayed fields_d
     return process_gpu_rate;
   if (process_is_field_displayed(process_cpu_usage, fields_displayed))
     return process_cpu_usage;
+  if (process_is_field_displayed(process_io_read, fields_displayed))
+    return process_io_read;
+  if (process_is_field_displayed(process_starvation, fields_displayed))
+    return process_starvation;
+  if (process_is_field_displayed(process_numa, fields_displayed))
+    return process_numa;
+  if (process_is_field_displayed(process_energy, fields_displayed))
+    return process_energy;
+  if (process_is_field_displayed(process_gpu_time, fields_displayed))
+    return process_gpu_time;
+  if (process_is_field_displayed(process_memory_peak, fields_displayed))
+    return process_memory_peak;
+  if (process_is_field_displayed(process_gpu_average, fields_displayed))
+    return process_gpu_average;
+  if (process_is_field_displayed(process_idle_held, fields_displayed))
+    return process_idle_held;
+  if (process_is_field_displayed(process_memory_growth, fields_displayed))
+    return process_memory_growth;
+  if (process_is_field_displayed(process_time_to_oom, fields_displayed))
+    return process_time_to_oom;
+  if (process_is_field_displayed(process_namespace_pid, fields_displayed))
+    return process_namespace_pid;
+  if (process_is_field_displayed(process_job_id, fields_displayed))
+    return process_job_id;
   if (process_is_field_displayed(process_command, fields_displayed))
     return process_command;
   if (process_is_field_displayed(process_type, fields_displayed))
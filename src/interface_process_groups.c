@@ -0,0 +1,328 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "nvtop/interface_process_groups.h"
+#include "nvtop/common.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int64_t process_group_key(unsigned host_id, pid_t pid) { return (int64_t)host_id << 32 | (uint32_t)pid; }
+
+// FNV-1a over the host and the user name
+int64_t process_group_name_key(unsigned host_id, const char *name) {
+  uint64_t hash = 14695981039346656037ull;
+  for (unsigned i = 0; i < sizeof(host_id); ++i) {
+    hash ^= (host_id >> (8 * i)) & 0xff;
+    hash *= 1099511628211ull;
+  }
+  for (const char *c = name; *c; ++c) {
+    hash ^= (unsigned char)*c;
+    hash *= 1099511628211ull;
+  }
+  return (int64_t)hash;
+}
+
+int64_t process_group_key_of(const struct gpuid_and_process *row, enum process_rollup rollup) {
+  switch (rollup) {
+  case process_rollup_user:
+    return process_group_name_key(row->host_id, GPUINFO_PROCESS_FIELD_VALID(row->process, user_name)
+                                                    ? row->process->user_name
+                                                    : "");
+  case process_rollup_cgroup:
+    return process_group_name_key(row->host_id,
+                                  GPUINFO_PROCESS_FIELD_VALID(row->process, cgroup) ? row->process->cgroup : "");
+  case process_rollup_job:
+    return process_group_name_key(row->host_id,
+                                  GPUINFO_PROCESS_FIELD_VALID(row->process, job_id) ? row->process->job_id : "");
+  default:
+    return process_group_key(row->host_id, row->process->pid);
+  }
+}
+
+static void process_group_add_member(struct process_group *group, const struct gpu_process *process) {
+  struct gpu_process *merged = &group->merged;
+  merged->type |= process->type;
+  if (!GPUINFO_PROCESS_FIELD_VALID(merged, user_name) && GPUINFO_PROCESS_FIELD_VALID(process, user_name))
+    SET_GPUINFO_PROCESS(merged, user_name, process->user_name);
+  else if (GPUINFO_PROCESS_FIELD_VALID(process, user_name) && strcmp(merged->user_name, process->user_name))
+    group->mixed_users = true;
+  if (!GPUINFO_PROCESS_FIELD_VALID(merged, cgroup) && GPUINFO_PROCESS_FIELD_VALID(process, cgroup)) {
+    memcpy(merged->cgroup, process->cgroup, sizeof(merged->cgroup));
+    SET_VALID(gpuinfo_process_cgroup_valid, merged->valid);
+  }
+  if (!GPUINFO_PROCESS_FIELD_VALID(merged, job_id) && GPUINFO_PROCESS_FIELD_VALID(process, job_id)) {
+    memcpy(merged->job_id, process->job_id, sizeof(merged->job_id));
+    SET_VALID(gpuinfo_process_job_id_valid, merged->valid);
+  }
+  // The host values of a rollup are summed once per process by process_rollup_add_process
+  if (!group->rollup) {
+    if (!GPUINFO_PROCESS_FIELD_VALID(merged, cmdline) && GPUINFO_PROCESS_FIELD_VALID(process, cmdline))
+      SET_GPUINFO_PROCESS(merged, cmdline, process->cmdline);
+    if (!GPUINFO_PROCESS_FIELD_VALID(merged, namespace_pid) && GPUINFO_PROCESS_FIELD_VALID(process, namespace_pid))
+      SET_GPUINFO_PROCESS(merged, namespace_pid, process->namespace_pid);
+    if (!GPUINFO_PROCESS_FIELD_VALID(merged, cpu_usage) && GPUINFO_PROCESS_FIELD_VALID(process, cpu_usage))
+      SET_GPUINFO_PROCESS(merged, cpu_usage, process->cpu_usage);
+    if (!GPUINFO_PROCESS_FIELD_VALID(merged, cpu_memory_res) && GPUINFO_PROCESS_FIELD_VALID(process, cpu_memory_res))
+      SET_GPUINFO_PROCESS(merged, cpu_memory_res, process->cpu_memory_res);
+    if (!GPUINFO_PROCESS_FIELD_VALID(merged, cpu_memory_virt) &&
+        GPUINFO_PROCESS_FIELD_VALID(process, cpu_memory_virt))
+      SET_GPUINFO_PROCESS(merged, cpu_memory_virt, process->cpu_memory_virt);
+  }
+  if (GPUINFO_PROCESS_FIELD_VALID(process, gpu_memory_usage))
+    SET_GPUINFO_PROCESS(merged, gpu_memory_usage, merged->gpu_memory_usage + process->gpu_memory_usage);
+  if (GPUINFO_PROCESS_FIELD_VALID(process, energy))
+    SET_GPUINFO_PROCESS(merged, energy, merged->energy + process->energy);
+  if (GPUINFO_PROCESS_FIELD_VALID(process, gpu_time))
+    SET_GPUINFO_PROCESS(merged, gpu_time, merged->gpu_time + process->gpu_time);
+  if (GPUINFO_PROCESS_FIELD_VALID(process, gpu_memory_peak))
+    SET_GPUINFO_PROCESS(merged, gpu_memory_peak, merged->gpu_memory_peak + process->gpu_memory_peak);
+  if (GPUINFO_PROCESS_FIELD_VALID(process, gpu_usage_average)) {
+    group->gpu_usage_average_sum += process->gpu_usage_average;
+    group->gpu_usage_average_count++;
+  }
+  if (GPUINFO_PROCESS_FIELD_VALID(process, idle_time))
+    SET_GPUINFO_PROCESS(merged, idle_time, merged->idle_time + process->idle_time);
+  if (GPUINFO_PROCESS_FIELD_VALID(process, idle_memory_time))
+    SET_GPUINFO_PROCESS(merged, idle_memory_time, merged->idle_memory_time + process->idle_memory_time);
+  if (GPUINFO_PROCESS_FIELD_VALID(process, gpu_memory_growth))
+    SET_GPUINFO_PROCESS(merged, gpu_memory_growth, merged->gpu_memory_growth + process->gpu_memory_growth);
+  // The group runs out of memory with its first member
+  if (GPUINFO_PROCESS_FIELD_VALID(process, time_to_oom) &&
+      (!GPUINFO_PROCESS_FIELD_VALID(merged, time_to_oom) || process->time_to_oom < merged->time_to_oom))
+    SET_GPUINFO_PROCESS(merged, time_to_oom, process->time_to_oom);
+  if (GPUINFO_PROCESS_FIELD_VALID(process, gpu_usage)) {
+    if (!group->gpu_usage_count || process->gpu_usage < group->gpu_usage_min)
+      group->gpu_usage_min = process->gpu_usage;
+    if (!group->gpu_usage_count || process->gpu_usage > group->gpu_usage_max)
+      group->gpu_usage_max = process->gpu_usage;
+    group->gpu_usage_sum += process->gpu_usage;
+    group->gpu_usage_count++;
+  }
+  if (GPUINFO_PROCESS_FIELD_VALID(process, encode_usage)) {
+    group->encode_usage_sum += process->encode_usage;
+    group->encode_usage_count++;
+  }
+  if (GPUINFO_PROCESS_FIELD_VALID(process, decode_usage)) {
+    group->decode_usage_sum += process->decode_usage;
+    group->decode_usage_count++;
+  }
+}
+
+static size_t process_group_append_device_range(char *buffer, size_t size, size_t printed, unsigned first,
+                                                unsigned last) {
+  if (printed >= size)
+    return printed;
+  const char *separator = printed ? "," : "";
+  if (first == last)
+    return printed + snprintf(&buffer[printed], size - printed, "%s%u", separator, first);
+  else
+    return printed + snprintf(&buffer[printed], size - printed, "%s%u-%u", separator, first, last);
+}
+
+static void process_group_finalize(struct process_group *group, all_processes all_procs, const unsigned *next_member) {
+  if (group->rollup) {
+    // The load a user puts on the devices is the sum over its processes
+    if (group->gpu_usage_count)
+      SET_GPUINFO_PROCESS(&group->merged, gpu_usage, group->gpu_usage_sum);
+    if (group->encode_usage_count)
+      SET_GPUINFO_PROCESS(&group->merged, encode_usage, group->encode_usage_sum);
+    if (group->decode_usage_count)
+      SET_GPUINFO_PROCESS(&group->merged, decode_usage, group->decode_usage_sum);
+    if (group->gpu_usage_average_count)
+      SET_GPUINFO_PROCESS(&group->merged, gpu_usage_average, group->gpu_usage_average_sum);
+    // A user column listing one of several users would be misleading
+    if (group->mixed_users)
+      RESET_GPUINFO_PROCESS(&group->merged, user_name);
+    if (group->rollup == process_rollup_cgroup)
+      snprintf(group->summary, sizeof(group->summary), "%s - %u process%s",
+               GPUINFO_PROCESS_FIELD_VALID(&group->merged, cgroup) ? group->merged.cgroup : "N/A",
+               group->processes_count, group->processes_count > 1 ? "es" : "");
+    else if (group->rollup == process_rollup_job)
+      snprintf(group->summary, sizeof(group->summary), "Job %s - %u process%s",
+               GPUINFO_PROCESS_FIELD_VALID(&group->merged, job_id) ? group->merged.job_id : "N/A",
+               group->processes_count, group->processes_count > 1 ? "es" : "");
+    else
+      snprintf(group->summary, sizeof(group->summary), "%u process%s", group->processes_count,
+               group->processes_count > 1 ? "es" : "");
+    SET_GPUINFO_PROCESS(&group->merged, cmdline, group->summary);
+  } else {
+    // The devices of one process show its mean load
+    if (group->gpu_usage_count)
+      SET_GPUINFO_PROCESS(&group->merged, gpu_usage,
+                          (group->gpu_usage_sum + group->gpu_usage_count / 2) / group->gpu_usage_count);
+    if (group->encode_usage_count)
+      SET_GPUINFO_PROCESS(&group->merged, encode_usage,
+                          (group->encode_usage_sum + group->encode_usage_count / 2) / group->encode_usage_count);
+    if (group->decode_usage_count)
+      SET_GPUINFO_PROCESS(&group->merged, decode_usage,
+                          (group->decode_usage_sum + group->decode_usage_count / 2) / group->decode_usage_count);
+    if (group->gpu_usage_average_count)
+      SET_GPUINFO_PROCESS(&group->merged, gpu_usage_average,
+                          (group->gpu_usage_average_sum + group->gpu_usage_average_count / 2) /
+                              group->gpu_usage_average_count);
+  }
+
+  size_t printed = 0;
+  unsigned range_first = all_procs.processes[group->first_member].gpu_id;
+  unsigned range_last = range_first;
+  for (unsigned member = next_member[group->first_member]; member != PROCESS_GROUP_NO_MEMBER;
+       member = next_member[member]) {
+    unsigned gpu_id = all_procs.processes[member].gpu_id;
+    if (gpu_id == range_last || gpu_id == range_last + 1) {
+      range_last = gpu_id;
+    } else {
+      printed = process_group_append_device_range(group->devices, sizeof(group->devices), printed, range_first,
+                                                  range_last);
+      range_first = range_last = gpu_id;
+    }
+  }
+  process_group_append_device_range(group->devices, sizeof(group->devices), printed, range_first, range_last);
+}
+
+// A process running on several devices is counted once and its host values are summed once
+static void process_rollup_add_process(struct process_groups *groups, struct process_group *group,
+                                       const struct gpuid_and_process *row) {
+  int64_t key = process_group_key(row->host_id, row->process->pid);
+  struct process_rollup_member *member;
+  HASH_FIND(hh, groups->rollup_members, &key, sizeof(key), member);
+  if (!member) {
+    member = calloc(1, sizeof(*member));
+    if (!member) {
+      perror("Cannot allocate memory: ");
+      exit(EXIT_FAILURE);
+    }
+    member->key = key;
+    HASH_ADD(hh, groups->rollup_members, key, sizeof(member->key), member);
+  }
+  if (member->generation != groups->generation) {
+    member->generation = groups->generation;
+    member->cpu_usage_counted = member->cpu_memory_res_counted = member->cpu_memory_virt_counted = false;
+    group->processes_count++;
+  }
+  const struct gpu_process *process = row->process;
+  struct gpu_process *merged = &group->merged;
+  if (!member->cpu_usage_counted && GPUINFO_PROCESS_FIELD_VALID(process, cpu_usage)) {
+    SET_GPUINFO_PROCESS(merged, cpu_usage, merged->cpu_usage + process->cpu_usage);
+    member->cpu_usage_counted = true;
+  }
+  if (!member->cpu_memory_res_counted && GPUINFO_PROCESS_FIELD_VALID(process, cpu_memory_res)) {
+    SET_GPUINFO_PROCESS(merged, cpu_memory_res, merged->cpu_memory_res + process->cpu_memory_res);
+    member->cpu_memory_res_counted = true;
+  }
+  if (!member->cpu_memory_virt_counted && GPUINFO_PROCESS_FIELD_VALID(process, cpu_memory_virt)) {
+    SET_GPUINFO_PROCESS(merged, cpu_memory_virt, merged->cpu_memory_virt + process->cpu_memory_virt);
+    member->cpu_memory_virt_counted = true;
+  }
+}
+
+static void process_groups_clear(struct process_groups *groups) {
+  struct process_group *group, *tmp_group;
+  HASH_ITER(hh, groups->groups_by_pid, group, tmp_group) {
+    HASH_DEL(groups->groups_by_pid, group);
+    free(group);
+  }
+  struct process_rollup_member *member, *tmp_member;
+  HASH_ITER(hh, groups->rollup_members, member, tmp_member) {
+    HASH_DEL(groups->rollup_members, member);
+    free(member);
+  }
+  groups->groups_count = 0;
+}
+
+void process_groups_update(struct process_groups *groups, all_processes all_procs, enum process_rollup rollup) {
+  // The keys of another rollup have another meaning
+  if (rollup != groups->rollup)
+    process_groups_clear(groups);
+  groups->rollup = rollup;
+  groups->generation++;
+  groups->groups_count = 0;
+  if (all_procs.processes_count > groups->capacity) {
+    groups->capacity = all_procs.processes_count;
+    groups->groups = reallocarray(groups->groups, groups->capacity, sizeof(*groups->groups));
+    groups->next_member = reallocarray(groups->next_member, groups->capacity, sizeof(*groups->next_member));
+    if (!groups->groups || !groups->next_member) {
+      perror("Could not re-allocate memory: ");
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  for (unsigned i = 0; i < all_procs.processes_count; ++i) {
+    const struct gpu_process *process = all_procs.processes[i].process;
+    int64_t key = process_group_key_of(&all_procs.processes[i], rollup);
+    struct process_group *group;
+    HASH_FIND(hh, groups->groups_by_pid, &key, sizeof(key), group);
+    if (!group) {
+      group = calloc(1, sizeof(*group));
+      if (!group) {
+        perror("Cannot allocate memory: ");
+        exit(EXIT_FAILURE);
+      }
+      group->key = key;
+      HASH_ADD(hh, groups->groups_by_pid, key, sizeof(group->key), group);
+    }
+    if (group->generation != groups->generation) {
+      memset(group, 0, offsetof(struct process_group, hh));
+      group->key = key;
+      group->rollup = rollup;
+      group->generation = groups->generation;
+      // A rollup has no pid, which also keeps it out of reach of the kill window
+      group->merged.pid = group->rollup ? 0 : process->pid;
+      group->first_member = i;
+      groups->groups[groups->groups_count++] = group;
+    } else {
+      groups->next_member[group->last_member] = i;
+    }
+    groups->next_member[i] = PROCESS_GROUP_NO_MEMBER;
+    group->last_member = i;
+    group->members_count++;
+    process_group_add_member(group, process);
+    if (rollup != process_rollup_none)
+      process_rollup_add_process(groups, group, &all_procs.processes[i]);
+  }
+
+  // Release what left since the previous update
+  struct process_group *group, *tmp_group;
+  HASH_ITER(hh, groups->groups_by_pid, group, tmp_group) {
+    if (group->generation != groups->generation) {
+      HASH_DEL(groups->groups_by_pid, group);
+      free(group);
+    }
+  }
+  struct process_rollup_member *member, *tmp_member;
+  HASH_ITER(hh, groups->rollup_members, member, tmp_member) {
+    if (member->generation != groups->generation) {
+      HASH_DEL(groups->rollup_members, member);
+      free(member);
+    }
+  }
+  for (unsigned i = 0; i < groups->groups_count; ++i)
+    process_group_finalize(groups->groups[i], all_procs, groups->next_member);
+}
+
+void process_groups_free(struct process_groups *groups) {
+  process_groups_clear(groups);
+  free(groups->groups);
+  free(groups->next_member);
+  memset(groups, 0, sizeof(*groups));
+}
@@ -1,5 +1,6 @@
 
 #include "nvtop/interface_ring_buffer.h"
+#include "nvtop/common.h"
 
 #include "stdio.h"
 #include "stdlib.h"
@@ -21,6 +22,24 @@ void interface_alloc_ring_buffer(unsigned devices_count, unsigned per_device_dat
   ring_buffer->monitored_dev_count = devices_count;
 }
 
+void interface_ring_buffer_add_devices(interface_ring_buffer *ring_buffer, unsigned devices_count) {
+  unsigned previous_count = ring_buffer->monitored_dev_count;
+  unsigned per_device_data_saved = ring_buffer->per_device_data_saved;
+  unsigned buffer_size = ring_buffer->buffer_size;
+  // The device is the outermost dimension, the existing data stays in place
+  ring_buffer->ring_buffer[0] =
+      reallocarray(ring_buffer->ring_buffer[0], devices_count, sizeof(unsigned[per_device_data_saved][2]));
+  ring_buffer->ring_buffer[1] =
+      reallocarray(ring_buffer->ring_buffer[1], devices_count, sizeof(unsigned[per_device_data_saved][buffer_size]));
+  if (!ring_buffer->ring_buffer[0] || !ring_buffer->ring_buffer[1]) {
+    perror("Could not re-allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  ring_buffer->monitored_dev_count = devices_count;
+  for (unsigned device = previous_count; device < devices_count; ++device)
+    interface_ring_buffer_empty(ring_buffer, device);
+}
+
 void interface_free_ring_buffer(interface_ring_buffer *buffer) {
   free(buffer->ring_buffer[0]);
   free(buffer->ring_buffer[1]);
@@ -68,18 +68,21 @@ static const char *setup_header_option_descriptions[setup_header_options_count]
 
 enum setup_chart_options {
   setup_chart_reverse,
+  setup_chart_heatmap,
   setup_chart_all_gpu,
   setup_chart_start_gpu_list,
   setup_chart_options_count
 };
 
 static const char *setup_chart_options_descriptions[setup_chart_options_count] = {
-    "Reverse plot direction", "Displayed all GPUs", "Displayed GPU"};
+    "Reverse plot direction", "Heatmap of the first percentage, one row per GPU", "Displayed all GPUs", "Displayed GPU"};
 
 static const char *setup_chart_gpu_value_descriptions[plot_information_count] = {
     "GPU utilization rate", "GPU memory utilization rate",   "GPU encoder rate", "GPU decoder rate",
     "GPU temperature",      "Power draw rate (current/max)", "Fan speed",        "GPU clock rate",
-    "GPU memory clock rate"};
+    "GPU memory clock rate", "PCIe receive throughput",      "PCIe transmit throughput",
+    "Power draw (watts)",   "GPU clock (MHz)",               "GPU memory clock (MHz)",
+    "GPU memory used (bytes)"};
 
 // Process List Options
 
@@ -87,17 +90,26 @@ enum setup_proc_list_options {
   setup_proc_list_hide_process_list,
   setup_proc_list_hide_nvtop_process,
   setup_proc_list_sort_ascending,
+  setup_proc_list_group_multi_device,
+  setup_proc_list_rollup_user,
+  setup_proc_list_rollup_cgroup,
+  setup_proc_list_rollup_job,
   setup_proc_list_sort_by,
   setup_proc_list_display,
   setup_proc_list_options_count
 };
 
 static const char *setup_proc_list_option_description[setup_proc_list_options_count] = {
-    "Don't display the process list", "Hide nvtop in the process list", "Sort Ascending", "Sort by", "Field Displayed"};
+    "Don't display the process list", "Hide nvtop in the process list", "Sort Ascending",
+    "Merge processes running on multiple devices", "Aggregate the processes per user",
+    "Aggregate the processes per cgroup", "Aggregate the processes per batch job", "Sort by", "Field Displayed"};
 
 static const char *setup_proc_list_value_descriptions[process_field_count] = {
     "Process Id",    "User name",        "Device Id", "Workload type",    "GPU usage", "Encoder usage",
-    "Decoder usage", "GPU memory usage", "CPU usage", "CPU memory usage", "Command"};
+    "Decoder usage", "GPU memory usage", "CPU usage", "CPU memory usage", "Host I/O read rate",
+    "Host starvation", "NUMA placement",   "Energy used (estimated)", "Accumulated GPU time",
+    "Peak GPU memory", "Average GPU usage", "Memory held while idle (GiB x hours)", "GPU memory growth",
+    "Time to out of memory", "Pid inside the container", "Batch job id", "Command"};
 
 static unsigned int sizeof_setup_windows[setup_window_type_count] = {[setup_window_type_setup] = 11,
                                                                      [setup_window_type_single] = 0,
@@ -298,9 +310,9 @@ static void draw_setup_window_chart(unsigned devices_count, struct list_head *de
   WINDOW *option_list_win;
 
   // Fix indices for this window
-  if (interface->setup_win.options_selected[0] > devices_count + 1)
-    interface->setup_win.options_selected[0] = devices_count + 1;
-  if (interface->setup_win.options_selected[0] > 0) {
+  if (interface->setup_win.options_selected[0] > setup_chart_start_gpu_list + devices_count - 1)
+    interface->setup_win.options_selected[0] = setup_chart_start_gpu_list + devices_count - 1;
+  if (interface->setup_win.options_selected[0] >= setup_chart_all_gpu) {
     if (interface->setup_win.options_selected[1] >= plot_information_count)
       interface->setup_win.options_selected[1] = plot_information_count - 1;
     option_list_win = interface->setup_win.split[0];
@@ -334,6 +346,14 @@ static void draw_setup_window_chart(unsigned devices_count, struct list_head *de
     mvwchgat(option_list_win, setup_chart_reverse + 1, 0, 3, A_STANDOUT, cyan_color, NULL);
   }
 
+  // Heatmap
+  option_state = interface->options.plot_heatmap;
+  mvwprintw(option_list_win, setup_chart_heatmap + 1, 0, "[%c] %s", option_state_char(option_state),
+            setup_chart_options_descriptions[setup_chart_heatmap]);
+  if (interface->setup_win.indentation_level == 1 && interface->setup_win.options_selected[0] == setup_chart_heatmap) {
+    mvwchgat(option_list_win, setup_chart_heatmap + 1, 0, 3, A_STANDOUT, cyan_color, NULL);
+  }
+
   // Set for all GPUs at once
   if (interface->setup_win.options_selected[0] == setup_chart_all_gpu) {
     if (interface->setup_win.indentation_level == 1)
@@ -482,6 +502,34 @@ static void draw_setup_window_proc_list(struct nvtop_interface *interface) {
       interface->setup_win.options_selected[0] == setup_proc_list_sort_ascending) {
     mvwchgat(option_list_win, setup_proc_list_sort_ascending + 1, 0, 3, A_STANDOUT, cyan_color, NULL);
   }
+  option_state = interface->options.group_multi_device_processes;
+  mvwprintw(option_list_win, setup_proc_list_group_multi_device + 1, 0, "[%c] %s", option_state_char(option_state),
+            setup_proc_list_option_description[setup_proc_list_group_multi_device]);
+  if (interface->setup_win.indentation_level == 1 &&
+      interface->setup_win.options_selected[0] == setup_proc_list_group_multi_device) {
+    mvwchgat(option_list_win, setup_proc_list_group_multi_device + 1, 0, 3, A_STANDOUT, cyan_color, NULL);
+  }
+  option_state = interface->options.process_rollup == process_rollup_user;
+  mvwprintw(option_list_win, setup_proc_list_rollup_user + 1, 0, "[%c] %s", option_state_char(option_state),
+            setup_proc_list_option_description[setup_proc_list_rollup_user]);
+  if (interface->setup_win.indentation_level == 1 &&
+      interface->setup_win.options_selected[0] == setup_proc_list_rollup_user) {
+    mvwchgat(option_list_win, setup_proc_list_rollup_user + 1, 0, 3, A_STANDOUT, cyan_color, NULL);
+  }
+  option_state = interface->options.process_rollup == process_rollup_cgroup;
+  mvwprintw(option_list_win, setup_proc_list_rollup_cgroup + 1, 0, "[%c] %s", option_state_char(option_state),
+            setup_proc_list_option_description[setup_proc_list_rollup_cgroup]);
+  if (interface->setup_win.indentation_level == 1 &&
+      interface->setup_win.options_selected[0] == setup_proc_list_rollup_cgroup) {
+    mvwchgat(option_list_win, setup_proc_list_rollup_cgroup + 1, 0, 3, A_STANDOUT, cyan_color, NULL);
+  }
+  option_state = interface->options.process_rollup == process_rollup_job;
+  mvwprintw(option_list_win, setup_proc_list_rollup_job + 1, 0, "[%c] %s", option_state_char(option_state),
+            setup_proc_list_option_description[setup_proc_list_rollup_job]);
+  if (interface->setup_win.indentation_level == 1 &&
+      interface->setup_win.options_selected[0] == setup_proc_list_rollup_job) {
+    mvwchgat(option_list_win, setup_proc_list_rollup_job + 1, 0, 3, A_STANDOUT, cyan_color, NULL);
+  }
 
   for (enum setup_proc_list_options i = setup_proc_list_sort_by; i < setup_proc_list_options_count; ++i) {
     if (interface->setup_win.options_selected[0] == i) {
@@ -761,6 +809,9 @@ void handle_setup_win_keypress(int keyId, struct nvtop_interface *interface) {
           if (interface->setup_win.options_selected[0] == setup_chart_reverse) {
             interface->options.plot_left_to_right = !interface->options.plot_left_to_right;
           }
+          if (interface->setup_win.options_selected[0] == setup_chart_heatmap) {
+            interface->options.plot_heatmap = !interface->options.plot_heatmap;
+          }
           if (interface->setup_win.options_selected[0] >= setup_chart_all_gpu) {
             handle_setup_win_keypress(KEY_RIGHT, interface);
           }
@@ -774,13 +825,15 @@ void handle_setup_win_keypress(int keyId, struct nvtop_interface *interface) {
               for (unsigned i = 0; i < interface->monitored_dev_count; ++i) {
                 interface->options.gpu_specific_opts[i].to_draw = plot_remove_draw_info(
                     interface->setup_win.options_selected[1], interface->options.gpu_specific_opts[i].to_draw);
-                interface_ring_buffer_empty(&interface->saved_data_ring, i);
+                interface_ring_buffer_empty(&interface->saved_data_ring,
+                                            interface->options.gpu_specific_opts[i].history_slot);
               }
             } else {
               for (unsigned i = 0; i < interface->monitored_dev_count; ++i) {
                 interface->options.gpu_specific_opts[i].to_draw = plot_add_draw_info(
                     interface->setup_win.options_selected[1], interface->options.gpu_specific_opts[i].to_draw);
-                interface_ring_buffer_empty(&interface->saved_data_ring, i);
+                interface_ring_buffer_empty(&interface->saved_data_ring,
+                                            interface->options.gpu_specific_opts[i].history_slot);
               }
             }
           }
@@ -793,7 +846,8 @@ void handle_setup_win_keypress(int keyId, struct nvtop_interface *interface) {
             else
               interface->options.gpu_specific_opts[selected_gpu].to_draw = plot_add_draw_info(
                   interface->setup_win.options_selected[1], interface->options.gpu_specific_opts[selected_gpu].to_draw);
-            interface_ring_buffer_empty(&interface->saved_data_ring, selected_gpu);
+            interface_ring_buffer_empty(&interface->saved_data_ring,
+                                        interface->options.gpu_specific_opts[selected_gpu].history_slot);
           }
         }
       }
@@ -806,6 +860,17 @@ void handle_setup_win_keypress(int keyId, struct nvtop_interface *interface) {
             interface->options.filter_nvtop_pid = !interface->options.filter_nvtop_pid;
           } else if (interface->setup_win.options_selected[0] == setup_proc_list_hide_process_list) {
             interface->options.hide_processes_list = !interface->options.hide_processes_list;
+          } else if (interface->setup_win.options_selected[0] == setup_proc_list_group_multi_device) {
+            interface->options.group_multi_device_processes = !interface->options.group_multi_device_processes;
+          } else if (interface->setup_win.options_selected[0] == setup_proc_list_rollup_user) {
+            interface->options.process_rollup =
+                interface->options.process_rollup == process_rollup_user ? process_rollup_none : process_rollup_user;
+          } else if (interface->setup_win.options_selected[0] == setup_proc_list_rollup_cgroup) {
+            interface->options.process_rollup =
+                interface->options.process_rollup == process_rollup_cgroup ? process_rollup_none : process_rollup_cgroup;
+          } else if (interface->setup_win.options_selected[0] == setup_proc_list_rollup_job) {
+            interface->options.process_rollup =
+                interface->options.process_rollup == process_rollup_job ? process_rollup_none : process_rollup_job;
           } else if (interface->setup_win.options_selected[0] == setup_proc_list_sort_by) {
             handle_setup_win_keypress(KEY_RIGHT, interface);
           }
@@ -0,0 +1,50 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "nvtop/json_util.h"
+
+void json_write_string(FILE *file, const char *string, size_t max_length) {
+  fputc('"', file);
+  for (size_t i = 0; string[i] && (!max_length || i < max_length); ++i) {
+    unsigned char c = (unsigned char)string[i];
+    switch (c) {
+    case '"':
+    case '\\':
+      fprintf(file, "\\%c", c);
+      break;
+    case '\n':
+      fputs("\\n", file);
+      break;
+    case '\r':
+      fputs("\\r", file);
+      break;
+    case '\t':
+      fputs("\\t", file);
+      break;
+    default:
+      if (c < 0x20)
+        fprintf(file, "\\u%04x", c);
+      else
+        fputc(c, file);
+    }
+  }
+  fputc('"', file);
+}
@@ -0,0 +1,98 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "nvtop/memory_trend.h"
+
+static unsigned oldest_sample(const struct memory_trend *trend) {
+  return trend->count < MEMORY_TREND_SAMPLES ? 0 : trend->next;
+}
+
+static unsigned newest_sample(const struct memory_trend *trend) {
+  return (trend->next + MEMORY_TREND_SAMPLES - 1) % MEMORY_TREND_SAMPLES;
+}
+
+bool memory_trend_push(struct memory_trend *trend, double time, double bytes) {
+  if (trend->count && time - trend->times[newest_sample(trend)] < MEMORY_TREND_WINDOW / MEMORY_TREND_SAMPLES)
+    return false;
+  trend->times[trend->next] = time;
+  trend->bytes[trend->next] = bytes;
+  trend->next = (trend->next + 1) % MEMORY_TREND_SAMPLES;
+  if (trend->count < MEMORY_TREND_SAMPLES)
+    trend->count++;
+  return true;
+}
+
+static double memory_trend_span(const struct memory_trend *trend) {
+  return trend->count ? trend->times[newest_sample(trend)] - trend->times[oldest_sample(trend)] : 0.;
+}
+
+// Least squares fit, r2 is the coefficient of determination
+static void memory_trend_fit(const struct memory_trend *trend, double *slope, double *r2) {
+  double first_time = trend->times[oldest_sample(trend)];
+  // Relative to the oldest sample to keep the precision
+  double time_mean = 0., bytes_mean = 0.;
+  for (unsigned i = 0; i < trend->count; ++i) {
+    time_mean += trend->times[i] - first_time;
+    bytes_mean += trend->bytes[i];
+  }
+  time_mean /= trend->count;
+  bytes_mean /= trend->count;
+  double covariance = 0., variance = 0., bytes_variance = 0.;
+  for (unsigned i = 0; i < trend->count; ++i) {
+    double time = trend->times[i] - first_time - time_mean;
+    covariance += time * (trend->bytes[i] - bytes_mean);
+    variance += time * time;
+    bytes_variance += (trend->bytes[i] - bytes_mean) * (trend->bytes[i] - bytes_mean);
+  }
+  *slope = covariance / variance;
+  *r2 = bytes_variance > 0. ? covariance * covariance / (variance * bytes_variance) : 0.;
+}
+
+bool memory_trend_slope(const struct memory_trend *trend, double *slope) {
+  if (trend->count < 2 || memory_trend_span(trend) < MEMORY_TREND_MIN_SPAN)
+    return false;
+  double r2;
+  memory_trend_fit(trend, slope, &r2);
+  return true;
+}
+
+bool memory_trend_sustained(const struct memory_trend *trend) {
+  if (trend->count < 3 || memory_trend_span(trend) < MEMORY_TREND_SUSTAINED_SPAN)
+    return false;
+  double slope, r2;
+  memory_trend_fit(trend, &slope, &r2);
+  if (!(slope > 0.) || r2 < MEMORY_TREND_SUSTAINED_R2)
+    return false;
+  unsigned rising = 0, first = oldest_sample(trend);
+  for (unsigned i = 1; i < trend->count; ++i) {
+    unsigned previous = (first + i - 1) % MEMORY_TREND_SAMPLES, current = (first + i) % MEMORY_TREND_SAMPLES;
+    if (trend->bytes[current] >= trend->bytes[previous])
+      rising++;
+  }
+  return rising >= MEMORY_TREND_SUSTAINED_RISING * (trend->count - 1);
+}
+
+bool memory_trend_time_to_exhaust(double slope, double free_bytes, double *seconds) {
+  if (!(slope > 0.))
+    return false;
+  *seconds = free_bytes > 0. ? free_bytes / slope : 0.;
+  return true;
+}
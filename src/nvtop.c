@@ -19,15 +19,27 @@
  *
  */
 
+#ifdef COLLECTOR_SUPPORT
+#include "nvtop/collector.h"
+#endif
 #include "nvtop/extract_gpuinfo.h"
+#include "nvtop/alert_rules.h"
+#include "nvtop/flight_recorder.h"
 #include "nvtop/info_messages.h"
 #include "nvtop/interface.h"
 #include "nvtop/interface_common.h"
 #include "nvtop/interface_options.h"
+#include "nvtop/shm_publisher.h"
+#include "nvtop/shm_snapshot.h"
+#include "nvtop/idle_report.h"
+#include "nvtop/process_summary.h"
+#include "nvtop/trace_export.h"
 #include "nvtop/time.h"
+#include "nvtop/usage_ledger.h"
 #include "nvtop/version.h"
 
 #include <getopt.h>
+#include <limits.h>
 #include <ncurses.h>
 #include <signal.h>
 #include <stdbool.h>
@@ -66,10 +78,60 @@ static const char helpstring[] = "Available options:\n"
                                  "  -i --gpu-info     : Show bar with additional GPU parametres\n"
                                  "  -E --encode-hide  : Set encode/decode auto hide time in seconds "
                                  "(default 30s, negative = always on screen)\n"
+#ifdef COLLECTOR_SUPPORT
+                                 "  --daemon[=ENDPOINT]: Run as a collector daemon serving the device data on a Unix "
+                                 "socket path or on [host]:port over TCP, loopback without host, * for all interfaces (default "
+                                 COLLECTOR_DEFAULT_SOCKET " as root, $XDG_RUNTIME_DIR/" COLLECTOR_USER_SOCKET_NAME
+                                 " otherwise)\n"
+                                 "  --connect[=ENDPOINTS]: Display the data served by the comma separated collector "
+                                 "daemons (socket paths or host[:port]) instead of polling the devices\n"
+#endif
+                                 "  --shm[=NAME]      : Publish the data of every refresh into the POSIX shared memory "
+                                 "segment NAME (default " NVTOP_SHM_DEFAULT_NAME ")\n"
+                                 "  --trace=FILE      : Record the device metrics and the process lifetimes as a "
+                                 "Perfetto (.pftrace) or Chrome JSON trace\n"
+                                 "  --record=DIR      : Keep the last samples in memory and write the ones around each "
+                                 "trigger to a timestamped file in DIR\n"
+                                 "  --record-triggers=LIST: Comma separated triggers among gpu<N, gpu>N, mem>N, "
+                                 "temp>N, power>N (watts), throttle and exit (default " FLIGHT_RECORDER_DEFAULT_TRIGGERS
+                                 ")\n"
+                                 "  --record-window=BEFORE[:AFTER]: Seconds recorded before and after a trigger "
+                                 "(default 30:10)\n"
+                                 "  --summary[=FILE]  : Write the GPU time, average usage, peak memory and energy of "
+                                 "each process to FILE as it exits, or print them all when quitting\n"
+                                 "  --idle-report[=COUNT]: Print the COUNT processes that held the most GPU memory "
+                                 "while idle when quitting (default 10)\n"
+                                 "  --idle-threshold=GIB: Memory a process must hold for its idle time to count as "
+                                 "idle-held (default 1 GiB)\n"
+                                 "  --ledger=FILE     : Run in the background, appending the daily GPU-seconds, GPU "
+                                 "memory byte-seconds and energy of each user and job to the ledger FILE\n"
+                                 "  --ledger-interval=SECONDS: Interval between the ledger writes (default 60)\n"
+                                 "  --report[=FROM[:TO]]: Print the usage per user and job recorded in the --ledger "
+                                 "FILE between the YYYY-MM-DD dates FROM and TO, then exit\n"
+                                 "  --job-env=NAMES   : Comma separated environment variables holding the batch job id "
+                                 "of a process (default " GPUINFO_DEFAULT_JOB_ID_VARIABLES ")\n"
                                  "  -h --help         : Print help and exit\n";
 
 static const char versionString[] = "nvtop version " NVTOP_VERSION_STRING;
 
+// Options without a short version
+enum long_only_options {
+  long_option_daemon = 256,
+  long_option_connect,
+  long_option_shm,
+  long_option_trace,
+  long_option_record,
+  long_option_record_triggers,
+  long_option_record_window,
+  long_option_summary,
+  long_option_idle_report,
+  long_option_idle_threshold,
+  long_option_ledger,
+  long_option_ledger_interval,
+  long_option_report,
+  long_option_job_env,
+};
+
 static const struct option long_opts[] = {
     {.name = "delay", .has_arg = required_argument, .flag = NULL, .val = 'd'},
     {.name = "version", .has_arg = no_argument, .flag = NULL, .val = 'v'},
@@ -83,11 +145,42 @@ static const struct option long_opts[] = {
     {.name = "no-plot", .has_arg = no_argument, .flag = NULL, .val = 'p'},
     {.name = "no-processes", .has_arg = no_argument, .flag = NULL, .val = 'P'},
     {.name = "reverse-abs", .has_arg = no_argument, .flag = NULL, .val = 'r'},
+#ifdef COLLECTOR_SUPPORT
+    {.name = "daemon", .has_arg = optional_argument, .flag = NULL, .val = long_option_daemon},
+    {.name = "connect", .has_arg = optional_argument, .flag = NULL, .val = long_option_connect},
+#endif
+    {.name = "shm", .has_arg = optional_argument, .flag = NULL, .val = long_option_shm},
+    {.name = "trace", .has_arg = required_argument, .flag = NULL, .val = long_option_trace},
+    {.name = "record", .has_arg = required_argument, .flag = NULL, .val = long_option_record},
+    {.name = "record-triggers", .has_arg = required_argument, .flag = NULL, .val = long_option_record_triggers},
+    {.name = "record-window", .has_arg = required_argument, .flag = NULL, .val = long_option_record_window},
+    {.name = "summary", .has_arg = optional_argument, .flag = NULL, .val = long_option_summary},
+    {.name = "idle-report", .has_arg = optional_argument, .flag = NULL, .val = long_option_idle_report},
+    {.name = "idle-threshold", .has_arg = required_argument, .flag = NULL, .val = long_option_idle_threshold},
+    {.name = "ledger", .has_arg = required_argument, .flag = NULL, .val = long_option_ledger},
+    {.name = "ledger-interval", .has_arg = required_argument, .flag = NULL, .val = long_option_ledger_interval},
+    {.name = "report", .has_arg = optional_argument, .flag = NULL, .val = long_option_report},
+    {.name = "job-env", .has_arg = required_argument, .flag = NULL, .val = long_option_job_env},
     {0, 0, 0, 0},
 };
 
 static const char opts[] = "hvd:c:CfE:pPri";
 
+// The accounting of the exited processes goes to the summary and to the idle report
+struct process_exit_reports {
+  struct process_summary *summary;
+  struct idle_report *idle_report;
+};
+
+static void record_process_exit(const struct gpu_info *device, const struct gpu_process *process,
+                                double observed_seconds, void *data) {
+  struct process_exit_reports *reports = data;
+  if (reports->summary)
+    process_summary_record(device, process, observed_seconds, reports->summary);
+  if (reports->idle_report)
+    idle_report_record(device, process, observed_seconds, reports->idle_report);
+}
+
 int main(int argc, char **argv) {
   (void)setlocale(LC_CTYPE, "");
 
@@ -103,6 +196,24 @@ int main(int argc, char **argv) {
   bool show_gpu_info_bar = false;
   double encode_decode_hide_time = -1.;
   char *custom_config_file_path = NULL;
+#ifdef COLLECTOR_SUPPORT
+  const char *daemon_endpoint = NULL;
+#endif
+  const char *connect_endpoints = NULL;
+  const char *shm_name = NULL;
+  const char *trace_path = NULL;
+  const char *record_directory = NULL;
+  const char *record_triggers = FLIGHT_RECORDER_DEFAULT_TRIGGERS;
+  double record_before = FLIGHT_RECORDER_DEFAULT_BEFORE, record_after = FLIGHT_RECORDER_DEFAULT_AFTER;
+  bool summary_option = false;
+  bool idle_report_option = false;
+  unsigned idle_report_count = IDLE_REPORT_DEFAULT_COUNT;
+  unsigned long long idle_threshold = GPUINFO_DEFAULT_IDLE_MEMORY_THRESHOLD;
+  const char *summary_path = NULL;
+  const char *ledger_path = NULL;
+  unsigned ledger_interval = USAGE_LEDGER_DEFAULT_FLUSH_INTERVAL;
+  bool report_option = false;
+  unsigned report_first_day = 0, report_last_day = UINT_MAX;
   while (true) {
     int optchar = getopt_long(argc, argv, opts, long_opts, NULL);
     if (optchar == -1)
@@ -161,6 +272,94 @@ int main(int argc, char **argv) {
     case 'r':
       reverse_plot_direction_option = true;
       break;
+#ifdef COLLECTOR_SUPPORT
+    case long_option_daemon:
+      daemon_endpoint = optarg ? optarg : collector_default_endpoint(true);
+      break;
+    case long_option_connect:
+      connect_endpoints = optarg ? optarg : collector_default_endpoint(false);
+      break;
+#endif
+    case long_option_shm:
+      shm_name = optarg ? optarg : NVTOP_SHM_DEFAULT_NAME;
+      break;
+    case long_option_trace:
+      trace_path = optarg;
+      break;
+    case long_option_record:
+      record_directory = optarg;
+      break;
+    case long_option_record_triggers:
+      record_triggers = optarg;
+      break;
+    case long_option_record_window: {
+      char *endptr = NULL;
+      record_before = strtod(optarg, &endptr);
+      if (endptr != optarg && *endptr == ':')
+        record_after = strtod(endptr + 1, &endptr);
+      if (endptr == optarg || *endptr != '\0' || record_before < 0. || record_after < 0.) {
+        fprintf(stderr, "Error: The recording window is BEFORE[:AFTER] in seconds\n");
+        exit(EXIT_FAILURE);
+      }
+    } break;
+    case long_option_summary:
+      summary_option = true;
+      summary_path = optarg;
+      break;
+    case long_option_idle_report:
+      idle_report_option = true;
+      if (optarg) {
+        char *endptr = NULL;
+        long int count = strtol(optarg, &endptr, 0);
+        if (endptr == optarg || *endptr != '\0' || count <= 0) {
+          fprintf(stderr, "Error: The idle report size must be a positive number of processes\n");
+          exit(EXIT_FAILURE);
+        }
+        idle_report_count = (unsigned)count;
+      }
+      break;
+    case long_option_idle_threshold: {
+      char *endptr = NULL;
+      double gib = strtod(optarg, &endptr);
+      if (endptr == optarg || *endptr != '\0' || gib < 0.) {
+        fprintf(stderr, "Error: The idle threshold is a size in GiB\n");
+        exit(EXIT_FAILURE);
+      }
+      idle_threshold = (unsigned long long)(gib * 1073741824.);
+      gpuinfo_set_idle_memory_threshold(idle_threshold);
+    } break;
+    case long_option_ledger:
+      ledger_path = optarg;
+      break;
+    case long_option_ledger_interval: {
+      char *endptr = NULL;
+      long int interval = strtol(optarg, &endptr, 0);
+      if (endptr == optarg || *endptr != '\0' || interval <= 0) {
+        fprintf(stderr, "Error: The ledger interval must be a positive number of seconds\n");
+        exit(EXIT_FAILURE);
+      }
+      ledger_interval = (unsigned)interval;
+    } break;
+    case long_option_report:
+      report_option = true;
+      if (optarg) {
+        char first[16] = "", last[16] = "";
+        const char *separator = strchr(optarg, ':');
+        size_t first_length = separator ? (size_t)(separator - optarg) : strlen(optarg);
+        if (first_length < sizeof(first))
+          memcpy(first, optarg, first_length);
+        if (separator && strlen(separator + 1) < sizeof(last))
+          strcpy(last, separator + 1);
+        if ((first_length && !usage_ledger_parse_day(first, &report_first_day)) ||
+            (separator && !usage_ledger_parse_day(last, &report_last_day))) {
+          fprintf(stderr, "Error: The report period is FROM[:TO] with YYYY-MM-DD dates\n");
+          exit(EXIT_FAILURE);
+        }
+      }
+      break;
+    case long_option_job_env:
+      gpuinfo_set_job_id_variables(optarg);
+      break;
     case ':':
     case '?':
       switch (optopt) {
@@ -198,14 +397,90 @@ int main(int argc, char **argv) {
     exit(EXIT_FAILURE);
   }
 
+  if (report_option) {
+    if (!ledger_path) {
+      fprintf(stderr, "Error: --report needs the --ledger file\n");
+      exit(EXIT_FAILURE);
+    }
+    return usage_ledger_report(ledger_path, report_first_day, report_last_day, stdout) ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+
+#ifdef COLLECTOR_SUPPORT
+  if (daemon_endpoint && connect_endpoints) {
+    fprintf(stderr, "Error: --daemon and --connect are mutually exclusive\n");
+    exit(EXIT_FAILURE);
+  }
+  if (daemon_endpoint) {
+    siga.sa_handler = exit_handler;
+    if (sigaction(SIGTERM, &siga, NULL) != 0) {
+      perror("Impossible to set signal handler for SIGTERM: ");
+      exit(EXIT_FAILURE);
+    }
+    return collector_daemon_run(daemon_endpoint, shm_name,
+                                update_interval_option_set ? update_interval_option : 1000, &signal_exit);
+  }
+  if (connect_endpoints)
+    collector_client_enable(connect_endpoints);
+#endif
+
+  if (ledger_path) {
+    siga.sa_handler = exit_handler;
+    if (sigaction(SIGTERM, &siga, NULL) != 0) {
+      perror("Impossible to set signal handler for SIGTERM: ");
+      exit(EXIT_FAILURE);
+    }
+    return usage_ledger_run(ledger_path, update_interval_option_set ? update_interval_option : 1000, ledger_interval,
+                            &signal_exit);
+  }
+
   unsigned allDevCount = 0;
   LIST_HEAD(monitoredGpus);
   LIST_HEAD(nonMonitoredGpus);
   if (!gpuinfo_init_info_extraction(&allDevCount, &monitoredGpus))
     return EXIT_FAILURE;
   if (allDevCount == 0) {
-    fprintf(stdout, "No GPU to monitor.\n");
-    return EXIT_SUCCESS;
+    if (connect_endpoints)
+      fprintf(stderr, "Error: No collector daemon is reachable on %s\n", connect_endpoints);
+    else
+      fprintf(stdout, "No GPU to monitor.\n");
+    return connect_endpoints ? EXIT_FAILURE : EXIT_SUCCESS;
+  }
+
+  struct shm_publisher *shm_publisher = NULL;
+  if (shm_name) {
+    shm_publisher = shm_publisher_create(shm_name);
+    if (!shm_publisher)
+      return EXIT_FAILURE;
+  }
+
+  struct trace_writer *trace_writer = NULL;
+  if (trace_path) {
+    trace_writer = trace_writer_open(trace_path);
+    if (!trace_writer) {
+      shm_publisher_destroy(shm_publisher);
+      return EXIT_FAILURE;
+    }
+  }
+
+  struct flight_recorder *flight_recorder = NULL;
+  if (record_directory) {
+    flight_recorder = flight_recorder_open(record_directory, record_triggers, record_before, record_after);
+    if (!flight_recorder) {
+      shm_publisher_destroy(shm_publisher);
+      trace_writer_close(trace_writer);
+      return EXIT_FAILURE;
+    }
+  }
+
+  struct process_summary *process_summary = NULL;
+  if (summary_option) {
+    process_summary = process_summary_open(summary_path);
+    if (!process_summary) {
+      shm_publisher_destroy(shm_publisher);
+      trace_writer_close(trace_writer);
+      flight_recorder_close(flight_recorder);
+      return EXIT_FAILURE;
+    }
   }
 
   unsigned numWarningMessages = 0;
@@ -251,6 +526,24 @@ int main(int argc, char **argv) {
     allDevicesOptions.update_interval = update_interval_option;
   allDevicesOptions.has_gpu_info_bar = allDevicesOptions.has_gpu_info_bar || show_gpu_info_bar;
 
+  struct alert_engine *alert_engine = NULL;
+  if (allDevicesOptions.alert_rules_count) {
+    alert_engine = alert_engine_create(allDevicesOptions.alert_rules_count, allDevicesOptions.alert_rules);
+    if (!alert_engine) {
+      shm_publisher_destroy(shm_publisher);
+      trace_writer_close(trace_writer);
+      flight_recorder_close(flight_recorder);
+      process_summary_close(process_summary);
+      return EXIT_FAILURE;
+    }
+  }
+
+  struct process_exit_reports process_exit_reports = {process_summary, NULL};
+  if (idle_report_option)
+    process_exit_reports.idle_report = idle_report_open(idle_report_count, idle_threshold);
+  if (process_exit_reports.summary || process_exit_reports.idle_report)
+    gpuinfo_set_process_exit_callback(record_process_exit, &process_exit_reports);
+
   gpuinfo_populate_static_infos(&monitoredGpus);
   unsigned numMonitoredGpus =
       interface_check_and_fix_monitored_gpus(allDevCount, &monitoredGpus, &nonMonitoredGpus, &allDevicesOptions);
@@ -271,15 +564,38 @@ int main(int argc, char **argv) {
   while (!signal_exit) {
     if (signal_resize_win) {
       signal_resize_win = 0;
-      update_window_size_to_terminal_size(interface);
+      interface_resize_to_terminal_size(interface);
     }
     interface_check_monitored_gpu_change(&interface, allDevCount, &numMonitoredGpus, &monitoredGpus, &nonMonitoredGpus);
     if (time_slept >= interface_update_interval(interface)) {
+      LIST_HEAD(newGpus);
+      if (gpuinfo_add_new_devices(&newGpus))
+        interface_add_devices(&interface, &allDevCount, &newGpus, &numMonitoredGpus, &monitoredGpus, &nonMonitoredGpus);
       gpuinfo_refresh_dynamic_info(&monitoredGpus);
+      uint64_t sample_time = trace_timestamp_now();
       if (!interface_freeze_processes(interface)) {
         gpuinfo_refresh_processes(&monitoredGpus);
         gpuinfo_utilisation_rate(&monitoredGpus);
+        gpuinfo_account_processes(&monitoredGpus);
         gpuinfo_fix_dynamic_info_from_process_info(&monitoredGpus);
+        interface_track_imbalance(&monitoredGpus, interface);
+      }
+      if (shm_publisher)
+        shm_publisher_publish(shm_publisher, &monitoredGpus);
+      if (trace_writer)
+        trace_writer_sample(trace_writer, &monitoredGpus, sample_time);
+      if (flight_recorder) {
+        nvtop_time now;
+        struct timespec wall_time;
+        nvtop_get_current_time(&now);
+        clock_gettime(CLOCK_REALTIME, &wall_time);
+        flight_recorder_sample(flight_recorder, &monitoredGpus, now.tv_sec + now.tv_nsec / 1e9,
+                               wall_time.tv_sec + wall_time.tv_nsec / 1e9);
+      }
+      if (alert_engine) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        alert_engine_evaluate(alert_engine, &monitoredGpus, now.tv_sec + now.tv_nsec / 1e9);
       }
       save_current_data_to_ring(&monitoredGpus, interface);
       timeout(interface_update_interval(interface));
@@ -321,6 +637,14 @@ int main(int argc, char **argv) {
     case KEY_F(12):
     case '+':
     case '-':
+    case 'g':
+    case 'u':
+    case 'c':
+    case 'J':
+    case 't':
+    case 'z':
+    case '[':
+    case ']':
       interface_key(input_char, interface);
       break;
     case 'k':
@@ -342,7 +666,14 @@ int main(int argc, char **argv) {
   }
 
   clean_ncurses(interface);
+  shm_publisher_destroy(shm_publisher);
+  trace_writer_close(trace_writer);
+  flight_recorder_close(flight_recorder);
+  alert_engine_destroy(alert_engine);
   gpuinfo_shutdown_info_extraction(&monitoredGpus);
+  // After the shutdown reported the processes still running
+  process_summary_close(process_summary);
+  idle_report_close(process_exit_reports.idle_report, stdout);
 
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,117 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "nvtop/plot_scale.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define PLOT_MAX_UNIT_PREFIXES 4
+
+static const struct {
+  double base;
+  unsigned prefix_count;
+  const char *names[PLOT_MAX_UNIT_PREFIXES];
+} plot_units[plot_unit_count] = {
+    [plot_unit_percent] = {1., 1, {"%"}},
+    [plot_unit_kib_per_second] = {1024., 4, {"KiB/s", "MiB/s", "GiB/s", "TiB/s"}},
+    [plot_unit_milliwatt] = {1000., 3, {"mW", "W", "kW"}},
+    [plot_unit_megahertz] = {1000., 2, {"MHz", "GHz"}},
+    [plot_unit_mebibyte] = {1024., 3, {"MiB", "GiB", "TiB"}},
+};
+
+enum plot_unit plot_information_unit(enum plot_information info) {
+  switch (info) {
+  case plot_pcie_rx:
+  case plot_pcie_tx:
+    return plot_unit_kib_per_second;
+  case plot_gpu_power_draw:
+    return plot_unit_milliwatt;
+  case plot_gpu_clock:
+  case plot_gpu_mem_clock:
+    return plot_unit_megahertz;
+  case plot_gpu_mem_used:
+    return plot_unit_mebibyte;
+  default:
+    return plot_unit_percent;
+  }
+}
+
+static double nice_ceiling(double value) {
+  if (value <= 1.)
+    return 1.;
+  double power = pow(10., floor(log10(value)));
+  double mantissa = value / power;
+  if (mantissa <= 1.)
+    return power;
+  if (mantissa <= 2.)
+    return 2. * power;
+  if (mantissa <= 2.5)
+    return 2.5 * power;
+  if (mantissa <= 5.)
+    return 5. * power;
+  return 10. * power;
+}
+
+void plot_autoscale(enum plot_unit unit, double max_value, struct plot_scale *scale) {
+  if (unit == plot_unit_percent) {
+    scale->full_scale = 100.;
+    scale->display_factor = 1.;
+    scale->unit_name = plot_units[unit].names[0];
+    return;
+  }
+  double factor = 1.;
+  unsigned prefix = 0;
+  double rounded = nice_ceiling(max_value);
+  while (rounded >= 1000. && prefix + 1 < plot_units[unit].prefix_count) {
+    factor /= plot_units[unit].base;
+    prefix++;
+    rounded = nice_ceiling(max_value * factor);
+  }
+  scale->full_scale = rounded / factor;
+  scale->display_factor = factor;
+  scale->unit_name = plot_units[unit].names[prefix];
+}
+
+void plot_axis_label(double value, char label[PLOT_Y_LABEL_SIZE]) {
+  if (value >= 999.5) {
+    snprintf(label, PLOT_Y_LABEL_SIZE, "%.0fk", fmin(value / 1000., 99.));
+  } else if (value >= 9.95 || fabs(value - nearbyint(value)) < .05) {
+    snprintf(label, PLOT_Y_LABEL_SIZE, "%.0f", value);
+  } else if (value >= 1.) {
+    snprintf(label, PLOT_Y_LABEL_SIZE, "%.1f", value);
+  } else {
+    // Drop the leading zero of the fractions
+    char fraction[8];
+    snprintf(fraction, sizeof(fraction), "%.2f", value);
+    size_t length = strlen(fraction);
+    while (length > 2 && fraction[length - 1] == '0')
+      fraction[--length] = '\0';
+    snprintf(label, PLOT_Y_LABEL_SIZE, "%s", fraction + 1);
+  }
+}
+
+void plot_y_labels(const struct plot_scale *scale, char labels[PLOT_Y_LABELS][PLOT_Y_LABEL_SIZE]) {
+  double top = scale->full_scale * scale->display_factor;
+  for (unsigned i = 0; i < PLOT_Y_LABELS; ++i)
+    plot_axis_label(top * (PLOT_Y_LABELS - 1 - i) / (PLOT_Y_LABELS - 1), labels[i]);
+}
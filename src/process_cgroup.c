@@ -0,0 +1,155 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "nvtop/process_cgroup.h"
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#define CONTAINER_SHORT_ID_LEN 12
+
+// Scope names given to the containers by the runtimes using the systemd cgroup driver
+static const struct {
+  const char *prefix;
+  const char *runtime;
+} container_scopes[] = {
+    {"docker-", "docker"},
+    {"cri-containerd-", "containerd"},
+    {"crio-", "crio"},
+    {"libpod-", "podman"},
+};
+
+static bool has_suffix(const char *component, size_t length, const char *suffix) {
+  size_t suffix_length = strlen(suffix);
+  return length >= suffix_length && strncmp(&component[length - suffix_length], suffix, suffix_length) == 0;
+}
+
+static bool component_is(const char *component, size_t length, const char *name) {
+  return length == strlen(name) && strncmp(component, name, length) == 0;
+}
+
+static bool is_container_id(const char *component, size_t length) {
+  if (length != 64)
+    return false;
+  for (size_t i = 0; i < length; ++i) {
+    if (!isxdigit((unsigned char)component[i]))
+      return false;
+  }
+  return true;
+}
+
+void process_cgroup_label(const char *path, char *label, size_t size) {
+  const char *pod = NULL, *container = NULL, *runtime = "container", *unit = NULL, *last = NULL;
+  size_t pod_length = 0, unit_length = 0, last_length = 0;
+  bool in_kubepods = false, in_docker = false;
+
+  for (const char *component = path; *component;) {
+    size_t length = strcspn(component, "/");
+    if (!length) {
+      component++;
+      continue;
+    }
+    last = component;
+    last_length = length;
+
+    if (strncmp(component, "kubepods", strlen("kubepods")) == 0)
+      in_kubepods = true;
+    if (component_is(component, length, "docker"))
+      in_docker = true;
+    const char *pod_marker = NULL;
+    if (in_kubepods) {
+      // kubepods-burstable-pod<uid>.slice with the systemd driver, pod<uid> with cgroupfs
+      const char *systemd_pod = strstr(component, "-pod");
+      if (systemd_pod && systemd_pod < component + length)
+        pod_marker = systemd_pod + strlen("-pod");
+      else if (strncmp(component, "pod", strlen("pod")) == 0)
+        pod_marker = component + strlen("pod");
+    }
+    if (pod_marker) {
+      pod = pod_marker;
+      pod_length = length - (size_t)(pod_marker - component);
+      if (has_suffix(pod, pod_length, ".slice"))
+        pod_length -= strlen(".slice");
+    } else if ((in_kubepods || in_docker) && is_container_id(component, length)) {
+      container = component;
+      runtime = in_docker ? "docker" : "container";
+    } else if (has_suffix(component, length, ".scope") || has_suffix(component, length, ".service")) {
+      bool is_container = false;
+      for (size_t i = 0; !is_container && i < sizeof(container_scopes) / sizeof(*container_scopes); ++i) {
+        size_t prefix_length = strlen(container_scopes[i].prefix);
+        if (strncmp(component, container_scopes[i].prefix, prefix_length) == 0) {
+          container = component + prefix_length;
+          runtime = container_scopes[i].runtime;
+          is_container = true;
+        }
+      }
+      if (!is_container) {
+        unit = component;
+        unit_length = length;
+      }
+    }
+    component += length;
+  }
+
+  if (pod) {
+    int written = snprintf(label, size, "pod:%.*s", (int)pod_length, pod);
+    // The systemd driver escapes the dashes of the UID
+    for (int i = (int)strlen("pod:"); i < written && (size_t)i < size; ++i) {
+      if (label[i] == '_')
+        label[i] = '-';
+    }
+  } else if (container) {
+    snprintf(label, size, "%s:%.*s", runtime, CONTAINER_SHORT_ID_LEN, container);
+  } else if (unit) {
+    snprintf(label, size, "%.*s", (int)unit_length, unit);
+  } else if (last) {
+    snprintf(label, size, "%.*s", (int)last_length, last);
+  } else {
+    snprintf(label, size, "/");
+  }
+}
+
+bool process_cgroup_job_id(const char *path, char *job_id, size_t size) {
+  bool in_slurm = false, in_pbs = false;
+  for (const char *component = path; *component;) {
+    size_t length = strcspn(component, "/");
+    if (!length) {
+      component++;
+      continue;
+    }
+    if (strncmp(component, "slurm", strlen("slurm")) == 0)
+      in_slurm = true;
+    else if (component_is(component, length, "pbs_jobs.service") || component_is(component, length, "pbspro") ||
+             component_is(component, length, "torque"))
+      in_pbs = true;
+    else if (in_slurm && length > strlen("job_") && strncmp(component, "job_", strlen("job_")) == 0) {
+      snprintf(job_id, size, "%.*s", (int)(length - strlen("job_")), component + strlen("job_"));
+      return true;
+    } else if (in_pbs && isdigit((unsigned char)component[0])) {
+      snprintf(job_id, size, "%.*s", (int)length, component);
+      return true;
+    }
+    component += length;
+  }
+  return false;
+}
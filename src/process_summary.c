@@ -0,0 +1,116 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "nvtop/process_summary.h"
+#include "nvtop/common.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PROCESS_SUMMARY_ROW_LEN 256
+#define PROCESS_SUMMARY_ROWS_INC 64
+
+struct process_summary {
+  FILE *file; // NULL when the table goes to the standard output
+  unsigned rows_count, rows_size;
+  char (*rows)[PROCESS_SUMMARY_ROW_LEN];
+};
+
+static const char process_summary_header[] = "    PID DEVICE           USER        OBSERVED  GPU TIME AVG GPU   PEAK MEM"
+                                             "     ENERGY COMMAND\n";
+
+struct process_summary *process_summary_open(const char *path) {
+  struct process_summary *summary = calloc(1, sizeof(*summary));
+  if (!summary) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  if (path) {
+    summary->file = fopen(path, "w");
+    if (!summary->file) {
+      fprintf(stderr, "Cannot open the summary file %s: %s\n", path, strerror(errno));
+      free(summary);
+      return NULL;
+    }
+    fputs(process_summary_header, summary->file);
+    fflush(summary->file);
+  }
+  return summary;
+}
+
+static void format_seconds(char *buffer, size_t size, double seconds) {
+  if (seconds < 60.)
+    snprintf(buffer, size, "%.1fs", seconds);
+  else if (seconds < 3600.)
+    snprintf(buffer, size, "%um%02us", (unsigned)seconds / 60, (unsigned)seconds % 60);
+  else
+    snprintf(buffer, size, "%uh%02um", (unsigned)seconds / 3600, (unsigned)seconds / 60 % 60);
+}
+
+void process_summary_record(const struct gpu_info *device, const struct gpu_process *process, double observed_seconds,
+                            void *data) {
+  struct process_summary *summary = data;
+  char observed[16], gpu_time[16] = "N/A", average[8] = "N/A", peak[24] = "N/A", energy[24] = "N/A";
+  format_seconds(observed, sizeof(observed), observed_seconds);
+  if (GPUINFO_PROCESS_FIELD_VALID(process, gpu_time))
+    format_seconds(gpu_time, sizeof(gpu_time), (double)process->gpu_time / 1e9);
+  if (GPUINFO_PROCESS_FIELD_VALID(process, gpu_usage_average))
+    snprintf(average, sizeof(average), "%u%%", process->gpu_usage_average);
+  if (GPUINFO_PROCESS_FIELD_VALID(process, gpu_memory_peak))
+    snprintf(peak, sizeof(peak), "%lluMiB", process->gpu_memory_peak / 1048576ull);
+  if (GPUINFO_PROCESS_FIELD_VALID(process, energy))
+    snprintf(energy, sizeof(energy), "%lluJ", process->energy / 1000ull);
+
+  char row[PROCESS_SUMMARY_ROW_LEN];
+  snprintf(row, sizeof(row), "%7d %-16s %-10.10s %9s %9s %7s %10s %10s %.120s\n", (int)process->pid, device->pdev,
+           GPUINFO_PROCESS_FIELD_VALID(process, user_name) ? process->user_name : "N/A", observed, gpu_time, average,
+           peak, energy, GPUINFO_PROCESS_FIELD_VALID(process, cmdline) ? process->cmdline : "");
+  if (summary->file) {
+    fputs(row, summary->file);
+    fflush(summary->file);
+    return;
+  }
+  if (summary->rows_count == summary->rows_size) {
+    summary->rows_size += PROCESS_SUMMARY_ROWS_INC;
+    summary->rows = reallocarray(summary->rows, summary->rows_size, sizeof(*summary->rows));
+    if (!summary->rows) {
+      perror("Could not re-allocate memory: ");
+      exit(EXIT_FAILURE);
+    }
+  }
+  memcpy(summary->rows[summary->rows_count++], row, sizeof(row));
+}
+
+void process_summary_close(struct process_summary *summary) {
+  if (!summary)
+    return;
+  if (summary->file) {
+    fclose(summary->file);
+  } else if (summary->rows_count) {
+    fputs(process_summary_header, stdout);
+    for (unsigned i = 0; i < summary->rows_count; ++i)
+      fputs(summary->rows[i], stdout);
+  }
+  free(summary->rows);
+  free(summary);
+}
@@ -0,0 +1,197 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "nvtop/shm_publisher.h"
+#include "nvtop/extract_gpuinfo_common.h"
+#include "nvtop/shm_snapshot.h"
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+_Static_assert(sizeof(struct nvtop_shm_device) == 168, "The shared memory layout changed, bump its version");
+_Static_assert(sizeof(struct nvtop_shm_process) == 56, "The shared memory layout changed, bump its version");
+
+struct shm_publisher {
+  char *name;
+  struct nvtop_shm_segment *segment;
+};
+
+// True if the segment was left behind by an nvtop that is not running anymore
+static bool shm_segment_abandoned(const char *name) {
+  const struct nvtop_shm_segment *segment = nvtop_shm_open(name);
+  if (!segment)
+    return false;
+  bool abandoned = kill(segment->publisher_pid, 0) < 0 && errno == ESRCH;
+  nvtop_shm_close(segment);
+  return abandoned;
+}
+
+struct shm_publisher *shm_publisher_create(const char *name) {
+  // Readers must never map a segment of another layout or a half initialized one: start from a new segment, without
+  // taking over the one of another publisher
+  int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0644);
+  if (fd < 0 && errno == EEXIST && shm_segment_abandoned(name)) {
+    shm_unlink(name);
+    fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0644);
+  }
+  if (fd < 0) {
+    if (errno == EEXIST)
+      fprintf(stderr, "The shared memory segment %s is in use, pick another name or remove /dev/shm%s\n", name, name);
+    else
+      fprintf(stderr, "Cannot create the shared memory segment %s: %s\n", name, strerror(errno));
+    return NULL;
+  }
+  if (ftruncate(fd, sizeof(struct nvtop_shm_segment)) < 0) {
+    fprintf(stderr, "Cannot resize the shared memory segment %s: %s\n", name, strerror(errno));
+    close(fd);
+    shm_unlink(name);
+    return NULL;
+  }
+  void *mapping = mmap(NULL, sizeof(struct nvtop_shm_segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    fprintf(stderr, "Cannot map the shared memory segment %s: %s\n", name, strerror(errno));
+    shm_unlink(name);
+    return NULL;
+  }
+
+  struct shm_publisher *publisher = malloc(sizeof(*publisher));
+  if (!publisher) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  publisher->name = strdup(name);
+  publisher->segment = mapping;
+  struct nvtop_shm_segment *segment = publisher->segment;
+  segment->layout_version = NVTOP_SHM_LAYOUT_VERSION;
+  segment->segment_size = sizeof(struct nvtop_shm_segment);
+  segment->device_size = sizeof(struct nvtop_shm_device);
+  segment->process_size = sizeof(struct nvtop_shm_process);
+  segment->max_devices = NVTOP_SHM_MAX_DEVICES;
+  segment->max_processes = NVTOP_SHM_MAX_PROCESSES;
+  segment->publisher_pid = getpid();
+  // The magic goes last, readers check it to detect an initialized segment
+  __atomic_store_n(&segment->magic, NVTOP_SHM_MAGIC, __ATOMIC_RELEASE);
+  return publisher;
+}
+
+#define SHM_COPY_DEVICE_FIELD(shm_device, shm_field, dynamic_info, field)                                              \
+  do {                                                                                                                 \
+    if (GPUINFO_DYNAMIC_FIELD_VALID(dynamic_info, field)) {                                                            \
+      (shm_device)->shm_field = (dynamic_info)->field;                                                                 \
+      (shm_device)->valid |= nvtop_shm_device_##shm_field;                                                             \
+    }                                                                                                                  \
+  } while (0)
+
+static void fill_device(struct nvtop_shm_device *shm_device, const struct gpu_info *device) {
+  memset(shm_device, 0, sizeof(*shm_device));
+  strncpy(shm_device->pdev, device->pdev, sizeof(shm_device->pdev) - 1);
+  if (GPUINFO_STATIC_FIELD_VALID(&device->static_info, device_name)) {
+    strncpy(shm_device->name, device->static_info.device_name, sizeof(shm_device->name) - 1);
+    shm_device->valid |= nvtop_shm_device_name;
+  }
+  const struct gpuinfo_dynamic_info *dynamic_info = &device->dynamic_info;
+  SHM_COPY_DEVICE_FIELD(shm_device, gpu_clock, dynamic_info, gpu_clock_speed);
+  SHM_COPY_DEVICE_FIELD(shm_device, mem_clock, dynamic_info, mem_clock_speed);
+  SHM_COPY_DEVICE_FIELD(shm_device, gpu_util, dynamic_info, gpu_util_rate);
+  SHM_COPY_DEVICE_FIELD(shm_device, mem_util, dynamic_info, mem_util_rate);
+  SHM_COPY_DEVICE_FIELD(shm_device, encoder_util, dynamic_info, encoder_rate);
+  SHM_COPY_DEVICE_FIELD(shm_device, decoder_util, dynamic_info, decoder_rate);
+  SHM_COPY_DEVICE_FIELD(shm_device, temperature, dynamic_info, gpu_temp);
+  SHM_COPY_DEVICE_FIELD(shm_device, fan_speed, dynamic_info, fan_speed);
+  SHM_COPY_DEVICE_FIELD(shm_device, power_draw, dynamic_info, power_draw);
+  SHM_COPY_DEVICE_FIELD(shm_device, power_draw_max, dynamic_info, power_draw_max);
+  SHM_COPY_DEVICE_FIELD(shm_device, pcie_rx, dynamic_info, pcie_rx);
+  SHM_COPY_DEVICE_FIELD(shm_device, pcie_tx, dynamic_info, pcie_tx);
+  SHM_COPY_DEVICE_FIELD(shm_device, total_memory, dynamic_info, total_memory);
+  SHM_COPY_DEVICE_FIELD(shm_device, used_memory, dynamic_info, used_memory);
+  SHM_COPY_DEVICE_FIELD(shm_device, free_memory, dynamic_info, free_memory);
+}
+
+#define SHM_COPY_PROCESS_FIELD(shm_process, shm_field, process, field)                                                   \
+  do {                                                                                                                 \
+    if (GPUINFO_PROCESS_FIELD_VALID(process, field)) {                                                                 \
+      (shm_process)->shm_field = (process)->field;                                                                     \
+      (shm_process)->valid |= nvtop_shm_process_##shm_field;                                                           \
+    }                                                                                                                  \
+  } while (0)
+
+static void fill_process(struct nvtop_shm_process *shm_process, unsigned device_index,
+                         const struct gpu_process *process) {
+  memset(shm_process, 0, sizeof(*shm_process));
+  shm_process->pid = process->pid;
+  shm_process->device_index = device_index;
+  if (process->type & gpu_process_graphical)
+    shm_process->type |= nvtop_shm_process_graphical;
+  if (process->type & gpu_process_compute)
+    shm_process->type |= nvtop_shm_process_compute;
+  SHM_COPY_PROCESS_FIELD(shm_process, gpu_util, process, gpu_usage);
+  SHM_COPY_PROCESS_FIELD(shm_process, encoder_util, process, encode_usage);
+  SHM_COPY_PROCESS_FIELD(shm_process, decoder_util, process, decode_usage);
+  SHM_COPY_PROCESS_FIELD(shm_process, gpu_memory, process, gpu_memory_usage);
+  SHM_COPY_PROCESS_FIELD(shm_process, gpu_memory_percentage, process, gpu_memory_percentage);
+  SHM_COPY_PROCESS_FIELD(shm_process, cpu_util, process, cpu_usage);
+  SHM_COPY_PROCESS_FIELD(shm_process, cpu_memory, process, cpu_memory_res);
+}
+
+void shm_publisher_publish(struct shm_publisher *publisher, struct list_head *devices) {
+  struct nvtop_shm_segment *segment = publisher->segment;
+  uint64_t sequence = __atomic_load_n(&segment->sequence, __ATOMIC_RELAXED);
+  // Odd sequence: readers wait or retry until the update is done
+  __atomic_store_n(&segment->sequence, sequence + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
+  unsigned devices_count = 0, processes_count = 0;
+  struct gpu_info *device;
+  list_for_each_entry(device, devices, list) {
+    if (devices_count == NVTOP_SHM_MAX_DEVICES)
+      break;
+    struct nvtop_shm_device *shm_device = &segment->devices[devices_count];
+    fill_device(shm_device, device);
+    shm_device->processes_offset = processes_count;
+    for (unsigned i = 0; i < device->processes_count && processes_count < NVTOP_SHM_MAX_PROCESSES; ++i) {
+      fill_process(&segment->processes[processes_count++], devices_count, &device->processes[i]);
+    }
+    shm_device->processes_count = processes_count - shm_device->processes_offset;
+    devices_count++;
+  }
+  segment->devices_count = devices_count;
+  segment->processes_count = processes_count;
+  struct timespec now;
+  clock_gettime(CLOCK_REALTIME, &now);
+  segment->update_time_ns = (uint64_t)now.tv_sec * UINT64_C(1000000000) + (uint64_t)now.tv_nsec;
+
+  __atomic_store_n(&segment->sequence, sequence + 2, __ATOMIC_RELEASE);
+}
+
+void shm_publisher_destroy(struct shm_publisher *publisher) {
+  if (!publisher)
+    return;
+  munmap(publisher->segment, sizeof(*publisher->segment));
+  shm_unlink(publisher->name);
+  free(publisher->name);
+  free(publisher);
+}
@@ -0,0 +1,474 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "nvtop/trace_export.h"
+#include "nvtop/extract_gpuinfo_common.h"
+#include "nvtop/json_util.h"
+#include "uthash.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// The events are written as they come and only the running processes are remembered, the memory used does not grow
+// with the length of the capture.
+
+enum trace_format {
+  trace_format_json,
+  trace_format_perfetto,
+};
+
+enum trace_metric {
+  trace_metric_gpu_util,
+  trace_metric_mem_util,
+  trace_metric_encoder,
+  trace_metric_decoder,
+  trace_metric_used_memory,
+  trace_metric_power,
+  trace_metric_temperature,
+  trace_metric_gpu_clock,
+  trace_metric_energy,
+  trace_metric_count,
+};
+
+static const char *trace_metric_names[trace_metric_count] = {
+    "GPU utilization (%)", "Memory controller utilization (%)",
+    "Encoder utilization (%)", "Decoder utilization (%)",
+    "Memory used (MiB)", "Power (W)",
+    "Temperature (C)", "GPU clock (MHz)",
+    "Energy used (J)",
+};
+
+struct traced_device {
+  const struct gpu_info *device;
+  unsigned id;
+  UT_hash_handle hh;
+};
+
+struct traced_process_key {
+  unsigned device_id;
+  pid_t pid;
+};
+
+struct traced_process {
+  struct traced_process_key key;
+  uint64_t track_uuid;
+  uint64_t last_sample; // Sample in which the process was last seen running
+  UT_hash_handle hh;
+};
+
+struct trace_writer {
+  FILE *file;
+  char *path;
+  int write_error; // errno of the first failed write, reported on close
+  enum trace_format format;
+  bool first_json_event;
+  unsigned devices_count;
+  struct traced_device *devices;
+  struct traced_process *processes;
+  uint64_t sample;
+  uint64_t next_process_uuid;
+};
+
+// Track uuids: each device owns a range holding its own track followed by one counter track per metric, the process
+// tracks come after all the device ranges
+#define TRACE_DEVICE_TRACK_UUID(device_id) (UINT64_C(1) + (uint64_t)(device_id) * (trace_metric_count + 1))
+#define TRACE_METRIC_TRACK_UUID(device_id, metric) (TRACE_DEVICE_TRACK_UUID(device_id) + 1 + (metric))
+#define TRACE_FIRST_PROCESS_UUID (UINT64_C(1) << 32)
+#define TRACE_MAX_NAME_LENGTH 256
+
+uint64_t trace_timestamp_now(void) {
+  struct timespec now;
+#ifdef CLOCK_BOOTTIME
+  clock_gettime(CLOCK_BOOTTIME, &now);
+#else
+  clock_gettime(CLOCK_MONOTONIC, &now);
+#endif
+  return (uint64_t)now.tv_sec * UINT64_C(1000000000) + (uint64_t)now.tv_nsec;
+}
+
+/*
+ *
+ * Perfetto protobuf encoding of the few messages used (perfetto/trace/trace_packet.proto)
+ *
+ */
+
+#define PB_BUFFER_SIZE 1024
+
+enum pb_wire_type {
+  pb_wire_varint = 0,
+  pb_wire_fixed64 = 1,
+  pb_wire_length_delimited = 2,
+};
+
+// TracePacket fields
+#define PB_PACKET_TIMESTAMP 8
+#define PB_PACKET_SEQUENCE_ID 10
+#define PB_PACKET_TRACK_EVENT 11
+#define PB_PACKET_SEQUENCE_FLAGS 13
+#define PB_PACKET_TRACK_DESCRIPTOR 60
+// TrackDescriptor fields
+#define PB_TRACK_UUID 1
+#define PB_TRACK_NAME 2
+#define PB_TRACK_PARENT_UUID 5
+#define PB_TRACK_COUNTER 8
+// TrackEvent fields
+#define PB_EVENT_TYPE 9
+#define PB_EVENT_TRACK_UUID 11
+#define PB_EVENT_NAME 23
+#define PB_EVENT_DOUBLE_COUNTER_VALUE 44
+
+enum pb_track_event_type {
+  pb_event_slice_begin = 1,
+  pb_event_slice_end = 2,
+  pb_event_counter = 4,
+};
+
+#define PB_SEQUENCE_ID 1
+#define PB_SEQ_INCREMENTAL_STATE_CLEARED 1
+
+struct pb_buffer {
+  size_t size;
+  unsigned char data[PB_BUFFER_SIZE];
+};
+
+static void pb_varint(struct pb_buffer *buffer, uint64_t value) {
+  do {
+    unsigned char byte = value & 0x7f;
+    value >>= 7;
+    if (value)
+      byte |= 0x80;
+    if (buffer->size < PB_BUFFER_SIZE)
+      buffer->data[buffer->size++] = byte;
+  } while (value);
+}
+
+static void pb_uint(struct pb_buffer *buffer, unsigned field, uint64_t value) {
+  pb_varint(buffer, (uint64_t)field << 3 | pb_wire_varint);
+  pb_varint(buffer, value);
+}
+
+static void pb_double(struct pb_buffer *buffer, unsigned field, double value) {
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  pb_varint(buffer, (uint64_t)field << 3 | pb_wire_fixed64);
+  // Little endian on the wire
+  for (unsigned i = 0; i < 8 && buffer->size < PB_BUFFER_SIZE; ++i)
+    buffer->data[buffer->size++] = (bits >> (8 * i)) & 0xff;
+}
+
+static void pb_bytes(struct pb_buffer *buffer, unsigned field, const void *data, size_t size) {
+  pb_varint(buffer, (uint64_t)field << 3 | pb_wire_length_delimited);
+  pb_varint(buffer, size);
+  if (buffer->size + size > PB_BUFFER_SIZE)
+    return;
+  memcpy(&buffer->data[buffer->size], data, size);
+  buffer->size += size;
+}
+
+static void pb_string(struct pb_buffer *buffer, unsigned field, const char *string) {
+  size_t length = strlen(string);
+  pb_bytes(buffer, field, string, length > TRACE_MAX_NAME_LENGTH ? TRACE_MAX_NAME_LENGTH : length);
+}
+
+static void pb_write_packet(struct trace_writer *writer, uint64_t timestamp, unsigned field,
+                            const struct pb_buffer *content) {
+  struct pb_buffer packet = {0};
+  if (timestamp)
+    pb_uint(&packet, PB_PACKET_TIMESTAMP, timestamp);
+  pb_uint(&packet, PB_PACKET_SEQUENCE_ID, PB_SEQUENCE_ID);
+  pb_bytes(&packet, field, content->data, content->size);
+  // A Trace message is the concatenation of its packets, field 1
+  struct pb_buffer header = {0};
+  pb_varint(&header, 1 << 3 | pb_wire_length_delimited);
+  pb_varint(&header, packet.size);
+  if ((fwrite(header.data, 1, header.size, writer->file) != header.size ||
+       fwrite(packet.data, 1, packet.size, writer->file) != packet.size) &&
+      !writer->write_error)
+    writer->write_error = errno;
+}
+
+static void pb_write_track(struct trace_writer *writer, uint64_t uuid, uint64_t parent_uuid, const char *name,
+                           bool counter) {
+  struct pb_buffer track = {0};
+  pb_uint(&track, PB_TRACK_UUID, uuid);
+  if (parent_uuid)
+    pb_uint(&track, PB_TRACK_PARENT_UUID, parent_uuid);
+  pb_string(&track, PB_TRACK_NAME, name);
+  if (counter)
+    pb_bytes(&track, PB_TRACK_COUNTER, NULL, 0);
+  pb_write_packet(writer, 0, PB_PACKET_TRACK_DESCRIPTOR, &track);
+}
+
+static void pb_write_event(struct trace_writer *writer, uint64_t timestamp, enum pb_track_event_type type,
+                           uint64_t track_uuid, const char *name, double value) {
+  struct pb_buffer event = {0};
+  pb_uint(&event, PB_EVENT_TYPE, type);
+  pb_uint(&event, PB_EVENT_TRACK_UUID, track_uuid);
+  if (name)
+    pb_string(&event, PB_EVENT_NAME, name);
+  if (type == pb_event_counter)
+    pb_double(&event, PB_EVENT_DOUBLE_COUNTER_VALUE, value);
+  pb_write_packet(writer, timestamp, PB_PACKET_TRACK_EVENT, &event);
+}
+
+/*
+ *
+ * Chrome JSON trace event format
+ *
+ */
+
+static void json_begin_event(struct trace_writer *writer) {
+  fputs(writer->first_json_event ? "\n" : ",\n", writer->file);
+  writer->first_json_event = false;
+}
+
+// Devices are shown as processes and the GPU processes as their threads
+static void json_write_name(struct trace_writer *writer, const char *kind, unsigned device_id, pid_t pid,
+                            const char *name) {
+  json_begin_event(writer);
+  fprintf(writer->file, "{\"ph\":\"M\",\"name\":\"%s\",\"pid\":%u,\"tid\":%d,\"args\":{\"name\":", kind,
+          device_id + 1, (int)pid);
+  json_write_string(writer->file, name, TRACE_MAX_NAME_LENGTH);
+  fputs("}}", writer->file);
+}
+
+static void json_write_counter(struct trace_writer *writer, uint64_t timestamp, unsigned device_id,
+                               enum trace_metric metric, double value) {
+  json_begin_event(writer);
+  fprintf(writer->file, "{\"ph\":\"C\",\"name\":\"%s\",\"pid\":%u,\"ts\":%.3f,\"args\":{\"value\":%.2f}}",
+          trace_metric_names[metric], device_id + 1, timestamp / 1000., value);
+}
+
+static void json_write_slice(struct trace_writer *writer, uint64_t timestamp, bool begin, unsigned device_id,
+                             pid_t pid, const char *name) {
+  json_begin_event(writer);
+  fprintf(writer->file, "{\"ph\":\"%c\",\"pid\":%u,\"tid\":%d,\"ts\":%.3f", begin ? 'B' : 'E', device_id + 1,
+          (int)pid, timestamp / 1000.);
+  if (name) {
+    fputs(",\"name\":", writer->file);
+    json_write_string(writer->file, name, TRACE_MAX_NAME_LENGTH);
+  }
+  fputc('}', writer->file);
+}
+
+/*
+ *
+ * Format independent part
+ *
+ */
+
+struct trace_writer *trace_writer_open(const char *path) {
+  FILE *file = fopen(path, "wb");
+  if (!file) {
+    fprintf(stderr, "Cannot open the trace file %s: %s\n", path, strerror(errno));
+    return NULL;
+  }
+  struct trace_writer *writer = calloc(1, sizeof(*writer));
+  if (!writer) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  writer->file = file;
+  writer->path = strdup(path);
+  if (!writer->path) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  writer->next_process_uuid = TRACE_FIRST_PROCESS_UUID;
+  size_t length = strlen(path);
+  const char *pftrace = ".pftrace", *perfetto_trace = ".perfetto-trace";
+  if ((length >= strlen(pftrace) && !strcmp(path + length - strlen(pftrace), pftrace)) ||
+      (length >= strlen(perfetto_trace) && !strcmp(path + length - strlen(perfetto_trace), perfetto_trace)))
+    writer->format = trace_format_perfetto;
+  else
+    writer->format = trace_format_json;
+
+  if (writer->format == trace_format_json) {
+    // Timestamps are CLOCK_BOOTTIME microseconds, like the Perfetto traces
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", file);
+    writer->first_json_event = true;
+  } else {
+    struct pb_buffer clear = {0};
+    pb_uint(&clear, PB_PACKET_SEQUENCE_ID, PB_SEQUENCE_ID);
+    pb_uint(&clear, PB_PACKET_SEQUENCE_FLAGS, PB_SEQ_INCREMENTAL_STATE_CLEARED);
+    struct pb_buffer header = {0};
+    pb_varint(&header, 1 << 3 | pb_wire_length_delimited);
+    pb_varint(&header, clear.size);
+    if (fwrite(header.data, 1, header.size, file) != header.size ||
+        fwrite(clear.data, 1, clear.size, file) != clear.size)
+      writer->write_error = errno;
+  }
+  return writer;
+}
+
+static unsigned trace_device_id(struct trace_writer *writer, const struct gpu_info *device) {
+  struct traced_device *traced;
+  HASH_FIND_PTR(writer->devices, &device, traced);
+  if (traced)
+    return traced->id;
+  traced = malloc(sizeof(*traced));
+  if (!traced) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  traced->device = device;
+  traced->id = writer->devices_count++;
+  HASH_ADD_PTR(writer->devices, device, traced);
+
+  char name[TRACE_MAX_NAME_LENGTH];
+  snprintf(name, sizeof(name), "GPU %u: %.200s", traced->id,
+           GPUINFO_STATIC_FIELD_VALID(&device->static_info, device_name) ? device->static_info.device_name
+                                                                        : device->pdev);
+  if (writer->format == trace_format_json) {
+    json_write_name(writer, "process_name", traced->id, 0, name);
+  } else {
+    pb_write_track(writer, TRACE_DEVICE_TRACK_UUID(traced->id), 0, name, false);
+    for (enum trace_metric metric = 0; metric < trace_metric_count; ++metric)
+      pb_write_track(writer, TRACE_METRIC_TRACK_UUID(traced->id, metric), TRACE_DEVICE_TRACK_UUID(traced->id),
+                     trace_metric_names[metric], true);
+  }
+  return traced->id;
+}
+
+static void trace_counter(struct trace_writer *writer, uint64_t timestamp, unsigned device_id,
+                          enum trace_metric metric, double value) {
+  if (writer->format == trace_format_json)
+    json_write_counter(writer, timestamp, device_id, metric, value);
+  else
+    pb_write_event(writer, timestamp, pb_event_counter, TRACE_METRIC_TRACK_UUID(device_id, metric), NULL, value);
+}
+
+static void trace_device_counters(struct trace_writer *writer, uint64_t timestamp, unsigned device_id,
+                                  const struct gpuinfo_dynamic_info *dynamic_info) {
+  if (GPUINFO_DYNAMIC_FIELD_VALID(dynamic_info, gpu_util_rate))
+    trace_counter(writer, timestamp, device_id, trace_metric_gpu_util, dynamic_info->gpu_util_rate);
+  if (GPUINFO_DYNAMIC_FIELD_VALID(dynamic_info, mem_util_rate))
+    trace_counter(writer, timestamp, device_id, trace_metric_mem_util, dynamic_info->mem_util_rate);
+  if (GPUINFO_DYNAMIC_FIELD_VALID(dynamic_info, encoder_rate))
+    trace_counter(writer, timestamp, device_id, trace_metric_encoder, dynamic_info->encoder_rate);
+  if (GPUINFO_DYNAMIC_FIELD_VALID(dynamic_info, decoder_rate))
+    trace_counter(writer, timestamp, device_id, trace_metric_decoder, dynamic_info->decoder_rate);
+  if (GPUINFO_DYNAMIC_FIELD_VALID(dynamic_info, used_memory))
+    trace_counter(writer, timestamp, device_id, trace_metric_used_memory,
+                  (double)dynamic_info->used_memory / (1024. * 1024.));
+  if (GPUINFO_DYNAMIC_FIELD_VALID(dynamic_info, power_draw))
+    trace_counter(writer, timestamp, device_id, trace_metric_power, dynamic_info->power_draw / 1000.);
+  if (GPUINFO_DYNAMIC_FIELD_VALID(dynamic_info, gpu_temp))
+    trace_counter(writer, timestamp, device_id, trace_metric_temperature, dynamic_info->gpu_temp);
+  if (GPUINFO_DYNAMIC_FIELD_VALID(dynamic_info, gpu_clock_speed))
+    trace_counter(writer, timestamp, device_id, trace_metric_gpu_clock, dynamic_info->gpu_clock_speed);
+  if (GPUINFO_DYNAMIC_FIELD_VALID(dynamic_info, energy_consumed))
+    trace_counter(writer, timestamp, device_id, trace_metric_energy, dynamic_info->energy_consumed / 1000.);
+}
+
+static void trace_process_start(struct trace_writer *writer, uint64_t timestamp, struct traced_process *traced,
+                                const struct gpu_process *process) {
+  char name[TRACE_MAX_NAME_LENGTH];
+  snprintf(name, sizeof(name), "%d %.200s", (int)process->pid,
+           GPUINFO_PROCESS_FIELD_VALID(process, cmdline) ? process->cmdline : "");
+  if (writer->format == trace_format_json) {
+    json_write_name(writer, "thread_name", traced->key.device_id, process->pid, name);
+    json_write_slice(writer, timestamp, true, traced->key.device_id, process->pid, name);
+  } else {
+    traced->track_uuid = writer->next_process_uuid++;
+    pb_write_track(writer, traced->track_uuid, TRACE_DEVICE_TRACK_UUID(traced->key.device_id), name, false);
+    pb_write_event(writer, timestamp, pb_event_slice_begin, traced->track_uuid, name, 0.);
+  }
+}
+
+static void trace_process_end(struct trace_writer *writer, uint64_t timestamp, const struct traced_process *traced) {
+  if (writer->format == trace_format_json)
+    json_write_slice(writer, timestamp, false, traced->key.device_id, traced->key.pid, NULL);
+  else
+    pb_write_event(writer, timestamp, pb_event_slice_end, traced->track_uuid, NULL, 0.);
+}
+
+// Ends the slices of the processes not seen in the current sample, or of all the processes if everything is set
+static void trace_end_processes(struct trace_writer *writer, uint64_t timestamp, bool everything) {
+  struct traced_process *traced, *tmp;
+  HASH_ITER(hh, writer->processes, traced, tmp) {
+    if (everything || traced->last_sample != writer->sample) {
+      trace_process_end(writer, timestamp, traced);
+      HASH_DEL(writer->processes, traced);
+      free(traced);
+    }
+  }
+}
+
+void trace_writer_sample(struct trace_writer *writer, struct list_head *devices, uint64_t timestamp_ns) {
+  writer->sample++;
+  struct gpu_info *device;
+  list_for_each_entry(device, devices, list) {
+    unsigned device_id = trace_device_id(writer, device);
+    trace_device_counters(writer, timestamp_ns, device_id, &device->dynamic_info);
+    for (unsigned i = 0; i < device->processes_count; ++i) {
+      const struct gpu_process *process = &device->processes[i];
+      struct traced_process_key key;
+      memset(&key, 0, sizeof(key));
+      key.device_id = device_id;
+      key.pid = process->pid;
+      struct traced_process *traced;
+      HASH_FIND(hh, writer->processes, &key, sizeof(key), traced);
+      if (!traced) {
+        traced = calloc(1, sizeof(*traced));
+        if (!traced) {
+          perror("Cannot allocate memory: ");
+          exit(EXIT_FAILURE);
+        }
+        traced->key = key;
+        HASH_ADD(hh, writer->processes, key, sizeof(traced->key), traced);
+        trace_process_start(writer, timestamp_ns, traced, process);
+      }
+      traced->last_sample = writer->sample;
+    }
+  }
+  trace_end_processes(writer, timestamp_ns, false);
+  // The JSON events are formatted straight into the stream, which keeps the error
+  if (ferror(writer->file) && !writer->write_error)
+    writer->write_error = errno ? errno : EIO;
+}
+
+bool trace_writer_close(struct trace_writer *writer) {
+  if (!writer)
+    return true;
+  trace_end_processes(writer, trace_timestamp_now(), true);
+  if (writer->format == trace_format_json)
+    fputs("\n]}\n", writer->file);
+  if (ferror(writer->file) && !writer->write_error)
+    writer->write_error = errno ? errno : EIO;
+  if (fclose(writer->file) != 0 && !writer->write_error)
+    writer->write_error = errno;
+  bool written = !writer->write_error;
+  if (!written)
+    fprintf(stderr, "Cannot write the trace file %s, it is incomplete: %s\n", writer->path,
+            strerror(writer->write_error));
+  free(writer->path);
+  struct traced_device *traced, *tmp;
+  HASH_ITER(hh, writer->devices, traced, tmp) {
+    HASH_DEL(writer->devices, traced);
+    free(traced);
+  }
+  free(writer);
+  return written;
+}
@@ -0,0 +1,590 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "nvtop/usage_ledger.h"
+#include "nvtop/common.h"
+#include "nvtop/extract_gpuinfo.h"
+#include "nvtop/time.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <uthash.h>
+
+#define USAGE_LEDGER_NAME_LEN 64
+#define USAGE_LEDGER_LINE_LEN 256
+#define USAGE_LEDGER_LAST_DAY 99991231u
+
+// Cumulative values of a process at the previous sample
+struct ledger_process_key {
+  const struct gpu_info *device;
+  pid_t pid;
+};
+
+struct ledger_process {
+  struct ledger_process_key key;
+  unsigned long long gpu_time, energy;
+  bool gpu_time_valid, energy_valid;
+  unsigned generation;
+  UT_hash_handle hh;
+};
+
+struct ledger_entry_key {
+  unsigned day; // YYYYMMDD
+  char user[USAGE_LEDGER_NAME_LEN];
+  char job[USAGE_LEDGER_NAME_LEN];
+};
+
+struct ledger_entry {
+  struct ledger_entry_key key;
+  double gpu_seconds, memory_byte_seconds, joules;
+  UT_hash_handle hh;
+};
+
+struct usage_ledger {
+  int fd, index_fd;
+  unsigned last_indexed_day; // Day of the last index line, the records written next continue its range
+  unsigned generation;
+  bool sampled;
+  uint64_t last_sample_ns;
+  struct ledger_process *processes;
+  struct ledger_entry *entries;
+};
+
+static uint32_t ledger_checksum(const char *data, size_t size) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= (unsigned char)data[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static bool write_all(int fd, const char *data, size_t size) {
+  while (size) {
+    ssize_t written = write(fd, data, size);
+    if (written < 0) {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    data += written;
+    size -= written;
+  }
+  return true;
+}
+
+static char *ledger_index_path(const char *path) {
+  size_t length = strlen(path);
+  char *index_path = malloc(length + sizeof(".idx"));
+  if (!index_path) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  memcpy(index_path, path, length);
+  memcpy(index_path + length, ".idx", sizeof(".idx"));
+  return index_path;
+}
+
+// The index lines are "YYYY-MM-DD <tab> offset": the records from the offset up to the offset of the next line are all
+// of that day. A day comes back in a later range when the wall clock is set back.
+static bool ledger_parse_index_line(const char *line, unsigned *day, unsigned long long *offset) {
+  char date[11];
+  if (strlen(line) < sizeof(date) || line[sizeof(date) - 1] != '\t')
+    return false;
+  memcpy(date, line, sizeof(date) - 1);
+  date[sizeof(date) - 1] = '\0';
+  char *end;
+  errno = 0;
+  *offset = strtoull(&line[sizeof(date)], &end, 10);
+  return usage_ledger_parse_day(date, day) && !errno && end != &line[sizeof(date)] && *end == '\n';
+}
+
+static unsigned ledger_last_indexed_day(const char *index_path) {
+  FILE *index = fopen(index_path, "r");
+  if (!index)
+    return 0;
+  unsigned last_day = 0, day;
+  unsigned long long offset;
+  char line[USAGE_LEDGER_LINE_LEN];
+  while (fgets(line, sizeof(line), index)) {
+    if (ledger_parse_index_line(line, &day, &offset))
+      last_day = day;
+  }
+  fclose(index);
+  return last_day;
+}
+
+// Terminates a line torn by a crash so that the next ones start on their own line
+static bool ledger_terminate_line(int fd) {
+  struct stat file_stat;
+  char last_char = '\n';
+  if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0)
+    (void)!pread(fd, &last_char, 1, file_stat.st_size - 1);
+  return last_char == '\n' || write_all(fd, "\n", 1);
+}
+
+struct usage_ledger *usage_ledger_open(const char *path) {
+  int fd = open(path, O_RDWR | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    fprintf(stderr, "Cannot open the usage ledger %s: %s\n", path, strerror(errno));
+    return NULL;
+  }
+  if (!ledger_terminate_line(fd)) {
+    fprintf(stderr, "Cannot write to the usage ledger %s: %s\n", path, strerror(errno));
+    close(fd);
+    return NULL;
+  }
+
+  char *index_path = ledger_index_path(path);
+  int index_fd = open(index_path, O_RDWR | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+  if (index_fd < 0 || !ledger_terminate_line(index_fd)) {
+    fprintf(stderr, "Cannot open the usage ledger index %s: %s\n", index_path, strerror(errno));
+    if (index_fd >= 0)
+      close(index_fd);
+    free(index_path);
+    close(fd);
+    return NULL;
+  }
+  struct usage_ledger *ledger = calloc(1, sizeof(*ledger));
+  if (!ledger) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  ledger->fd = fd;
+  ledger->index_fd = index_fd;
+  ledger->last_indexed_day = ledger_last_indexed_day(index_path);
+  free(index_path);
+  return ledger;
+}
+
+static void ledger_copy_name(char *name, const char *source, size_t length) {
+  if (!length) {
+    strcpy(name, "-");
+    return;
+  }
+  if (length >= USAGE_LEDGER_NAME_LEN)
+    length = USAGE_LEDGER_NAME_LEN - 1;
+  for (size_t i = 0; i < length; ++i)
+    name[i] = source[i] == '\t' || source[i] == '\n' ? '_' : source[i];
+  name[length] = '\0';
+}
+
+// The job of a process is its batch scheduler job id, or the name of its executable outside of a scheduler
+static void ledger_job_name(const struct gpu_process *process, char *job) {
+  if (GPUINFO_PROCESS_FIELD_VALID(process, job_id)) {
+    ledger_copy_name(job, process->job_id, strlen(process->job_id));
+    return;
+  }
+  if (!GPUINFO_PROCESS_FIELD_VALID(process, cmdline)) {
+    ledger_copy_name(job, "", 0);
+    return;
+  }
+  const char *command = process->cmdline;
+  size_t length = strcspn(command, " ");
+  size_t name_start = 0;
+  for (size_t i = 0; i < length; ++i) {
+    if (command[i] == '/')
+      name_start = i + 1;
+  }
+  ledger_copy_name(job, &command[name_start], length - name_start);
+}
+
+static unsigned ledger_day_of(time_t wall_time) {
+  struct tm local;
+  if (!localtime_r(&wall_time, &local))
+    return 0;
+  return (unsigned)(local.tm_year + 1900) * 10000u + (unsigned)(local.tm_mon + 1) * 100u + (unsigned)local.tm_mday;
+}
+
+void usage_ledger_sample(struct usage_ledger *ledger, struct list_head *devices, time_t wall_time, uint64_t now_ns) {
+  double elapsed = ledger->sampled && now_ns > ledger->last_sample_ns ? (double)(now_ns - ledger->last_sample_ns) / 1e9
+                                                                      : 0.;
+  unsigned day = ledger_day_of(wall_time);
+  ledger->generation++;
+
+  struct gpu_info *device;
+  list_for_each_entry(device, devices, list) {
+    for (unsigned i = 0; i < device->processes_count; ++i) {
+      const struct gpu_process *process = &device->processes[i];
+      struct ledger_process_key process_key;
+      memset(&process_key, 0, sizeof(process_key));
+      process_key.device = device;
+      process_key.pid = process->pid;
+      struct ledger_process *previous;
+      HASH_FIND(hh, ledger->processes, &process_key, sizeof(process_key), previous);
+      if (!previous) {
+        previous = calloc(1, sizeof(*previous));
+        if (!previous) {
+          perror("Cannot allocate memory: ");
+          exit(EXIT_FAILURE);
+        }
+        previous->key = process_key;
+        HASH_ADD(hh, ledger->processes, key, sizeof(previous->key), previous);
+      }
+      previous->generation = ledger->generation;
+      // The first sample is a baseline: what a collector daemon accumulated before is already in the ledger or
+      // predates it. Afterwards, a value that appears or decreases belongs to a new process.
+      bool count_whole = ledger->sampled;
+
+      double gpu_seconds = 0., joules = 0., memory_byte_seconds = 0.;
+      if (GPUINFO_PROCESS_FIELD_VALID(process, gpu_time)) {
+        // A smaller value is a new process reusing the pid
+        if (previous->gpu_time_valid && process->gpu_time >= previous->gpu_time)
+          gpu_seconds = (double)(process->gpu_time - previous->gpu_time) / 1e9;
+        else if (count_whole)
+          gpu_seconds = (double)process->gpu_time / 1e9;
+        previous->gpu_time = process->gpu_time;
+      }
+      previous->gpu_time_valid = GPUINFO_PROCESS_FIELD_VALID(process, gpu_time);
+      if (GPUINFO_PROCESS_FIELD_VALID(process, energy)) {
+        if (previous->energy_valid && process->energy >= previous->energy)
+          joules = (double)(process->energy - previous->energy) / 1e3;
+        else if (count_whole)
+          joules = (double)process->energy / 1e3;
+        previous->energy = process->energy;
+      }
+      previous->energy_valid = GPUINFO_PROCESS_FIELD_VALID(process, energy);
+      if (GPUINFO_PROCESS_FIELD_VALID(process, gpu_memory_usage))
+        memory_byte_seconds = (double)process->gpu_memory_usage * elapsed;
+      if (gpu_seconds <= 0. && joules <= 0. && memory_byte_seconds <= 0.)
+        continue;
+
+      struct ledger_entry_key entry_key;
+      memset(&entry_key, 0, sizeof(entry_key));
+      entry_key.day = day;
+      if (GPUINFO_PROCESS_FIELD_VALID(process, user_name))
+        ledger_copy_name(entry_key.user, process->user_name, strlen(process->user_name));
+      else
+        ledger_copy_name(entry_key.user, "", 0);
+      ledger_job_name(process, entry_key.job);
+      struct ledger_entry *entry;
+      HASH_FIND(hh, ledger->entries, &entry_key, sizeof(entry_key), entry);
+      if (!entry) {
+        entry = calloc(1, sizeof(*entry));
+        if (!entry) {
+          perror("Cannot allocate memory: ");
+          exit(EXIT_FAILURE);
+        }
+        entry->key = entry_key;
+        HASH_ADD(hh, ledger->entries, key, sizeof(entry->key), entry);
+      }
+      entry->gpu_seconds += gpu_seconds;
+      entry->memory_byte_seconds += memory_byte_seconds;
+      entry->joules += joules;
+    }
+  }
+
+  struct ledger_process *process, *tmp;
+  HASH_ITER(hh, ledger->processes, process, tmp) {
+    if (process->generation != ledger->generation) {
+      HASH_DEL(ledger->processes, process);
+      free(process);
+    }
+  }
+  ledger->sampled = true;
+  ledger->last_sample_ns = now_ns;
+}
+
+static int ledger_entry_compare(const struct ledger_entry *a, const struct ledger_entry *b) {
+  if (a->key.day != b->key.day)
+    return a->key.day < b->key.day ? -1 : 1;
+  int user = strcmp(a->key.user, b->key.user);
+  return user ? user : strcmp(a->key.job, b->key.job);
+}
+
+static size_t ledger_format_day(char *buffer, size_t size, unsigned day) {
+  return snprintf(buffer, size, "%04u-%02u-%02u", day / 10000u, day / 100u % 100u, day % 100u);
+}
+
+bool usage_ledger_flush(struct usage_ledger *ledger) {
+  if (!ledger->entries)
+    return true;
+  HASH_SORT(ledger->entries, ledger_entry_compare);
+  struct stat ledger_stat, index_stat;
+  if (fstat(ledger->fd, &ledger_stat) != 0 || fstat(ledger->index_fd, &index_stat) != 0)
+    return false;
+
+  size_t records_size = HASH_COUNT(ledger->entries) * USAGE_LEDGER_LINE_LEN;
+  char *records = malloc(records_size);
+  char *index = malloc(records_size);
+  if (!records || !index) {
+    perror("Cannot allocate memory: ");
+    exit(EXIT_FAILURE);
+  }
+  size_t records_length = 0, index_length = 0;
+  unsigned indexed_day = ledger->last_indexed_day;
+  struct ledger_entry *entry, *tmp;
+  HASH_ITER(hh, ledger->entries, entry, tmp) {
+    char *line = &records[records_length];
+    if (entry->key.day != indexed_day) {
+      indexed_day = entry->key.day;
+      index_length += ledger_format_day(&index[index_length], records_size - index_length, indexed_day);
+      index_length += snprintf(&index[index_length], records_size - index_length, "\t%llu\n",
+                               (unsigned long long)ledger_stat.st_size + records_length);
+    }
+    size_t length = ledger_format_day(line, USAGE_LEDGER_LINE_LEN, entry->key.day);
+    length += snprintf(&line[length], USAGE_LEDGER_LINE_LEN - length, "\t%s\t%s\t%.3f\t%.0f\t%.3f", entry->key.user,
+                       entry->key.job, entry->gpu_seconds, entry->memory_byte_seconds, entry->joules);
+    length += snprintf(&line[length], USAGE_LEDGER_LINE_LEN - length, "\t%08" PRIx32 "\n",
+                       ledger_checksum(line, length));
+    records_length += length;
+  }
+
+  // The index is durable before the records: after a crash in between it points to the end of the ledger, where the
+  // records of the next flush go, and no record is ever left out of the indexed ranges
+  bool success = (!index_length || (write_all(ledger->index_fd, index, index_length) && fsync(ledger->index_fd) == 0)) &&
+                 write_all(ledger->fd, records, records_length) && fsync(ledger->fd) == 0;
+  if (success) {
+    HASH_ITER(hh, ledger->entries, entry, tmp) {
+      HASH_DEL(ledger->entries, entry);
+      free(entry);
+    }
+    ledger->last_indexed_day = indexed_day;
+  } else {
+    // Keep the totals for the next flush and drop what was partially written
+    if (ftruncate(ledger->fd, ledger_stat.st_size) != 0 || ftruncate(ledger->index_fd, index_stat.st_size) != 0)
+      fprintf(stderr, "Cannot restore the usage ledger after a failed write: %s\n", strerror(errno));
+  }
+  free(records);
+  free(index);
+  return success;
+}
+
+void usage_ledger_close(struct usage_ledger *ledger) {
+  if (!ledger)
+    return;
+  if (!usage_ledger_flush(ledger))
+    fprintf(stderr, "Cannot write to the usage ledger: %s\n", strerror(errno));
+  struct ledger_entry *entry, *tmp_entry;
+  HASH_ITER(hh, ledger->entries, entry, tmp_entry) {
+    HASH_DEL(ledger->entries, entry);
+    free(entry);
+  }
+  struct ledger_process *process, *tmp_process;
+  HASH_ITER(hh, ledger->processes, process, tmp_process) {
+    HASH_DEL(ledger->processes, process);
+    free(process);
+  }
+  close(ledger->fd);
+  close(ledger->index_fd);
+  free(ledger);
+}
+
+bool usage_ledger_parse_day(const char *date, unsigned *day) {
+  unsigned year, month, mday;
+  int consumed = 0;
+  if (sscanf(date, "%4u-%2u-%2u%n", &year, &month, &mday, &consumed) != 3 || consumed != 10 || date[consumed] != '\0')
+    return false;
+  if (month < 1 || month > 12 || mday < 1 || mday > 31)
+    return false;
+  *day = year * 10000u + month * 100u + mday;
+  return true;
+}
+
+// Splits a record into its fields, returns false if it is malformed or torn
+static bool ledger_parse_record(char *line, unsigned *day, struct ledger_entry *values) {
+  size_t length = strlen(line);
+  if (!length || line[length - 1] != '\n')
+    return false;
+  line[--length] = '\0';
+  char *checksum = strrchr(line, '\t');
+  if (!checksum)
+    return false;
+  char *end;
+  uint32_t expected = (uint32_t)strtoul(checksum + 1, &end, 16);
+  if (end == checksum + 1 || *end != '\0' || expected != ledger_checksum(line, checksum - line))
+    return false;
+  *checksum = '\0';
+
+  char *fields[6];
+  char *save = NULL;
+  unsigned count = 0;
+  for (char *field = strtok_r(line, "\t", &save); field && count < 6; field = strtok_r(NULL, "\t", &save))
+    fields[count++] = field;
+  if (count != 6 || !usage_ledger_parse_day(fields[0], day))
+    return false;
+  memset(&values->key, 0, sizeof(values->key));
+  values->key.day = *day;
+  ledger_copy_name(values->key.user, fields[1], strlen(fields[1]));
+  ledger_copy_name(values->key.job, fields[2], strlen(fields[2]));
+  values->gpu_seconds = strtod(fields[3], NULL);
+  values->memory_byte_seconds = strtod(fields[4], NULL);
+  values->joules = strtod(fields[5], NULL);
+  return true;
+}
+
+static void ledger_report_add(struct ledger_entry **totals, const char *user, const char *job,
+                              const struct ledger_entry *values) {
+  struct ledger_entry_key key;
+  memset(&key, 0, sizeof(key));
+  ledger_copy_name(key.user, user, strlen(user));
+  ledger_copy_name(key.job, job, strlen(job));
+  struct ledger_entry *total;
+  HASH_FIND(hh, *totals, &key, sizeof(key), total);
+  if (!total) {
+    total = calloc(1, sizeof(*total));
+    if (!total) {
+      perror("Cannot allocate memory: ");
+      exit(EXIT_FAILURE);
+    }
+    total->key = key;
+    HASH_ADD(hh, *totals, key, sizeof(total->key), total);
+  }
+  total->gpu_seconds += values->gpu_seconds;
+  total->memory_byte_seconds += values->memory_byte_seconds;
+  total->joules += values->joules;
+}
+
+// The totals of a user have the job "*", which sorts before the job names
+static int ledger_report_compare(const struct ledger_entry *a, const struct ledger_entry *b) {
+  int user = strcmp(a->key.user, b->key.user);
+  if (user)
+    return user;
+  bool a_total = strcmp(a->key.job, "*") == 0, b_total = strcmp(b->key.job, "*") == 0;
+  if (a_total != b_total)
+    return a_total ? -1 : 1;
+  return strcmp(a->key.job, b->key.job);
+}
+
+bool usage_ledger_report(const char *path, unsigned first_day, unsigned last_day, FILE *out) {
+  FILE *ledger = fopen(path, "r");
+  if (!ledger) {
+    fprintf(stderr, "Cannot open the usage ledger %s: %s\n", path, strerror(errno));
+    return false;
+  }
+  // Only the records from the first to the end of the last indexed range of a day in the period are read
+  unsigned long long start_offset = 0, end_offset = ULLONG_MAX;
+  char line[USAGE_LEDGER_LINE_LEN];
+  char *index_path = ledger_index_path(path);
+  FILE *index = fopen(index_path, "r");
+  free(index_path);
+  if (index) {
+    unsigned day;
+    unsigned long long offset;
+    bool indexed = false, in_period = false;
+    start_offset = ULLONG_MAX;
+    end_offset = 0;
+    while (fgets(line, sizeof(line), index)) {
+      if (!ledger_parse_index_line(line, &day, &offset))
+        continue;
+      // A line ends the range of the previous one
+      if (in_period && offset > end_offset)
+        end_offset = offset;
+      in_period = day >= first_day && day <= last_day;
+      if (in_period && offset < start_offset)
+        start_offset = offset;
+      indexed = true;
+    }
+    fclose(index);
+    if (!indexed || in_period)
+      end_offset = ULLONG_MAX;
+    if (!indexed)
+      start_offset = 0;
+    if (start_offset >= end_offset)
+      start_offset = end_offset = 0;
+  }
+  if (fseeko(ledger, (off_t)start_offset, SEEK_SET) != 0)
+    rewind(ledger);
+
+  struct ledger_entry *totals = NULL;
+  struct ledger_entry all = {0}, values;
+  unsigned first_seen = 0, last_seen = 0;
+  while ((unsigned long long)ftello(ledger) < end_offset && fgets(line, sizeof(line), ledger)) {
+    unsigned day;
+    if (!ledger_parse_record(line, &day, &values) || day < first_day || day > last_day)
+      continue;
+    if (!first_seen || day < first_seen)
+      first_seen = day;
+    if (day > last_seen)
+      last_seen = day;
+    ledger_report_add(&totals, values.key.user, "*", &values);
+    ledger_report_add(&totals, values.key.user, values.key.job, &values);
+    all.gpu_seconds += values.gpu_seconds;
+    all.memory_byte_seconds += values.memory_byte_seconds;
+    all.joules += values.joules;
+  }
+  fclose(ledger);
+
+  if (!totals) {
+    fprintf(out, "No GPU usage recorded in this period.\n");
+    return true;
+  }
+  char first[16], last[16];
+  ledger_format_day(first, sizeof(first), first_seen);
+  ledger_format_day(last, sizeof(last), last_seen);
+  fprintf(out, "GPU usage from %s to %s\n", first, last);
+  fprintf(out, "%-16s %-24s %12s %16s %12s\n", "USER", "JOB", "GPU HOURS", "GPU MEM GiB*H", "ENERGY kWh");
+  HASH_SORT(totals, ledger_report_compare);
+  struct ledger_entry *total, *tmp;
+  HASH_ITER(hh, totals, total, tmp) {
+    fprintf(out, "%-16s %-24s %12.3f %16.3f %12.3f\n", total->key.user, total->key.job, total->gpu_seconds / 3600.,
+            total->memory_byte_seconds / (3600. * 1073741824.), total->joules / 3.6e6);
+    HASH_DEL(totals, total);
+    free(total);
+  }
+  fprintf(out, "%-16s %-24s %12.3f %16.3f %12.3f\n", "*", "*", all.gpu_seconds / 3600.,
+          all.memory_byte_seconds / (3600. * 1073741824.), all.joules / 3.6e6);
+  return true;
+}
+
+int usage_ledger_run(const char *path, int update_interval, unsigned flush_interval, volatile sig_atomic_t *stop) {
+  struct usage_ledger *ledger = usage_ledger_open(path);
+  if (!ledger)
+    return EXIT_FAILURE;
+  unsigned devices_count = 0;
+  LIST_HEAD(devices);
+  if (!gpuinfo_init_info_extraction(&devices_count, &devices) || devices_count == 0) {
+    fprintf(stderr, "No GPU to monitor.\n");
+    usage_ledger_close(ledger);
+    return EXIT_FAILURE;
+  }
+  gpuinfo_populate_static_infos(&devices);
+
+  nvtop_time last_flush;
+  nvtop_get_current_time(&last_flush);
+  while (!*stop) {
+    gpuinfo_refresh_dynamic_info(&devices);
+    gpuinfo_refresh_processes(&devices);
+    gpuinfo_utilisation_rate(&devices);
+    gpuinfo_account_processes(&devices);
+    gpuinfo_fix_dynamic_info_from_process_info(&devices);
+    nvtop_time now;
+    nvtop_get_current_time(&now);
+    usage_ledger_sample(ledger, &devices, time(NULL), nvtop_time_u64(now));
+    if (nvtop_difftime(last_flush, now) >= flush_interval) {
+      if (!usage_ledger_flush(ledger))
+        fprintf(stderr, "Cannot write to the usage ledger %s: %s\n", path, strerror(errno));
+      last_flush = now;
+    }
+    // Interrupted by the signals that stop the ledger
+    struct timespec interval = {.tv_sec = update_interval / 1000, .tv_nsec = update_interval % 1000 * 1000000l};
+    nanosleep(&interval, NULL);
+  }
+  usage_ledger_close(ledger);
+  gpuinfo_shutdown_info_extraction(&devices);
+  return EXIT_SUCCESS;
+}
@@ -20,13 +20,41 @@
  */
 
 #include <algorithm>
+#include <array>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fstream>
 #include <gtest/gtest.h>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <vector>
 
 extern "C" {
+#include "nvtop/extract_gpuinfo.h"
 #include "nvtop/interface.h"
+#include "nvtop/interface_imbalance.h"
+#include "nvtop/interface_process_groups.h"
+#include "nvtop/host_locality.h"
+#include "nvtop/device_topology.h"
+#include "nvtop/collector.h"
+#include "nvtop/shm_publisher.h"
+#include "nvtop/shm_snapshot.h"
+#include "nvtop/trace_export.h"
+#include "nvtop/flight_recorder.h"
+#include "nvtop/json_util.h"
+#include "nvtop/alert_rules.h"
+#include "nvtop/process_summary.h"
+#include "nvtop/idle_report.h"
+#include "nvtop/memory_trend.h"
+#include "nvtop/usage_ledger.h"
+#include "nvtop/process_cgroup.h"
 #include "nvtop/interface_layout_selection.h"
+#include "nvtop/interface_heatmap.h"
+#include "nvtop/interface_history.h"
+#include "nvtop/plot_scale.h"
 }
 
 static std::ostream &operator<<(std::ostream &os, const struct window_position &win) {
@@ -139,12 +167,14 @@ bool test_with_terminal_size(unsigned device_count, unsigned header_rows, unsign
   unsigned num_plots = 0;
   std::vector<struct window_position> dev_positions(device_count);
   std::vector<struct window_position> plot_positions(MAX_CHARTS);
+  enum device_header_layout header_layout;
+  struct window_position legend_position;
   struct window_position process_position;
   struct window_position setup_position;
   std::vector<unsigned> map_dev_to_plot(device_count);
   compute_sizes_from_layout(device_count, header_rows, header_cols, rows, cols, plot_display.data(), proc_display,
-                            dev_positions.data(), &num_plots, plot_positions.data(), map_dev_to_plot.data(),
-                            &process_position, &setup_position, false);
+                            &header_layout, dev_positions.data(), &legend_position, &num_plots, plot_positions.data(),
+                            map_dev_to_plot.data(), &process_position, &setup_position, false);
   plot_positions.resize(num_plots);
 
   return check_layout(screen, dev_positions, plot_positions, process_position, setup_position);
@@ -166,12 +196,14 @@ TEST(InterfaceLayout, CheckEmptyProcessWindow) {
   unsigned num_plots = 0;
   std::vector<struct window_position> dev_positions(device_count);
   std::vector<struct window_position> plot_positions(MAX_CHARTS);
+  enum device_header_layout header_layout;
+  struct window_position legend_position;
   struct window_position process_position;
   struct window_position setup_position;
   std::vector<unsigned> map_dev_to_plot(device_count);
   compute_sizes_from_layout(device_count, header_rows, header_cols, rows, cols, plot_display.data(), proc_display,
-                            dev_positions.data(), &num_plots, plot_positions.data(), map_dev_to_plot.data(),
-                            &process_position, &setup_position, false);
+                            &header_layout, dev_positions.data(), &legend_position, &num_plots, plot_positions.data(),
+                            map_dev_to_plot.data(), &process_position, &setup_position, false);
   plot_positions.resize(num_plots);
   EXPECT_EQ(num_plots, 0);
   EXPECT_TRUE(window_is_empty(process_position));
@@ -189,17 +221,1190 @@ TEST(InterfaceLayout, FixInfiniteLoop) {
   unsigned num_plots = 0;
   std::vector<struct window_position> dev_positions(device_count);
   std::vector<struct window_position> plot_positions(MAX_CHARTS);
+  enum device_header_layout header_layout;
+  struct window_position legend_position;
   struct window_position process_position;
   struct window_position setup_position;
   std::vector<unsigned> map_dev_to_plot(device_count);
   compute_sizes_from_layout(device_count, header_rows, header_cols, rows, cols, plot_display.data(), proc_display,
-                            dev_positions.data(), &num_plots, plot_positions.data(), map_dev_to_plot.data(),
-                            &process_position, &setup_position, false);
+                            &header_layout, dev_positions.data(), &legend_position, &num_plots, plot_positions.data(),
+                            map_dev_to_plot.data(), &process_position, &setup_position, false);
   plot_positions.resize(num_plots);
 }
 
 TEST(InterfaceLayout, LayoutSelection_test_fail_case1) { test_with_terminal_size(32, 3, 55, 16, 1760); }
 
+TEST(InterfaceLayout, DeviceGridForManyDevices) {
+  for (unsigned device_count : {16u, 64u, 256u}) {
+    unsigned header_rows = 3, header_cols = 78, rows = 50, cols = 200;
+    struct window_position screen = {.posX = 0, .posY = 0, .sizeX = cols, .sizeY = rows};
+
+    nvtop_interface_gpu_opts to_draw_default = {.to_draw = plot_default_draw_info()};
+    std::vector<nvtop_interface_gpu_opts> plot_display(device_count, to_draw_default);
+
+    process_field_displayed proc_display = process_default_displayed_field();
+
+    unsigned num_plots = 0;
+    std::vector<struct window_position> dev_positions(device_count);
+    std::vector<struct window_position> plot_positions(MAX_CHARTS);
+    enum device_header_layout header_layout;
+    struct window_position legend_position;
+    struct window_position process_position;
+    struct window_position setup_position;
+    std::vector<unsigned> map_dev_to_plot(device_count);
+    compute_sizes_from_layout(device_count, header_rows, header_cols, rows, cols, plot_display.data(), proc_display,
+                              &header_layout, dev_positions.data(), &legend_position, &num_plots,
+                              plot_positions.data(), map_dev_to_plot.data(), &process_position, &setup_position,
+                              false);
+    plot_positions.resize(num_plots);
+    EXPECT_TRUE(check_layout(screen, dev_positions, plot_positions, process_position, setup_position));
+
+    // One line per cell row, then the legend, leaving room for the processes
+    EXPECT_EQ(header_layout, device_count > 64 ? device_header_grid_narrow : device_header_grid_wide);
+    unsigned cell_cols = device_grid_cell_cols(device_count, header_layout);
+    unsigned cells_per_row = (cols + 1) / (cell_cols + 1);
+    for (unsigned dev_id = 0; dev_id < device_count; ++dev_id) {
+      EXPECT_EQ(dev_positions[dev_id].sizeY, 1u);
+      EXPECT_EQ(dev_positions[dev_id].posY, dev_id / cells_per_row);
+    }
+    EXPECT_EQ(legend_position.posY, (device_count + cells_per_row - 1) / cells_per_row);
+    EXPECT_GE(process_position.sizeY, 6u);
+    for (unsigned dev_id = 0; dev_id < device_count; ++dev_id) {
+      if (num_plots)
+        EXPECT_LT(map_dev_to_plot[dev_id], num_plots);
+    }
+  }
+}
+
+TEST(InterfaceLayout, CachedLayoutMatchesComputedOne) {
+  struct layout_result {
+    enum device_header_layout header_layout;
+    std::vector<struct window_position> dev_positions;
+    std::vector<unsigned> map_dev_to_plot;
+    struct window_position legend_position;
+    unsigned num_plots;
+    std::vector<struct window_position> plot_positions;
+    struct window_position process_position;
+    struct window_position setup_position;
+  };
+  auto layout = [](const std::vector<nvtop_interface_gpu_opts> &plot_display, unsigned rows, unsigned cols) {
+    layout_result result;
+    result.dev_positions.resize(plot_display.size());
+    result.map_dev_to_plot.resize(plot_display.size());
+    result.plot_positions.resize(MAX_CHARTS);
+    compute_sizes_from_layout(plot_display.size(), 3, 78, rows, cols, plot_display.data(),
+                              process_default_displayed_field(), &result.header_layout, result.dev_positions.data(),
+                              &result.legend_position, &result.num_plots, result.plot_positions.data(),
+                              result.map_dev_to_plot.data(), &result.process_position, &result.setup_position, false);
+    result.plot_positions.resize(result.num_plots);
+    return result;
+  };
+  auto same_position = [](const struct window_position &a, const struct window_position &b) {
+    return a.posX == b.posX && a.posY == b.posY && a.sizeX == b.sizeX && a.sizeY == b.sizeY;
+  };
+  auto expect_same = [&](const layout_result &a, const layout_result &b) {
+    EXPECT_EQ(a.header_layout, b.header_layout);
+    EXPECT_EQ(a.map_dev_to_plot, b.map_dev_to_plot);
+    EXPECT_EQ(a.num_plots, b.num_plots);
+    for (size_t i = 0; i < a.dev_positions.size(); ++i)
+      EXPECT_TRUE(same_position(a.dev_positions[i], b.dev_positions[i])) << a.dev_positions[i];
+    for (size_t i = 0; i < a.plot_positions.size() && i < b.plot_positions.size(); ++i)
+      EXPECT_TRUE(same_position(a.plot_positions[i], b.plot_positions[i])) << a.plot_positions[i];
+    EXPECT_TRUE(same_position(a.process_position, b.process_position));
+    EXPECT_TRUE(same_position(a.setup_position, b.setup_position));
+  };
+
+  nvtop_interface_gpu_opts to_draw_default = {.to_draw = plot_default_draw_info()};
+  std::vector<nvtop_interface_gpu_opts> plot_display(6, to_draw_default);
+  layout_cache_clear();
+  layout_result computed = layout(plot_display, 60, 200);
+  expect_same(computed, layout(plot_display, 60, 200));
+
+  // Another set of metrics of the same size shares the layout, another count does not
+  nvtop_interface_gpu_opts to_draw_other = {.to_draw = (1 << plot_gpu_temperature) | (1 << plot_fan_speed)};
+  std::vector<nvtop_interface_gpu_opts> other_metrics(6, to_draw_other);
+  expect_same(computed, layout(other_metrics, 60, 200));
+  plot_display[0].to_draw = plot_remove_draw_info(plot_gpu_mem_rate, plot_display[0].to_draw);
+  layout_result one_less = layout(plot_display, 60, 200);
+  layout_cache_clear();
+  expect_same(one_less, layout(plot_display, 60, 200));
+
+  // Evicting the least recently used layouts keeps the results right
+  for (unsigned cols = 100; cols < 100 + 2 * LAYOUT_CACHE_SIZE; ++cols) {
+    layout_result cached = layout(plot_display, 60, cols);
+    expect_same(cached, layout(plot_display, 60, cols));
+  }
+  layout_cache_clear();
+}
+
+TEST(InterfaceImbalance, FlagsConsistentlyLaggingDevice) {
+  struct imbalance_tracker tracker;
+  imbalance_tracker_alloc(4, &tracker);
+  // Job 42 on devices 0-2 with device 2 behind, device 3 runs an unrelated single device job
+  const std::array<struct imbalance_sample, 4> samples = {{
+      {42, 0, true, 90, 1000},
+      {42, 1, true, 92, 1000},
+      {42, 2, true, 40, 500},
+      {7, 3, true, 10, 100},
+  }};
+  for (unsigned i = 0; i < IMBALANCE_WINDOW_SIZE; ++i)
+    imbalance_tracker_push(&tracker, samples.size(), samples.data());
+  EXPECT_FALSE(imbalance_device_is_straggler(&tracker, 0));
+  EXPECT_FALSE(imbalance_device_is_straggler(&tracker, 1));
+  EXPECT_TRUE(imbalance_device_is_straggler(&tracker, 2));
+  EXPECT_FALSE(imbalance_device_is_straggler(&tracker, 3));
+  EXPECT_EQ(imbalance_device_usage_gap(&tracker, 2), 34u);
+  EXPECT_EQ(imbalance_device_memory_imbalance(&tracker, 2), 50u);
+  EXPECT_EQ(imbalance_device_usage_gap(&tracker, 3), 0u);
+  imbalance_tracker_free(&tracker);
+}
+
+TEST(InterfaceImbalance, TransientLagIsNotReported) {
+  struct imbalance_tracker tracker;
+  imbalance_tracker_alloc(2, &tracker);
+  const std::array<struct imbalance_sample, 2> balanced = {{{1, 0, true, 80, 10}, {1, 1, true, 80, 10}}};
+  const std::array<struct imbalance_sample, 2> lagging = {{{1, 0, true, 80, 10}, {1, 1, true, 20, 10}}};
+  for (unsigned i = 0; i < IMBALANCE_WINDOW_SIZE; ++i) {
+    if (i % 4 == 0)
+      imbalance_tracker_push(&tracker, lagging.size(), lagging.data());
+    else
+      imbalance_tracker_push(&tracker, balanced.size(), balanced.data());
+  }
+  EXPECT_FALSE(imbalance_device_is_straggler(&tracker, 1));
+  // The window slides: only lagging samples remain after a full window
+  for (unsigned i = 0; i < IMBALANCE_WINDOW_SIZE; ++i)
+    imbalance_tracker_push(&tracker, lagging.size(), lagging.data());
+  EXPECT_TRUE(imbalance_device_is_straggler(&tracker, 1));
+  imbalance_tracker_free(&tracker);
+}
+
+TEST(InterfaceProcessGroups, RollupRowsStableAcrossRefreshes) {
+  char alice[] = "alice", bob[] = "bob", carol[] = "carol";
+  struct gpu_process processes[4] = {};
+  struct gpuid_and_process rows[4] = {};
+  const pid_t pids[4] = {10, 10, 11, 12};
+  char *users[4] = {alice, alice, alice, bob};
+  const unsigned gpu_ids[4] = {0, 1, 1, 0};
+  for (unsigned i = 0; i < 4; ++i) {
+    processes[i].pid = pids[i];
+    SET_GPUINFO_PROCESS(&processes[i], user_name, users[i]);
+    SET_GPUINFO_PROCESS(&processes[i], cpu_usage, 10 * pids[i]);
+    SET_GPUINFO_PROCESS(&processes[i], gpu_memory_usage, 1000u);
+    SET_GPUINFO_PROCESS(&processes[i], gpu_usage, 20u);
+    rows[i].gpu_id = gpu_ids[i];
+    rows[i].process = &processes[i];
+  }
+  all_processes all_procs = {4, rows};
+
+  struct process_groups groups = {};
+  process_groups_update(&groups, all_procs, process_rollup_user);
+  ASSERT_EQ(groups.groups_count, 2u);
+  struct process_group *alice_group = groups.groups[0];
+  // The process running on two devices counts once, with its CPU usage counted once
+  EXPECT_EQ(alice_group->members_count, 3u);
+  EXPECT_EQ(alice_group->processes_count, 2u);
+  EXPECT_EQ(alice_group->merged.cpu_usage, 210u);
+  EXPECT_EQ(alice_group->merged.gpu_memory_usage, 3000u);
+  EXPECT_EQ(alice_group->merged.gpu_usage, 60u);
+  EXPECT_EQ(alice_group->merged.pid, 0);
+  EXPECT_STREQ(alice_group->devices, "0-1");
+  EXPECT_STREQ(alice_group->merged.cmdline, "2 processes");
+  EXPECT_EQ(groups.groups[1]->processes_count, 1u);
+
+  // The next refresh reuses the group of alice without accumulating into it, bob left and carol came
+  SET_GPUINFO_PROCESS(&processes[3], user_name, carol);
+  process_groups_update(&groups, all_procs, process_rollup_user);
+  ASSERT_EQ(groups.groups_count, 2u);
+  EXPECT_EQ(groups.groups[0], alice_group);
+  EXPECT_EQ(alice_group->merged.cpu_usage, 210u);
+  EXPECT_EQ(alice_group->merged.gpu_memory_usage, 3000u);
+  EXPECT_EQ(alice_group->processes_count, 2u);
+  EXPECT_STREQ(groups.groups[1]->merged.user_name, "carol");
+  int64_t bob_key = process_group_name_key(0, "bob");
+  struct process_group *left;
+  HASH_FIND(hh, groups.groups_by_pid, &bob_key, sizeof(bob_key), left);
+  EXPECT_EQ(left, nullptr);
+  EXPECT_EQ(HASH_COUNT(groups.groups_by_pid), 2u);
+
+  // Without rollup, the devices of a process are merged and show its mean load
+  process_groups_update(&groups, all_procs, process_rollup_none);
+  ASSERT_EQ(groups.groups_count, 3u);
+  EXPECT_EQ(groups.groups[0]->members_count, 2u);
+  EXPECT_EQ(groups.groups[0]->merged.pid, 10);
+  EXPECT_EQ(groups.groups[0]->merged.gpu_usage, 20u);
+  EXPECT_EQ(groups.groups[0]->merged.cpu_usage, 100u);
+  process_groups_free(&groups);
+}
+
+TEST(HostLocality, ParseKernelList) {
+  struct host_mask mask;
+  EXPECT_TRUE(host_mask_from_list("0-3,8,10-11\n", &mask));
+  for (unsigned id = 0; id < 16; ++id) {
+    bool expected = id <= 3 || id == 8 || id == 10 || id == 11;
+    EXPECT_EQ(host_mask_is_set(&mask, id), expected) << "id " << id;
+  }
+  EXPECT_FALSE(host_mask_from_list("", &mask));
+  EXPECT_FALSE(host_mask_from_list("3-1", &mask));
+  EXPECT_FALSE(host_mask_from_list("0,a", &mask));
+}
+
+TEST(HostLocality, ClassifyPlacement) {
+  struct host_mask node1_cpus, node0_cpus, all_cpus, node0, node1, all_nodes;
+  ASSERT_TRUE(host_mask_from_list("0-7", &node0_cpus));
+  ASSERT_TRUE(host_mask_from_list("8-15", &node1_cpus));
+  ASSERT_TRUE(host_mask_from_list("0-15", &all_cpus));
+  ASSERT_TRUE(host_mask_from_list("0", &node0));
+  ASSERT_TRUE(host_mask_from_list("1", &node1));
+  ASSERT_TRUE(host_mask_from_list("0-1", &all_nodes));
+  EXPECT_EQ(host_locality_classify(1, &node1_cpus, &node1_cpus, &node1), host_locality_local);
+  EXPECT_EQ(host_locality_classify(1, &node1_cpus, &all_cpus, &all_nodes), host_locality_any);
+  EXPECT_EQ(host_locality_classify(1, &node1_cpus, &node0_cpus, &all_nodes), host_locality_remote);
+  EXPECT_EQ(host_locality_classify(1, &node1_cpus, &node1_cpus, &node0), host_locality_remote);
+}
+
+TEST(ProcessStarvation, ClassifiesTheHostBottleneck) {
+  struct gpu_info device = {};
+  struct gpu_process process = {};
+  // Nothing to tell without the GPU and CPU usages
+  gpuinfo_classify_process_starvation(&device, &process);
+  EXPECT_FALSE(GPUINFO_PROCESS_FIELD_VALID(&process, starvation));
+  SET_GPUINFO_DYNAMIC(&device.dynamic_info, gpu_util_rate, 10);
+  gpuinfo_classify_process_starvation(&device, &process);
+  EXPECT_FALSE(GPUINFO_PROCESS_FIELD_VALID(&process, starvation));
+
+  SET_GPUINFO_PROCESS(&process, cpu_usage, 50);
+  gpuinfo_classify_process_starvation(&device, &process);
+  ASSERT_TRUE(GPUINFO_PROCESS_FIELD_VALID(&process, starvation));
+  EXPECT_EQ(process.starvation, gpu_process_not_starved);
+  SET_GPUINFO_PROCESS(&process, cpu_usage, 100);
+  gpuinfo_classify_process_starvation(&device, &process);
+  EXPECT_EQ(process.starvation, gpu_process_starved_cpu);
+  // The usage of the process on the device takes precedence over the device usage
+  SET_GPUINFO_PROCESS(&process, gpu_usage, 80);
+  gpuinfo_classify_process_starvation(&device, &process);
+  EXPECT_EQ(process.starvation, gpu_process_not_starved);
+  RESET_GPUINFO_PROCESS(&process, gpu_usage);
+
+  SET_GPUINFO_PROCESS(&process, voluntary_ctx_switches, 50ul);
+  SET_GPUINFO_PROCESS(&process, involuntary_ctx_switches, 500ul);
+  gpuinfo_classify_process_starvation(&device, &process);
+  EXPECT_EQ(process.starvation, gpu_process_starved_preempted);
+
+  // A fast storage reader is I/O bound when the wait time is not accounted, and the wait time decides otherwise
+  SET_GPUINFO_PROCESS(&process, cpu_usage, 20);
+  SET_GPUINFO_PROCESS(&process, io_read_rate, 64ull << 20);
+  gpuinfo_classify_process_starvation(&device, &process);
+  EXPECT_EQ(process.starvation, gpu_process_starved_io);
+  SET_GPUINFO_PROCESS(&process, cpu_io_wait, 5);
+  gpuinfo_classify_process_starvation(&device, &process);
+  EXPECT_EQ(process.starvation, gpu_process_starved_preempted);
+  SET_GPUINFO_PROCESS(&process, cpu_io_wait, 40);
+  gpuinfo_classify_process_starvation(&device, &process);
+  EXPECT_EQ(process.starvation, gpu_process_starved_io);
+}
+
+TEST(ProcessCgroup, LabelFromPath) {
+  char label[PROCESS_CGROUP_LABEL_LEN];
+  process_cgroup_label("/kubepods.slice/kubepods-burstable.slice/"
+                       "kubepods-burstable-pod0a1b2c3d_4e5f_6789_abcd_ef0123456789.slice/"
+                       "cri-containerd-5d41402abc4b2a76b9719d911017c592aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa.scope",
+                       label, sizeof(label));
+  EXPECT_STREQ(label, "pod:0a1b2c3d-4e5f-6789-abcd-ef0123456789");
+  process_cgroup_label("/kubepods/besteffort/pod0a1b2c3d-4e5f-6789-abcd-ef0123456789/"
+                       "5d41402abc4b2a76b9719d911017c592aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+                       label, sizeof(label));
+  EXPECT_STREQ(label, "pod:0a1b2c3d-4e5f-6789-abcd-ef0123456789");
+  process_cgroup_label("/system.slice/docker-5d41402abc4b2a76b9719d911017c592aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa.scope",
+                       label, sizeof(label));
+  EXPECT_STREQ(label, "docker:5d41402abc4b");
+  process_cgroup_label("/docker/5d41402abc4b2a76b9719d911017c592aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa", label,
+                       sizeof(label));
+  EXPECT_STREQ(label, "docker:5d41402abc4b");
+  process_cgroup_label("/user.slice/user-1000.slice/user@1000.service/app.slice/app-firefox-1234.scope", label,
+                       sizeof(label));
+  EXPECT_STREQ(label, "app-firefox-1234.scope");
+  process_cgroup_label("/system.slice/slurmstepd.scope/job_42/step_0/user/task_0", label, sizeof(label));
+  EXPECT_STREQ(label, "slurmstepd.scope");
+  process_cgroup_label("/", label, sizeof(label));
+  EXPECT_STREQ(label, "/");
+}
+
+TEST(ProcessCgroup, JobIdFromPath) {
+  char job_id[PROCESS_JOB_ID_LEN];
+  EXPECT_TRUE(process_cgroup_job_id("/system.slice/slurmstepd.scope/job_4242/step_0/user/task_0", job_id,
+                                    sizeof(job_id)));
+  EXPECT_STREQ(job_id, "4242");
+  EXPECT_TRUE(process_cgroup_job_id("/slurm/uid_1000/job_17/step_batch/task_0", job_id, sizeof(job_id)));
+  EXPECT_STREQ(job_id, "17");
+  EXPECT_TRUE(process_cgroup_job_id("/pbs_jobs.service/jobid/1234.pbs-server", job_id, sizeof(job_id)));
+  EXPECT_STREQ(job_id, "1234.pbs-server");
+  EXPECT_TRUE(process_cgroup_job_id("/pbspro/98.head", job_id, sizeof(job_id)));
+  EXPECT_STREQ(job_id, "98.head");
+  EXPECT_FALSE(process_cgroup_job_id("/user.slice/user-1000.slice/job_12.scope", job_id, sizeof(job_id)));
+  EXPECT_FALSE(process_cgroup_job_id("/system.slice/slurmd.service", job_id, sizeof(job_id)));
+  EXPECT_FALSE(process_cgroup_job_id("", job_id, sizeof(job_id)));
+}
+
+TEST(DeviceTopology, PciePathDistance) {
+  const char switch_port1[] = "/sys/devices/pci0000:00/0000:00:01.0/0000:01:00.0/0000:02:08.0/0000:03:00.0";
+  const char switch_port2[] = "/sys/devices/pci0000:00/0000:00:01.0/0000:01:00.0/0000:02:10.0/0000:04:00.0";
+  const char nested_switch[] =
+      "/sys/devices/pci0000:00/0000:00:01.0/0000:01:00.0/0000:02:18.0/0000:05:00.0/0000:06:00.0/0000:07:00.0";
+  const char other_root_port[] = "/sys/devices/pci0000:00/0000:00:02.0/0000:08:00.0";
+  const char other_root[] = "/sys/devices/pci0000:80/0000:80:01.0/0000:81:00.0";
+  EXPECT_EQ(topology_pcie_link_between(switch_port1, 0, switch_port2, 0), topology_link_pcie_switch);
+  EXPECT_EQ(topology_pcie_link_between(switch_port1, 0, nested_switch, 0), topology_link_pcie_bridges);
+  EXPECT_EQ(topology_pcie_link_between(switch_port1, 0, other_root_port, 0), topology_link_host_bridge);
+  EXPECT_EQ(topology_pcie_link_between(switch_port1, 0, other_root, 0), topology_link_numa_node);
+  EXPECT_EQ(topology_pcie_link_between(switch_port1, 0, other_root, 1), topology_link_system);
+  EXPECT_EQ(topology_pcie_link_between(switch_port1, 0, "/sys/devices/platform/gpu", 0), topology_link_unknown);
+  EXPECT_NEAR(topology_pcie_bandwidth(16., 16), 31.5, 0.1);
+  EXPECT_NEAR(topology_pcie_bandwidth(2.5, 1), 0.25, 0.01);
+}
+
+TEST(Collector, SnapshotRoundTripAndDelta) {
+  char cmdline[] = "python train.py";
+  struct gpu_process processes[2] = {};
+  processes[0].pid = 42;
+  SET_GPUINFO_PROCESS(&processes[0], gpu_memory_usage, 1024);
+  SET_GPUINFO_PROCESS(&processes[0], cmdline, cmdline);
+  SET_GPUINFO_PROCESS(&processes[0], starvation, gpu_process_starved_io);
+  processes[1].pid = 43;
+  struct gpu_info devices[2] = {};
+  for (unsigned i = 0; i < 2; ++i) {
+    snprintf(devices[i].pdev, PDEV_LEN, "0000:0%u:00.0", i + 1);
+    SET_GPUINFO_STATIC(&devices[i].static_info, temperature_slowdown_threshold, 90);
+    SET_GPUINFO_DYNAMIC(&devices[i].dynamic_info, gpu_util_rate, 10 * (i + 1));
+    SET_GPUINFO_DYNAMIC(&devices[i].dynamic_info, gpu_temp, 50);
+  }
+  devices[1].processes = processes;
+  devices[1].processes_count = 2;
+  struct gpu_info *device_ptrs[2] = {&devices[0], &devices[1]};
+  struct collector_device_history histories[2] = {};
+
+  struct collector_buffer buffer = {};
+  struct collector_snapshot snapshot = {};
+  for (unsigned i = 0; i < 2; ++i)
+    collector_device_history_update(&histories[i], &devices[i], 1);
+  collector_encode_snapshot(2, device_ptrs, histories, 1, 0, &buffer);
+  ASSERT_TRUE(collector_decode_snapshot(buffer.data, buffer.size, &snapshot));
+  ASSERT_EQ(snapshot.devices_count, 2u);
+  EXPECT_EQ(snapshot.sequence, 1u);
+  EXPECT_STREQ(snapshot.devices[1].pdev, "0000:02:00.0");
+  EXPECT_TRUE(snapshot.devices[1].has_static_info);
+  EXPECT_EQ(snapshot.devices[1].static_info.temperature_slowdown_threshold, 90u);
+  EXPECT_EQ(snapshot.devices[1].dynamic_info.gpu_util_rate, 20u);
+  ASSERT_EQ(snapshot.devices[1].processes_count, 2u);
+  EXPECT_EQ(snapshot.devices[1].processes[0].pid, 42);
+  EXPECT_EQ(snapshot.devices[1].processes[0].gpu_memory_usage, 1024u);
+  EXPECT_EQ(snapshot.devices[1].processes[0].starvation, gpu_process_starved_io);
+  ASSERT_TRUE(GPUINFO_PROCESS_FIELD_VALID(&snapshot.devices[1].processes[0], cmdline));
+  EXPECT_STREQ(snapshot.devices[1].processes[0].cmdline, cmdline);
+  EXPECT_FALSE(GPUINFO_PROCESS_FIELD_VALID(&snapshot.devices[1].processes[1], cmdline));
+
+  // Only the utilization of the first device changed: the rest keeps its previous data
+  size_t full_size = buffer.size;
+  SET_GPUINFO_DYNAMIC(&devices[0].dynamic_info, gpu_util_rate, 99);
+  for (unsigned i = 0; i < 2; ++i)
+    collector_device_history_update(&histories[i], &devices[i], 2);
+  collector_encode_snapshot(2, device_ptrs, histories, 2, 1, &buffer);
+  EXPECT_LT(buffer.size, full_size / 4);
+  ASSERT_TRUE(collector_decode_snapshot(buffer.data, buffer.size, &snapshot));
+  EXPECT_EQ(snapshot.sequence, 2u);
+  EXPECT_EQ(snapshot.devices[0].dynamic_info.gpu_util_rate, 99u);
+  EXPECT_EQ(snapshot.devices[0].dynamic_info.gpu_temp, 50u);
+  EXPECT_EQ(snapshot.devices[1].dynamic_info.gpu_util_rate, 20u);
+  EXPECT_EQ(snapshot.devices[1].processes_count, 2u);
+
+  // Then a process field and the process list of the second device
+  SET_GPUINFO_PROCESS(&processes[1], gpu_usage, 30);
+  for (unsigned i = 0; i < 2; ++i)
+    collector_device_history_update(&histories[i], &devices[i], 3);
+  collector_encode_snapshot(2, device_ptrs, histories, 3, 2, &buffer);
+  ASSERT_TRUE(collector_decode_snapshot(buffer.data, buffer.size, &snapshot));
+  ASSERT_EQ(snapshot.devices[1].processes_count, 2u);
+  EXPECT_EQ(snapshot.devices[1].processes[1].gpu_usage, 30u);
+  EXPECT_STREQ(snapshot.devices[1].processes[0].cmdline, cmdline);
+  devices[1].processes = &processes[1];
+  devices[1].processes_count = 1;
+  for (unsigned i = 0; i < 2; ++i)
+    collector_device_history_update(&histories[i], &devices[i], 4);
+  collector_encode_snapshot(2, device_ptrs, histories, 4, 3, &buffer);
+  ASSERT_TRUE(collector_decode_snapshot(buffer.data, buffer.size, &snapshot));
+  EXPECT_EQ(snapshot.devices[1].dynamic_info.gpu_util_rate, 20u);
+  ASSERT_EQ(snapshot.devices[1].processes_count, 1u);
+  EXPECT_EQ(snapshot.devices[1].processes[0].pid, 43);
+  EXPECT_EQ(snapshot.devices[1].processes[0].gpu_usage, 30u);
+
+  // Truncated payloads and out of range values are rejected
+  EXPECT_FALSE(collector_decode_snapshot(buffer.data, buffer.size - 1, &snapshot));
+  SET_GPUINFO_PROCESS(&processes[1], starvation, gpu_process_starved_io);
+  collector_device_history_update(&histories[1], &devices[1], 5);
+  collector_encode_snapshot(2, device_ptrs, histories, 5, 4, &buffer);
+  ASSERT_TRUE(collector_decode_snapshot(buffer.data, buffer.size, &snapshot));
+  ASSERT_EQ(buffer.data[buffer.size - 4], (char)gpu_process_starved_io);
+  buffer.data[buffer.size - 4] = (char)gpu_process_starvation_count;
+  EXPECT_FALSE(collector_decode_snapshot(buffer.data, buffer.size, &snapshot));
+  // A peer claiming billions of devices gets nothing allocated
+  buffer.data[buffer.size - 4] = (char)gpu_process_starved_io;
+  memset(buffer.data + 8, 0xff, 4);
+  EXPECT_FALSE(collector_decode_snapshot(buffer.data, buffer.size, &snapshot));
+  EXPECT_EQ(snapshot.devices_count, 2u);
+
+  for (unsigned i = 0; i < 2; ++i)
+    collector_device_history_free(&histories[i]);
+  collector_snapshot_free(&snapshot);
+  collector_buffer_free(&buffer);
+}
+
+TEST(ShmSnapshot, PublishAndRead) {
+  struct gpu_process processes[3] = {};
+  for (unsigned i = 0; i < 3; ++i) {
+    processes[i].pid = 100 + i;
+    SET_GPUINFO_PROCESS(&processes[i], gpu_usage, 10 * i);
+  }
+  struct gpu_info devices[2] = {};
+  LIST_HEAD(device_list);
+  for (unsigned i = 0; i < 2; ++i) {
+    snprintf(devices[i].pdev, PDEV_LEN, "0000:0%u:00.0", i + 1);
+    list_add_tail(&devices[i].list, &device_list);
+  }
+  strcpy(devices[0].static_info.device_name, "Test GPU");
+  SET_VALID(gpuinfo_device_name_valid, devices[0].static_info.valid);
+  SET_GPUINFO_DYNAMIC(&devices[1].dynamic_info, gpu_util_rate, 55);
+  devices[0].processes = processes;
+  devices[0].processes_count = 1;
+  devices[1].processes = processes + 1;
+  devices[1].processes_count = 2;
+
+  char name[64];
+  snprintf(name, sizeof(name), "/nvtop-test-%d", (int)getpid());
+  struct shm_publisher *publisher = shm_publisher_create(name);
+  ASSERT_NE(publisher, nullptr);
+  shm_publisher_publish(publisher, &device_list);
+  const struct nvtop_shm_segment *segment = nvtop_shm_open(name);
+  ASSERT_NE(segment, nullptr);
+  // The segment of a running publisher is not taken over
+  EXPECT_EQ(shm_publisher_create(name), nullptr);
+  std::unique_ptr<struct nvtop_shm_segment> snapshot(new struct nvtop_shm_segment);
+  ASSERT_TRUE(nvtop_shm_read(segment, snapshot.get()));
+  EXPECT_EQ(snapshot->sequence, 2u);
+  ASSERT_EQ(snapshot->devices_count, 2u);
+  EXPECT_STREQ(snapshot->devices[0].name, "Test GPU");
+  EXPECT_FALSE(snapshot->devices[0].valid & nvtop_shm_device_gpu_util);
+  EXPECT_EQ(snapshot->devices[1].gpu_util, 55u);
+  EXPECT_EQ(snapshot->devices[1].processes_offset, 1u);
+  ASSERT_EQ(snapshot->devices[1].processes_count, 2u);
+  EXPECT_EQ(snapshot->processes[2].pid, 102);
+  EXPECT_EQ(snapshot->processes[2].device_index, 1u);
+  EXPECT_EQ(snapshot->processes[2].gpu_util, 20u);
+  // A publisher that died during an update leaves the segment stale
+  int fd = shm_open(name, O_RDWR, 0);
+  ASSERT_GE(fd, 0);
+  void *mapping = mmap(NULL, sizeof(struct nvtop_shm_segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  ASSERT_NE(mapping, MAP_FAILED);
+  static_cast<struct nvtop_shm_segment *>(mapping)->sequence = 3;
+  EXPECT_FALSE(nvtop_shm_read(segment, snapshot.get()));
+  munmap(mapping, sizeof(struct nvtop_shm_segment));
+  nvtop_shm_close(segment);
+  shm_publisher_destroy(publisher);
+}
+
+TEST(TraceExport, JsonCountersAndSlices) {
+  struct gpu_process process = {};
+  process.pid = 1234;
+  char cmdline[] = "train \"model\"";
+  SET_GPUINFO_PROCESS(&process, cmdline, cmdline);
+  struct gpu_info device = {};
+  LIST_HEAD(device_list);
+  list_add_tail(&device.list, &device_list);
+  strcpy(device.static_info.device_name, "Test GPU");
+  SET_VALID(gpuinfo_device_name_valid, device.static_info.valid);
+  SET_GPUINFO_DYNAMIC(&device.dynamic_info, gpu_util_rate, 42);
+  SET_GPUINFO_DYNAMIC(&device.dynamic_info, power_draw, 150000);
+  device.processes = &process;
+  device.processes_count = 1;
+
+  char path[64];
+  snprintf(path, sizeof(path), "/tmp/nvtop-trace-test-%d.json", (int)getpid());
+  struct trace_writer *writer = trace_writer_open(path);
+  ASSERT_NE(writer, nullptr);
+  trace_writer_sample(writer, &device_list, 1000000);
+  device.processes_count = 0;
+  trace_writer_sample(writer, &device_list, 2000000);
+  EXPECT_TRUE(trace_writer_close(writer));
+
+  // A full disk is reported instead of leaving a truncated trace behind silently
+  struct trace_writer *full = trace_writer_open("/dev/full");
+  ASSERT_NE(full, nullptr);
+  trace_writer_sample(full, &device_list, 1000000);
+  EXPECT_FALSE(trace_writer_close(full));
+
+  std::ifstream file(path);
+  std::string trace((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  unlink(path);
+  EXPECT_NE(trace.find("\"args\":{\"name\":\"GPU 0: Test GPU\"}"), std::string::npos);
+  EXPECT_NE(trace.find("{\"ph\":\"C\",\"name\":\"GPU utilization (%)\",\"pid\":1,\"ts\":1000.000,\"args\":{\"value\":42.00}}"),
+            std::string::npos);
+  EXPECT_NE(trace.find("\"name\":\"Power (W)\",\"pid\":1,\"ts\":2000.000,\"args\":{\"value\":150.00}"),
+            std::string::npos);
+  EXPECT_EQ(trace.find("Temperature"), std::string::npos);
+  EXPECT_NE(trace.find("{\"ph\":\"B\",\"pid\":1,\"tid\":1234,\"ts\":1000.000,\"name\":\"1234 train \\\"model\\\"\"}"),
+            std::string::npos);
+  EXPECT_NE(trace.find("{\"ph\":\"E\",\"pid\":1,\"tid\":1234,\"ts\":2000.000}"), std::string::npos);
+  EXPECT_EQ(trace.substr(trace.size() - 4), "\n]}\n");
+}
+
+TEST(JsonUtil, EscapesStrings) {
+  char *text = NULL;
+  size_t size;
+  FILE *file = open_memstream(&text, &size);
+  ASSERT_NE(file, nullptr);
+  json_write_string(file, "say \"hi\"\\\n\t\x01", 0);
+  json_write_string(file, "truncated", 5);
+  fclose(file);
+  EXPECT_STREQ(text, "\"say \\\"hi\\\"\\\\\\n\\t\\u0001\"\"trunc\"");
+  free(text);
+}
+
+TEST(FlightRecorder, WritesTheSamplesAroundATrigger) {
+  struct flight_trigger triggers[FLIGHT_RECORDER_MAX_TRIGGERS];
+  unsigned count;
+  ASSERT_TRUE(flight_triggers_parse("gpu<10,temp>85.5,throttle,exit", &count, triggers));
+  ASSERT_EQ(count, 4u);
+  EXPECT_TRUE(triggers[0].kind == flight_trigger_gpu_util && triggers[0].below && triggers[0].threshold == 10.);
+  EXPECT_TRUE(triggers[1].kind == flight_trigger_temperature && !triggers[1].below && triggers[1].threshold == 85.5);
+  EXPECT_EQ(triggers[3].kind, flight_trigger_process_exit);
+  EXPECT_FALSE(flight_triggers_parse("gpu", &count, triggers));
+  EXPECT_FALSE(flight_triggers_parse("exit<3", &count, triggers));
+  EXPECT_FALSE(flight_triggers_parse("fan>50", &count, triggers));
+  EXPECT_FALSE(flight_triggers_parse("mem>9x", &count, triggers));
+
+  char directory[] = "/tmp/nvtop-flight-test-XXXXXX";
+  ASSERT_NE(mkdtemp(directory), nullptr);
+  struct gpu_info device = {};
+  LIST_HEAD(device_list);
+  list_add_tail(&device.list, &device_list);
+  strcpy(device.static_info.device_name, "Test GPU");
+  SET_VALID(gpuinfo_device_name_valid, device.static_info.valid);
+  struct flight_recorder *recorder = flight_recorder_open(directory, "gpu<10", 2., 1.);
+  ASSERT_NE(recorder, nullptr);
+  // The utilization collapses at 104, the samples from 102 to 105 are written whatever the sampling rate. The wall
+  // clock is set back 500s at 103, which only shows in the times written.
+  for (double second = 100.; second <= 107.; second += 0.25) {
+    SET_GPUINFO_DYNAMIC(&device.dynamic_info, gpu_util_rate, second < 104. ? 50 : 5);
+    flight_recorder_sample(recorder, &device_list, second, second < 103. ? second + 1000. : second + 500.);
+  }
+  flight_recorder_close(recorder);
+
+  std::vector<std::string> lines;
+  DIR *dir = opendir(directory);
+  ASSERT_NE(dir, nullptr);
+  while (struct dirent *entry = readdir(dir)) {
+    if (entry->d_name[0] == '.')
+      continue;
+    std::string path = std::string(directory) + "/" + entry->d_name;
+    std::ifstream file(path);
+    for (std::string line; std::getline(file, line);)
+      lines.push_back(line);
+    unlink(path.c_str());
+  }
+  closedir(dir);
+  rmdir(directory);
+  ASSERT_EQ(lines.size(), 14u);
+  EXPECT_EQ(lines[0], "{\"trigger\":\"GPU0 gpu<10 (5.0)\",\"time\":604.000,\"before\":2,\"after\":1,"
+                      "\"devices\":[\"Test GPU\"]}");
+  EXPECT_EQ(lines[1], "{\"time\":1102.000,\"devices\":[{\"id\":0,\"gpu_util\":50}],\"processes\":[]}");
+  EXPECT_EQ(lines[13].substr(0, 15), "{\"time\":605.000");
+}
+
+namespace {
+unsigned long long fake_energy_counter;
+void fake_refresh_dynamic_info(struct gpu_info *device) {
+  RESET_ALL(device->dynamic_info.valid);
+  SET_GPUINFO_DYNAMIC(&device->dynamic_info, energy_counter, fake_energy_counter);
+}
+
+// The processes are rebuilt at every refresh
+void fake_refresh_processes(struct gpu_process processes[2]) {
+  for (unsigned i = 0; i < 2; ++i)
+    RESET_ALL(processes[i].valid);
+  processes[0].pid = 10;
+  SET_GPUINFO_PROCESS(&processes[0], gpu_usage, 30);
+  processes[1].pid = 11;
+  SET_GPUINFO_PROCESS(&processes[1], gpu_usage, 5);
+  SET_GPUINFO_PROCESS(&processes[1], encode_usage, 5);
+}
+} // namespace
+
+TEST(Energy, ApportionedByEngineUsage) {
+  struct gpu_vendor vendor = {};
+  vendor.refresh_dynamic_info = fake_refresh_dynamic_info;
+  struct gpu_process processes[2] = {};
+  struct gpu_info device = {};
+  device.vendor = &vendor;
+  device.processes = processes;
+  device.processes_count = 2;
+  LIST_HEAD(device_list);
+  list_add_tail(&device.list, &device_list);
+
+  fake_energy_counter = 1000;
+  gpuinfo_refresh_dynamic_info(&device_list);
+  fake_refresh_processes(processes);
+  gpuinfo_account_processes(&device_list);
+  EXPECT_EQ(device.dynamic_info.energy_consumed, 0u);
+  EXPECT_EQ(processes[0].energy, 0u);
+
+  fake_energy_counter = 3000;
+  gpuinfo_refresh_dynamic_info(&device_list);
+  EXPECT_TRUE(GPUINFO_DYNAMIC_FIELD_VALID(&device.dynamic_info, power_draw));
+  fake_refresh_processes(processes);
+  gpuinfo_account_processes(&device_list);
+  EXPECT_EQ(device.dynamic_info.energy_consumed, 2000u);
+  EXPECT_EQ(processes[0].energy, 1500u);
+  EXPECT_EQ(processes[1].energy, 500u);
+
+  // The energy of the processes accumulates, a counter reset is not accounted
+  fake_energy_counter = 500;
+  gpuinfo_refresh_dynamic_info(&device_list);
+  fake_refresh_processes(processes);
+  gpuinfo_account_processes(&device_list);
+  EXPECT_EQ(device.dynamic_info.energy_consumed, 2000u);
+  EXPECT_EQ(processes[0].energy, 1500u);
+  gpuinfo_clear_cache();
+}
+
+TEST(Energy, ApportionedByEngineTime) {
+  struct gpu_vendor vendor = {};
+  vendor.refresh_dynamic_info = fake_refresh_dynamic_info;
+  struct gpu_process processes[2] = {};
+  struct gpu_info device = {};
+  device.vendor = &vendor;
+  device.processes = processes;
+  device.processes_count = 2;
+  LIST_HEAD(device_list);
+  list_add_tail(&device.list, &device_list);
+
+  // The rounded usage percentages disagree with the engine time counters, which win
+  const uint64_t gfx_engine_used[2][2] = {{1000000000ull, 1000000000ull}, {4000000000ull, 2000000000ull}};
+  for (unsigned refresh = 0; refresh < 2; ++refresh) {
+    fake_energy_counter = 1000 + 2000 * refresh;
+    gpuinfo_refresh_dynamic_info(&device_list);
+    for (unsigned i = 0; i < 2; ++i) {
+      RESET_ALL(processes[i].valid);
+      processes[i].pid = 20 + i;
+      SET_GPUINFO_PROCESS(&processes[i], gfx_engine_used, gfx_engine_used[refresh][i]);
+      SET_GPUINFO_PROCESS(&processes[i], gpu_usage, i ? 90 : 10);
+    }
+    gpuinfo_account_processes(&device_list);
+  }
+  EXPECT_EQ(processes[0].energy, 1500u);
+  EXPECT_EQ(processes[1].energy, 500u);
+  device.processes_count = 0;
+  gpuinfo_account_processes(&device_list);
+  gpuinfo_clear_cache();
+}
+
+TEST(ProcessAccounting, LifetimeValuesAndExitSummary) {
+  struct gpu_vendor vendor = {};
+  vendor.refresh_dynamic_info = fake_refresh_dynamic_info;
+  struct gpu_process process = {};
+  struct gpu_info device = {};
+  strcpy(device.pdev, "0000:01:00.0");
+  device.vendor = &vendor;
+  device.processes = &process;
+  device.processes_count = 1;
+  LIST_HEAD(device_list);
+  list_add_tail(&device.list, &device_list);
+
+  char path[64];
+  snprintf(path, sizeof(path), "/tmp/nvtop-summary-test-%d.txt", (int)getpid());
+  struct process_summary *summary = process_summary_open(path);
+  ASSERT_NE(summary, nullptr);
+  gpuinfo_set_process_exit_callback(process_summary_record, summary);
+
+  const uint64_t gfx_engine_used[2] = {1000000000ull, 3500000000ull};
+  const unsigned long long memory[2] = {100ull << 20, 50ull << 20};
+  const unsigned gpu_usage[2] = {50, 30};
+  char cmdline[] = "train.py";
+  for (unsigned i = 0; i < 2; ++i) {
+    RESET_ALL(process.valid);
+    process.pid = 42;
+    SET_GPUINFO_PROCESS(&process, cmdline, cmdline);
+    SET_GPUINFO_PROCESS(&process, gfx_engine_used, gfx_engine_used[i]);
+    SET_GPUINFO_PROCESS(&process, gpu_memory_usage, memory[i]);
+    SET_GPUINFO_PROCESS(&process, gpu_usage, gpu_usage[i]);
+    gpuinfo_account_processes(&device_list);
+  }
+  // Only the engine time used while the process was observed is counted
+  EXPECT_EQ(process.gpu_time, 2500000000ull);
+  EXPECT_EQ(process.gpu_memory_peak, 100ull << 20);
+  EXPECT_EQ(process.gpu_usage_average, 40u);
+
+  device.processes_count = 0;
+  gpuinfo_account_processes(&device_list);
+  gpuinfo_set_process_exit_callback(NULL, NULL);
+  process_summary_close(summary);
+
+  std::ifstream file(path);
+  std::string header, row;
+  std::getline(file, header);
+  std::getline(file, row);
+  unlink(path);
+  EXPECT_EQ(header.find("    PID DEVICE"), 0u);
+  EXPECT_EQ(row.find("     42 0000:01:00.0"), 0u);
+  EXPECT_NE(row.find(" 2.5s     40%     100MiB        N/A train.py"), std::string::npos);
+}
+
+TEST(ProcessAccounting, IdleHeldMemoryAndReport) {
+  struct gpu_vendor vendor = {};
+  vendor.refresh_dynamic_info = fake_refresh_dynamic_info;
+  std::array<struct gpu_process, 4> processes = {};
+  struct gpu_info device = {};
+  strcpy(device.pdev, "0000:01:00.0");
+  device.vendor = &vendor;
+  device.processes = processes.data();
+  device.processes_count = processes.size();
+  LIST_HEAD(device_list);
+  list_add_tail(&device.list, &device_list);
+  gpuinfo_set_idle_memory_threshold(3ull << 30);
+
+  // Idle above the threshold, idle below it and busy
+  const unsigned long long memory[4] = {8ull << 30, 6ull << 30, 2ull << 30, 8ull << 30};
+  const unsigned gpu_usage[4] = {0, 0, 0, 80};
+  for (unsigned sample = 0; sample < 2; ++sample) {
+    for (unsigned i = 0; i < processes.size(); ++i) {
+      RESET_ALL(processes[i].valid);
+      processes[i].pid = 100 + i;
+      SET_GPUINFO_PROCESS(&processes[i], gpu_memory_usage, memory[i]);
+      SET_GPUINFO_PROCESS(&processes[i], gpu_usage, gpu_usage[i]);
+    }
+    gpuinfo_account_processes(&device_list);
+    usleep(20000);
+  }
+  EXPECT_GE(processes[0].idle_time, 20000000ull);
+  EXPECT_DOUBLE_EQ(processes[0].idle_memory_time, processes[0].idle_time / 1e9 * (8ull << 30));
+  EXPECT_DOUBLE_EQ(processes[1].idle_memory_time * 8., processes[0].idle_memory_time * 6.);
+  EXPECT_EQ(processes[2].idle_time, 0u);
+  EXPECT_TRUE(GPUINFO_PROCESS_FIELD_VALID(&processes[3], idle_memory_time));
+  EXPECT_EQ(processes[3].idle_memory_time, 0.);
+
+  // The report keeps the worst offenders, in order
+  struct idle_report *report = idle_report_open(1, 3ull << 30);
+  gpuinfo_set_process_exit_callback(idle_report_record, report);
+  device.processes_count = 0;
+  gpuinfo_account_processes(&device_list);
+  gpuinfo_set_process_exit_callback(NULL, NULL);
+  gpuinfo_set_idle_memory_threshold(GPUINFO_DEFAULT_IDLE_MEMORY_THRESHOLD);
+  char *text;
+  size_t text_size;
+  FILE *output = open_memstream(&text, &text_size);
+  idle_report_close(report, output);
+  fclose(output);
+  std::string lines(text);
+  free(text);
+  EXPECT_EQ(lines.find("Processes holding the most GPU memory while idle (above 3.0 GiB)\nRANK     PID DEVICE"), 0u);
+  EXPECT_NE(lines.find("\n   1     100 0000:01:00.0"), std::string::npos);
+  EXPECT_EQ(lines.find("     101 "), std::string::npos);
+
+  report = idle_report_open(2, 1ull << 30);
+  struct gpu_process ranked = {};
+  for (unsigned gib_hours : {1u, 3u, 2u}) {
+    ranked.pid = gib_hours;
+    SET_GPUINFO_PROCESS(&ranked, idle_memory_time, gib_hours * 3600. * (1ull << 30));
+    idle_report_record(&device, &ranked, 7200., report);
+  }
+  output = open_memstream(&text, &text_size);
+  idle_report_close(report, output);
+  fclose(output);
+  lines = text;
+  free(text);
+  EXPECT_NE(lines.find("   1       3 0000:01:00.0     N/A          3.00GiBh      0.0s     2h00m       0MiB \n"
+                       "   2       2 "),
+            std::string::npos);
+  EXPECT_EQ(lines.find("1.00GiBh"), std::string::npos);
+}
+
+TEST(UsageLedger, DailyTotalsAndIndexedReport) {
+  struct gpu_process process = {};
+  struct gpu_info device = {};
+  device.processes = &process;
+  device.processes_count = 1;
+  LIST_HEAD(device_list);
+  list_add_tail(&device.list, &device_list);
+
+  char path[64];
+  snprintf(path, sizeof(path), "/tmp/nvtop-ledger-test-%d", (int)getpid());
+  struct usage_ledger *ledger = usage_ledger_open(path);
+  ASSERT_NE(ledger, nullptr);
+
+  struct tm day = {};
+  day.tm_year = 2026 - 1900;
+  day.tm_mon = 9;
+  day.tm_mday = 17;
+  day.tm_hour = 12;
+  day.tm_isdst = -1;
+  time_t first_day = mktime(&day);
+  char user[] = "alice";
+  char cmdline[] = "/usr/bin/python3 train.py";
+  process.pid = 42;
+  SET_GPUINFO_PROCESS(&process, user_name, user);
+  SET_GPUINFO_PROCESS(&process, cmdline, cmdline);
+  SET_GPUINFO_PROCESS(&process, gpu_memory_usage, 1ull << 30);
+  // The values at the first sample are a baseline
+  SET_GPUINFO_PROCESS(&process, gpu_time, 5000000000ull);
+  SET_GPUINFO_PROCESS(&process, energy, 1000ull);
+  usage_ledger_sample(ledger, &device_list, first_day, 1000000000ull);
+  SET_GPUINFO_PROCESS(&process, gpu_time, 1805000000000ull);
+  SET_GPUINFO_PROCESS(&process, energy, 3600001000ull);
+  usage_ledger_sample(ledger, &device_list, first_day, 3601000000000ull);
+  EXPECT_TRUE(usage_ledger_flush(ledger));
+
+  // A new process the next day is counted whole
+  process.pid = 43;
+  SET_GPUINFO_PROCESS(&process, gpu_time, 3600000000000ull);
+  RESET_GPUINFO_PROCESS(&process, energy);
+  RESET_GPUINFO_PROCESS(&process, gpu_memory_usage);
+  usage_ledger_sample(ledger, &device_list, first_day + 86400, 3602000000000ull);
+  EXPECT_TRUE(usage_ledger_flush(ledger));
+  // The records of a day after the wall clock was set back are found as well
+  process.pid = 44;
+  SET_GPUINFO_PROCESS(&process, gpu_time, 1800000000000ull);
+  usage_ledger_sample(ledger, &device_list, first_day, 3603000000000ull);
+  usage_ledger_close(ledger);
+
+  // A record torn by a crash is ignored and the next ones start on their own line
+  FILE *file = fopen(path, "a");
+  fputs("2026-10-18\tbob\tjob\t100", file);
+  fclose(file);
+  ledger = usage_ledger_open(path);
+  ASSERT_NE(ledger, nullptr);
+  usage_ledger_close(ledger);
+
+  char report_path[80];
+  snprintf(report_path, sizeof(report_path), "%s.report", path);
+  file = fopen(report_path, "w");
+  EXPECT_TRUE(usage_ledger_report(path, 20261017u, 20261017u, file));
+  EXPECT_TRUE(usage_ledger_report(path, 20261018u, 20261018u, file));
+  fclose(file);
+
+  std::ifstream report(report_path);
+  std::vector<std::string> lines;
+  for (std::string line; std::getline(report, line);)
+    lines.push_back(line);
+  std::string index_path = std::string(path) + ".idx";
+  unlink(path);
+  unlink(index_path.c_str());
+  unlink(report_path);
+  ASSERT_EQ(lines.size(), 10u);
+  EXPECT_EQ(lines[0], "GPU usage from 2026-10-17 to 2026-10-17");
+  // Half an hour of GPU time twice, 1GiB over an hour and 3.6MJ
+  EXPECT_EQ(lines[2], "alice            *                               1.000            1.000        1.000");
+  EXPECT_EQ(lines[3], "alice            python3                         1.000            1.000        1.000");
+  EXPECT_EQ(lines[5], "GPU usage from 2026-10-18 to 2026-10-18");
+  EXPECT_EQ(lines[7], "alice            *                               1.000            0.000        0.000");
+  EXPECT_EQ(lines[9], "*                *                               1.000            0.000        0.000");
+}
+
+TEST(InterfaceHeatmap, ShiftsColumnsOnNewSamples) {
+  for (bool newest_first : {false, true}) {
+    struct heatmap heatmap;
+    heatmap_alloc(2, 4, newest_first, &heatmap);
+    // Every column is filled on the first update
+    EXPECT_EQ(heatmap_advance(&heatmap, 3), 4u);
+    for (unsigned row = 0; row < 2; ++row) {
+      for (unsigned age = 0; age < 4; ++age)
+        *heatmap_cell(&heatmap, row, age) = age < 3 ? 10 * row + age : HEATMAP_NO_DATA;
+    }
+    EXPECT_EQ(heatmap_advance(&heatmap, 3), 0u);
+
+    // Two new samples: the older cells move two columns away from the newest one
+    EXPECT_EQ(heatmap_advance(&heatmap, 5), 2u);
+    for (unsigned row = 0; row < 2; ++row) {
+      EXPECT_EQ(*heatmap_cell(&heatmap, row, 2), 10 * row);
+      EXPECT_EQ(*heatmap_cell(&heatmap, row, 3), 10 * row + 1);
+    }
+    EXPECT_EQ(heatmap.cells[newest_first ? 3 : 0], 1);
+
+    // A shift as wide as the heatmap refills it whole
+    EXPECT_EQ(heatmap_advance(&heatmap, 9), 4u);
+    heatmap_free(&heatmap);
+  }
+}
+
+TEST(InterfacePlotScale, RoundsToUnitPrefixes) {
+  struct plot_scale scale;
+  plot_autoscale(plot_unit_percent, 12345., &scale);
+  EXPECT_EQ(scale.full_scale, 100.);
+  EXPECT_STREQ(scale.unit_name, "%");
+
+  // 12 GiB/s of PCIe traffic rounds up to 20 GiB/s
+  plot_autoscale(plot_unit_kib_per_second, 12. * 1024 * 1024, &scale);
+  EXPECT_STREQ(scale.unit_name, "GiB/s");
+  EXPECT_DOUBLE_EQ(scale.full_scale * scale.display_factor, 20.);
+  EXPECT_DOUBLE_EQ(scale.full_scale, 20. * 1024 * 1024);
+
+  // 230 W rounds up to 250 W, 950 MHz to 1 GHz
+  plot_autoscale(plot_unit_milliwatt, 230000., &scale);
+  EXPECT_STREQ(scale.unit_name, "W");
+  EXPECT_DOUBLE_EQ(scale.full_scale, 250000.);
+  plot_autoscale(plot_unit_megahertz, 950., &scale);
+  EXPECT_STREQ(scale.unit_name, "GHz");
+  EXPECT_DOUBLE_EQ(scale.full_scale * scale.display_factor, 1.);
+
+  // No data still has a non-empty scale
+  plot_autoscale(plot_unit_mebibyte, 0., &scale);
+  EXPECT_STREQ(scale.unit_name, "MiB");
+  EXPECT_DOUBLE_EQ(scale.full_scale, 1.);
+
+  char labels[PLOT_Y_LABELS][PLOT_Y_LABEL_SIZE];
+  plot_autoscale(plot_unit_megahertz, 950., &scale);
+  plot_y_labels(&scale, labels);
+  const char *expected[PLOT_Y_LABELS] = {"1", ".75", ".5", ".25", "0"};
+  for (unsigned i = 0; i < PLOT_Y_LABELS; ++i)
+    EXPECT_STREQ(labels[i], expected[i]);
+  plot_autoscale(plot_unit_milliwatt, 230000., &scale);
+  plot_y_labels(&scale, labels);
+  EXPECT_STREQ(labels[1], "188");
+  plot_autoscale(plot_unit_kib_per_second, 5. * 1024, &scale);
+  plot_y_labels(&scale, labels);
+  EXPECT_STREQ(labels[3], "1.2");
+}
+
+TEST(InterfaceHistory, RangeLookups) {
+  struct sample_clock clock;
+  sample_clock_alloc(4, &clock);
+  for (unsigned i = 0; i < 6; ++i)
+    sample_clock_push(&clock, i * 1.5);
+  // The two oldest times were overwritten
+  ASSERT_EQ(clock.count, 4u);
+  std::array<double, 4> times;
+  sample_clock_copy(&clock, times.data());
+  EXPECT_EQ(times, (std::array<double, 4>{3., 4.5, 6., 7.5}));
+  EXPECT_EQ(history_lower_bound(4, times.data(), 0.), 0u);
+  EXPECT_EQ(history_lower_bound(4, times.data(), 4.5), 1u);
+  EXPECT_EQ(history_lower_bound(4, times.data(), 5.), 2u);
+  EXPECT_EQ(history_lower_bound(4, times.data(), 8.), 4u);
+  sample_clock_free(&clock);
+
+  std::vector<unsigned> values = {3, 9, 1, 4, 7, 2, 8, 5, 6, 0, 11};
+  struct history_series series;
+  history_series_alloc(values.size(), &series);
+  std::copy(values.begin(), values.end(), history_series_samples(&series));
+  history_series_build(&series);
+  for (unsigned begin = 0; begin < values.size(); ++begin) {
+    for (unsigned end = begin + 1; end <= values.size(); ++end)
+      EXPECT_EQ(history_series_max(&series, begin, end), *std::max_element(&values[begin], &values[0] + end));
+  }
+  history_series_free(&series);
+}
+
+namespace {
+std::vector<std::string> read_fifo_lines(int fd) {
+  std::string data;
+  char buffer[4096];
+  for (ssize_t size; (size = read(fd, buffer, sizeof(buffer))) > 0;)
+    data.append(buffer, size);
+  std::vector<std::string> lines;
+  for (size_t begin = 0, end; (end = data.find('\n', begin)) != std::string::npos; begin = end + 1)
+    lines.push_back(data.substr(begin, end - begin));
+  return lines;
+}
+} // namespace
+
+TEST(AlertRules, FiringIsDeduplicatedAndRateLimited) {
+  struct alert_clause clauses[ALERT_MAX_CLAUSES];
+  unsigned count;
+  ASSERT_TRUE(alert_condition_parse("gpu < 10 && procmem > 10G", &count, clauses));
+  ASSERT_EQ(count, 2u);
+  EXPECT_TRUE(clauses[0].metric == alert_metric_gpu_util && clauses[0].below && clauses[0].threshold == 10.);
+  EXPECT_TRUE(clauses[1].metric == alert_metric_process_memory && clauses[1].threshold == 10737418240.);
+  ASSERT_TRUE(alert_condition_parse("temp>slowdown-5", &count, clauses));
+  EXPECT_TRUE(clauses[0].reference == alert_reference_slowdown && clauses[0].threshold == -5.);
+  EXPECT_FALSE(alert_condition_parse("gpu < 10 &&", &count, clauses));
+  EXPECT_FALSE(alert_condition_parse("gpu = 10", &count, clauses));
+  EXPECT_FALSE(alert_condition_parse("mem > slowdown", &count, clauses));
+  EXPECT_FALSE(alert_condition_parse("vram > 1", &count, clauses));
+
+  char fifo[64];
+  snprintf(fifo, sizeof(fifo), "/tmp/nvtop-alert-test-%d", (int)getpid());
+  ASSERT_EQ(mkfifo(fifo, 0600), 0);
+  int reader = open(fifo, O_RDONLY | O_NONBLOCK);
+  ASSERT_GE(reader, 0);
+  struct gpu_info device = {};
+  strcpy(device.pdev, "0000:01:00.0");
+  LIST_HEAD(device_list);
+  list_add_tail(&device.list, &device_list);
+  SET_GPUINFO_DYNAMIC(&device.dynamic_info, total_memory, 100);
+
+  unsigned rules_count = 0;
+  struct alert_rule *rules = NULL;
+  struct alert_rule *rule = alert_rules_append(&rules_count, &rules, "memory_full");
+  rule->condition = strdup("mem > 95");
+  rule->duration = 30.;
+  rule->fifo = strdup(fifo);
+  struct alert_engine *engine = alert_engine_create(rules_count, rules);
+  ASSERT_NE(engine, nullptr);
+  // Fires once after 30 s, then needs a new episode and the end of the cooldown
+  const std::vector<std::pair<double, unsigned>> used_memory = {{0., 96}, {20., 97}, {30., 96}, {40., 99}, {50., 50},
+                                                                {60., 96}, {90., 96}, {330., 96}};
+  for (const auto &sample : used_memory) {
+    SET_GPUINFO_DYNAMIC(&device.dynamic_info, used_memory, sample.second);
+    alert_engine_evaluate(engine, &device_list, sample.first);
+  }
+  alert_engine_destroy(engine);
+  std::vector<std::string> lines = read_fifo_lines(reader);
+  ASSERT_EQ(lines.size(), 2u);
+  EXPECT_NE(lines[0].find("\"alert\":\"memory_full\",\"device\":0,\"pdev\":\"0000:01:00.0\","
+                          "\"message\":\"memory_full on GPU0: mem=96.0\",\"dropped\":0}"),
+            std::string::npos);
+
+  // A flapping metric only gets the burst of the rate limiter through, the next firing counts the dropped ones
+  rule->cooldown = 0.;
+  rule->duration = 0.;
+  engine = alert_engine_create(rules_count, rules);
+  for (unsigned step = 0; step < 30; ++step) {
+    SET_GPUINFO_DYNAMIC(&device.dynamic_info, used_memory, step % 2 ? 50 : 96);
+    alert_engine_evaluate(engine, &device_list, step * .1);
+  }
+  SET_GPUINFO_DYNAMIC(&device.dynamic_info, used_memory, 50);
+  alert_engine_evaluate(engine, &device_list, 60.);
+  SET_GPUINFO_DYNAMIC(&device.dynamic_info, used_memory, 96);
+  alert_engine_evaluate(engine, &device_list, 61.);
+  alert_engine_destroy(engine);
+  lines = read_fifo_lines(reader);
+  ASSERT_EQ(lines.size(), (size_t)ALERT_MAX_FIRINGS_PER_MINUTE + 1);
+  EXPECT_NE(lines.back().find("\"dropped\":3}"), std::string::npos);
+
+  free(rule->fifo);
+  rule->fifo = NULL;
+  EXPECT_EQ(alert_engine_create(rules_count, rules), nullptr);
+  alert_rules_free(rules_count, rules);
+  close(reader);
+  unlink(fifo);
+}
+
+TEST(InterfaceOptions, AlertRulesKeptWhenSaving) {
+  char config[64];
+  snprintf(config, sizeof(config), "/tmp/nvtop-alert-config-%d.ini", (int)getpid());
+  {
+    std::ofstream file(config);
+    file << "[Alert]\nName = hot\nCondition = temp > slowdown - 5 ; before throttling\n"
+            "Command = sync ; logger \"$NVTOP_ALERT_MESSAGE\"\n"
+            "[Alert]\nName = idle_holder\nCondition = gpu < 10 && procmem > 10G\nDuration = 600\nFifo = /run/alerts\n";
+  }
+  LIST_HEAD(devices);
+  nvtop_interface_option options = {};
+  alloc_interface_options_internals(config, 0, &devices, &options);
+  ASSERT_TRUE(load_interface_options_from_config_file(0, &options));
+  ASSERT_TRUE(save_interface_options_to_config_file(0, &options));
+  alert_rules_free(options.alert_rules_count, options.alert_rules);
+  options.alert_rules_count = 0;
+  options.alert_rules = NULL;
+  ASSERT_TRUE(load_interface_options_from_config_file(0, &options));
+  unlink(config);
+
+  ASSERT_EQ(options.alert_rules_count, 2u);
+  EXPECT_STREQ(options.alert_rules[0].condition, "temp > slowdown - 5");
+  EXPECT_STREQ(options.alert_rules[0].command, "sync ; logger \"$NVTOP_ALERT_MESSAGE\"");
+  EXPECT_EQ(options.alert_rules[0].cooldown, ALERT_DEFAULT_COOLDOWN);
+  EXPECT_STREQ(options.alert_rules[1].name, "idle_holder");
+  EXPECT_EQ(options.alert_rules[1].duration, 600.);
+  EXPECT_STREQ(options.alert_rules[1].fifo, "/run/alerts");
+  EXPECT_EQ(options.alert_rules[1].command, nullptr);
+  alert_rules_free(options.alert_rules_count, options.alert_rules);
+  free(options.gpu_specific_opts);
+  free(options.config_file_location);
+}
+
+TEST(MemoryTrend, SlopeAndTimeToExhaust) {
+  struct memory_trend trend = {};
+  double slope, seconds;
+  ASSERT_TRUE(memory_trend_push(&trend, 0., 0.));
+  EXPECT_FALSE(memory_trend_push(&trend, 1., 1048576.));
+  EXPECT_FALSE(memory_trend_slope(&trend, &slope));
+  // 1MiB per second for 10 minutes, only the last 5 minutes are kept
+  for (unsigned i = 1; i <= 60; ++i)
+    ASSERT_TRUE(memory_trend_push(&trend, i * 10., i * 10. * 1048576.));
+  ASSERT_TRUE(memory_trend_slope(&trend, &slope));
+  EXPECT_NEAR(slope, 1048576., 1e-3);
+  EXPECT_TRUE(memory_trend_sustained(&trend));
+
+  // A single allocation step has a slope but is not a sustained growth, nor a growth over a minute only
+  struct memory_trend step = {}, short_trend = {};
+  for (unsigned i = 0; i <= 30; ++i) {
+    memory_trend_push(&step, i * 10., i < 15 ? 0. : 1e9);
+    if (i <= 6)
+      memory_trend_push(&short_trend, i * 10., i * 1e6);
+  }
+  double step_slope;
+  ASSERT_TRUE(memory_trend_slope(&step, &step_slope));
+  EXPECT_GT(step_slope, 0.);
+  EXPECT_FALSE(memory_trend_sustained(&step));
+  ASSERT_TRUE(memory_trend_slope(&short_trend, &step_slope));
+  EXPECT_FALSE(memory_trend_sustained(&short_trend));
+
+  ASSERT_TRUE(memory_trend_time_to_exhaust(slope, 3600. * 1048576., &seconds));
+  EXPECT_NEAR(seconds, 3600., 1e-6);
+  EXPECT_FALSE(memory_trend_time_to_exhaust(-slope, 3600. * 1048576., &seconds));
+  EXPECT_FALSE(memory_trend_time_to_exhaust(0., 3600. * 1048576., &seconds));
+}
+
+TEST(InterfaceOptions, AlertSectionWithoutName) {
+  char config[64];
+  snprintf(config, sizeof(config), "/tmp/nvtop-alert-noname-%d.ini", (int)getpid());
+  {
+    std::ofstream file(config);
+    file << "[Alert]\nName = hot\nCondition = temp > 80\nFifo = /dev/null\n"
+            "[Alert]\nCondition = gpu < 10\nFifo = /dev/null\n";
+  }
+  LIST_HEAD(devices);
+  nvtop_interface_option options = {};
+  alloc_interface_options_internals(config, 0, &devices, &options);
+  ASSERT_TRUE(load_interface_options_from_config_file(0, &options));
+  unlink(config);
+
+  // Not merged into the previous rule
+  ASSERT_EQ(options.alert_rules_count, 2u);
+  EXPECT_STREQ(options.alert_rules[0].condition, "temp > 80");
+  EXPECT_EQ(options.alert_rules[1].name, nullptr);
+  EXPECT_EQ(alert_engine_create(options.alert_rules_count, options.alert_rules), nullptr);
+  alert_rules_free(options.alert_rules_count, options.alert_rules);
+  free(options.gpu_specific_opts);
+  free(options.config_file_location);
+}
+
+TEST(InterfaceOptions, HistorySlotFollowsMonitoredDevices) {
+  std::array<struct gpu_info, 3> devices = {};
+  LIST_HEAD(monitored);
+  LIST_HEAD(not_monitored);
+  for (auto &device : devices)
+    list_add_tail(&device.list, &monitored);
+  nvtop_interface_option options = {};
+  char config[] = "/nonexistent/nvtop.ini";
+  alloc_interface_options_internals(config, devices.size(), &monitored, &options);
+
+  // Stop monitoring the first device then start again
+  options.gpu_specific_opts[0].doNotMonitor = true;
+  EXPECT_EQ(interface_check_and_fix_monitored_gpus(devices.size(), &monitored, &not_monitored, &options), 2u);
+  options.gpu_specific_opts[2].doNotMonitor = false;
+  options.gpu_specific_opts[1].doNotMonitor = true;
+  EXPECT_EQ(interface_check_and_fix_monitored_gpus(devices.size(), &monitored, &not_monitored, &options), 2u);
+
+  for (unsigned i = 0; i < devices.size(); ++i) {
+    const nvtop_interface_gpu_opts &opts = options.gpu_specific_opts[i];
+    EXPECT_EQ(opts.linkedGpu, &devices[opts.history_slot]);
+  }
+  // The options of the monitored devices come first, in the order of the list
+  unsigned idx = 0;
+  struct gpu_info *device;
+  list_for_each_entry(device, &monitored, list) { EXPECT_EQ(options.gpu_specific_opts[idx++].linkedGpu, device); }
+  EXPECT_EQ(idx, 2u);
+  free(options.gpu_specific_opts);
+  free(options.config_file_location);
+}
+
 #ifdef THOROUGH_TESTING
 
 TEST(InterfaceLayout, CheckManyTermSize) {
@@ -0,0 +1,94 @@
+/*
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of Nvtop.
+ *
+ * Nvtop is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nvtop is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with nvtop.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Time compute_sizes_from_layout over terminal sizes up to 500x200 and up to 256 devices, with and without the
+// layout cache. Usage: layoutBenchmark [size_step]
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+extern "C" {
+#include "nvtop/interface_layout_selection.h"
+#include "nvtop/interface_options.h"
+}
+
+namespace {
+
+struct layout_buffers {
+  std::vector<nvtop_interface_gpu_opts> plot_display;
+  std::vector<struct window_position> dev_positions;
+  std::vector<unsigned> map_dev_to_plot;
+  std::array<struct window_position, MAX_CHARTS> plot_positions;
+};
+
+void layout(layout_buffers &buffers, unsigned rows, unsigned cols) {
+  enum device_header_layout header_layout;
+  struct window_position legend_position, process_position, setup_position;
+  unsigned num_plots;
+  compute_sizes_from_layout(buffers.plot_display.size(), 3, 78, rows, cols, buffers.plot_display.data(),
+                            process_default_displayed_field(), &header_layout, buffers.dev_positions.data(),
+                            &legend_position, &num_plots, buffers.plot_positions.data(),
+                            buffers.map_dev_to_plot.data(), &process_position, &setup_position, false);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  unsigned step = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4;
+  if (!step)
+    step = 1;
+  const unsigned max_rows = 200, max_cols = 500;
+  const std::array<unsigned, 9> device_counts = {1, 2, 4, 8, 16, 32, 64, 128, 256};
+
+  std::printf("%8s %10s %16s %16s\n", "devices", "layouts", "computed (us)", "cached (us)");
+  for (unsigned devices : device_counts) {
+    layout_buffers buffers;
+    nvtop_interface_gpu_opts to_draw_default = {.to_draw = plot_default_draw_info()};
+    buffers.plot_display.assign(devices, to_draw_default);
+    buffers.dev_positions.resize(devices);
+    buffers.map_dev_to_plot.resize(devices);
+
+    using clock = std::chrono::steady_clock;
+    clock::duration computed{0}, cached{0};
+    unsigned layouts = 0;
+    for (unsigned rows = 1; rows <= max_rows; rows += step) {
+      for (unsigned cols = 1; cols <= max_cols; cols += step) {
+        layout_cache_clear();
+        clock::time_point start = clock::now();
+        layout(buffers, rows, cols);
+        clock::time_point middle = clock::now();
+        layout(buffers, rows, cols);
+        clock::time_point end = clock::now();
+        computed += middle - start;
+        cached += end - middle;
+        layouts++;
+      }
+    }
+    layout_cache_clear();
+    std::printf("%8u %10u %16.2f %16.2f\n", devices, layouts,
+                std::chrono::duration<double, std::micro>(computed).count() / layouts,
+                std::chrono::duration<double, std::micro>(cached).count() / layouts);
+  }
+  return EXIT_SUCCESS;
+}